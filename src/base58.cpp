@@ -264,6 +264,8 @@ public:
     std::string operator()(const CNoDestination& no) const { return {}; }
 };
 
+} // namespace
+
 CTxDestination DecodeDestination(const std::string& str, const CChainParams& params)
 {
     std::vector<unsigned char> data;
@@ -329,7 +331,6 @@ CTxDestination DecodeDestination(const std::string& str, const CChainParams& par
     }
     return CNoDestination();
 }
-} // namespace
 
 void CBitcoinSecret::SetKey(const CKey& vchSecret)
 {
@@ -0,0 +1,66 @@
+// Copyright (c) 2026 The PlexHive Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <bctindex.h>
+
+#include <chain.h>
+#include <consensus/params.h>
+#include <primitives/block.h>
+#include <util.h>
+
+static const char DB_BCT = 'c';
+
+std::unique_ptr<CBCTIndex> pbctIndex;
+
+CScript CBCTIndexEntry::BCTScript(const CScript& scriptPubKeyBCF) const
+{
+    CScript script(scriptPubKeyBCF);
+    script << OP_RETURN << OP_BEE;
+    script.insert(script.end(), scriptPubKeyHoney.begin(), scriptPubKeyHoney.end());
+    return script;
+}
+
+CBCTIndex::CBCTIndex(size_t nCacheSize, bool fMemory, bool fWipe) :
+    db(GetDataDir() / "bctindex", nCacheSize, fMemory, fWipe)
+{
+}
+
+bool CBCTIndex::Lookup(const uint256& txid, const CBlockIndex* pindexTip, CBCTIndexEntry& entry) const
+{
+    if (!db.Read(std::make_pair(DB_BCT, txid), entry))
+        return false;
+
+    // Left behind by a block that has since been reorged out, or isn't on this branch
+    const CBlockIndex* pindexBCT = pindexTip->GetAncestor(entry.nHeight);
+    return pindexBCT && pindexBCT->GetBlockHash() == entry.hashBlock;
+}
+
+bool CBCTIndex::WriteBlock(const CBlock& block, const CBlockIndex* pindex, const Consensus::Params& consensusParams)
+{
+    if (block.IsHiveMined(consensusParams))     // No BCTs will be found in Hivemined blocks
+        return true;
+
+    const CScript& scriptPubKeyBCF = consensusParams.scriptPubKeyBCF;
+    const CScript& scriptPubKeyCF = consensusParams.scriptPubKeyCF;
+    CDBBatch batch(db);
+    for (const auto& tx : block.vtx) {
+        if (tx->IsCoinBase())
+            continue;
+
+        CBCTIndexEntry entry;
+        if (!tx->IsBCT(consensusParams, scriptPubKeyBCF, &entry.nBeeFee, &entry.scriptPubKeyHoney))
+            continue;
+        entry.nHeight = pindex->nHeight;
+        entry.hashBlock = pindex->GetBlockHash();
+        if (tx->vout.size() > 1 && tx->vout[1].scriptPubKey == scriptPubKeyCF) {
+            entry.fCommunityContrib = true;
+            entry.nCommunityContrib = tx->vout[1].nValue;
+        }
+        batch.Write(std::make_pair(DB_BCT, tx->GetHash()), entry);
+    }
+
+    if (batch.SizeEstimate() == 0)
+        return true;
+    return db.WriteBatch(batch);
+}
@@ -0,0 +1,80 @@
+// Copyright (c) 2026 The PlexHive Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_BCTINDEX_H
+#define BITCOIN_BCTINDEX_H
+
+#include <amount.h>
+#include <dbwrapper.h>
+#include <script/script.h>
+#include <serialize.h>
+#include <uint256.h>
+
+#include <memory>
+
+class CBlock;
+class CBlockIndex;
+namespace Consensus { struct Params; }
+
+/** Maintain the BCT locator index by default */
+static const bool DEFAULT_BCTINDEX = true;
+
+/** What CheckHiveProof needs to know about a BCT, and where it was confirmed */
+struct CBCTIndexEntry
+{
+    int nHeight;
+    uint256 hashBlock;
+    CAmount nBeeFee;                // Value of the bee creation output
+    CScript scriptPubKeyHoney;      // Honey script carried by the bee creation output
+    bool fCommunityContrib;         // Whether the second output pays the community fund...
+    CAmount nCommunityContrib;      // ...and if so, how much
+
+    CBCTIndexEntry() : nHeight(-1), nBeeFee(0), fCommunityContrib(false), nCommunityContrib(0) {}
+
+    /** Rebuild the bee creation output's scriptPubKey, which IsBCTScript accepted when the entry was made */
+    CScript BCTScript(const CScript& scriptPubKeyBCF) const;
+
+    ADD_SERIALIZE_METHODS;
+
+    template <typename Stream, typename Operation>
+    inline void SerializationOp(Stream& s, Operation ser_action) {
+        READWRITE(nHeight);
+        READWRITE(hashBlock);
+        READWRITE(nBeeFee);
+        READWRITE(*(CScriptBase*)(&scriptPubKeyHoney));
+        READWRITE(fCommunityContrib);
+        READWRITE(nCommunityContrib);
+    }
+};
+
+/**
+ * BCT locator index.
+ *
+ * Maps each BCT's txid to a CBCTIndexEntry, written by ConnectBlock into
+ * LevelDB in the bctindex directory. When a BCT's outputs have left the UTXO
+ * set (spent, or not yet rebuilt during a reindex) CheckHiveProof looks it up
+ * here instead of reading its whole block back from disk. Entries are never
+ * removed on disconnect; each names its block, and a lookup only succeeds if
+ * that block is an ancestor of the block being validated.
+ */
+class CBCTIndex
+{
+private:
+    CDBWrapper db;
+
+public:
+    explicit CBCTIndex(size_t nCacheSize, bool fMemory = false, bool fWipe = false);
+
+    CBCTIndex(const CBCTIndex&) = delete;
+    CBCTIndex& operator=(const CBCTIndex&) = delete;
+
+    /** Fetch the entry for txid, if it was confirmed on the chain ending at pindexTip */
+    bool Lookup(const uint256& txid, const CBlockIndex* pindexTip, CBCTIndexEntry& entry) const;
+    /** Record the BCTs in block, which is at pindex */
+    bool WriteBlock(const CBlock& block, const CBlockIndex* pindex, const Consensus::Params& consensusParams);
+};
+
+extern std::unique_ptr<CBCTIndex> pbctIndex;
+
+#endif // BITCOIN_BCTINDEX_H
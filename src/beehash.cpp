@@ -0,0 +1,50 @@
+// Copyright (c) 2026 The PlexHive Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <beehash.h>
+
+#include <primitives/block.h>
+
+#include <algorithm>
+
+// Longest decimal rendering of a uint32_t
+static const size_t MAX_NONCE_DIGITS = 10;
+
+CBeeHasher::CBeeHasher(const std::string& deterministicRandString, const std::string& txid, bool minotaur) :
+    fMinotaur(minotaur), prefixWriter(SER_GETHASH, 0), prefixLength(0)
+{
+    if (!fMinotaur) {
+        prefixWriter << deterministicRandString << txid;
+        return;
+    }
+
+    prefixLength = deterministicRandString.size() + txid.size();
+    buffer.resize(prefixLength + MAX_NONCE_DIGITS + 1);
+    std::copy(deterministicRandString.begin(), deterministicRandString.end(), buffer.begin());
+    std::copy(txid.begin(), txid.end(), buffer.begin() + deterministicRandString.size());
+}
+
+arith_uint256 CBeeHasher::GetBeeHash(uint32_t beeNonce)
+{
+    if (!fMinotaur) {
+        CHashWriter ss(prefixWriter);
+        ss << beeNonce;
+        return UintToArith256(ss.GetHash());
+    }
+
+    // Write the nonce's decimal digits in place after the prefix
+    char digits[MAX_NONCE_DIGITS];
+    size_t digitCount = 0;
+    do {
+        digits[digitCount++] = '0' + (beeNonce % 10);
+        beeNonce /= 10;
+    } while (beeNonce > 0);
+
+    char* p = &buffer[prefixLength];
+    while (digitCount > 0)
+        *p++ = digits[--digitCount];
+    *p = '\0';
+
+    return UintToArith256(CBlockHeader::MinotaurHashArbitrary(buffer.data()));
+}
@@ -0,0 +1,47 @@
+// Copyright (c) 2026 The PlexHive Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_BEEHASH_H
+#define BITCOIN_BEEHASH_H
+
+#include <arith_uint256.h>
+#include <hash.h>
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+/**
+ * PlexHive: Hive: Mining optimisations: Zero-allocation bee hash kernel.
+ *
+ * A bee's hash only varies with its nonce; the deterministicRandString and
+ * BCT txid are fixed for a whole CBeeRange. Everything that doesn't depend on
+ * the nonce is serialized once at construction, so checking a bee costs one
+ * hash and no string formatting or heap allocation.
+ *
+ * Results are bit-identical to the original string-based formulations:
+ *  - sha256d (Hive 1.0/1.1):   CHashWriter << deterministicRandString << txid << nonce
+ *  - Minotaur (Hive 1.2):      Minotaur(deterministicRandString + txid + decimal(nonce))
+ */
+class CBeeHasher
+{
+private:
+    bool fMinotaur;
+    CHashWriter prefixWriter;       // sha256d: hash state after deterministicRandString and txid
+    std::vector<char> buffer;       // Minotaur: deterministicRandString + txid, then room for nonce digits and a terminator
+    size_t prefixLength;
+
+public:
+    CBeeHasher(const std::string& deterministicRandString, const std::string& txid, bool minotaur);
+
+    /** Get the given bee's hash, ready to be compared against the bee hash target */
+    arith_uint256 GetBeeHash(uint32_t beeNonce);
+
+    /** Check whether the given bee meets the bee hash target */
+    bool CheckBee(uint32_t beeNonce, const arith_uint256& beeHashTarget) {
+        return GetBeeHash(beeNonce) < beeHashTarget;
+    }
+};
+
+#endif // BITCOIN_BEEHASH_H
@@ -0,0 +1,162 @@
+// Copyright (c) 2026 The PlexHive Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <beepopindex.h>
+
+#include <base58.h>
+#include <blockfilereader.h>
+#include <chain.h>
+#include <primitives/block.h>
+#include <script/standard.h>
+#include <util.h>
+#include <validation.h>
+
+#include <algorithm>
+
+static const char DB_BEEPOP = 'p';
+
+std::unique_ptr<CBeePopulationIndex> pbeePopIndex;
+
+static size_t WindowSize(const Consensus::Params& consensusParams)
+{
+    return consensusParams.beeGestationBlocks + consensusParams.beeLifespanBlocks;
+}
+
+CBeePopulationIndex::CBeePopulationIndex(const Consensus::Params& consensusParamsIn, size_t nCacheSize, bool fMemory, bool fWipe) :
+    db(GetDataDir() / "beepop", nCacheSize, fMemory, fWipe), consensusParams(consensusParamsIn), ring(WindowSize(consensusParamsIn))
+{
+    std::unique_ptr<CDBIterator> pcursor(db.NewIterator());
+    pcursor->Seek(std::make_pair(DB_BEEPOP, (uint32_t)0));
+    size_t nLoaded = 0;
+    for (; pcursor->Valid(); pcursor->Next()) {
+        std::pair<char, uint32_t> key;
+        if (!pcursor->GetKey(key) || key.first != DB_BEEPOP)
+            break;
+        CBeePopEntry entry;
+        if (!pcursor->GetValue(entry) || entry.nHeight < 0)
+            continue;
+        if (key.second >= ring.size() || key.second != entry.nHeight % ring.size())
+            continue;   // Written with a different window; it'll be refilled
+        ring[key.second] = entry;
+        nLoaded++;
+    }
+    LogPrint(BCLog::HIVE, "%s: Loaded %u of %u entries\n", __func__, nLoaded, ring.size());
+}
+
+bool CBeePopulationIndex::Lookup(const CBlockIndex* pindex, CBeePopEntry& entry) const
+{
+    LOCK(cs);
+    const CBeePopEntry& slot = ring[pindex->nHeight % ring.size()];
+    if (slot.nHeight != pindex->nHeight || slot.hashBlock != pindex->GetBlockHash())
+        return false;
+    entry = slot;
+    return true;
+}
+
+void CBeePopulationIndex::Store(const CBeePopEntry& entry)
+{
+    uint32_t nSlot = entry.nHeight % ring.size();
+    LOCK(cs);
+    ring[nSlot] = entry;
+    db.Write(std::make_pair(DB_BEEPOP, nSlot), entry);
+}
+
+void CBeePopulationIndex::BlockConnected(const std::shared_ptr<const CBlock>& pblock, const CBlockIndex* pindex, const std::vector<CTransactionRef>& vtxConflicted)
+{
+    CBeePopEntry entry;
+    CountBlockBees(*pblock, pindex, consensusParams, entry);
+    Store(entry);
+}
+
+void CountBlockBees(const CBlock& block, const CBlockIndex* pindex, const Consensus::Params& consensusParams, CBeePopEntry& entry)
+{
+    entry.nHeight = pindex->nHeight;
+    entry.hashBlock = pindex->GetBlockHash();
+    entry.nBees = entry.nBCTs = 0;
+
+    if (block.IsHiveMined(consensusParams))     // No BCTs will be found in Hivemined blocks
+        return;
+
+    const CScript& scriptPubKeyBCF = consensusParams.scriptPubKeyBCF;
+    const CScript& scriptPubKeyCF = consensusParams.scriptPubKeyCF;
+    CAmount beeCost = GetBeeCost(pindex->nHeight, consensusParams);
+    for (const auto& tx : block.vtx) {
+        CAmount beeFeePaid;
+        if (!tx->IsBCT(consensusParams, scriptPubKeyBCF, &beeFeePaid))
+            continue;
+        if (tx->vout.size() > 1 && tx->vout[1].scriptPubKey == scriptPubKeyCF) {    // If it has a community fund contrib...
+            CAmount donationAmount = tx->vout[1].nValue;
+            CAmount expectedDonationAmount = (beeFeePaid + donationAmount) / consensusParams.communityContribFactor;  // ...check for valid donation amount
+            // PlexHive: MinotaurX+Hive1.2
+            if (IsMinotaurXEnabled(pindex, consensusParams))
+                expectedDonationAmount += expectedDonationAmount >> 1;
+            if (donationAmount != expectedDonationAmount)
+                continue;
+            beeFeePaid += donationAmount;                                           // Add donation amount back to total paid
+        }
+        entry.nBees += beeFeePaid / beeCost;
+        entry.nBCTs++;
+    }
+}
+
+bool GetBlockBees(const CBlockIndex* pindex, const Consensus::Params& consensusParams, CBeePopEntry& entry, CSequentialBlockReader* blockReader)
+{
+    if (pbeePopIndex && pbeePopIndex->Lookup(pindex, entry))
+        return true;
+
+    if (pindex->GetBlockHeader().IsHiveMined(consensusParams)) {
+        entry.nHeight = pindex->nHeight;
+        entry.hashBlock = pindex->GetBlockHash();
+        entry.nBees = entry.nBCTs = 0;
+        return true;
+    }
+
+    if (fHavePruned && !(pindex->nStatus & BLOCK_HAVE_DATA) && pindex->nTx > 0) {
+        LogPrintf("! GetBlockBees: Warn: Block not available (pruned data); can't calculate network bee count.\n");
+        return false;
+    }
+
+    CBlock block;
+    if (blockReader ? !blockReader->Read(block, pindex) : !ReadBlockFromDisk(block, pindex, consensusParams)) {
+        LogPrintf("! GetBlockBees: Warn: Block not available (not found on disk); can't calculate network bee count.\n");
+        return false;
+    }
+    CountBlockBees(block, pindex, consensusParams, entry);
+    if (pbeePopIndex)
+        pbeePopIndex->Store(entry);
+    return true;
+}
+
+void BuildBeePopGraph(const std::vector<CBeePopEntry>& entries, int tipHeight, const Consensus::Params& consensusParams, std::vector<BeePopGraphPoint>& graph)
+{
+    const int totalBeeLifespan = WindowSize(consensusParams);
+    std::vector<int> immatureDelta(totalBeeLifespan + 1, 0);
+    std::vector<int> matureDelta(totalBeeLifespan + 1, 0);
+
+    // Graph position 0 is the tip itself and isn't plotted
+    auto addSpan = [&](std::vector<int>& delta, int fromHeight, int toHeight, int bees) {
+        int start = std::max(fromHeight - tipHeight, 1);
+        int stop = std::min(toHeight - tipHeight, totalBeeLifespan);
+        if (start < stop) {
+            delta[start] += bees;
+            delta[stop] -= bees;
+        }
+    };
+
+    for (const CBeePopEntry& entry : entries) {
+        int beeMaturesBlock = entry.nHeight + consensusParams.beeGestationBlocks;
+        int beeDiesBlock = beeMaturesBlock + consensusParams.beeLifespanBlocks;
+        addSpan(immatureDelta, entry.nHeight, beeMaturesBlock, entry.nBees);
+        addSpan(matureDelta, beeMaturesBlock, beeDiesBlock, entry.nBees);
+    }
+
+    graph.resize(totalBeeLifespan);
+    int immaturePop = 0, maturePop = 0;
+    for (int i = 0; i < totalBeeLifespan; i++) {
+        immaturePop += immatureDelta[i];
+        maturePop += matureDelta[i];
+        graph[i].immaturePop = immaturePop;
+        graph[i].maturePop = maturePop;
+    }
+}
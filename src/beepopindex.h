@@ -0,0 +1,96 @@
+// Copyright (c) 2026 The PlexHive Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_BEEPOPINDEX_H
+#define BITCOIN_BEEPOPINDEX_H
+
+#include <dbwrapper.h>
+#include <pow.h>
+#include <serialize.h>
+#include <sync.h>
+#include <uint256.h>
+#include <validationinterface.h>
+
+#include <memory>
+#include <vector>
+
+class CBlock;
+class CBlockIndex;
+class CSequentialBlockReader;
+
+/** Bees created by the BCTs in a single block */
+struct CBeePopEntry
+{
+    int nHeight;
+    uint256 hashBlock;
+    int nBees;
+    int nBCTs;
+
+    CBeePopEntry() : nHeight(-1), nBees(0), nBCTs(0) {}
+
+    ADD_SERIALIZE_METHODS;
+
+    template <typename Stream, typename Operation>
+    inline void SerializationOp(Stream& s, Operation ser_action) {
+        READWRITE(nHeight);
+        READWRITE(hashBlock);
+        READWRITE(nBees);
+        READWRITE(nBCTs);
+    }
+};
+
+/**
+ * Network bee population index.
+ *
+ * Holds a CBeePopEntry for each of the last beeGestationBlocks +
+ * beeLifespanBlocks heights, in a ring buffer indexed by height modulo that
+ * window, filled in as blocks connect. The ring is mirrored to LevelDB in
+ * the beepop directory so it survives restarts. Each entry names its block, so
+ * entries left behind by a reorg are recognised as stale on lookup and simply
+ * overwritten when the replacement block connects. Informational only;
+ * consensus never consults it.
+ */
+class CBeePopulationIndex : public CValidationInterface
+{
+private:
+    CDBWrapper db;
+    const Consensus::Params& consensusParams;
+    mutable CCriticalSection cs;
+    std::vector<CBeePopEntry> ring;
+
+public:
+    CBeePopulationIndex(const Consensus::Params& consensusParams, size_t nCacheSize, bool fMemory = false, bool fWipe = false);
+
+    CBeePopulationIndex(const CBeePopulationIndex&) = delete;
+    CBeePopulationIndex& operator=(const CBeePopulationIndex&) = delete;
+
+    /** Fetch the entry for pindex, if it's held */
+    bool Lookup(const CBlockIndex* pindex, CBeePopEntry& entry) const;
+    /** Record an entry, replacing whatever shared its slot */
+    void Store(const CBeePopEntry& entry);
+
+protected:
+    void BlockConnected(const std::shared_ptr<const CBlock>& pblock, const CBlockIndex* pindex, const std::vector<CTransactionRef>& vtxConflicted) override;
+};
+
+extern std::unique_ptr<CBeePopulationIndex> pbeePopIndex;
+
+/** Count the bees created by the BCTs in block, which is at pindex */
+void CountBlockBees(const CBlock& block, const CBlockIndex* pindex, const Consensus::Params& consensusParams, CBeePopEntry& entry);
+
+/**
+ * Get the bees created at pindex from the population index, falling back to reading the block from disk,
+ * through blockReader if given
+ */
+bool GetBlockBees(const CBlockIndex* pindex, const Consensus::Params& consensusParams, CBeePopEntry& entry, CSequentialBlockReader* blockReader = nullptr);
+
+/**
+ * Build the population graph for the beeGestationBlocks + beeLifespanBlocks
+ * heights following tipHeight from the entries in that window. Each entry
+ * contributes to two height spans (gestation and life), which are applied as
+ * deltas and prefix-summed, so the cost is O(window + entries).
+ */
+void BuildBeePopGraph(const std::vector<CBeePopEntry>& entries, int tipHeight, const Consensus::Params& consensusParams, std::vector<BeePopGraphPoint>& graph);
+
+#endif // BITCOIN_BEEPOPINDEX_H
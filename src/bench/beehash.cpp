@@ -0,0 +1,71 @@
+// Copyright (c) 2026 The PlexHive Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <bench/bench.h>
+#include <arith_uint256.h>
+#include <beehash.h>
+#include <hash.h>
+#include <primitives/block.h>
+
+#include <sstream>
+
+// Each iteration checks a single bee, so the reported times are seconds per
+// bee; bees/second for one core is their reciprocal. The *Legacy variants are
+// the string-formatting paths CheckBin/CheckBinMinotaur used before CBeeHasher.
+
+static const std::string detRandString =
+    "5f2e7ab91d3c4a0e8f6b2d1c9a7e3f05b4c8d2e6f1a3b5c7d9e0f2a4b6c8d0e2"
+    "0e1d2c3b4a5968778695a4b3c2d1e0f0f1e2d3c4b5a69788796a5b4c3d2e1f00";
+static const std::string bctTxid = "8a7c2e5d9b1f3a6c4e0d8b2f7a5c3e1d9b7f5a3c1e0d2b4f6a8c0e2d4b6f8a0c";
+
+// Hive 1.0/1.1: sha256d inner hash
+static void BeeHashSHA256d(benchmark::State& state)
+{
+    CBeeHasher hasher(detRandString, bctTxid, false);
+    arith_uint256 beeHashTarget = arith_uint256().SetCompact(0x1e00ffff);
+    uint32_t beeNonce = 0;
+    uint32_t found = 0;
+    while (state.KeepRunning())
+        found += hasher.CheckBee(beeNonce++, beeHashTarget);
+}
+
+static void BeeHashSHA256dLegacy(benchmark::State& state)
+{
+    arith_uint256 beeHashTarget = arith_uint256().SetCompact(0x1e00ffff);
+    int beeNonce = 0;
+    uint32_t found = 0;
+    while (state.KeepRunning()) {
+        std::string hashHex = (CHashWriter(SER_GETHASH, 0) << detRandString << bctTxid << beeNonce++).GetHash().GetHex();
+        found += arith_uint256(hashHex) < beeHashTarget;
+    }
+}
+
+// Hive 1.2: Minotaur inner hash
+static void BeeHashMinotaur(benchmark::State& state)
+{
+    CBeeHasher hasher(detRandString, bctTxid, true);
+    arith_uint256 beeHashTarget = arith_uint256().SetCompact(0x1e00ffff);
+    uint32_t beeNonce = 0;
+    uint32_t found = 0;
+    while (state.KeepRunning())
+        found += hasher.CheckBee(beeNonce++, beeHashTarget);
+}
+
+static void BeeHashMinotaurLegacy(benchmark::State& state)
+{
+    arith_uint256 beeHashTarget = arith_uint256().SetCompact(0x1e00ffff);
+    int beeNonce = 0;
+    uint32_t found = 0;
+    while (state.KeepRunning()) {
+        std::stringstream buf;
+        buf << detRandString << bctTxid << beeNonce++;
+        arith_uint256 beeHash(CBlockHeader::MinotaurHashString(buf.str()).ToString());
+        found += beeHash < beeHashTarget;
+    }
+}
+
+BENCHMARK(BeeHashSHA256d, 800 * 1000);
+BENCHMARK(BeeHashSHA256dLegacy, 300 * 1000);
+BENCHMARK(BeeHashMinotaur, 60 * 1000);
+BENCHMARK(BeeHashMinotaurLegacy, 50 * 1000);
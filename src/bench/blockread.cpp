@@ -0,0 +1,118 @@
+// Copyright (c) 2026 The PlexHive Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <bench/bench.h>
+
+#include <arith_uint256.h>
+#include <chain.h>
+#include <chainparams.h>
+#include <clientversion.h>
+#include <fs.h>
+#include <pow.h>
+#include <random.h>
+#include <streams.h>
+#include <util.h>
+#include <validation.h>
+
+namespace block_bench {
+#include <bench/data/block413567.raw.h>
+} // namespace block_bench
+
+// Reads of an already-validated block, as made when serving getdata, getblock,
+// REST and wallet rescans. The *Paranoid variants re-check the block's proof on
+// every read, as all reads did before -paranoidblockreads became opt-in. The
+// paranoid Hive read isn't measured, as CheckHiveProof needs a chainstate
+// holding the BCT being proven.
+
+// Nonces meeting the target below for each test header, found in advance so
+// setup doesn't have to grind for them
+static const uint32_t NONCE_SHA256D = 556;
+static const uint32_t NONCE_MINOTAURX = 183;
+
+// The mainnet benchmark block's transactions, under a post-fork header of the given type
+static CBlock MakeBlock(POW_TYPE powType, bool fHive)
+{
+    CDataStream stream((const char*)block_bench::block413567,
+            (const char*)&block_bench::block413567[sizeof(block_bench::block413567)],
+            SER_NETWORK, PROTOCOL_VERSION);
+    CBlock block;
+    stream >> block;
+
+    const Consensus::Params& consensusParams = Params().GetConsensus();
+    block.nVersion = powType << 16;
+    block.nTime = consensusParams.powForkTime + 1;
+    block.nBits = UintToArith256(consensusParams.powTypeLimits[POW_TYPE_MINOTAURX]).GetCompact();
+    if (fHive) {
+        block.nNonce = consensusParams.hiveNonceMarker;
+        return block;
+    }
+
+    block.nNonce = powType == POW_TYPE_MINOTAURX ? NONCE_MINOTAURX : NONCE_SHA256D;
+    while (!CheckProofOfWork(block.GetPoWHash(), block.nBits, consensusParams))
+        block.nNonce++;
+    return block;
+}
+
+// Stores a block in a scratch datadir and indexes it as fully validated
+class BlockReadFixture
+{
+private:
+    fs::path dir;
+    uint256 hash;
+
+public:
+    CBlockIndex index;
+
+    explicit BlockReadFixture(const CBlock& block) : hash(block.GetHash()), index(block)
+    {
+        dir = fs::temp_directory_path() / strprintf("bench_blockread_%lu", (unsigned long)GetRand(1ULL << 32));
+        gArgs.ForceSetArg("-datadir", dir.string());
+        ClearDatadirCache();
+
+        CDiskBlockPos pos(0, 0);
+        {
+            CAutoFile fileout(OpenBlockFile(pos), SER_DISK, CLIENT_VERSION);
+            assert(!fileout.IsNull());
+            fileout << block;
+        }
+
+        index.phashBlock = &hash;
+        index.nFile = pos.nFile;
+        index.nDataPos = pos.nPos;
+        index.nStatus = BLOCK_VALID_SCRIPTS | BLOCK_HAVE_DATA;
+    }
+
+    ~BlockReadFixture()
+    {
+        ClearDatadirCache();
+        fs::remove_all(dir);
+    }
+};
+
+static void ReadBlock(benchmark::State& state, POW_TYPE powType, bool fHive, bool fParanoid)
+{
+    SelectParams(CBaseChainParams::MAIN);
+    BlockReadFixture fixture(MakeBlock(powType, fHive));
+    const Consensus::Params& consensusParams = Params().GetConsensus();
+
+    fParanoidBlockReads = fParanoid;
+    while (state.KeepRunning()) {
+        CBlock block;
+        bool ret = ReadBlockFromDisk(block, &fixture.index, consensusParams);
+        assert(ret);
+    }
+    fParanoidBlockReads = DEFAULT_PARANOID_BLOCK_READS;
+}
+
+static void BlockReadSHA256d(benchmark::State& state) { ReadBlock(state, POW_TYPE_SHA256, false, false); }
+static void BlockReadSHA256dParanoid(benchmark::State& state) { ReadBlock(state, POW_TYPE_SHA256, false, true); }
+static void BlockReadMinotaurX(benchmark::State& state) { ReadBlock(state, POW_TYPE_MINOTAURX, false, false); }
+static void BlockReadMinotaurXParanoid(benchmark::State& state) { ReadBlock(state, POW_TYPE_MINOTAURX, false, true); }
+static void BlockReadHive(benchmark::State& state) { ReadBlock(state, POW_TYPE_SHA256, true, false); }
+
+BENCHMARK(BlockReadSHA256d, 100);
+BENCHMARK(BlockReadSHA256dParanoid, 100);
+BENCHMARK(BlockReadMinotaurX, 100);
+BENCHMARK(BlockReadMinotaurXParanoid, 100);
+BENCHMARK(BlockReadHive, 100);
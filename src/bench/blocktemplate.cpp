@@ -0,0 +1,161 @@
+// Copyright (c) 2026 The PlexHive Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <bench/bench.h>
+
+#include <blocktemplate.h>
+#include <chainparams.h>
+#include <consensus/merkle.h>
+#include <consensus/validation.h>
+#include <fs.h>
+#include <miner.h>
+#include <pow.h>
+#include <random.h>
+#include <scheduler.h>
+#include <script/sigcache.h>
+#include <txdb.h>
+#include <txmempool.h>
+#include <util.h>
+#include <validation.h>
+#include <validationinterface.h>
+
+#include <assert.h>
+
+#include <boost/thread.hpp>
+
+// Time taken to get a block template, as getblocktemplate, the pow miner and
+// BusyBees would, against the number of transactions in the mempool.
+// BlockTemplate* assemble one from scratch with the engine stopped;
+// BlockTemplateReady* serve one from the engine's ready selection. Each
+// mempool transaction spends its own output of a confirmed fanout, so all
+// are independent packages of one.
+
+class BlockTemplateFixture
+{
+public:
+    fs::path pathTemp;
+    CScheduler scheduler;
+    boost::thread threadScheduler;
+    CScript scriptPubKey;
+
+    explicit BlockTemplateFixture(size_t nTxs, bool fEngine)
+    {
+        SelectParams(CBaseChainParams::REGTEST);
+        const CChainParams& chainparams = Params();
+        InitSignatureCache();
+        InitScriptExecutionCache();
+
+        ClearDatadirCache();
+        pathTemp = fs::temp_directory_path() / strprintf("bench_plexhive_%lu_%i", (unsigned long)GetTime(), (int)GetRand(100000));
+        fs::create_directories(pathTemp);
+        gArgs.ForceSetArg("-datadir", pathTemp.string());
+
+        // Block connection queues callbacks, so something has to run them
+        threadScheduler = boost::thread(boost::bind(&CScheduler::serviceQueue, &scheduler));
+        GetMainSignals().RegisterBackgroundSignalScheduler(scheduler);
+
+        pblocktree.reset(new CBlockTreeDB(1 << 20, true));
+        pcoinsdbview.reset(new CCoinsViewDB(1 << 23, true));
+        pcoinsTip.reset(new CCoinsViewCache(pcoinsdbview.get()));
+        bool ret = LoadGenesisBlock(chainparams);
+        assert(ret);
+        CValidationState state;
+        ret = ActivateBestChain(state, chainparams);
+        assert(ret);
+
+        // Mature a coinbase, then confirm a transaction fanning it out to an output per mempool transaction
+        scriptPubKey = CScript() << OP_TRUE;
+        CTransactionRef coinbase = Mine();
+        for (int i = 0; i < COINBASE_MATURITY; i++)
+            Mine();
+        CMutableTransaction fanout;
+        fanout.vin.resize(1);
+        fanout.vin[0].prevout = COutPoint(coinbase->GetHash(), 0);
+        fanout.vout.resize(nTxs);
+        for (CTxOut& out : fanout.vout) {
+            out.nValue = (coinbase->vout[0].nValue - COIN) / nTxs;
+            out.scriptPubKey = scriptPubKey;
+        }
+        CTransactionRef fanoutRef = MakeTransactionRef(fanout);
+        {
+            LOCK2(cs_main, mempool.cs);
+            mempool.addUnchecked(fanoutRef->GetHash(), CTxMemPoolEntry(fanoutRef, COIN, 0, chainActive.Height(), true, 4, LockPoints()));
+        }
+        Mine();
+        assert(mempool.size() == 0);
+
+        LOCK2(cs_main, mempool.cs);
+        for (size_t i = 0; i < nTxs; i++) {
+            CMutableTransaction tx;
+            tx.vin.resize(1);
+            tx.vin[0].prevout = COutPoint(fanoutRef->GetHash(), i);
+            tx.vout.resize(1);
+            const CAmount nFee = 1000 + i;
+            tx.vout[0].nValue = fanout.vout[i].nValue - nFee;
+            tx.vout[0].scriptPubKey = scriptPubKey;
+            mempool.addUnchecked(tx.GetHash(), CTxMemPoolEntry(MakeTransactionRef(tx), nFee, 0, chainActive.Height(), false, 4, LockPoints()));
+        }
+
+        if (fEngine) {
+            blockTemplateEngine.Start();
+            blockTemplateEngine.Rebuild();
+        }
+    }
+
+    ~BlockTemplateFixture()
+    {
+        blockTemplateEngine.Stop();
+        threadScheduler.interrupt();
+        threadScheduler.join();
+        GetMainSignals().FlushBackgroundCallbacks();
+        GetMainSignals().UnregisterBackgroundSignalScheduler();
+        mempool.clear();
+        UnloadBlockIndex();
+        pcoinsTip.reset();
+        pcoinsdbview.reset();
+        pblocktree.reset();
+        fs::remove_all(pathTemp);
+    }
+
+    // Mine a block of what's in the mempool, returning its coinbase
+    CTransactionRef Mine()
+    {
+        const CChainParams& chainparams = Params();
+        std::unique_ptr<CBlockTemplate> pblocktemplate = BlockAssembler(chainparams).CreateNewBlock(scriptPubKey);
+        CBlock& block = pblocktemplate->block;
+        block.hashMerkleRoot = BlockMerkleRoot(block);
+        while (!CheckProofOfWork(block.GetPoWHash(), block.nBits, chainparams.GetConsensus()))
+            ++block.nNonce;
+        bool ret = ProcessNewBlock(chainparams, std::make_shared<const CBlock>(block), true, nullptr);
+        assert(ret);
+        return block.vtx[0];
+    }
+
+    void GetTemplate()
+    {
+        std::unique_ptr<CBlockTemplate> pblocktemplate = BlockAssembler(Params()).CreateNewBlock(scriptPubKey);
+        assert(pblocktemplate->block.vtx.size() > 1);
+    }
+};
+
+static void BlockTemplate(benchmark::State& state, size_t nTxs, bool fEngine)
+{
+    BlockTemplateFixture fixture(nTxs, fEngine);
+    while (state.KeepRunning())
+        fixture.GetTemplate();
+}
+
+static void BlockTemplate100(benchmark::State& state) { BlockTemplate(state, 100, false); }
+static void BlockTemplate1000(benchmark::State& state) { BlockTemplate(state, 1000, false); }
+static void BlockTemplate5000(benchmark::State& state) { BlockTemplate(state, 5000, false); }
+static void BlockTemplateReady100(benchmark::State& state) { BlockTemplate(state, 100, true); }
+static void BlockTemplateReady1000(benchmark::State& state) { BlockTemplate(state, 1000, true); }
+static void BlockTemplateReady5000(benchmark::State& state) { BlockTemplate(state, 5000, true); }
+
+BENCHMARK(BlockTemplate100, 500);
+BENCHMARK(BlockTemplate1000, 50);
+BENCHMARK(BlockTemplate5000, 10);
+BENCHMARK(BlockTemplateReady100, 5000);
+BENCHMARK(BlockTemplateReady1000, 2000);
+BENCHMARK(BlockTemplateReady5000, 500);
@@ -5,8 +5,12 @@
 #include <bench/bench.h>
 #include <coins.h>
 #include <policy/policy.h>
+#include <random.h>
+#include <script/standard.h>
 #include <wallet/crypter.h>
 
+#include <memory>
+#include <unordered_map>
 #include <vector>
 
 // FIXME: Dedup with SetupDummyInputs in test/transaction_tests.cpp.
@@ -84,4 +88,113 @@ static void CCoinsCaching(benchmark::State& state)
     }
 }
 
+
+// UTXO churn as blocks connect, on a coins map the size of a busy cache. Each
+// round spends coins picked at random from those in the map, creates as many
+// new ones and looks up outpoints that aren't there, as checking inputs and
+// adding outputs does. CCoinsMapChurn runs it on the map CCoinsViewCache uses,
+// and UnorderedCoinsMapChurn on the std::unordered_map it used before.
+// CCoinsViewCacheChurn does the same through a CCoinsViewCache, flushing it
+// into its parent every so often as ConnectTip does.
+static const size_t CHURN_MAP_SIZE = 200 * 1000;
+static const size_t CHURN_PER_ROUND = 16;
+static const size_t CHURN_ROUNDS_PER_FLUSH = 200;
+
+typedef std::unordered_map<COutPoint, CCoinsCacheEntry, SaltedOutpointHasher> UnorderedCoinsMap;
+
+static COutPoint RandomOutPoint(FastRandomContext& rng)
+{
+    return COutPoint(rng.rand256(), rng.randrange(4));
+}
+
+static Coin RandomCoin(FastRandomContext& rng)
+{
+    Coin coin;
+    coin.out.nValue = rng.randrange(50 * COIN);
+    coin.out.scriptPubKey = GetScriptForDestination(CKeyID(uint160(rng.randbytes(20))));
+    coin.nHeight = 1;
+    return coin;
+}
+
+template <typename Map>
+static void CoinsMapChurn(benchmark::State& state)
+{
+    FastRandomContext rng(true);
+    Map map;
+    std::vector<COutPoint> live;
+    live.reserve(CHURN_MAP_SIZE);
+    while (live.size() < CHURN_MAP_SIZE) {
+        live.push_back(RandomOutPoint(rng));
+        map.emplace(live.back(), CCoinsCacheEntry(RandomCoin(rng)));
+    }
+    std::vector<Coin> fresh(CHURN_PER_ROUND);
+    for (Coin& coin : fresh)
+        coin = RandomCoin(rng);
+
+    while (state.KeepRunning()) {
+        for (size_t i = 0; i < CHURN_PER_ROUND; i++) {
+            COutPoint& spend = live[rng.randrange(live.size())];
+            auto it = map.find(spend);
+            assert(it != map.end());
+            map.erase(it);
+
+            spend = RandomOutPoint(rng);
+            map.emplace(spend, CCoinsCacheEntry(Coin(fresh[i])));
+
+            bool missing = map.find(RandomOutPoint(rng)) == map.end();
+            assert(missing);
+        }
+    }
+}
+
+static void CCoinsMapChurn(benchmark::State& state)
+{
+    CoinsMapChurn<CCoinsMap>(state);
+}
+
+static void UnorderedCoinsMapChurn(benchmark::State& state)
+{
+    CoinsMapChurn<UnorderedCoinsMap>(state);
+}
+
+static void CCoinsViewCacheChurn(benchmark::State& state)
+{
+    FastRandomContext rng(true);
+    CCoinsView coinsDummy;
+    CCoinsViewCache coinsTip(&coinsDummy);
+    std::vector<COutPoint> live;
+    live.reserve(CHURN_MAP_SIZE);
+    while (live.size() < CHURN_MAP_SIZE) {
+        live.push_back(RandomOutPoint(rng));
+        coinsTip.AddCoin(live.back(), RandomCoin(rng), false);
+    }
+    std::vector<Coin> fresh(CHURN_PER_ROUND);
+    for (Coin& coin : fresh)
+        coin = RandomCoin(rng);
+
+    std::unique_ptr<CCoinsViewCache> view(new CCoinsViewCache(&coinsTip));
+    size_t nRounds = 0;
+    while (state.KeepRunning()) {
+        for (size_t i = 0; i < CHURN_PER_ROUND; i++) {
+            COutPoint& spend = live[rng.randrange(live.size())];
+            bool spent = view->SpendCoin(spend);
+            assert(spent);
+
+            spend = RandomOutPoint(rng);
+            view->AddCoin(spend, Coin(fresh[i]), false);
+
+            bool missing = !view->HaveCoin(RandomOutPoint(rng));
+            assert(missing);
+        }
+        if (++nRounds % CHURN_ROUNDS_PER_FLUSH == 0) {
+            bool flushed = view->Flush();
+            assert(flushed);
+            view.reset(new CCoinsViewCache(&coinsTip));
+        }
+    }
+}
+
 BENCHMARK(CCoinsCaching, 170 * 1000);
+BENCHMARK(CCoinsMapChurn, 20 * 1000);
+BENCHMARK(UnorderedCoinsMapChurn, 20 * 1000);
+BENCHMARK(CCoinsViewCacheChurn, 10 * 1000);
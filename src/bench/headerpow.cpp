@@ -0,0 +1,74 @@
+// Copyright (c) 2026 The PlexHive Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <bench/bench.h>
+
+#include <arith_uint256.h>
+#include <chainparams.h>
+#include <checkqueue.h>
+#include <primitives/block.h>
+#include <util.h>
+#include <validation.h>
+
+#include <boost/thread/thread.hpp>
+
+// Proof of work checks for a headers message's worth of MinotaurX headers, as
+// made by ProcessNewBlockHeaders before it takes cs_main. Each iteration checks
+// HEADERS_PER_BATCH headers, so headers/s is HEADERS_PER_BATCH divided by the
+// reported time. The headers needn't meet their target; checking costs the same.
+
+static const int MIN_CORES = 2;
+static const size_t HEADERS_PER_BATCH = 100;
+
+static std::vector<CBlockHeader> MakeMinotaurXHeaderChain()
+{
+    SelectParams(CBaseChainParams::MAIN);
+    const Consensus::Params& consensusParams = Params().GetConsensus();
+
+    std::vector<CBlockHeader> headers(HEADERS_PER_BATCH);
+    uint256 hashPrev;
+    for (size_t i = 0; i < headers.size(); i++) {
+        CBlockHeader& header = headers[i];
+        header.nVersion = POW_TYPE_MINOTAURX << 16;
+        header.hashPrevBlock = hashPrev;
+        header.hashMerkleRoot = uint256S(strprintf("%064x", i + 1));
+        header.nTime = consensusParams.powForkTime + 1 + 60 * i;
+        header.nBits = UintToArith256(consensusParams.powTypeLimits[POW_TYPE_MINOTAURX]).GetCompact();
+        header.nNonce = i;
+        hashPrev = header.GetHash();
+    }
+    return headers;
+}
+
+static void HeaderPoWSerial(benchmark::State& state)
+{
+    const std::vector<CBlockHeader> headers = MakeMinotaurXHeaderChain();
+    const Consensus::Params& consensusParams = Params().GetConsensus();
+
+    while (state.KeepRunning()) {
+        std::vector<unsigned char> vPoWValid(headers.size(), 0);
+        CheckHeadersPoW(headers, consensusParams, vPoWValid, nullptr);
+    }
+}
+
+static void HeaderPoWParallel(benchmark::State& state)
+{
+    const std::vector<CBlockHeader> headers = MakeMinotaurXHeaderChain();
+    const Consensus::Params& consensusParams = Params().GetConsensus();
+
+    CCheckQueue<CHeaderPoWCheck> queue(8);
+    boost::thread_group tg;
+    for (int i = 0; i < std::max(MIN_CORES, GetNumCores()) - 1; i++)
+        tg.create_thread([&]{queue.Thread();});
+
+    while (state.KeepRunning()) {
+        std::vector<unsigned char> vPoWValid(headers.size(), 0);
+        CheckHeadersPoW(headers, consensusParams, vPoWValid, &queue);
+    }
+    tg.interrupt_all();
+    tg.join_all();
+}
+
+BENCHMARK(HeaderPoWSerial, 10);
+BENCHMARK(HeaderPoWParallel, 10);
@@ -0,0 +1,179 @@
+// Copyright (c) 2026 The PlexHive Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <bench/bench.h>
+
+#include <chainparams.h>
+#include <consensus/merkle.h>
+#include <consensus/validation.h>
+#include <fs.h>
+#include <key.h>
+#include <keystore.h>
+#include <miner.h>
+#include <pow.h>
+#include <random.h>
+#include <scheduler.h>
+#include <script/sigcache.h>
+#include <script/sign.h>
+#include <script/standard.h>
+#include <txdb.h>
+#include <txmempool.h>
+#include <util.h>
+#include <validation.h>
+#include <validationinterface.h>
+
+#include <assert.h>
+
+#include <boost/thread.hpp>
+
+// A flood of transactions accepted to an empty mempool with
+// AcceptToMemoryPoolMany, against the threads checking them. Each iteration
+// accepts MEMPOOL_FLOOD_TXS signed spends, alternately P2PKH and P2WPKH, of
+// the outputs of a confirmed fanout, so the accepted tx/s is
+// MEMPOOL_FLOOD_TXS over the time taken per iteration. The signature cache
+// is kept to its smallest so that every iteration verifies every signature.
+
+static const size_t MEMPOOL_FLOOD_TXS = 2000;
+
+class MempoolFloodFixture
+{
+public:
+    fs::path pathTemp;
+    CScheduler scheduler;
+    boost::thread threadScheduler;
+    boost::thread_group threadGroup;
+    std::vector<CTransactionRef> vFlood;
+
+    explicit MempoolFloodFixture(int nThreads)
+    {
+        SelectParams(CBaseChainParams::REGTEST);
+        const CChainParams& chainparams = Params();
+        gArgs.ForceSetArg("-maxsigcachesize", "0");
+        InitSignatureCache();
+        InitScriptExecutionCache();
+
+        ClearDatadirCache();
+        pathTemp = fs::temp_directory_path() / strprintf("bench_plexhive_%lu_%i", (unsigned long)GetTime(), (int)GetRand(100000));
+        fs::create_directories(pathTemp);
+        gArgs.ForceSetArg("-datadir", pathTemp.string());
+
+        // Block connection queues callbacks, so something has to run them
+        threadScheduler = boost::thread(boost::bind(&CScheduler::serviceQueue, &scheduler));
+        GetMainSignals().RegisterBackgroundSignalScheduler(scheduler);
+
+        pblocktree.reset(new CBlockTreeDB(1 << 20, true));
+        pcoinsdbview.reset(new CCoinsViewDB(1 << 23, true));
+        pcoinsTip.reset(new CCoinsViewCache(pcoinsdbview.get()));
+        bool ret = LoadGenesisBlock(chainparams);
+        assert(ret);
+        CValidationState state;
+        ret = ActivateBestChain(state, chainparams);
+        assert(ret);
+
+        // Mature a coinbase, then confirm a transaction fanning it out to the keyed outputs the flood spends
+        CKey key;
+        key.MakeNewKey(true);
+        CBasicKeyStore keystore;
+        keystore.AddKey(key);
+        const CScript scriptP2PKH = GetScriptForDestination(key.GetPubKey().GetID());
+        const CScript scriptP2WPKH = GetScriptForDestination(WitnessV0KeyHash(key.GetPubKey().GetID()));
+
+        CTransactionRef coinbase = Mine();
+        for (int i = 0; i < COINBASE_MATURITY; i++)
+            Mine();
+        CMutableTransaction fanout;
+        fanout.vin.resize(1);
+        fanout.vin[0].prevout = COutPoint(coinbase->GetHash(), 0);
+        fanout.vout.resize(MEMPOOL_FLOOD_TXS);
+        for (size_t i = 0; i < MEMPOOL_FLOOD_TXS; i++) {
+            fanout.vout[i].nValue = (coinbase->vout[0].nValue - COIN) / MEMPOOL_FLOOD_TXS;
+            fanout.vout[i].scriptPubKey = i % 2 ? scriptP2WPKH : scriptP2PKH;
+        }
+        CTransactionRef fanoutRef = MakeTransactionRef(fanout);
+        {
+            LOCK2(cs_main, mempool.cs);
+            mempool.addUnchecked(fanoutRef->GetHash(), CTxMemPoolEntry(fanoutRef, COIN, 0, chainActive.Height(), true, 4, LockPoints()));
+        }
+        Mine();
+        assert(mempool.size() == 0);
+
+        for (size_t i = 0; i < MEMPOOL_FLOOD_TXS; i++) {
+            CMutableTransaction tx;
+            tx.vin.resize(1);
+            tx.vin[0].prevout = COutPoint(fanoutRef->GetHash(), i);
+            tx.vout.resize(1);
+            tx.vout[0].nValue = fanout.vout[i].nValue - 1000;
+            tx.vout[0].scriptPubKey = scriptP2PKH;
+            ret = SignSignature(keystore, fanout.vout[i].scriptPubKey, tx, 0, fanout.vout[i].nValue, SIGHASH_ALL | SIGHASH_FORKID);    // PlexHive: Replay attack protection
+            assert(ret);
+            vFlood.push_back(MakeTransactionRef(tx));
+        }
+
+        // The calling thread checks too, as it does for blocks
+        nScriptCheckThreads = nThreads > 1 ? nThreads : 0;
+        for (int i = 0; i < nThreads - 1; i++)
+            threadGroup.create_thread(&ThreadTxAcceptCheck);
+    }
+
+    ~MempoolFloodFixture()
+    {
+        threadGroup.interrupt_all();
+        threadGroup.join_all();
+        nScriptCheckThreads = 0;
+        threadScheduler.interrupt();
+        threadScheduler.join();
+        GetMainSignals().FlushBackgroundCallbacks();
+        GetMainSignals().UnregisterBackgroundSignalScheduler();
+        mempool.clear();
+        UnloadBlockIndex();
+        pcoinsTip.reset();
+        pcoinsdbview.reset();
+        pblocktree.reset();
+        fs::remove_all(pathTemp);
+        gArgs.ForceSetArg("-maxsigcachesize", strprintf("%d", DEFAULT_MAX_SIG_CACHE_SIZE));
+    }
+
+    // Mine a block of what's in the mempool, returning its coinbase
+    CTransactionRef Mine()
+    {
+        const CChainParams& chainparams = Params();
+        std::unique_ptr<CBlockTemplate> pblocktemplate = BlockAssembler(chainparams).CreateNewBlock(CScript() << OP_TRUE);
+        CBlock& block = pblocktemplate->block;
+        block.hashMerkleRoot = BlockMerkleRoot(block);
+        while (!CheckProofOfWork(block.GetPoWHash(), block.nBits, chainparams.GetConsensus()))
+            ++block.nNonce;
+        bool ret = ProcessNewBlock(chainparams, std::make_shared<const CBlock>(block), true, nullptr);
+        assert(ret);
+        return block.vtx[0];
+    }
+
+    void Flood()
+    {
+        mempool.clear();
+        std::vector<CTxToAccept> vTxs;
+        vTxs.reserve(vFlood.size());
+        int64_t nNow = GetTime();
+        for (const CTransactionRef& tx : vFlood)
+            vTxs.emplace_back(tx, nNow);
+        AcceptToMemoryPoolMany(mempool, vTxs, false /* bypass_limits */, 0 /* nAbsurdFee */);
+        assert(mempool.size() == vFlood.size());
+    }
+};
+
+static void MempoolFlood(benchmark::State& state, int nThreads)
+{
+    MempoolFloodFixture fixture(nThreads);
+    while (state.KeepRunning())
+        fixture.Flood();
+}
+
+static void MempoolFlood1Thread(benchmark::State& state) { MempoolFlood(state, 1); }
+static void MempoolFlood2Threads(benchmark::State& state) { MempoolFlood(state, 2); }
+static void MempoolFlood4Threads(benchmark::State& state) { MempoolFlood(state, 4); }
+static void MempoolFlood8Threads(benchmark::State& state) { MempoolFlood(state, 8); }
+
+BENCHMARK(MempoolFlood1Thread, 5);
+BENCHMARK(MempoolFlood2Threads, 5);
+BENCHMARK(MempoolFlood4Threads, 5);
+BENCHMARK(MempoolFlood8Threads, 5);
@@ -6,6 +6,8 @@
 #include <policy/policy.h>
 #include <txmempool.h>
 
+#include <assert.h>
+
 #include <list>
 #include <vector>
 
@@ -112,3 +114,78 @@ static void MempoolEviction(benchmark::State& state)
 }
 
 BENCHMARK(MempoolEviction, 41000);
+
+// Adding and confirming transactions where the ancestor and descendant walks
+// are long. MempoolDeepChain adds a chain of transactions each spending the
+// last, as chains of BCT funding and change transactions do, then removes them
+// for a block in order, so every addition walks all the ancestors and every
+// removal all the descendants. MempoolWideFanout adds a transaction fanning out
+// to many children and one spending all of them, then removes them for a block.
+
+static const int MEMPOOL_STRESS_TXS = 500;
+
+static void MempoolDeepChain(benchmark::State& state)
+{
+    std::vector<CTransactionRef> vChain;
+    uint256 hashPrev;
+    for (int i = 0; i < MEMPOOL_STRESS_TXS; i++) {
+        CMutableTransaction tx;
+        tx.vin.resize(1);
+        tx.vin[0].prevout = COutPoint(hashPrev, 0);
+        tx.vin[0].scriptSig = CScript() << i;
+        tx.vout.resize(1);
+        tx.vout[0].scriptPubKey = CScript() << OP_1 << OP_EQUAL;
+        tx.vout[0].nValue = 10 * COIN;
+        vChain.push_back(MakeTransactionRef(tx));
+        hashPrev = vChain.back()->GetHash();
+    }
+
+    CTxMemPool pool;
+    while (state.KeepRunning()) {
+        for (const CTransactionRef& tx : vChain)
+            AddTx(*tx, 1000LL, pool);
+        pool.removeForBlock(vChain, 1);
+        assert(pool.size() == 0);
+    }
+}
+
+static void MempoolWideFanout(benchmark::State& state)
+{
+    CMutableTransaction fanout;
+    fanout.vin.resize(1);
+    fanout.vin[0].scriptSig = CScript() << OP_1;
+    fanout.vout.resize(MEMPOOL_STRESS_TXS);
+    for (CTxOut& out : fanout.vout) {
+        out.scriptPubKey = CScript() << OP_1 << OP_EQUAL;
+        out.nValue = COIN;
+    }
+    std::vector<CTransactionRef> vTxs{MakeTransactionRef(fanout)};
+
+    CMutableTransaction sweep;
+    sweep.vout.resize(1);
+    sweep.vout[0].scriptPubKey = CScript() << OP_2 << OP_EQUAL;
+    sweep.vout[0].nValue = COIN;
+    for (int i = 0; i < MEMPOOL_STRESS_TXS; i++) {
+        CMutableTransaction tx;
+        tx.vin.resize(1);
+        tx.vin[0].prevout = COutPoint(vTxs[0]->GetHash(), i);
+        tx.vin[0].scriptSig = CScript() << OP_1;
+        tx.vout.resize(1);
+        tx.vout[0].scriptPubKey = CScript() << OP_1 << OP_EQUAL;
+        tx.vout[0].nValue = COIN;
+        vTxs.push_back(MakeTransactionRef(tx));
+        sweep.vin.emplace_back(COutPoint(vTxs.back()->GetHash(), 0));
+    }
+    vTxs.push_back(MakeTransactionRef(sweep));
+
+    CTxMemPool pool;
+    while (state.KeepRunning()) {
+        for (const CTransactionRef& tx : vTxs)
+            AddTx(*tx, 1000LL, pool);
+        pool.removeForBlock(vTxs, 1);
+        assert(pool.size() == 0);
+    }
+}
+
+BENCHMARK(MempoolDeepChain, 10);
+BENCHMARK(MempoolWideFanout, 100);
@@ -0,0 +1,99 @@
+// Copyright (c) 2026 The PlexHive Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <bench/bench.h>
+#include <crypto/common.h>
+#include <crypto/minotaurx/minotaur.h>
+#include <crypto/minotaurx/yespowerarena.h>
+#include <uint256.h>
+
+#include <vector>
+
+// Compares the original Minotaur() against the reusable MinotaurHasher on
+// an 80-byte header, for both classical Minotaur (bee hashes) and MinotaurX
+// (pow hashes).
+
+static void MinotaurLegacy(benchmark::State& state)
+{
+    std::vector<unsigned char> header(80, 0);
+    uint32_t nonce = 0;
+    while (state.KeepRunning()) {
+        WriteLE32(&header[76], nonce++);
+        Minotaur(header.begin(), header.end(), false);
+    }
+}
+
+static void MinotaurReusable(benchmark::State& state)
+{
+    MinotaurHasher hasher;
+    std::vector<unsigned char> header(80, 0);
+    uint32_t nonce = 0;
+    while (state.KeepRunning()) {
+        WriteLE32(&header[76], nonce++);
+        hasher.Hash(header.data(), header.size(), false);
+    }
+}
+
+static void MinotaurXLegacy(benchmark::State& state)
+{
+    std::vector<unsigned char> header(80, 0);
+    uint32_t nonce = 0;
+    while (state.KeepRunning()) {
+        WriteLE32(&header[76], nonce++);
+        Minotaur(header.begin(), header.end(), true);
+    }
+}
+
+static void MinotaurXReusable(benchmark::State& state)
+{
+    MinotaurHasher hasher;
+    std::vector<unsigned char> header(80, 0);
+    uint32_t nonce = 0;
+    while (state.KeepRunning()) {
+        WriteLE32(&header[76], nonce++);
+        hasher.Hash(header.data(), header.size(), true);
+    }
+}
+
+static void MinotaurXArena(benchmark::State& state)
+{
+    MinotaurHasher hasher;
+    YespowerArena arena;
+    std::vector<unsigned char> header(80, 0);
+    uint32_t nonce = 0;
+    while (state.KeepRunning()) {
+        WriteLE32(&header[76], nonce++);
+        hasher.Hash(header.data(), header.size(), true, arena.Get());
+    }
+}
+
+// First MinotaurX hash on a fresh thread: yespower_tls() allocates and faults in its memory during the hash
+static void MinotaurXColdTLS(benchmark::State& state)
+{
+    std::vector<unsigned char> header(80, 0);
+    while (state.KeepRunning()) {
+        yespower_local_t local;
+        yespower_init_local(&local);
+        Minotaur(header.begin(), header.end(), true, &local);
+        yespower_free_local(&local);
+    }
+}
+
+// The same, with the memory provided by a fresh arena
+static void MinotaurXColdArena(benchmark::State& state)
+{
+    std::vector<unsigned char> header(80, 0);
+    while (state.KeepRunning()) {
+        YespowerArena arena;
+        Minotaur(header.begin(), header.end(), true, arena.Get());
+    }
+}
+
+BENCHMARK(MinotaurLegacy, 80 * 1000);
+BENCHMARK(MinotaurReusable, 100 * 1000);
+BENCHMARK(MinotaurXLegacy, 400);
+BENCHMARK(MinotaurXReusable, 400);
+BENCHMARK(MinotaurXArena, 400);
+BENCHMARK(MinotaurXColdTLS, 300);
+BENCHMARK(MinotaurXColdArena, 300);
@@ -0,0 +1,125 @@
+// Copyright (c) 2026 The PlexHive Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <bench/bench.h>
+
+#include <netio.h>
+#include <util.h>
+
+#ifdef USE_EPOLL
+
+#include <assert.h>
+#include <memory>
+#include <vector>
+
+#include <sys/socket.h>
+#include <unistd.h>
+
+// Round trips through the I/O threads serving peer sockets. Each peer is one
+// end of a socketpair, served by a handler that echoes back what it reads;
+// the benchmark writes a message to the other end of each peer pinged and
+// waits for all the replies. NetIoPing* ping every peer each iteration,
+// measuring messages handled as the number of peers grows; NetIoLatency*
+// ping one peer among many, measuring how long a message waits to be read
+// while the others sit idle.
+
+static const size_t MESSAGE_SIZE = 64;
+
+class EchoHandler : public CNetIoHandler
+{
+public:
+    ReadResult SocketReadable(void* conn) override
+    {
+        const int fd = *static_cast<int*>(conn);
+        char buf[4096];
+        ssize_t nBytes;
+        while ((nBytes = recv(fd, buf, sizeof(buf), MSG_DONTWAIT)) > 0) {
+            ssize_t nSent = send(fd, buf, nBytes, MSG_NOSIGNAL | MSG_DONTWAIT);
+            assert(nSent == nBytes);
+        }
+        return READ_DONE;
+    }
+    void SocketWritable(void* conn) override {}
+    void SocketRemoved(void* conn) override {}
+};
+
+class NetIoFixture
+{
+public:
+    EchoHandler handler;
+    CNetIoThreads netio;
+    std::vector<std::unique_ptr<int>> vServed;
+    std::vector<int> vRemote;
+
+    NetIoFixture(size_t nPeers, int nThreads) : netio(handler)
+    {
+        RaiseFileDescriptorLimit(2 * nPeers + 64);
+        bool ret = netio.Start(nThreads);
+        assert(ret);
+        for (size_t i = 0; i < nPeers; i++) {
+            int fds[2];
+            ret = socketpair(AF_UNIX, SOCK_STREAM, 0, fds) == 0;
+            assert(ret);
+            vServed.emplace_back(new int(fds[0]));
+            vRemote.push_back(fds[1]);
+            ret = netio.Add(i, fds[0], vServed.back().get());
+            assert(ret);
+        }
+    }
+
+    ~NetIoFixture()
+    {
+        netio.Stop();
+        for (const std::unique_ptr<int>& fd : vServed)
+            close(*fd);
+        for (int fd : vRemote)
+            close(fd);
+    }
+
+    void Ping(size_t nBegin, size_t nEnd)
+    {
+        char msg[MESSAGE_SIZE] = {};
+        for (size_t i = nBegin; i < nEnd; i++) {
+            ssize_t nSent = send(vRemote[i], msg, sizeof(msg), MSG_NOSIGNAL);
+            assert(nSent == (ssize_t)sizeof(msg));
+        }
+        for (size_t i = nBegin; i < nEnd; i++) {
+            ssize_t nRecv = recv(vRemote[i], msg, sizeof(msg), MSG_WAITALL);
+            assert(nRecv == (ssize_t)sizeof(msg));
+        }
+    }
+};
+
+static void NetIoPing(benchmark::State& state, size_t nPeers)
+{
+    NetIoFixture fixture(nPeers, DEFAULT_NET_THREADS);
+    while (state.KeepRunning())
+        fixture.Ping(0, nPeers);
+}
+
+static void NetIoLatency(benchmark::State& state, size_t nPeers)
+{
+    NetIoFixture fixture(nPeers, DEFAULT_NET_THREADS);
+    size_t nPeer = 0;
+    while (state.KeepRunning()) {
+        fixture.Ping(nPeer, nPeer + 1);
+        nPeer = (nPeer + 1) % nPeers;
+    }
+}
+
+static void NetIoPing100(benchmark::State& state) { NetIoPing(state, 100); }
+static void NetIoPing500(benchmark::State& state) { NetIoPing(state, 500); }
+static void NetIoPing1000(benchmark::State& state) { NetIoPing(state, 1000); }
+static void NetIoLatency100(benchmark::State& state) { NetIoLatency(state, 100); }
+static void NetIoLatency500(benchmark::State& state) { NetIoLatency(state, 500); }
+static void NetIoLatency1000(benchmark::State& state) { NetIoLatency(state, 1000); }
+
+BENCHMARK(NetIoPing100, 1000);
+BENCHMARK(NetIoPing500, 200);
+BENCHMARK(NetIoPing1000, 100);
+BENCHMARK(NetIoLatency100, 50 * 1000);
+BENCHMARK(NetIoLatency500, 50 * 1000);
+BENCHMARK(NetIoLatency1000, 50 * 1000);
+
+#endif // USE_EPOLL
@@ -0,0 +1,93 @@
+// Copyright (c) 2026 The PlexHive Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <blockcache.h>
+
+#include <chain.h>
+#include <memusage.h>
+#include <primitives/block.h>
+#include <serialize.h>
+#include <streams.h>
+#include <validation.h>
+#include <version.h>
+
+CSerializedBlockCache blockServeCache;
+
+size_t CSerializedBlockCache::EntryUsage(const SerializedBlockRef& data)
+{
+    // The block's bytes, the shared_ptr's control block, and the list and map nodes pointing at it
+    return memusage::DynamicUsage(*data) + memusage::MallocUsage(sizeof(std::vector<unsigned char>) + 2 * sizeof(void*)) +
+        memusage::MallocUsage(sizeof(EntryList::value_type) + 2 * sizeof(void*)) +
+        memusage::MallocUsage(sizeof(std::map<Key, EntryList::iterator>::value_type) + 4 * sizeof(void*));
+}
+
+void CSerializedBlockCache::Trim()
+{
+    AssertLockHeld(cs);
+    while (nUsage > nMaxUsage && !entries.empty()) {
+        nUsage -= EntryUsage(entries.back().second);
+        mapEntries.erase(entries.back().first);
+        entries.pop_back();
+    }
+}
+
+void CSerializedBlockCache::SetMaxUsage(size_t nMaxUsageIn)
+{
+    LOCK(cs);
+    nMaxUsage = nMaxUsageIn;
+    Trim();
+}
+
+SerializedBlockRef CSerializedBlockCache::Serialize(const CBlock& block, bool fWitness)
+{
+    std::shared_ptr<std::vector<unsigned char>> data = std::make_shared<std::vector<unsigned char>>();
+    data->reserve(::GetSerializeSize(block, SER_NETWORK, PROTOCOL_VERSION | (fWitness ? 0 : SERIALIZE_TRANSACTION_NO_WITNESS)));
+    CVectorWriter(SER_NETWORK, PROTOCOL_VERSION | (fWitness ? 0 : SERIALIZE_TRANSACTION_NO_WITNESS), *data, 0) << block;
+    return data;
+}
+
+SerializedBlockRef CSerializedBlockCache::Get(const CBlockIndex* pindex, bool fWitness, const Consensus::Params& consensusParams)
+{
+    const Key key(pindex->GetBlockHash(), fWitness);
+    {
+        LOCK(cs);
+        auto it = mapEntries.find(key);
+        if (it != mapEntries.end()) {
+            nHits++;
+            entries.splice(entries.begin(), entries, it->second);
+            return it->second->second;
+        }
+        nMisses++;
+    }
+
+    // Read outside the lock, so a slow disk doesn't hold up hits
+    CBlock block;
+    if (!ReadBlockFromDisk(block, pindex, consensusParams))
+        return nullptr;
+    SerializedBlockRef data = Serialize(block, fWitness);
+
+    LOCK(cs);
+    size_t nEntryUsage = EntryUsage(data);
+    if (nEntryUsage > nMaxUsage || mapEntries.count(key))
+        return data;    // Too big to keep, or another reader got here first
+    entries.emplace_front(key, data);
+    mapEntries.emplace(key, entries.begin());
+    nUsage += nEntryUsage;
+    Trim();
+    return data;
+}
+
+CSerializedBlockCache::Stats CSerializedBlockCache::GetStats() const
+{
+    LOCK(cs);
+    return Stats{nHits, nMisses, entries.size(), nUsage, nMaxUsage};
+}
+
+void CSerializedBlockCache::Clear()
+{
+    LOCK(cs);
+    entries.clear();
+    mapEntries.clear();
+    nUsage = 0;
+}
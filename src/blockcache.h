@@ -0,0 +1,90 @@
+// Copyright (c) 2026 The PlexHive Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_BLOCKCACHE_H
+#define BITCOIN_BLOCKCACHE_H
+
+#include <sync.h>
+#include <uint256.h>
+
+#include <list>
+#include <map>
+#include <memory>
+#include <utility>
+#include <vector>
+
+class CBlock;
+class CBlockIndex;
+namespace Consensus { struct Params; }
+
+/** Default for -blockservecache, in MiB */
+static const unsigned int DEFAULT_BLOCK_SERVE_CACHE = 32;
+
+/** A block serialized with or without witness data, shared between everyone serving it */
+typedef std::shared_ptr<const std::vector<unsigned char>> SerializedBlockRef;
+
+/**
+ * LRU cache of serialized blocks.
+ *
+ * Serving a block to a peer, over REST or through getblock means reading it
+ * from disk, deserializing it, then serializing it again. Peers syncing
+ * from us tend to ask for the same recent blocks, so the serialized bytes
+ * are kept here, keyed by block hash and whether they include witness data,
+ * up to a fixed memory budget. A block's bytes never change once it's
+ * stored, so entries are only ever evicted, never invalidated.
+ */
+class CSerializedBlockCache
+{
+private:
+    typedef std::pair<uint256, bool> Key;  // Block hash, witness serialization
+    typedef std::list<std::pair<Key, SerializedBlockRef>> EntryList;
+
+    mutable CCriticalSection cs;
+    size_t nMaxUsage;
+    size_t nUsage;
+    EntryList entries;  // Most recently used first
+    std::map<Key, EntryList::iterator> mapEntries;
+    uint64_t nHits;
+    uint64_t nMisses;
+
+    static size_t EntryUsage(const SerializedBlockRef& data);
+    void Trim();
+
+public:
+    explicit CSerializedBlockCache(size_t nMaxUsageIn = DEFAULT_BLOCK_SERVE_CACHE << 20) :
+        nMaxUsage(nMaxUsageIn), nUsage(0), nHits(0), nMisses(0) {}
+
+    CSerializedBlockCache(const CSerializedBlockCache&) = delete;
+    CSerializedBlockCache& operator=(const CSerializedBlockCache&) = delete;
+
+    /** Set the memory budget, in bytes; 0 disables caching */
+    void SetMaxUsage(size_t nMaxUsageIn);
+
+    /**
+     * Get the block at pindex, serialized for the network with or without
+     * witness data, reading it from disk if it isn't cached. Returns nullptr
+     * if it couldn't be read.
+     */
+    SerializedBlockRef Get(const CBlockIndex* pindex, bool fWitness, const Consensus::Params& consensusParams);
+
+    /** Serialize block for the network with or without witness data */
+    static SerializedBlockRef Serialize(const CBlock& block, bool fWitness);
+
+    struct Stats
+    {
+        uint64_t nHits;
+        uint64_t nMisses;
+        size_t nEntries;
+        size_t nUsage;
+        size_t nMaxUsage;
+    };
+    Stats GetStats() const;
+
+    /** Drop all entries */
+    void Clear();
+};
+
+extern CSerializedBlockCache blockServeCache;
+
+#endif // BITCOIN_BLOCKCACHE_H
@@ -0,0 +1,162 @@
+// Copyright (c) 2026 The PlexHive Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <blockfilereader.h>
+
+#include <chain.h>
+#include <clientversion.h>
+#include <consensus/consensus.h>
+#include <primitives/block.h>
+#include <streams.h>
+#include <util.h>
+#include <validation.h>
+
+#ifndef WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// Each block is preceded in its file by the network magic and its serialized size
+static const unsigned int BLOCK_RECORD_HEADER_SIZE = 8;
+
+CBlockFileReader blockFileReader;
+
+CMappedBlockFile::~CMappedBlockFile()
+{
+#ifndef WIN32
+    munmap(const_cast<unsigned char*>(pdata), nSize);
+#endif
+}
+
+std::shared_ptr<const CMappedBlockFile> CBlockFileReader::GetMapping(int nFile, size_t nMinSize)
+{
+    LOCK(cs);
+    for (auto it = mappings.begin(); it != mappings.end(); it++) {
+        if ((*it)->nFile != nFile)
+            continue;
+        std::shared_ptr<const CMappedBlockFile> mapping = *it;
+        mappings.erase(it);
+        if (mapping->nSize >= nMinSize) {
+            mappings.push_front(mapping);
+            return mapping;
+        }
+        break;  // The file has grown since it was mapped; map it afresh
+    }
+
+#ifdef WIN32
+    return nullptr;
+#else
+    fs::path path = GetBlockPosFilename(CDiskBlockPos(nFile, 0), "blk");
+    int fd = open(path.string().c_str(), O_RDONLY);
+    if (fd == -1)
+        return nullptr;
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size <= 0 || (size_t)st.st_size < nMinSize) {
+        close(fd);
+        return nullptr;
+    }
+    void* pdata = mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (pdata == MAP_FAILED) {
+        LogPrint(BCLog::BENCH, "%s: Couldn't map %s\n", __func__, path.string());
+        return nullptr;
+    }
+
+    std::shared_ptr<const CMappedBlockFile> mapping = std::make_shared<const CMappedBlockFile>(nFile, (const unsigned char*)pdata, st.st_size);
+    mappings.push_front(mapping);
+    if (mappings.size() > nMaxMappings)
+        mappings.pop_back();
+    return mapping;
+#endif
+}
+
+bool CBlockFileReader::ReadBlock(CBlock& block, const CDiskBlockPos& pos)
+{
+    if (pos.IsNull() || pos.nPos < BLOCK_RECORD_HEADER_SIZE)
+        return false;
+
+    std::shared_ptr<const CMappedBlockFile> mapping = GetMapping(pos.nFile, pos.nPos);
+    if (!mapping)
+        return false;
+
+    unsigned int nBlockSize;
+    CSpanReader header(SER_DISK, CLIENT_VERSION, mapping->pdata + pos.nPos - 4, mapping->pdata + pos.nPos);
+    header >> nBlockSize;
+    if (nBlockSize == 0 || nBlockSize > MAX_BLOCK_SERIALIZED_SIZE)
+        return false;
+
+    if (pos.nPos + (size_t)nBlockSize > mapping->nSize) {
+        mapping = GetMapping(pos.nFile, pos.nPos + (size_t)nBlockSize);
+        if (!mapping)
+            return false;
+    }
+
+    CSpanReader filein(SER_DISK, CLIENT_VERSION, mapping->pdata + pos.nPos, mapping->pdata + pos.nPos + nBlockSize);
+    filein >> block;
+    return true;
+}
+
+void CBlockFileReader::WillNeed(int nFile, size_t nBegin, size_t nEnd)
+{
+#ifndef WIN32
+    std::shared_ptr<const CMappedBlockFile> mapping = GetMapping(nFile, nBegin);
+    if (!mapping || nBegin >= mapping->nSize)
+        return;
+
+    static const size_t nPageSize = sysconf(_SC_PAGESIZE);
+    nBegin -= nBegin % nPageSize;
+    nEnd = std::min(mapping->nSize, nEnd);
+    madvise(const_cast<unsigned char*>(mapping->pdata) + nBegin, nEnd - nBegin, MADV_WILLNEED);
+#endif
+}
+
+void CBlockFileReader::Invalidate(int nFile)
+{
+    LOCK(cs);
+    mappings.remove_if([nFile](const std::shared_ptr<const CMappedBlockFile>& mapping) { return mapping->nFile == nFile; });
+}
+
+void CBlockFileReader::Clear()
+{
+    LOCK(cs);
+    mappings.clear();
+}
+
+void AdviseSequential(FILE* file)
+{
+#ifdef __linux__
+    posix_fadvise(fileno(file), 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+}
+
+bool CSequentialBlockReader::Read(CBlock& block, const CBlockIndex* pindex)
+{
+    CDiskBlockPos pos;
+    {
+        LOCK(cs_main);
+        pos = pindex->GetBlockPos();
+    }
+
+    // Top up the read-ahead once the reader is halfway through what was last requested, or has left it
+    if (nReadAhead > 0 && !pos.IsNull()) {
+        bool fBackwards = pos.nFile == nFile && pos.nPos < nLastPos;
+        bool fOutside = pos.nFile != nFile || pos.nPos < nAdvisedFrom || pos.nPos >= nAdvisedTo;
+        if (fBackwards && (fOutside || pos.nPos < nAdvisedFrom + nReadAhead / 2)) {
+            // Blocks earlier in the file follow; also cover this one, whose end lies past pos
+            nAdvisedFrom = pos.nPos > nReadAhead ? pos.nPos - nReadAhead : 0;
+            nAdvisedTo = (size_t)pos.nPos + MAX_BLOCK_SERIALIZED_SIZE;
+            blockFileReader.WillNeed(pos.nFile, nAdvisedFrom, nAdvisedTo);
+        } else if (!fBackwards && (fOutside || (size_t)pos.nPos + nReadAhead / 2 > nAdvisedTo)) {
+            nAdvisedFrom = pos.nPos;
+            nAdvisedTo = (size_t)pos.nPos + nReadAhead;
+            blockFileReader.WillNeed(pos.nFile, nAdvisedFrom, nAdvisedTo);
+        }
+        nFile = pos.nFile;
+        nLastPos = pos.nPos;
+    }
+
+    return ReadBlockFromDisk(block, pindex, consensusParams);
+}
@@ -0,0 +1,109 @@
+// Copyright (c) 2026 The PlexHive Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_BLOCKFILEREADER_H
+#define BITCOIN_BLOCKFILEREADER_H
+
+#include <sync.h>
+
+#include <cstdio>
+#include <list>
+#include <memory>
+
+class CBlock;
+class CBlockIndex;
+struct CDiskBlockPos;
+namespace Consensus { struct Params; }
+
+/** Block files kept mapped at once */
+static const size_t DEFAULT_BLOCKFILE_MAPPINGS = sizeof(void*) == 4 ? 2 : 8;
+/** Bytes a sequential block reader asks the kernel to read ahead */
+static const size_t DEFAULT_BLOCK_READAHEAD = 16 * 1024 * 1024;
+
+/** A read-only mapping of a whole blk?????.dat file */
+struct CMappedBlockFile
+{
+    int nFile;
+    const unsigned char* pdata;
+    size_t nSize;
+
+    CMappedBlockFile(int nFileIn, const unsigned char* pdataIn, size_t nSizeIn) : nFile(nFileIn), pdata(pdataIn), nSize(nSizeIn) {}
+    ~CMappedBlockFile();
+
+    CMappedBlockFile(const CMappedBlockFile&) = delete;
+    CMappedBlockFile& operator=(const CMappedBlockFile&) = delete;
+};
+
+/**
+ * Memory-mapped block file reader.
+ *
+ * Keeps the most recently read block files mapped, up to a fixed number of
+ * mappings, and deserializes blocks straight out of the mapping, saving the
+ * open/seek/read/close round trip ReadBlockFromDisk otherwise makes per
+ * block. A file still being appended to is remapped when a block lies past
+ * the end of its mapping. Mappings are dropped when a file is pruned or
+ * finalized; readers already holding one keep it alive until they're done.
+ * Where mmap isn't available every read reports failure, and callers fall
+ * back to reading the file.
+ */
+class CBlockFileReader
+{
+private:
+    CCriticalSection cs;
+    const size_t nMaxMappings;
+    std::list<std::shared_ptr<const CMappedBlockFile>> mappings;    // Most recently used first
+
+    /** Get a mapping of nFile covering at least its first nMinSize bytes */
+    std::shared_ptr<const CMappedBlockFile> GetMapping(int nFile, size_t nMinSize);
+
+public:
+    explicit CBlockFileReader(size_t nMaxMappingsIn = DEFAULT_BLOCKFILE_MAPPINGS) : nMaxMappings(nMaxMappingsIn) {}
+
+    CBlockFileReader(const CBlockFileReader&) = delete;
+    CBlockFileReader& operator=(const CBlockFileReader&) = delete;
+
+    /**
+     * Deserialize the block stored at pos. Returns false if its file couldn't
+     * be mapped or doesn't hold a well-formed record there; throws if the
+     * record couldn't be deserialized, in which case ReadBlockFromDisk reads
+     * the file instead.
+     */
+    bool ReadBlock(CBlock& block, const CDiskBlockPos& pos);
+    /** Ask the kernel to start reading bytes nBegin to nEnd of block file nFile into memory */
+    void WillNeed(int nFile, size_t nBegin, size_t nEnd);
+    /** Drop the mapping of nFile, if held, eg because the file is about to be truncated or removed */
+    void Invalidate(int nFile);
+    /** Drop all mappings */
+    void Clear();
+};
+
+extern CBlockFileReader blockFileReader;
+
+/** Ask the kernel to read ahead aggressively on a file that'll be read front to back */
+void AdviseSequential(FILE* file);
+
+/**
+ * Reads consecutive blocks, walking the chain either forwards as rescans do
+ * or backwards as VerifyDB and the bee population window do, keeping the
+ * kernel reading ahead of the blocks in the direction of travel so the scan
+ * waits on the disk rather than on a fault per page.
+ */
+class CSequentialBlockReader
+{
+private:
+    const Consensus::Params& consensusParams;
+    const size_t nReadAhead;
+    int nFile;
+    size_t nLastPos;
+    size_t nAdvisedFrom, nAdvisedTo;    // Range of nFile for which read-ahead has been requested
+
+public:
+    explicit CSequentialBlockReader(const Consensus::Params& consensusParamsIn, size_t nReadAheadIn = DEFAULT_BLOCK_READAHEAD) :
+        consensusParams(consensusParamsIn), nReadAhead(nReadAheadIn), nFile(-1), nLastPos(0), nAdvisedFrom(0), nAdvisedTo(0) {}
+
+    /** Read the block at pindex, as ReadBlockFromDisk does */
+    bool Read(CBlock& block, const CBlockIndex* pindex);
+};
+
+#endif // BITCOIN_BLOCKFILEREADER_H
@@ -0,0 +1,281 @@
+// Copyright (c) 2026 The PlexHive Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <blockprefetch.h>
+
+#include <chain.h>
+#include <util.h>
+#include <utiltime.h>
+#include <validation.h>
+
+#include <algorithm>
+#include <atomic>
+#include <iterator>
+#include <set>
+
+CBlockPrefetcher blockPrefetcher;
+
+struct CBlockPrefetcher::Job
+{
+    const uint256 hash;
+    const CDiskBlockPos pos;
+    CCoinsView* const pcoinsBase;
+    const Consensus::Params& consensusParams;
+    const uint64_t nCoinsGeneration;
+
+    std::atomic<bool> fCancelled;
+    std::atomic<bool> fReadClaimed;
+    std::atomic<size_t> nNextBatch;
+
+    // Set by the read, and only read after it
+    std::unique_ptr<CPrefetchedBlock> result;
+    std::vector<COutPoint> vInputs;
+    std::vector<std::vector<std::pair<COutPoint, Coin>>> vBatchCoins;   // Each written only by the thread that claimed its batch
+
+    // Guarded by the prefetcher's cs
+    bool fRead;
+    bool fFailed;
+    bool fCoinsFailed;
+    size_t nBatchesLeft;
+    int64_t nCoinsStart;
+
+    Job(const CBlockIndex* pindex, CCoinsView* pcoinsBaseIn, const Consensus::Params& consensusParamsIn, uint64_t nCoinsGenerationIn) :
+        hash(pindex->GetBlockHash()), pos(pindex->GetBlockPos()), pcoinsBase(pcoinsBaseIn),
+        consensusParams(consensusParamsIn), nCoinsGeneration(nCoinsGenerationIn), fCancelled(false), fReadClaimed(false), nNextBatch(0),
+        fRead(false), fFailed(false), fCoinsFailed(false), nBatchesLeft(0), nCoinsStart(0) {}
+};
+
+CBlockPrefetcher::CBlockPrefetcher() : nCoinsGeneration(0), nRunning(0), fStop(false) {}
+
+CBlockPrefetcher::~CBlockPrefetcher()
+{
+    Stop();
+}
+
+void CBlockPrefetcher::Start(int nThreads)
+{
+    Stop();
+    WaitableLock lock(cs);
+    fStop = false;
+    for (int i = 0; i < nThreads; i++)
+        threads.emplace_back(&TraceThread<std::function<void()>>, "blkprefetch", std::function<void()>(std::bind(&CBlockPrefetcher::ThreadPrefetch, this)));
+}
+
+void CBlockPrefetcher::Stop()
+{
+    std::vector<std::thread> threadsStopping;
+    {
+        WaitableLock lock(cs);
+        fStop = true;
+        threadsStopping.swap(threads);
+    }
+    condWork.notify_all();
+    for (std::thread& thread : threadsStopping)
+        thread.join();
+    Clear();
+}
+
+bool CBlockPrefetcher::IsRunning() const
+{
+    WaitableLock lock(cs);
+    return !threads.empty();
+}
+
+void CBlockPrefetcher::ThreadPrefetch()
+{
+    WaitableLock lock(cs);
+    while (true) {
+        condWork.wait(lock, [this] { return fStop || !tasks.empty(); });
+        if (fStop)
+            return;
+        std::function<void()> task = std::move(tasks.front());
+        tasks.pop_front();
+        nRunning++;
+        lock.unlock();
+        task();
+        lock.lock();
+        nRunning--;
+        condDone.notify_all();
+    }
+}
+
+void CBlockPrefetcher::ReadJob(const std::shared_ptr<Job>& job)
+{
+    if (job->fCancelled || job->fReadClaimed.exchange(true))
+        return;
+
+    int64_t nStart = GetTimeMicros();
+    std::shared_ptr<CBlock> pblock = std::make_shared<CBlock>();
+    // The proof is left to ConnectBlock, which checks it as the block connects
+    bool fOk = ReadBlockFromDisk(*pblock, job->pos, job->consensusParams, false) && pblock->GetHash() == job->hash;
+    int64_t nRead = GetTimeMicros();
+
+    if (fOk) {
+        job->result.reset(new CPrefetchedBlock());
+        CPrefetchedBlock& result = *job->result;
+        result.txdata.reserve(pblock->vtx.size());
+        for (const CTransactionRef& tx : pblock->vtx)
+            result.txdata.emplace_back(*tx);
+        int64_t nPrecomputed = GetTimeMicros();
+
+        // Outputs of the block's own transactions aren't in any view yet
+        std::set<uint256> setTxids;
+        for (const CTransactionRef& tx : pblock->vtx)
+            setTxids.insert(tx->GetHash());
+        for (const CTransactionRef& tx : pblock->vtx) {
+            if (tx->IsCoinBase())
+                continue;
+            for (const CTxIn& txin : tx->vin) {
+                if (!setTxids.count(txin.prevout.hash))
+                    job->vInputs.push_back(txin.prevout);
+            }
+        }
+        job->vBatchCoins.resize((job->vInputs.size() + BLOCK_PREFETCH_BATCH - 1) / BLOCK_PREFETCH_BATCH);
+
+        result.pblock = std::move(pblock);
+        result.nInputsLooked = job->vInputs.size();
+        result.nReadTime = nRead - nStart;
+        result.nPrecomputeTime = nPrecomputed - nRead;
+        result.nCoinsTime = 0;
+    }
+
+    {
+        WaitableLock lock(cs);
+        job->fRead = true;
+        job->fFailed = !fOk;
+        job->nBatchesLeft = job->vBatchCoins.size();
+        job->nCoinsStart = GetTimeMicros();
+        if (!job->fCancelled) {
+            // Leave one batch to this thread
+            for (size_t i = 1; i < job->nBatchesLeft; i++)
+                tasks.emplace_back([this, job] { LookupBatch(job); });
+            condWork.notify_all();
+        }
+    }
+    condDone.notify_all();
+
+    while (LookupBatch(job)) {}
+}
+
+bool CBlockPrefetcher::LookupBatch(const std::shared_ptr<Job>& job)
+{
+    if (job->fCancelled)
+        return false;
+    const size_t nBatch = job->nNextBatch++;
+    if (nBatch >= job->vBatchCoins.size())
+        return false;
+
+    std::vector<std::pair<COutPoint, Coin>>& coins = job->vBatchCoins[nBatch];
+    const size_t nEnd = std::min(job->vInputs.size(), (nBatch + 1) * BLOCK_PREFETCH_BATCH);
+    bool fOk = true;
+    try {
+        for (size_t i = nBatch * BLOCK_PREFETCH_BATCH; i < nEnd; i++) {
+            Coin coin;
+            if (job->pcoinsBase->GetCoin(job->vInputs[i], coin) && !coin.IsSpent())
+                coins.emplace_back(job->vInputs[i], std::move(coin));
+        }
+    } catch (const std::exception& e) {
+        // Connecting the block will look the coins up again, and handle the error there
+        LogPrint(BCLog::BENCH, "%s: Error looking up inputs of block %s: %s\n", __func__, job->hash.ToString(), e.what());
+        fOk = false;
+    }
+
+    {
+        WaitableLock lock(cs);
+        if (!fOk)
+            job->fCoinsFailed = true;
+        if (--job->nBatchesLeft == 0)
+            job->result->nCoinsTime = GetTimeMicros() - job->nCoinsStart;
+    }
+    condDone.notify_all();
+    return true;
+}
+
+void CBlockPrefetcher::CancelJob(const std::shared_ptr<Job>& job)
+{
+    // Tasks already queued for it find it cancelled and return; any running carry on to no one
+    job->fCancelled = true;
+}
+
+void CBlockPrefetcher::Prefetch(const std::vector<const CBlockIndex*>& vpindex, CCoinsView* pcoinsBase, const Consensus::Params& consensusParams)
+{
+    AssertLockHeld(cs_main);
+    {
+        WaitableLock lock(cs);
+        if (threads.empty())
+            return;
+
+        for (auto it = jobs.begin(); it != jobs.end(); ) {
+            if (std::find(vpindex.begin(), vpindex.end(), it->first) == vpindex.end()) {
+                CancelJob(it->second);
+                it = jobs.erase(it);
+            } else {
+                ++it;
+            }
+        }
+
+        // The first block is about to connect; if it wasn't already being prepared, there's no time to now
+        for (size_t i = 1; i < vpindex.size(); i++) {
+            const CBlockIndex* pindex = vpindex[i];
+            if (jobs.count(pindex) || !(pindex->nStatus & BLOCK_HAVE_DATA))
+                continue;
+            std::shared_ptr<Job> job = std::make_shared<Job>(pindex, pcoinsBase, consensusParams, nCoinsGeneration);
+            jobs.emplace(pindex, job);
+            tasks.emplace_back([this, job] { ReadJob(job); });
+        }
+    }
+    condWork.notify_all();
+}
+
+std::unique_ptr<CPrefetchedBlock> CBlockPrefetcher::Take(const CBlockIndex* pindex)
+{
+    AssertLockHeld(cs_main);
+    WaitableLock lock(cs);
+    auto it = jobs.find(pindex);
+    if (it == jobs.end())
+        return nullptr;
+    std::shared_ptr<Job> job = it->second;
+    jobs.erase(it);
+
+    // Read it here if it's still waiting in line, with the pool still taking the input lookups
+    lock.unlock();
+    ReadJob(job);
+    lock.lock();
+    condDone.wait(lock, [&job] { return job->fRead; });
+    if (job->fFailed)
+        return nullptr;
+
+    lock.unlock();
+    while (LookupBatch(job)) {}
+    lock.lock();
+    condDone.wait(lock, [&job] { return job->nBatchesLeft == 0; });
+
+    std::unique_ptr<CPrefetchedBlock> result = std::move(job->result);
+    if (!job->fCoinsFailed && job->nCoinsGeneration == nCoinsGeneration) {
+        size_t nCoins = 0;
+        for (const auto& coins : job->vBatchCoins)
+            nCoins += coins.size();
+        result->coins.reserve(nCoins);
+        for (auto& coins : job->vBatchCoins)
+            std::move(coins.begin(), coins.end(), std::back_inserter(result->coins));
+    }
+    return result;
+}
+
+void CBlockPrefetcher::CoinsFlushed()
+{
+    WaitableLock lock(cs);
+    nCoinsGeneration++;
+}
+
+void CBlockPrefetcher::Clear()
+{
+    WaitableLock lock(cs);
+    for (const auto& entry : jobs)
+        CancelJob(entry.second);
+    jobs.clear();
+    tasks.clear();
+    // Running tasks may still be reading the views they were given
+    condDone.wait(lock, [this] { return nRunning == 0; });
+}
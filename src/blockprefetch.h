@@ -0,0 +1,123 @@
+// Copyright (c) 2026 The PlexHive Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_BLOCKPREFETCH_H
+#define BITCOIN_BLOCKPREFETCH_H
+
+#include <coins.h>
+#include <primitives/block.h>
+#include <script/interpreter.h>
+#include <sync.h>
+
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <thread>
+#include <utility>
+#include <vector>
+
+class CBlockIndex;
+namespace Consensus { struct Params; }
+
+/** Default for -blockprefetch, the threads preparing blocks ahead of connection */
+static const int DEFAULT_BLOCK_PREFETCH_THREADS = 4;
+static const int MAX_BLOCK_PREFETCH_THREADS = 16;
+/** Blocks after the one connecting that are prepared ahead */
+static const int BLOCK_PREFETCH_DEPTH = 2;
+/** Inputs looked up by one prefetch task */
+static const size_t BLOCK_PREFETCH_BATCH = 128;
+
+/** A block read and prepared for connection ahead of its turn */
+struct CPrefetchedBlock
+{
+    std::shared_ptr<const CBlock> pblock;
+    /** The transactions' signature hash midstates, in block order, as ConnectBlock would compute them */
+    std::vector<PrecomputedTransactionData> txdata;
+    /** Unspent coins the block spends, as the view below the tip cache had them */
+    std::vector<std::pair<COutPoint, Coin>> coins;
+
+    unsigned int nInputsLooked;     // Inputs looked up, ie those not spending outputs of the block itself
+    int64_t nReadTime;              // Microseconds spent reading and checking the block
+    int64_t nPrecomputeTime;        // ... computing txdata
+    int64_t nCoinsTime;             // ... from the start of the input lookups to the end of the last
+};
+
+/**
+ * Prepares the next blocks to be connected while the current one connects.
+ *
+ * ConnectTip otherwise reads a block, then fetches each of its inputs from
+ * the coin database as ConnectBlock misses the cache, one after another and
+ * between queuing script checks. Given the blocks due next, a pool of
+ * threads reads and deserializes each, computes its txdata and looks up its
+ * inputs in the view below the tip cache, spreading the lookups over the
+ * pool. When the block's turn comes, ConnectTip takes the result, puts the
+ * coins found into the tip cache as clean entries where it has none, and
+ * connects the block as it would otherwise.
+ *
+ * The coins looked up are only what a cache miss would read if nothing has
+ * been flushed below the tip cache since the lookups started, as the view
+ * below only changes on a flush; CoinsFlushed() is called as one starts,
+ * and the coins of blocks prefetched before it are dropped. Connection
+ * order, and what's checked and how, are unchanged.
+ *
+ * Prefetch(), Take() and CoinsFlushed() are called under cs_main.
+ */
+class CBlockPrefetcher
+{
+private:
+    struct Job;
+
+    mutable CWaitableCriticalSection cs;
+    CConditionVariable condWork;    // Signalled when tasks are queued, or to stop
+    CConditionVariable condDone;    // Signalled when a job's stage finishes
+    std::deque<std::function<void()>> tasks;
+    std::map<const CBlockIndex*, std::shared_ptr<Job>> jobs;
+    uint64_t nCoinsGeneration;
+    int nRunning;                   // Tasks running on worker threads
+    bool fStop;
+    std::vector<std::thread> threads;
+
+    void ThreadPrefetch();
+    void ReadJob(const std::shared_ptr<Job>& job);
+    /** Look up the next batch of the job's inputs not yet claimed, returning false if there were none */
+    bool LookupBatch(const std::shared_ptr<Job>& job);
+    void CancelJob(const std::shared_ptr<Job>& job);
+
+public:
+    CBlockPrefetcher();
+    ~CBlockPrefetcher();
+
+    CBlockPrefetcher(const CBlockPrefetcher&) = delete;
+    CBlockPrefetcher& operator=(const CBlockPrefetcher&) = delete;
+
+    /** Start nThreads worker threads; with none, Prefetch() does nothing */
+    void Start(int nThreads);
+    /** Stop the worker threads, after the tasks they're running */
+    void Stop();
+    bool IsRunning() const;
+
+    /**
+     * Prepare the blocks due to connect next, vpindex[0] being the one about
+     * to, looking up their inputs in pcoinsBase, which must be safe to read
+     * from other threads. vpindex[0] is only kept, not started. Blocks
+     * prepared or being prepared that aren't in vpindex are dropped.
+     */
+    void Prefetch(const std::vector<const CBlockIndex*>& vpindex, CCoinsView* pcoinsBase, const Consensus::Params& consensusParams);
+    /**
+     * Take the prepared block at pindex, waiting for it if it's being
+     * prepared, or preparing it here if that hadn't started, and helping
+     * with the input lookups left. Returns nullptr if it wasn't prefetched
+     * or couldn't be read.
+     */
+    std::unique_ptr<CPrefetchedBlock> Take(const CBlockIndex* pindex);
+    /** The view below the tip cache is about to change */
+    void CoinsFlushed();
+    /** Drop all prefetched blocks */
+    void Clear();
+};
+
+extern CBlockPrefetcher blockPrefetcher;
+
+#endif // BITCOIN_BLOCKPREFETCH_H
@@ -0,0 +1,321 @@
+// Copyright (c) 2026 The PlexHive Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <blocktemplate.h>
+
+#include <chain.h>
+#include <chainparams.h>
+#include <consensus/consensus.h>
+#include <consensus/tx_verify.h>
+#include <miner.h>
+#include <util.h>
+#include <utiltime.h>
+#include <validation.h>
+
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <limits>
+
+#include <boost/bind.hpp>
+
+CBlockTemplateEngine blockTemplateEngine;
+
+CBlockTemplateEngine::CBlockTemplateEngine() : fTipChanged(false), fRunning(false), fStop(false) {}
+
+CBlockTemplateEngine::~CBlockTemplateEngine()
+{
+    Stop();
+}
+
+void CBlockTemplateEngine::Start()
+{
+    Stop();
+    mempool.NotifyEntryAdded.connect(boost::bind(&CBlockTemplateEngine::TransactionAdded, this, _1));
+    mempool.NotifyEntryRemoved.connect(boost::bind(&CBlockTemplateEngine::TransactionRemoved, this, _1, _2));
+    RegisterValidationInterface(this);
+
+    WaitableLock lock(cs);
+    fRunning = true;
+    fStop = false;
+    fTipChanged = true;
+    thread = std::thread(&TraceThread<std::function<void()>>, "tmplengine", std::function<void()>(std::bind(&CBlockTemplateEngine::ThreadRebuild, this)));
+}
+
+void CBlockTemplateEngine::Stop()
+{
+    std::thread threadStopping;
+    {
+        WaitableLock lock(cs);
+        if (!fRunning)
+            return;
+        fStop = true;
+        threadStopping.swap(thread);
+    }
+    condWork.notify_all();
+    if (threadStopping.joinable())
+        threadStopping.join();
+
+    UnregisterValidationInterface(this);
+    mempool.NotifyEntryAdded.disconnect(boost::bind(&CBlockTemplateEngine::TransactionAdded, this, _1));
+    mempool.NotifyEntryRemoved.disconnect(boost::bind(&CBlockTemplateEngine::TransactionRemoved, this, _1, _2));
+
+    LOCK(mempool.cs);
+    WaitableLock lock(cs);
+    fRunning = false;
+    for (Slot& slot : slots) {
+        slot.pindexPrev = nullptr;
+        slot.selection = CTemplateSelection();
+        slot.mapPos.clear();
+        slot.fStale = false;
+    }
+}
+
+bool CBlockTemplateEngine::IsRunning() const
+{
+    WaitableLock lock(cs);
+    return fRunning;
+}
+
+void CBlockTemplateEngine::ThreadRebuild()
+{
+    WaitableLock lock(cs);
+    while (!fStop) {
+        if (!fTipChanged) {
+            // Otherwise wait for the first selection to come due
+            int64_t nDue = std::numeric_limits<int64_t>::max();
+            for (const Slot& slot : slots) {
+                if (slot.pindexPrev)
+                    nDue = std::min(nDue, slot.nBuildTime + (slot.fStale ? BLOCK_TEMPLATE_REBUILD_INTERVAL : BLOCK_TEMPLATE_MAX_AGE));
+            }
+            int64_t nNow = GetTimeMillis();
+            if (nDue == std::numeric_limits<int64_t>::max()) {
+                condWork.wait(lock);
+                continue;
+            }
+            if (nDue > nNow) {
+                condWork.wait_for(lock, std::chrono::milliseconds(nDue - nNow));
+                continue;
+            }
+        }
+        fTipChanged = false;
+        lock.unlock();
+        Rebuild();
+        lock.lock();
+    }
+}
+
+void CBlockTemplateEngine::SetSelection(Slot& slot, const CBlockIndex* pindexPrev, CTemplateSelection&& selection)
+{
+    slot.pindexPrev = pindexPrev;
+    slot.selection = std::move(selection);
+    slot.mapPos.clear();
+    slot.mapPos.reserve(slot.selection.vtx.size());
+    for (size_t i = 0; i < slot.selection.vtx.size(); i++)
+        slot.mapPos.emplace(slot.selection.vtx[i].tx->GetHash(), i);
+    slot.fStale = false;
+    slot.nBuildTime = GetTimeMillis();
+}
+
+void CBlockTemplateEngine::Rebuild()
+{
+    if (!IsRunning())
+        return;
+
+    const CChainParams& chainparams = Params();
+    const Consensus::Params& consensusParams = chainparams.GetConsensus();
+    int64_t nTimeStart = GetTimeMicros();
+
+    LOCK2(cs_main, mempool.cs);
+    const CBlockIndex* pindexPrev = chainActive.Tip();
+    CTemplateSelection selectionPow, selectionHive;
+    bool fPow = false, fHive = false;
+    // Nobody mines on a chain that's still syncing, so there's no need to keep up with it
+    if (pindexPrev && !IsInitialBlockDownload()) {
+        fPow = BlockAssembler(chainparams).CreateSelection(false, selectionPow);
+        if (IsHiveEnabled(pindexPrev, consensusParams)) {
+            // Hive blocks only differ in leaving out BCTs, so without any there's nothing to redo
+            bool fHasBCTs = false;
+            for (const CTemplateTx& entry : selectionPow.vtx) {
+                if (entry.tx->IsBCT(consensusParams, consensusParams.scriptPubKeyBCF)) {
+                    fHasBCTs = true;
+                    break;
+                }
+            }
+            if (fPow && !fHasBCTs) {
+                selectionHive = selectionPow;
+                selectionHive.fIncludeBCTs = false;
+                fHive = true;
+            } else {
+                fHive = BlockAssembler(chainparams).CreateSelection(true, selectionHive);
+            }
+        }
+    }
+    size_t nPowTxs = selectionPow.vtx.size(), nHiveTxs = selectionHive.vtx.size();
+
+    WaitableLock lock(cs);
+    SetSelection(slots[KIND_POW], fPow ? pindexPrev : nullptr, std::move(selectionPow));
+    SetSelection(slots[KIND_HIVE], fHive ? pindexPrev : nullptr, std::move(selectionHive));
+    stats.nBuilds++;
+    stats.nLastBuildMicros = GetTimeMicros() - nTimeStart;
+    LogPrint(BCLog::BENCH, "%s: pow %s (%u txs), hive %s (%u txs) in %.2fms\n", __func__,
+        fPow ? "ready" : "none", nPowTxs, fHive ? "ready" : "none", nHiveTxs, 0.001 * stats.nLastBuildMicros);
+}
+
+void CBlockTemplateEngine::TransactionAdded(CTransactionRef tx)
+{
+    AssertLockHeld(mempool.cs);
+    WaitableLock lock(cs);
+    if (!slots[KIND_POW].pindexPrev && !slots[KIND_HIVE].pindexPrev)
+        return;
+    CTxMemPool::txiter it = mempool.mapTx.find(tx->GetHash());
+    if (it == mempool.mapTx.end())
+        return;
+    const Consensus::Params& consensusParams = Params().GetConsensus();
+    const CTxMemPool::setEntries& parents = mempool.GetMemPoolParents(it);
+
+    bool fNotify = false;
+    for (Slot& slot : slots) {
+        if (!slot.pindexPrev)
+            continue;
+        CTemplateSelection& selection = slot.selection;
+
+        // Nothing to do for transactions package selection would leave out anyway
+        if (it->GetModFeesWithAncestors() < selection.blockMinFeeRate.GetFee(it->GetSizeWithAncestors()))
+            continue;
+        if (!IsFinalTx(*tx, selection.nHeight, selection.nLockTimeCutoff))
+            continue;
+        if (!selection.fIncludeWitness && tx->HasWitness())
+            continue;
+        if (!selection.fIncludeBCTs && tx->IsBCT(consensusParams, consensusParams.scriptPubKeyBCF))
+            continue;
+
+        bool fParentsSelected = true;
+        for (CTxMemPool::txiter parent : parents) {
+            if (!slot.mapPos.count(parent->GetTx().GetHash())) {
+                fParentsSelected = false;
+                break;
+            }
+        }
+        if (fParentsSelected) {
+            // With its parents in, it's a package of its own
+            if (it->GetModifiedFee() < selection.blockMinFeeRate.GetFee(it->GetTxSize()))
+                continue;
+            if (selection.nBlockWeight + WITNESS_SCALE_FACTOR * it->GetTxSize() < selection.nBlockMaxWeight &&
+                    selection.nBlockSigOpsCost + it->GetSigOpCost() < MAX_BLOCK_SIGOPS_COST) {
+                slot.mapPos.emplace(tx->GetHash(), selection.vtx.size());
+                selection.vtx.push_back(CTemplateTx{it->GetSharedTx(), it->GetFee(), it->GetSigOpCost(), (int64_t)it->GetTxWeight()});
+                selection.nBlockWeight += it->GetTxWeight();
+                selection.nBlockSigOpsCost += it->GetSigOpCost();
+                selection.nFees += it->GetFee();
+                stats.nAppended++;
+                continue;
+            }
+        }
+        if (!slot.fStale) {
+            slot.fStale = true;
+            fNotify = true;
+        }
+    }
+    if (fNotify)
+        condWork.notify_all();
+}
+
+void CBlockTemplateEngine::TransactionRemoved(CTransactionRef tx, MemPoolRemovalReason reason)
+{
+    // Transactions are removed for a block as the tip moves on, and the selections are rebuilt anyway
+    if (reason == MemPoolRemovalReason::BLOCK)
+        return;
+
+    AssertLockHeld(mempool.cs);
+    WaitableLock lock(cs);
+    for (Slot& slot : slots) {
+        auto pos = slot.mapPos.find(tx->GetHash());
+        if (pos == slot.mapPos.end())
+            continue;
+        CTemplateSelection& selection = slot.selection;
+        CTemplateTx& entry = selection.vtx[pos->second];
+        selection.nBlockWeight -= entry.nWeight;
+        selection.nBlockSigOpsCost -= entry.nSigOpsCost;
+        selection.nFees -= entry.nFee;
+        entry.tx.reset();
+        slot.mapPos.erase(pos);
+        stats.nRemoved++;
+
+        // Drop the gaps once they're most of the selection
+        if (selection.vtx.size() >= 64 && slot.mapPos.size() * 2 < selection.vtx.size()) {
+            selection.vtx.erase(std::remove_if(selection.vtx.begin(), selection.vtx.end(),
+                [](const CTemplateTx& e) { return !e.tx; }), selection.vtx.end());
+            for (size_t i = 0; i < selection.vtx.size(); i++)
+                slot.mapPos[selection.vtx[i].tx->GetHash()] = i;
+        }
+    }
+}
+
+void CBlockTemplateEngine::UpdatedBlockTip(const CBlockIndex* pindexNew, const CBlockIndex* pindexFork, bool fInitialDownload)
+{
+    {
+        WaitableLock lock(cs);
+        fTipChanged = true;
+    }
+    condWork.notify_all();
+}
+
+bool CBlockTemplateEngine::GetSelection(Kind kind, const CBlockIndex* pindexPrev, bool fIncludeWitness, unsigned int nBlockMaxWeight, const CFeeRate& blockMinFeeRate, CTemplateSelection& selectionOut)
+{
+    AssertLockHeld(cs_main);
+    AssertLockHeld(mempool.cs);
+    WaitableLock lock(cs);
+    const Slot& slot = slots[kind];
+    if (!slot.pindexPrev || slot.pindexPrev != pindexPrev)
+        return false;
+    const CTemplateSelection& selection = slot.selection;
+    if (selection.fIncludeWitness != fIncludeWitness || selection.nBlockMaxWeight != nBlockMaxWeight || selection.blockMinFeeRate != blockMinFeeRate)
+        return false;
+
+    selectionOut.vtx.clear();
+    selectionOut.vtx.reserve(slot.mapPos.size());
+    for (const CTemplateTx& entry : selection.vtx) {
+        if (entry.tx)
+            selectionOut.vtx.push_back(entry);
+    }
+    selectionOut.nBlockWeight = selection.nBlockWeight;
+    selectionOut.nBlockSigOpsCost = selection.nBlockSigOpsCost;
+    selectionOut.nFees = selection.nFees;
+    selectionOut.nHeight = selection.nHeight;
+    selectionOut.nLockTimeCutoff = selection.nLockTimeCutoff;
+    selectionOut.fIncludeWitness = selection.fIncludeWitness;
+    selectionOut.fIncludeBCTs = selection.fIncludeBCTs;
+    selectionOut.nBlockMaxWeight = selection.nBlockMaxWeight;
+    selectionOut.blockMinFeeRate = selection.blockMinFeeRate;
+    stats.nServed++;
+    return true;
+}
+
+bool CBlockTemplateEngine::HasSelection(Kind kind, const CBlockIndex* pindexPrev, bool fIncludeWitness) const
+{
+    WaitableLock lock(cs);
+    const Slot& slot = slots[kind];
+    return slot.pindexPrev && slot.pindexPrev == pindexPrev && slot.selection.fIncludeWitness == fIncludeWitness;
+}
+
+void CBlockTemplateEngine::Discard(Kind kind, const CBlockIndex* pindexPrev)
+{
+    AssertLockHeld(mempool.cs);
+    {
+        WaitableLock lock(cs);
+        Slot& slot = slots[kind];
+        if (!slot.pindexPrev || slot.pindexPrev != pindexPrev)
+            return;
+        SetSelection(slot, nullptr, CTemplateSelection());
+        fTipChanged = true;
+    }
+    condWork.notify_all();
+}
+
+CBlockTemplateEngine::Stats CBlockTemplateEngine::GetStats() const
+{
+    WaitableLock lock(cs);
+    return stats;
+}
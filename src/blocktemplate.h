@@ -0,0 +1,169 @@
+// Copyright (c) 2026 The PlexHive Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_BLOCKTEMPLATE_H
+#define BITCOIN_BLOCKTEMPLATE_H
+
+#include <amount.h>
+#include <policy/feerate.h>
+#include <primitives/transaction.h>
+#include <sync.h>
+#include <txmempool.h>
+#include <validationinterface.h>
+
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+class CBlockIndex;
+
+/** PlexHive: Hive: Mining optimisations: Default for -blocktemplatecache */
+static const bool DEFAULT_BLOCK_TEMPLATE_CACHE = true;
+/** Least time between rebuilds of a selection gone stale, in milliseconds */
+static const int64_t BLOCK_TEMPLATE_REBUILD_INTERVAL = 1000;
+/** Most time a selection's kept without a rebuild, in milliseconds, to pick up fee changes made with prioritisetransaction */
+static const int64_t BLOCK_TEMPLATE_MAX_AGE = 30 * 1000;
+
+/** A transaction in a template selection */
+struct CTemplateTx
+{
+    CTransactionRef tx;     // Null once removed from the selection
+    CAmount nFee;
+    int64_t nSigOpsCost;
+    int64_t nWeight;
+};
+
+/** Transactions selected for a block on a given tip, in block order, and what BlockAssembler selected them under */
+struct CTemplateSelection
+{
+    std::vector<CTemplateTx> vtx;
+    uint64_t nBlockWeight;          // Including what's reserved for the coinbase, as BlockAssembler counts it
+    int64_t nBlockSigOpsCost;       // ...
+    CAmount nFees;
+
+    int nHeight;
+    int64_t nLockTimeCutoff;
+    bool fIncludeWitness;
+    bool fIncludeBCTs;
+    unsigned int nBlockMaxWeight;
+    CFeeRate blockMinFeeRate;
+
+    CTemplateSelection() : nBlockWeight(0), nBlockSigOpsCost(0), nFees(0), nHeight(0), nLockTimeCutoff(0),
+        fIncludeWitness(false), fIncludeBCTs(true), nBlockMaxWeight(0) {}
+};
+
+/**
+ * PlexHive: Hive: Mining optimisations: Keeps a selection of transactions
+ * ready for the next block, so that getblocktemplate, the pow miner and
+ * BusyBees get a template without running package selection over the
+ * whole mempool at the moment they ask.
+ *
+ * Two selections are kept: one for pow blocks, which is the same whatever
+ * the pow type as the algorithm doesn't affect which transactions go in,
+ * and one for Hive blocks, which may not include BCTs. Each is built by
+ * BlockAssembler as CreateNewBlock would, and checked with
+ * TestBlockValidity, on a background thread when the tip changes.
+ *
+ * Between builds, each selection follows the mempool. A transaction
+ * removed from the mempool is removed from it; as the mempool removes a
+ * transaction's descendants with it, what's left stays in a valid order.
+ * A transaction added whose in-mempool parents are all selected, and that
+ * fits, is appended: it was accepted against the same tip. A template made
+ * from the selection is still checked with TestBlockValidity, and one that
+ * fails has its selection discarded and rebuilt. One the selection would have
+ * taken but can't be appended, as it has a parent left out or the block is
+ * full, marks the selection stale, and it's rebuilt at most once every
+ * BLOCK_TEMPLATE_REBUILD_INTERVAL.
+ *
+ * The mempool events come under mempool.cs, and builds are made under
+ * cs_main and mempool.cs, so a selection never misses an event.
+ */
+class CBlockTemplateEngine : public CValidationInterface
+{
+public:
+    enum Kind {
+        KIND_POW,
+        KIND_HIVE,
+        NUM_KINDS
+    };
+
+    struct Stats
+    {
+        uint64_t nBuilds;       // Selections built
+        uint64_t nServed;       // Templates made from a ready selection
+        uint64_t nAppended;     // Transactions appended to a selection
+        uint64_t nRemoved;      // ... removed from one
+        int64_t nLastBuildMicros;
+
+        Stats() : nBuilds(0), nServed(0), nAppended(0), nRemoved(0), nLastBuildMicros(0) {}
+    };
+
+private:
+    struct Slot
+    {
+        const CBlockIndex* pindexPrev;  // Tip the selection's for, or null if there's none
+        CTemplateSelection selection;
+        std::unordered_map<uint256, size_t, SaltedTxidHasher> mapPos;   // Position in selection.vtx of each transaction still selected
+        bool fStale;
+        int64_t nBuildTime;             // In milliseconds
+
+        Slot() : pindexPrev(nullptr), fStale(false), nBuildTime(0) {}
+    };
+
+    mutable CWaitableCriticalSection cs;
+    CConditionVariable condWork;
+    Slot slots[NUM_KINDS];          // Guarded by cs, and only changed under mempool.cs too
+    Stats stats;                    // Guarded by cs
+    bool fTipChanged;               // Guarded by cs
+    bool fRunning;                  // Guarded by cs
+    bool fStop;                     // Guarded by cs
+    std::thread thread;
+
+    void ThreadRebuild();
+    void TransactionAdded(CTransactionRef tx);
+    void TransactionRemoved(CTransactionRef tx, MemPoolRemovalReason reason);
+    static void SetSelection(Slot& slot, const CBlockIndex* pindexPrev, CTemplateSelection&& selection);
+
+protected:
+    void UpdatedBlockTip(const CBlockIndex* pindexNew, const CBlockIndex* pindexFork, bool fInitialDownload) override;
+
+public:
+    CBlockTemplateEngine();
+    ~CBlockTemplateEngine();
+
+    CBlockTemplateEngine(const CBlockTemplateEngine&) = delete;
+    CBlockTemplateEngine& operator=(const CBlockTemplateEngine&) = delete;
+
+    /** Start following the mempool and tip, and building selections */
+    void Start();
+    /** Stop, and drop the selections */
+    void Stop();
+    bool IsRunning() const;
+
+    /** Build both selections on the current tip now, if running */
+    void Rebuild();
+
+    /**
+     * Get the ready selection of kind for a block on pindexPrev, if there's
+     * one selected under the same rules, with the removed transactions
+     * left out. cs_main and mempool.cs must be held.
+     */
+    bool GetSelection(Kind kind, const CBlockIndex* pindexPrev, bool fIncludeWitness, unsigned int nBlockMaxWeight, const CFeeRate& blockMinFeeRate, CTemplateSelection& selectionOut);
+
+    /** Whether there's a ready selection of kind for a block on pindexPrev, with or without witness transactions */
+    bool HasSelection(Kind kind, const CBlockIndex* pindexPrev, bool fIncludeWitness) const;
+
+    /**
+     * Drop the ready selection of kind for a block on pindexPrev, whose block
+     * failed its check, and have the selections rebuilt straight away.
+     * mempool.cs must be held.
+     */
+    void Discard(Kind kind, const CBlockIndex* pindexPrev);
+
+    Stats GetStats() const;
+};
+
+extern CBlockTemplateEngine blockTemplateEngine;
+
+#endif // BITCOIN_BLOCKTEMPLATE_H
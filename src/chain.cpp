@@ -122,6 +122,29 @@ void CBlockIndex::BuildSkip()
         pskip = pprev->GetAncestor(GetSkipHeight(nHeight));
 }
 
+void CBlockIndex::BuildHiveSkip(const Consensus::Params& consensusParams)
+{
+    bool fHive = IsHiveMined(consensusParams);
+    bool fLegacyVersion = nVersion >= 0x20000000;
+    if (!pprev) {
+        pprevHive = pprevPoW = nullptr;
+        for (int i = 0; i < NUM_BLOCK_TYPES; i++)
+            pprevPoWType[i] = nullptr;
+        nHiveRun = fHive ? 1 : 0;
+        nLastLegacyVersionHeight = fLegacyVersion ? nHeight : -1;
+        return;
+    }
+
+    bool fPrevHive = pprev->IsHiveMined(consensusParams);
+    POW_TYPE prevPowType = pprev->GetPoWType();
+    pprevHive = fPrevHive ? pprev : pprev->pprevHive;
+    pprevPoW = fPrevHive ? pprev->pprevPoW : pprev;
+    for (int i = 0; i < NUM_BLOCK_TYPES; i++)
+        pprevPoWType[i] = (!fPrevHive && prevPowType == i) ? pprev : pprev->pprevPoWType[i];
+    nHiveRun = fHive ? pprev->nHiveRun + 1 : 0;
+    nLastLegacyVersionHeight = fLegacyVersion ? nHeight : pprev->nLastLegacyVersionHeight;
+}
+
 // PlexHive: Hive: Grant hive-mined blocks bonus work value - they get the work value of
 // their own block plus that of the PoW block behind them
 arith_uint256 GetBlockProof(const CBlockIndex& block)
@@ -147,11 +170,8 @@ arith_uint256 GetBlockProof(const CBlockIndex& block)
         assert(block.pprev);
 
         // PlexHive: Hive 1.1: Set bnPreviousTarget from nBits in most recent pow block, not just assuming it's one back. Note this logic is still valid for Hive 1.0 so doesn't need to be gated.
-        CBlockIndex* pindexTemp = block.pprev;
-        while (pindexTemp->GetBlockHeader().IsHiveMined(consensusParams)) {
-            assert(pindexTemp->pprev);
-            pindexTemp = pindexTemp->pprev;
-        }
+        const CBlockIndex* pindexTemp = block.pprevPoW;   // PlexHive: Hive: Follow the hive skip link
+        assert(pindexTemp);
 
         arith_uint256 bnPreviousTarget;
         bnPreviousTarget.SetCompact(pindexTemp->nBits, &fNegative, &fOverflow); // PlexHive: Hive 1.1: Set bnPreviousTarget from nBits in most recent pow block, not just assuming it's one back
@@ -183,20 +203,16 @@ arith_uint256 GetBlockProof(const CBlockIndex& block)
             LogPrintf("**** Initial block chainwork = %s\n", bnTargetScaled.ToString());
         }
 
-        // Find last hive block
-        CBlockIndex *currBlock = block.pprev;
-        int blocksSinceHive;
+        // Find last hive block, if it's within maxKPow blocks
+        // PlexHive: Hive: Follow the hive skip link
+        const CBlockIndex *lastHiveBlock = block.pprevHive;
+        int blocksSinceHive = consensusParams.maxKPow;
         double lastHiveDifficulty = 0;
 
-        for (blocksSinceHive = 0; blocksSinceHive < consensusParams.maxKPow; blocksSinceHive++) {
-            if (currBlock->GetBlockHeader().IsHiveMined(consensusParams)) {
-                lastHiveDifficulty = GetDifficulty(currBlock, true);
-                if (verbose) LogPrintf("**** Got last Hive diff = %.12f, at %s\n", lastHiveDifficulty, currBlock->GetBlockHash().ToString());
-                break;
-            }
-
-            assert(currBlock->pprev);
-            currBlock = currBlock->pprev;
+        if (lastHiveBlock && block.pprev->nHeight - lastHiveBlock->nHeight < consensusParams.maxKPow) {
+            blocksSinceHive = block.pprev->nHeight - lastHiveBlock->nHeight;
+            lastHiveDifficulty = GetDifficulty(lastHiveBlock, true);
+            if (verbose) LogPrintf("**** Got last Hive diff = %.12f, at %s\n", lastHiveDifficulty, lastHiveBlock->GetBlockHash().ToString());
         }
 
         if (verbose) LogPrintf("**** Pow blocks since last Hive block = %d\n", blocksSinceHive);
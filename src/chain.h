@@ -220,6 +220,18 @@ public:
     //! (memory only) Maximum nTime in the chain up to and including this block.
     unsigned int nTimeMax;
 
+    //! PlexHive: Hive: (memory only) Hive skip links, set by BuildHiveSkip()
+    //! Nearest hivemined predecessor
+    CBlockIndex* pprevHive;
+    //! Nearest predecessor that isn't hivemined
+    CBlockIndex* pprevPoW;
+    //! Nearest predecessor that isn't hivemined, for each pow type
+    CBlockIndex* pprevPoWType[NUM_BLOCK_TYPES];
+    //! Number of consecutive hivemined blocks ending with this one
+    int nHiveRun;
+    //! Height of the last block up to and including this one with a pre-MinotaurX (>= 0x20000000) version, or -1
+    int nLastLegacyVersionHeight;
+
     void SetNull()
     {
         phashBlock = nullptr;
@@ -236,6 +248,13 @@ public:
         nSequenceId = 0;
         nTimeMax = 0;
 
+        pprevHive = nullptr;
+        pprevPoW = nullptr;
+        for (int i = 0; i < NUM_BLOCK_TYPES; i++)
+            pprevPoWType[i] = nullptr;
+        nHiveRun = 0;
+        nLastLegacyVersionHeight = -1;
+
         nVersion       = 0;
         hashMerkleRoot = uint256();
         nTime          = 0;
@@ -305,6 +324,17 @@ public:
         return (int64_t)nTime;
     }
 
+    // Header checks without building a CBlockHeader
+    bool IsHiveMined(const Consensus::Params& consensusParams) const
+    {
+        return nNonce == consensusParams.hiveNonceMarker;
+    }
+
+    POW_TYPE GetPoWType() const
+    {
+        return (POW_TYPE)((nVersion >> 16) & 0xFF);
+    }
+
     int64_t GetBlockTimeMax() const
     {
         return (int64_t)nTimeMax;
@@ -360,6 +390,9 @@ public:
     //! Build the skiplist pointer for this entry.
     void BuildSkip();
 
+    //! PlexHive: Hive: Build the hive skip links for this entry. pprev's must already be built.
+    void BuildHiveSkip(const Consensus::Params& consensusParams);
+
     //! Efficiently find an ancestor of this block.
     CBlockIndex* GetAncestor(int height);
     const CBlockIndex* GetAncestor(int height) const;
@@ -10,6 +10,7 @@
 #include <util.h>
 #include <utilstrencodings.h>
 #include <base58.h> // PlexHive: Needed for DecodeDestination()
+#include <script/standard.h>
 
 #include <assert.h>
 
@@ -218,6 +219,8 @@ public:
                         //   (the tx=... number in the SetBestChain debug.log lines)
             0.004948320129629319 // * estimated number of transactions per second after that timestamp
         };
+
+        UpdateHiveScripts();
     }
 };
 
@@ -360,6 +363,8 @@ public:
             344,
             0.001
         };
+
+        UpdateHiveScripts();
     }
 };
 
@@ -449,9 +454,17 @@ public:
         base58Prefixes[EXT_SECRET_KEY] = {0x04, 0x35, 0x83, 0x94};
 
         bech32_hrp = "rplh";
+
+        UpdateHiveScripts();
     }
 };
 
+void CChainParams::UpdateHiveScripts()
+{
+    consensus.scriptPubKeyBCF = GetScriptForDestination(DecodeDestination(consensus.beeCreationAddress, *this));
+    consensus.scriptPubKeyCF = GetScriptForDestination(DecodeDestination(consensus.hiveCommunityAddress, *this));
+}
+
 static std::unique_ptr<CChainParams> globalChainParams;
 
 const CChainParams &Params() {
@@ -77,6 +77,9 @@ public:
 protected:
     CChainParams() {}
 
+    // Fill the consensus Hive scripts from their addresses; call once base58Prefixes are set
+    void UpdateHiveScripts();
+
     Consensus::Params consensus;
     CMessageHeader::MessageStartChars pchMessageStart;
     int nDefaultPort;
@@ -59,7 +59,7 @@ struct TortureGarden {
 };
 
 // Get a 64-byte hash for given 64-byte input, using given TortureGarden contexts and given algo index
-uint512 GetHash(uint512 inputHash, TortureGarden *garden, unsigned int algo, yespower_local_t *local) {
+inline uint512 GetHash(uint512 inputHash, TortureGarden *garden, unsigned int algo, yespower_local_t *local) {
     uint512 outputHash;
     switch (algo) {
         case 0:
@@ -159,7 +159,7 @@ uint512 GetHash(uint512 inputHash, TortureGarden *garden, unsigned int algo, yes
 }
 
 // Recursively traverse a given torture garden starting with a given hash and given node within the garden. The hash is overwritten with the final hash.
-uint512 TraverseGarden(TortureGarden *garden, uint512 hash, TortureNode *node, yespower_local_t *local) {
+inline uint512 TraverseGarden(TortureGarden *garden, uint512 hash, TortureNode *node, yespower_local_t *local) {
     uint512 partialHash = GetHash(hash, garden, node->algo, local);
 
 #ifdef MINOTAUR_DEBUG
@@ -179,7 +179,7 @@ uint512 TraverseGarden(TortureGarden *garden, uint512 hash, TortureNode *node, y
 }
 
 // Associate child nodes with a parent node
-void LinkNodes(TortureNode *parent, TortureNode *childLeft, TortureNode *childRight) {
+inline void LinkNodes(TortureNode *parent, TortureNode *childLeft, TortureNode *childRight) {
     parent->childLeft = childLeft;
     parent->childRight = childRight;
 }
@@ -247,4 +247,107 @@ template<typename T> uint256 Minotaur(const T begin, const T end, bool minotaurX
     return uint256(hash);
 }
 
+// Reusable Minotaur hashing state.
+// Minotaur() above rebuilds the garden links and a full set of SPH contexts on every call; the garden's
+// topology never changes though, so here it's a static table, the algos are dispatched through a function
+// table and the garden is walked iteratively. Results are bit-identical to Minotaur().
+
+// Children of each garden node as {even, odd} on the last byte of the node's output hash
+static const unsigned char minotaurGardenChildren[22][2] = {
+    {1, 2}, {3, 4}, {5, 6}, {7, 8}, {9, 10}, {11, 12}, {13, 14},
+    {15, 16}, {15, 16}, {15, 16}, {15, 16},
+    {17, 18}, {17, 18}, {17, 18}, {17, 18},
+    {19, 20}, {19, 20}, {19, 20}, {19, 20},
+    {21, 21}, {21, 21},
+    {0, 0}      // Exit node; no children
+};
+static const unsigned int MINOTAUR_EXIT_NODE = 21;
+
+typedef void (*MinotaurAlgoFn)(TortureGarden *garden, const uint512& input, uint512& output, yespower_local_t *local);
+
+#define MINOTAUR_SPH_ALGO(name, context, sph) \
+    inline void name(TortureGarden *garden, const uint512& input, uint512& output, yespower_local_t *local) { \
+        sph##_init(&garden->context); \
+        sph(&garden->context, static_cast<const void*>(input.begin()), 64); \
+        sph##_close(&garden->context, static_cast<void*>(output.begin())); \
+    }
+
+MINOTAUR_SPH_ALGO(MinotaurAlgoBlake, context_blake, sph_blake512)
+MINOTAUR_SPH_ALGO(MinotaurAlgoBmw, context_bmw, sph_bmw512)
+MINOTAUR_SPH_ALGO(MinotaurAlgoCubehash, context_cubehash, sph_cubehash512)
+MINOTAUR_SPH_ALGO(MinotaurAlgoEcho, context_echo, sph_echo512)
+MINOTAUR_SPH_ALGO(MinotaurAlgoFugue, context_fugue, sph_fugue512)
+MINOTAUR_SPH_ALGO(MinotaurAlgoGroestl, context_groestl, sph_groestl512)
+MINOTAUR_SPH_ALGO(MinotaurAlgoHamsi, context_hamsi, sph_hamsi512)
+MINOTAUR_SPH_ALGO(MinotaurAlgoSha2, context_sha2, sph_sha512)
+MINOTAUR_SPH_ALGO(MinotaurAlgoJh, context_jh, sph_jh512)
+MINOTAUR_SPH_ALGO(MinotaurAlgoKeccak, context_keccak, sph_keccak512)
+MINOTAUR_SPH_ALGO(MinotaurAlgoLuffa, context_luffa, sph_luffa512)
+MINOTAUR_SPH_ALGO(MinotaurAlgoShabal, context_shabal, sph_shabal512)
+MINOTAUR_SPH_ALGO(MinotaurAlgoShavite, context_shavite, sph_shavite512)
+MINOTAUR_SPH_ALGO(MinotaurAlgoSimd, context_simd, sph_simd512)
+MINOTAUR_SPH_ALGO(MinotaurAlgoSkein, context_skein, sph_skein512)
+MINOTAUR_SPH_ALGO(MinotaurAlgoWhirlpool, context_whirlpool, sph_whirlpool)
+
+#undef MINOTAUR_SPH_ALGO
+
+// The CPU-hard gate (MinotaurX only)
+inline void MinotaurAlgoYespower(TortureGarden *garden, const uint512& input, uint512& output, yespower_local_t *local) {
+    if (local == NULL)  // Self-manage storage on current thread
+        yespower_tls(input.begin(), 64, &yespower_params, (yespower_binary_t*)output.begin());
+    else                // Use provided thread-local storage
+        yespower(local, input.begin(), 64, &yespower_params, (yespower_binary_t*)output.begin());
+}
+
+// Algo dispatch table, in the same order as GetHash(). NB: The CPU-hard gate must be entry MINOTAUR_ALGO_COUNT.
+static const MinotaurAlgoFn minotaurAlgos[MINOTAUR_ALGO_COUNT + 1] = {
+    MinotaurAlgoBlake, MinotaurAlgoBmw, MinotaurAlgoCubehash, MinotaurAlgoEcho,
+    MinotaurAlgoFugue, MinotaurAlgoGroestl, MinotaurAlgoHamsi, MinotaurAlgoSha2,
+    MinotaurAlgoJh, MinotaurAlgoKeccak, MinotaurAlgoLuffa, MinotaurAlgoShabal,
+    MinotaurAlgoShavite, MinotaurAlgoSimd, MinotaurAlgoSkein, MinotaurAlgoWhirlpool,
+    MinotaurAlgoYespower
+};
+
+// Minotaur hasher holding its SPH contexts across calls. Not thread-safe; keep one per thread.
+class MinotaurHasher {
+private:
+    TortureGarden garden;   // Only the contexts are used; topology comes from minotaurGardenChildren
+
+public:
+    // Produce a Minotaur 32-byte hash from len bytes of data.
+    // Optionally, use the MinotaurX hardened hash.
+    // Optionally, use provided thread-local memory for yespower.
+    uint256 Hash(const void *data, size_t len, bool minotaurX, yespower_local_t *local = NULL) {
+        // Find initial sha512 hash of the variable length data
+        uint512 hash;
+        static unsigned char empty[1];
+        sph_sha512_init(&garden.context_sha2);
+        sph_sha512(&garden.context_sha2, (len == 0 ? empty : data), len);
+        sph_sha512_close(&garden.context_sha2, static_cast<void*>(hash.begin()));
+
+        // Assign algos to torture net nodes based on initial hash
+        unsigned char algos[MINOTAUR_EXIT_NODE + 1];
+        for (unsigned int i = 0; i <= MINOTAUR_EXIT_NODE; i++)
+            algos[i] = hash.ByteAt(i) % MINOTAUR_ALGO_COUNT;
+
+        // Hardened garden gates on MinotaurX
+        if (minotaurX)
+            algos[MINOTAUR_EXIT_NODE] = MINOTAUR_ALGO_COUNT;
+
+        // Walk the garden; every path passes through 7 nodes and ends at the exit node
+        uint512 partialHash;
+        unsigned int node = 0;
+        while (true) {
+            minotaurAlgos[algos[node]](&garden, hash, partialHash, local);
+            hash = partialHash;
+            if (node == MINOTAUR_EXIT_NODE)
+                break;
+            node = minotaurGardenChildren[node][hash.ByteAt(63) % 2];
+        }
+
+        // Return truncated result
+        return uint256(hash);
+    }
+};
+
 #endif // PLHV_CRYPTO_MINOTAURX_MINOTAUR_H
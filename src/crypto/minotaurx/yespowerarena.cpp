@@ -0,0 +1,119 @@
+// Copyright (c) 2026 The PlexHive Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <crypto/minotaurx/yespowerarena.h>
+
+#include <crypto/minotaurx/minotaur.h>
+
+#include <atomic>
+#include <stdint.h>
+#include <stdlib.h>
+
+// Must match yespower.c, which releases the region with munmap() when MAP_ANON is available and free() otherwise
+#ifdef __unix__
+#include <sys/mman.h>
+#endif
+
+static const size_t ARENA_PAGE_SIZE = 4096;
+static const size_t ARENA_HUGEPAGE_SIZE = 2 * 1024 * 1024;
+
+static std::atomic<size_t> arenaCount(0);
+static std::atomic<size_t> arenaHugePageCount(0);
+static std::atomic<size_t> arenaBytesUsed(0);
+static std::atomic<size_t> arenaBytesPeak(0);
+
+size_t YespowerMemoryNeeded(const yespower_params_t& params)
+{
+    // Mirrors the allocation in yespower(); see Swidth_* and PWXsimple there
+    const size_t B_size = (size_t)128 * params.r;
+    const size_t V_size = B_size * params.N;
+    if (params.version == YESPOWER_0_5)
+        return B_size + V_size + B_size * 2 + 2 * ((1 << 8) * 2 * 8);
+    return B_size + V_size + B_size + 64 + 3 * ((1 << 11) * 2 * 8);
+}
+
+YespowerArena::YespowerArena() : YespowerArena(yespower_params) {}
+
+YespowerArena::YespowerArena(const yespower_params_t& params) : nBytes(0), fHugePages(false)
+{
+    yespower_init_local(&local);
+    const size_t need = YespowerMemoryNeeded(params);
+    uint8_t *base = NULL, *aligned = NULL;
+    size_t baseSize = 0;
+
+#ifdef MAP_ANON
+    int flags = MAP_ANON | MAP_PRIVATE;
+#ifdef MAP_NOCORE
+    flags |= MAP_NOCORE;
+#endif
+#ifdef MAP_HUGETLB
+    // Explicit huge pages, if the admin has reserved any. munmap() needs a whole number of them.
+    baseSize = (need + ARENA_HUGEPAGE_SIZE - 1) & ~(ARENA_HUGEPAGE_SIZE - 1);
+    base = (uint8_t*)mmap(NULL, baseSize, PROT_READ | PROT_WRITE, flags | MAP_HUGETLB, -1, 0);
+    if (base != MAP_FAILED) {
+        aligned = base;
+        fHugePages = true;
+    }
+#endif
+    if (!fHugePages) {
+        // Over-map by one huge page so the working memory can start on a huge page boundary,
+        // giving transparent huge pages a chance to back it
+        baseSize = need + ARENA_HUGEPAGE_SIZE;
+        base = (uint8_t*)mmap(NULL, baseSize, PROT_READ | PROT_WRITE, flags, -1, 0);
+        if (base == MAP_FAILED) {
+            base = NULL;
+        } else {
+            aligned = (uint8_t*)(((uintptr_t)base + ARENA_HUGEPAGE_SIZE - 1) & ~(uintptr_t)(ARENA_HUGEPAGE_SIZE - 1));
+#ifdef MADV_HUGEPAGE
+            fHugePages = madvise(aligned, (need + ARENA_HUGEPAGE_SIZE - 1) & ~(ARENA_HUGEPAGE_SIZE - 1), MADV_HUGEPAGE) == 0;
+#endif
+        }
+    }
+#else
+    baseSize = need + 63;
+    base = (uint8_t*)malloc(baseSize);
+    if (base)
+        aligned = (uint8_t*)(((uintptr_t)base + 63) & ~(uintptr_t)63);
+#endif
+    if (!base)
+        return;     // yespower() will fall back to allocating on first use
+
+    // Pre-fault, so the first hash doesn't pay for it
+    for (size_t i = 0; i < need; i += ARENA_PAGE_SIZE)
+        aligned[i] = 0;
+
+    local.base = base;
+    local.aligned = aligned;
+    local.base_size = baseSize;
+    local.aligned_size = need;
+    nBytes = baseSize;
+
+    arenaCount++;
+    if (fHugePages)
+        arenaHugePageCount++;
+    size_t used = (arenaBytesUsed += nBytes);
+    size_t peak = arenaBytesPeak.load();
+    while (used > peak && !arenaBytesPeak.compare_exchange_weak(peak, used)) {}
+}
+
+YespowerArena::~YespowerArena()
+{
+    if (nBytes) {
+        arenaCount--;
+        if (fHugePages)
+            arenaHugePageCount--;
+        arenaBytesUsed -= nBytes;
+    }
+    yespower_free_local(&local);
+}
+
+YespowerArenaStats GetYespowerArenaStats()
+{
+    YespowerArenaStats stats;
+    stats.arenas = arenaCount.load();
+    stats.hugepage_arenas = arenaHugePageCount.load();
+    stats.used = arenaBytesUsed.load();
+    stats.peak = arenaBytesPeak.load();
+    return stats;
+}
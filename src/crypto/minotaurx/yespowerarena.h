@@ -0,0 +1,62 @@
+// Copyright (c) 2026 The PlexHive Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef PLHV_CRYPTO_MINOTAURX_YESPOWERARENA_H
+#define PLHV_CRYPTO_MINOTAURX_YESPOWERARENA_H
+
+#include <crypto/minotaurx/yespower/yespower.h>
+
+#include <stddef.h>
+
+/**
+ * PlexHive: MinotaurX+Hive1.2: Explicitly-owned yespower working memory.
+ *
+ * yespower_tls() allocates its ~2MiB region lazily on the first hash a thread
+ * computes, faults it in page by page during that hash, and never releases it
+ * when the thread exits. An arena is sized for the given parameters up front,
+ * backed by huge pages where the OS offers them, pre-faulted, and freed on
+ * destruction. Pass Get() to MinotaurHasher::Hash() or
+ * CBlockHeader::GetPoWHash(). Not thread-safe; keep one per thread.
+ */
+class YespowerArena
+{
+private:
+    yespower_local_t local;
+    size_t nBytes;
+    bool fHugePages;
+
+public:
+    /** Allocate enough memory for yespower with the given parameters */
+    explicit YespowerArena(const yespower_params_t& params);
+    /** Allocate enough memory for MinotaurX's yespower gate */
+    YespowerArena();
+    ~YespowerArena();
+
+    YespowerArena(const YespowerArena&) = delete;
+    YespowerArena& operator=(const YespowerArena&) = delete;
+
+    yespower_local_t* Get() { return &local; }
+
+    /** Bytes of working memory held (0 if allocation failed) */
+    size_t Size() const { return nBytes; }
+
+    /** Whether the memory is backed by huge pages (explicit or transparent) */
+    bool UsingHugePages() const { return fHugePages; }
+};
+
+/** Bytes of working memory yespower needs for the given parameters */
+size_t YespowerMemoryNeeded(const yespower_params_t& params);
+
+/** Process-wide arena usage, for getmemoryinfo */
+struct YespowerArenaStats
+{
+    size_t arenas;          // Live arenas
+    size_t hugepage_arenas; // Live arenas backed by huge pages
+    size_t used;            // Bytes currently held by live arenas
+    size_t peak;            // Highest value of used since startup
+};
+
+YespowerArenaStats GetYespowerArenaStats();
+
+#endif // PLHV_CRYPTO_MINOTAURX_YESPOWERARENA_H
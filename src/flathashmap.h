@@ -0,0 +1,333 @@
+// Copyright (c) 2026 The PlexHive Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_FLATHASHMAP_H
+#define BITCOIN_FLATHASHMAP_H
+
+#include <memusage.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/**
+ * Open-addressing hash map.
+ *
+ * Lookups probe a flat array of (hash, pointer) buckets linearly, so a miss
+ * or a hit costs a run of adjacent cache lines rather than a walk down a
+ * bucket's chain of separately allocated nodes, and the key's full hash is
+ * kept alongside so neither probing nor growing the table rehashes a key.
+ *
+ * Values live in nodes handed out from a pool of chunks, so as with
+ * std::unordered_map a reference to a value stays valid until it's erased,
+ * even across inserts that grow the table. Iterators are invalidated by an
+ * insert that grows the table, but not by erasing other elements, so the
+ * usual erase-while-iterating loops work. The memory the map allocates is
+ * counted exactly by DynamicMemoryUsage().
+ *
+ * Pool memory is only given back by clear(); nodes freed by erase are reused
+ * by later inserts.
+ */
+template <typename K, typename T, typename Hash = std::hash<K>>
+class flathashmap
+{
+public:
+    typedef K key_type;
+    typedef T mapped_type;
+    typedef std::pair<const K, T> value_type;
+    typedef size_t size_type;
+
+private:
+    union node {
+        node* next;
+        typename std::aligned_storage<sizeof(value_type), alignof(value_type)>::type storage;
+
+        value_type* get() { return reinterpret_cast<value_type*>(&storage); }
+    };
+
+    struct bucket {
+        value_type* p;  // The value held, or nullptr
+        size_t hash;    // The value's key's hash; where p is nullptr, 0 if the bucket was never used and 1 if erased
+    };
+
+    static const size_t MIN_BUCKETS = 16;
+    static const size_t MIN_CHUNK_NODES = 16;
+    static const size_t MAX_CHUNK_NODES = 4096;
+
+    Hash hasher;
+    std::unique_ptr<bucket[]> buckets;
+    size_t nBuckets;    // 0 or a power of two
+    size_t nSize;
+    size_t nErased;     // Buckets marked erased, which probes have to step over
+
+    std::vector<std::pair<std::unique_ptr<node[]>, size_t>> chunks;
+    node* freeNodes;
+    size_t nChunkUsage;
+
+    static bool IsEmpty(const bucket& b) { return !b.p && b.hash == 0; }
+
+    node* AllocateNode()
+    {
+        if (!freeNodes) {
+            size_t nNodes = chunks.empty() ? MIN_CHUNK_NODES : std::min(chunks.back().second * 2, MAX_CHUNK_NODES);
+            chunks.emplace_back(std::unique_ptr<node[]>(new node[nNodes]), nNodes);
+            nChunkUsage += memusage::MallocUsage(nNodes * sizeof(node));
+            node* chunk = chunks.back().first.get();
+            for (size_t i = 0; i < nNodes; i++) {
+                chunk[i].next = freeNodes;
+                freeNodes = &chunk[i];
+            }
+        }
+        node* n = freeNodes;
+        freeNodes = n->next;
+        return n;
+    }
+
+    void FreeNode(value_type* p)
+    {
+        node* n = reinterpret_cast<node*>(p);
+        n->next = freeNodes;
+        freeNodes = n;
+    }
+
+    /** Make sure one more element fits without probes getting too long, growing or tidying the table if not.
+     *  Returns whether the table was rebuilt, moving every element. */
+    bool ReserveOne()
+    {
+        if ((nSize + nErased + 1) * 4 <= nBuckets * 3)
+            return false;
+        size_t nNewBuckets = std::max(nBuckets, MIN_BUCKETS);
+        while ((nSize + 1) * 2 > nNewBuckets)
+            nNewBuckets *= 2;
+        Rehash(nNewBuckets);
+        return true;
+    }
+
+    void Rehash(size_t nNewBuckets)
+    {
+        std::unique_ptr<bucket[]> newBuckets(new bucket[nNewBuckets]());
+        const size_t mask = nNewBuckets - 1;
+        for (size_t i = 0; i < nBuckets; i++) {
+            if (!buckets[i].p)
+                continue;
+            size_t j = buckets[i].hash & mask;
+            while (newBuckets[j].p)
+                j = (j + 1) & mask;
+            newBuckets[j] = buckets[i];
+        }
+        buckets = std::move(newBuckets);
+        nBuckets = nNewBuckets;
+        nErased = 0;
+    }
+
+    size_t FindIndex(const K& key) const
+    {
+        if (nSize == 0)
+            return nBuckets;
+        const size_t hash = hasher(key);
+        const size_t mask = nBuckets - 1;
+        for (size_t i = hash & mask; !IsEmpty(buckets[i]); i = (i + 1) & mask) {
+            if (buckets[i].p && buckets[i].hash == hash && buckets[i].p->first == key)
+                return i;
+        }
+        return nBuckets;
+    }
+
+    size_t NextIndex(size_t i) const
+    {
+        while (i < nBuckets && !buckets[i].p)
+            i++;
+        return i;
+    }
+
+    template <bool fConst>
+    class iter
+    {
+    private:
+        friend class flathashmap;
+        friend class iter<!fConst>;
+        typedef typename std::conditional<fConst, const flathashmap, flathashmap>::type map_type;
+        map_type* m;
+        size_t i;
+
+        iter(map_type* mIn, size_t iIn) : m(mIn), i(iIn) {}
+
+    public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef typename flathashmap::value_type value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef typename std::conditional<fConst, const value_type*, value_type*>::type pointer;
+        typedef typename std::conditional<fConst, const value_type&, value_type&>::type reference;
+
+        iter() : m(nullptr), i(0) {}
+        template <bool fOtherConst, typename = typename std::enable_if<fConst && !fOtherConst>::type>
+        iter(const iter<fOtherConst>& it) : m(it.m), i(it.i) {}
+
+        reference operator*() const { return *m->buckets[i].p; }
+        pointer operator->() const { return m->buckets[i].p; }
+        iter& operator++() { i = m->NextIndex(i + 1); return *this; }
+        iter operator++(int) { iter copy(*this); ++(*this); return copy; }
+        bool operator==(const iter& other) const { return i == other.i; }
+        bool operator!=(const iter& other) const { return i != other.i; }
+    };
+
+public:
+    typedef iter<false> iterator;
+    typedef iter<true> const_iterator;
+
+    flathashmap() : nBuckets(0), nSize(0), nErased(0), freeNodes(nullptr), nChunkUsage(0) {}
+    ~flathashmap() { clear(); }
+
+    flathashmap(const flathashmap&) = delete;
+    flathashmap& operator=(const flathashmap&) = delete;
+
+    iterator begin() { return iterator(this, NextIndex(0)); }
+    iterator end() { return iterator(this, nBuckets); }
+    const_iterator begin() const { return const_iterator(this, NextIndex(0)); }
+    const_iterator end() const { return const_iterator(this, nBuckets); }
+
+    size_type size() const { return nSize; }
+    bool empty() const { return nSize == 0; }
+
+    iterator find(const K& key) { return iterator(this, FindIndex(key)); }
+    const_iterator find(const K& key) const { return const_iterator(this, FindIndex(key)); }
+    size_type count(const K& key) const { return FindIndex(key) != nBuckets; }
+
+    /** Construct a value from args, and insert it unless its key is already present */
+    template <typename... Args>
+    std::pair<iterator, bool> emplace(Args&&... args)
+    {
+        node* n = AllocateNode();
+        try {
+            ::new (n->get()) value_type(std::forward<Args>(args)...);
+        } catch (...) {
+            FreeNode(n->get());
+            throw;
+        }
+        value_type* p = n->get();
+
+        const size_t hash = hasher(p->first);
+        size_t nInsertAt = nBuckets;
+        size_t i = 0;
+        if (nBuckets > 0) {
+            const size_t mask = nBuckets - 1;
+            for (i = hash & mask; !IsEmpty(buckets[i]); i = (i + 1) & mask) {
+                if (!buckets[i].p) {
+                    if (nInsertAt == nBuckets)
+                        nInsertAt = i;  // Reuse the first erased bucket on the way, once we know the key's absent
+                } else if (buckets[i].hash == hash && buckets[i].p->first == p->first) {
+                    p->~value_type();
+                    FreeNode(p);
+                    return std::make_pair(iterator(this, i), false);
+                }
+            }
+        }
+        if (nInsertAt != nBuckets) {
+            nErased--;
+        } else if (ReserveOne()) {
+            // Only taking an empty bucket can make probes longer. The rebuilt table has no erased buckets,
+            // and the key's known to be absent, so the first free bucket on its probe is the one
+            const size_t mask = nBuckets - 1;
+            for (nInsertAt = hash & mask; buckets[nInsertAt].p; nInsertAt = (nInsertAt + 1) & mask) {}
+        } else {
+            nInsertAt = i;
+        }
+        buckets[nInsertAt].p = p;
+        buckets[nInsertAt].hash = hash;
+        nSize++;
+        return std::make_pair(iterator(this, nInsertAt), true);
+    }
+
+    T& operator[](const K& key)
+    {
+        iterator it = find(key);
+        if (it == end())
+            it = emplace(std::piecewise_construct, std::forward_as_tuple(key), std::tuple<>()).first;
+        return it->second;
+    }
+
+    /** Erase the element at it, returning an iterator to the next one */
+    iterator erase(const_iterator it)
+    {
+        bucket& b = buckets[it.i];
+        b.p->~value_type();
+        FreeNode(b.p);
+        b.p = nullptr;
+        nSize--;
+        const size_t mask = nBuckets - 1;
+        if (IsEmpty(buckets[(it.i + 1) & mask])) {
+            // No probe runs on past here, so neither this bucket nor any erased ones leading up to it need stepping over
+            b.hash = 0;
+            for (size_t j = (it.i - 1) & mask; !buckets[j].p && buckets[j].hash == 1; j = (j - 1) & mask) {
+                buckets[j].hash = 0;
+                nErased--;
+            }
+        } else {
+            b.hash = 1;
+            nErased++;
+        }
+        return iterator(this, NextIndex(it.i + 1));
+    }
+
+    size_type erase(const K& key)
+    {
+        const_iterator it = find(key);
+        if (it == end())
+            return 0;
+        erase(it);
+        return 1;
+    }
+
+    void clear()
+    {
+        for (size_t i = 0; i < nBuckets; i++) {
+            if (buckets[i].p)
+                buckets[i].p->~value_type();
+        }
+        buckets.reset();
+        nBuckets = nSize = nErased = 0;
+        std::vector<std::pair<std::unique_ptr<node[]>, size_t>>().swap(chunks);
+        freeNodes = nullptr;
+        nChunkUsage = 0;
+    }
+
+    /** Exchange contents with other, in constant time */
+    void swap(flathashmap& other)
+    {
+        std::swap(hasher, other.hasher);
+        std::swap(buckets, other.buckets);
+        std::swap(nBuckets, other.nBuckets);
+        std::swap(nSize, other.nSize);
+        std::swap(nErased, other.nErased);
+        std::swap(chunks, other.chunks);
+        std::swap(freeNodes, other.freeNodes);
+        std::swap(nChunkUsage, other.nChunkUsage);
+    }
+
+    /** Heap memory held by the map itself, not counting anything the values own */
+    size_t DynamicMemoryUsage() const
+    {
+        return (nBuckets ? memusage::MallocUsage(nBuckets * sizeof(bucket)) : 0) + nChunkUsage +
+            (chunks.capacity() ? memusage::MallocUsage(chunks.capacity() * sizeof(chunks[0])) : 0);
+    }
+};
+
+namespace memusage
+{
+
+template <typename K, typename T, typename Hash>
+static inline size_t DynamicUsage(const flathashmap<K, T, Hash>& m)
+{
+    return m.DynamicMemoryUsage();
+}
+
+}
+
+#endif // BITCOIN_FLATHASHMAP_H
@@ -76,10 +76,12 @@ private:
     std::deque<std::unique_ptr<WorkItem>> queue;
     bool running;
     size_t maxDepth;
+    size_t peakDepth;
 
 public:
     explicit WorkQueue(size_t _maxDepth) : running(true),
-                                 maxDepth(_maxDepth)
+                                 maxDepth(_maxDepth),
+                                 peakDepth(0)
     {
     }
     /** Precondition: worker threads have all stopped (they have been joined).
@@ -95,6 +97,7 @@ public:
             return false;
         }
         queue.emplace_back(std::unique_ptr<WorkItem>(item));
+        peakDepth = std::max(peakDepth, queue.size());
         cond.notify_one();
         return true;
     }
@@ -115,6 +118,14 @@ public:
             (*i)();
         }
     }
+    /** Items waiting for a worker now, and most that have waited at once */
+    void GetDepth(size_t& depth, size_t& peak, size_t& max)
+    {
+        std::unique_lock<std::mutex> lock(cs);
+        depth = queue.size();
+        peak = peakDepth;
+        max = maxDepth;
+    }
     /** Interrupt and exit loops */
     void Interrupt()
     {
@@ -499,6 +510,14 @@ struct event_base* EventBase()
     return eventBase;
 }
 
+bool GetHTTPWorkQueueDepth(size_t& depth, size_t& peak, size_t& max)
+{
+    if (!workQueue)
+        return false;
+    workQueue->GetDepth(depth, peak, max);
+    return true;
+}
+
 static void httpevent_callback_fn(evutil_socket_t, short, void* data)
 {
     // Static handler: simply call inner handler
@@ -6,6 +6,7 @@
 #define BITCOIN_HTTPSERVER_H
 
 #include <string>
+#include <stddef.h>
 #include <stdint.h>
 #include <functional>
 
@@ -51,6 +52,11 @@ void UnregisterHTTPHandler(const std::string &prefix, bool exactMatch);
  */
 struct event_base* EventBase();
 
+/** Get how many requests wait for a worker now, the most that have waited at once, and the most
+ * that may (-rpcworkqueue). Returns false if the server isn't running.
+ */
+bool GetHTTPWorkQueueDepth(size_t& depth, size_t& peak, size_t& max);
+
 /** In-flight HTTP request.
  * Thin C++ wrapper around evhttp_request.
  */
@@ -11,6 +11,11 @@
 
 #include <addrman.h>
 #include <amount.h>
+#include <bctindex.h>
+#include <blockcache.h>
+#include <blockprefetch.h>
+#include <blocktemplate.h>
+#include <beepopindex.h>
 #include <chain.h>
 #include <chainparams.h>
 #include <checkpoints.h>
@@ -192,6 +197,8 @@ void Shutdown()
     StopREST();
     StopRPC();
     StopHTTPServer();
+    StopPowMiner();     // PlexHive: MinotaurX+Hive1.2
+    blockTemplateEngine.Stop();
 #ifdef ENABLE_WALLET
     FlushWallets();
 #endif
@@ -210,6 +217,9 @@ void Shutdown()
     // CScheduler/checkqueue threadGroup
     threadGroup.interrupt_all();
     threadGroup.join_all();
+    blockPrefetcher.Stop();
+    uiInterface.NotifyBlockTip.disconnect(&RPCPublishTipSnapshot);
+    RPCPublishTipSnapshot(false, nullptr);
 
     if (fDumpMempoolLater && gArgs.GetArg("-persistmempool", DEFAULT_PERSIST_MEMPOOL)) {
         DumpMempool();
@@ -248,14 +258,22 @@ void Shutdown()
             FlushStateToDisk();
         }
         pcoinsTip.reset();
+        pcoinsflusher.reset();
         pcoinscatcher.reset();
         pcoinsdbview.reset();
         pblocktree.reset();
+        pbctIndex.reset();
     }
 #ifdef ENABLE_WALLET
     StopWallets();
 #endif
 
+    // PlexHive: Hive: Close the Hive indexes
+    if (pbeePopIndex) {
+        UnregisterValidationInterface(pbeePopIndex.get());
+        pbeePopIndex.reset();
+    }
+
 #if ENABLE_ZMQ
     if (pzmqNotificationInterface) {
         UnregisterValidationInterface(pzmqNotificationInterface);
@@ -335,6 +353,7 @@ std::string HelpMessage(HelpMessageMode mode)
     strUsage += HelpMessageOpt("-?", _("Print this help message and exit"));
     strUsage += HelpMessageOpt("-version", _("Print version and exit"));
     strUsage += HelpMessageOpt("-alertnotify=<cmd>", _("Execute command when a relevant alert is received or we see a really long fork (%s in cmd is replaced by message)"));
+    strUsage += HelpMessageOpt("-backgroundflush", strprintf(_("Write the coins cache to the database on a background thread, so block connection carries on during the write (default: %u)"), DEFAULT_BACKGROUND_FLUSH));
     strUsage += HelpMessageOpt("-blocknotify=<cmd>", _("Execute command when the best block changes (%s in cmd is replaced by block hash)"));
     if (showDebug)
         strUsage += HelpMessageOpt("-blocksonly", strprintf(_("Whether to operate in a blocks only mode (default: %u)"), DEFAULT_BLOCKSONLY));
@@ -362,6 +381,8 @@ std::string HelpMessage(HelpMessageMode mode)
         strUsage += HelpMessageOpt("-minimumchainwork=<hex>", strprintf("Minimum work assumed to exist on a valid chain in hex (default: %s, testnet: %s)", defaultChainParams->GetConsensus().nMinimumChainWork.GetHex(), testnetChainParams->GetConsensus().nMinimumChainWork.GetHex()));
     }
     strUsage += HelpMessageOpt("-persistmempool", strprintf(_("Whether to save the mempool on shutdown and load on restart (default: %u)"), DEFAULT_PERSIST_MEMPOOL));
+    strUsage += HelpMessageOpt("-blockprefetch=<n>", strprintf(_("Set the number of threads preparing the next blocks to connect while one connects (0 to %d, 0 = off, default: %d)"), MAX_BLOCK_PREFETCH_THREADS, DEFAULT_BLOCK_PREFETCH_THREADS));
+    strUsage += HelpMessageOpt("-blockservecache=<n>", strprintf(_("Keep up to <n> MiB of recently served blocks serialized in memory (default: %u)"), DEFAULT_BLOCK_SERVE_CACHE));
     strUsage += HelpMessageOpt("-blockreconstructionextratxn=<n>", strprintf(_("Extra transactions to keep in memory for compact block reconstructions (default: %u)"), DEFAULT_BLOCK_RECONSTRUCTION_EXTRA_TXN));
     strUsage += HelpMessageOpt("-par=<n>", strprintf(_("Set the number of script verification threads (%u to %d, 0 = auto, <0 = leave that many cores free, default: %d)"),
         -GetNumCores(), MAX_SCRIPTCHECK_THREADS, DEFAULT_SCRIPTCHECK_THREADS));
@@ -376,6 +397,7 @@ std::string HelpMessage(HelpMessageMode mode)
 #ifndef WIN32
     strUsage += HelpMessageOpt("-sysperms", _("Create new files with system default permissions, instead of umask 077 (only effective with disabled wallet functionality)"));
 #endif
+    strUsage += HelpMessageOpt("-bctindex", strprintf(_("Maintain an index of bee creation transactions, so Hive blocks can be validated without reading the blocks holding their BCTs (default: %u)"), DEFAULT_BCTINDEX));
     strUsage += HelpMessageOpt("-txindex", strprintf(_("Maintain a full transaction index, used by the getrawtransaction rpc call (default: %u)"), DEFAULT_TXINDEX));
 
     strUsage += HelpMessageGroup(_("Connection options:"));
@@ -396,6 +418,9 @@ std::string HelpMessage(HelpMessageMode mode)
     strUsage += HelpMessageOpt("-maxreceivebuffer=<n>", strprintf(_("Maximum per-connection receive buffer, <n>*1000 bytes (default: %u)"), DEFAULT_MAXRECEIVEBUFFER));
     strUsage += HelpMessageOpt("-maxsendbuffer=<n>", strprintf(_("Maximum per-connection send buffer, <n>*1000 bytes (default: %u)"), DEFAULT_MAXSENDBUFFER));
     strUsage += HelpMessageOpt("-maxtimeadjustment", strprintf(_("Maximum allowed median peer time offset adjustment. Local perspective of time may be influenced by peers forward or backward by this amount. (default: %u seconds)"), DEFAULT_MAX_TIME_ADJUSTMENT));
+#ifdef USE_EPOLL
+    strUsage += HelpMessageOpt("-netthreads=<n>", strprintf(_("Set the number of threads reading from and writing to peers (1 to %d, default: %d)"), MAX_NET_THREADS, DEFAULT_NET_THREADS));
+#endif
     strUsage += HelpMessageOpt("-onion=<ip:port>", strprintf(_("Use separate SOCKS5 proxy to reach peers via Tor hidden services (default: %s)"), "-proxy"));
     strUsage += HelpMessageOpt("-onlynet=<net>", _("Only connect to nodes in network <net> (ipv4, ipv6 or onion)"));
     strUsage += HelpMessageOpt("-permitbaremultisig", strprintf(_("Relay non-P2SH multisig (default: %u)"), DEFAULT_PERMIT_BAREMULTISIG));
@@ -440,6 +465,7 @@ std::string HelpMessage(HelpMessageMode mode)
         strUsage += HelpMessageOpt("-checkblockindex", strprintf("Do a full consistency check for mapBlockIndex, setBlockIndexCandidates, chainActive and mapBlocksUnlinked occasionally. Also sets -checkmempool (default: %u)", defaultChainParams->DefaultConsistencyChecks()));
         strUsage += HelpMessageOpt("-checkmempool=<n>", strprintf("Run checks every <n> transactions (default: %u)", defaultChainParams->DefaultConsistencyChecks()));
         strUsage += HelpMessageOpt("-checkpoints", strprintf("Disable expensive verification for known chain history (default: %u)", DEFAULT_CHECKPOINTS_ENABLED));
+        strUsage += HelpMessageOpt("-paranoidblockreads", strprintf("Check the PoW or Hive proof of every block read from disk, even ones already validated (default: %u)", DEFAULT_PARANOID_BLOCK_READS));
         strUsage += HelpMessageOpt("-disablesafemode", strprintf("Disable safemode, override a real safe mode event (default: %u)", DEFAULT_DISABLE_SAFEMODE));
         strUsage += HelpMessageOpt("-deprecatedrpc=<method>", "Allows deprecated RPC method(s) to be used");
         strUsage += HelpMessageOpt("-testsafemode", strprintf("Force safe mode (default: %u)", DEFAULT_TESTSAFEMODE));
@@ -496,6 +522,7 @@ std::string HelpMessage(HelpMessageMode mode)
     strUsage += HelpMessageGroup(_("Block creation options:"));
     strUsage += HelpMessageOpt("-blockmaxweight=<n>", strprintf(_("Set maximum BIP141 block weight (default: %d)"), DEFAULT_BLOCK_MAX_WEIGHT));
     strUsage += HelpMessageOpt("-blockmaxsize=<n>", _("Set maximum BIP141 block weight to this * 4. Deprecated, use blockmaxweight"));
+    strUsage += HelpMessageOpt("-blocktemplatecache", strprintf(_("Keep transactions selected for the next block up to date with the mempool, so block templates are ready when asked for (default: %u)"), DEFAULT_BLOCK_TEMPLATE_CACHE));
     strUsage += HelpMessageOpt("-blockmintxfee=<amt>", strprintf(_("Set lowest fee rate (in %s/kB) for transactions to be included in block creation. (default: %s)"), CURRENCY_UNIT, FormatMoney(DEFAULT_BLOCK_MIN_TX_FEE)));
     if (showDebug)
         strUsage += HelpMessageOpt("-blockversion=<n>", "Override block version to test forking scenarios");
@@ -518,8 +545,9 @@ std::string HelpMessage(HelpMessageMode mode)
     }
 
     // PlexHive: Hive: Mining optimisations
-    strUsage += HelpMessageOpt("-hivecheckdelay=<ms>", strprintf(_("Time between Hive checks in ms. This should be left at default unless performance degradation is observed (default: %u)"), DEFAULT_HIVE_CHECK_DELAY));
+    strUsage += HelpMessageOpt("-hivecheckdelay=<ms>", strprintf(_("Delay in ms between a new block arriving and the Hive check starting. This should be left at default unless performance degradation is observed (default: %u)"), DEFAULT_HIVE_CHECK_DELAY));
     strUsage += HelpMessageOpt("-hivecheckthreads=<threads>", strprintf(_("Number of threads to use when checking bees, -1 for all available cores, or -2 for one less than all available cores (default: %u)"), DEFAULT_HIVE_THREADS));
+    strUsage += HelpMessageOpt("-hivechecknice=<n>", strprintf(_("Scheduling niceness (0-19) of bee checking threads; higher values leave more CPU for other programs (default: %u)"), DEFAULT_HIVE_CHECK_NICE));
     strUsage += HelpMessageOpt("-hiveearlyabort", strprintf(_("Abort Hive checking as quickly as possible when a new block comes in. This should be left enabled unless performance degradation is observed. (default: %u)"), DEFAULT_HIVE_EARLY_OUT));
 
     // PlexHive: MinotaurX+Hive1.2: Allow switching of default pow algo via conf / command line, for miners that can't easily adjust their getblocktemplate calls
@@ -929,12 +957,15 @@ bool AppInitParameterInteraction()
     }
 
     // Make sure enough file descriptors are available
-    int nBind = std::max(nUserBind, size_t(1));
     nUserMaxConnections = gArgs.GetArg("-maxconnections", DEFAULT_MAX_PEER_CONNECTIONS);
     nMaxConnections = std::max(nUserMaxConnections, 0);
 
     // Trim requested connection counts, to fit into system limitations
+    // With epoll, sockets aren't limited to FD_SETSIZE; only the descriptor limit below applies
+#ifndef USE_EPOLL
+    int nBind = std::max(nUserBind, size_t(1));
     nMaxConnections = std::max(std::min(nMaxConnections, (int)(FD_SETSIZE - nBind - MIN_CORE_FILEDESCRIPTORS - MAX_ADDNODE_CONNECTIONS)), 0);
+#endif
     nFD = RaiseFileDescriptorLimit(nMaxConnections + MIN_CORE_FILEDESCRIPTORS + MAX_ADDNODE_CONNECTIONS);
     if (nFD < MIN_CORE_FILEDESCRIPTORS)
         return InitError(_("Not enough file descriptors available."));
@@ -997,6 +1028,7 @@ bool AppInitParameterInteraction()
     }
     fCheckBlockIndex = gArgs.GetBoolArg("-checkblockindex", chainparams.DefaultConsistencyChecks());
     fCheckpointsEnabled = gArgs.GetBoolArg("-checkpoints", DEFAULT_CHECKPOINTS_ENABLED);
+    fParanoidBlockReads = gArgs.GetBoolArg("-paranoidblockreads", DEFAULT_PARANOID_BLOCK_READS);
 
     hashAssumeValid = uint256S(gArgs.GetArg("-assumevalid", chainparams.GetConsensus().defaultAssumeValid.GetHex()));
     if (!hashAssumeValid.IsNull())
@@ -1249,13 +1281,24 @@ bool AppInitMain()
 
     InitSignatureCache();
     InitScriptExecutionCache();
+    blockServeCache.SetMaxUsage(std::max<int64_t>(0, gArgs.GetArg("-blockservecache", DEFAULT_BLOCK_SERVE_CACHE)) << 20);
 
     LogPrintf("Using %u threads for script verification\n", nScriptCheckThreads);
     if (nScriptCheckThreads) {
         for (int i=0; i<nScriptCheckThreads-1; i++)
             threadGroup.create_thread(&ThreadScriptCheck);
+        // PlexHive: MinotaurX+Hive1.2: As many again for header proof of work, which is checked while scripts aren't
+        for (int i=0; i<nScriptCheckThreads-1; i++)
+            threadGroup.create_thread(&ThreadHeaderCheck);
+        // And for checking batches of transactions for the mempool
+        for (int i=0; i<nScriptCheckThreads-1; i++)
+            threadGroup.create_thread(&ThreadTxAcceptCheck);
     }
 
+    int nBlockPrefetchThreads = std::max(0, std::min<int>(gArgs.GetArg("-blockprefetch", DEFAULT_BLOCK_PREFETCH_THREADS), MAX_BLOCK_PREFETCH_THREADS));
+    LogPrintf("Using %u threads for block prefetch\n", nBlockPrefetchThreads);
+    blockPrefetcher.Start(nBlockPrefetchThreads);
+
     // Start the lightweight task scheduler thread
     CScheduler::Function serviceLoop = boost::bind(&CScheduler::serviceQueue, &scheduler);
     threadGroup.create_thread(boost::bind(&TraceThread<CScheduler::Function>, "scheduler", serviceLoop));
@@ -1442,12 +1485,19 @@ bool AppInitMain()
             try {
                 UnloadBlockIndex();
                 pcoinsTip.reset();
+                pcoinsflusher.reset();
                 pcoinsdbview.reset();
                 pcoinscatcher.reset();
                 // new CBlockTreeDB tries to delete the existing file, which
                 // fails if it's still open from the previous loop. Close it first:
                 pblocktree.reset();
                 pblocktree.reset(new CBlockTreeDB(nBlockTreeDBCache, false, fReset));
+                // PlexHive: Hive: Close the Hive indexes too; they're reopened below
+                pbctIndex.reset();
+                if (pbeePopIndex) {
+                    UnregisterValidationInterface(pbeePopIndex.get());
+                    pbeePopIndex.reset();
+                }
 
                 if (fReset) {
                     pblocktree->WriteReindexing(true);
@@ -1515,7 +1565,13 @@ bool AppInitMain()
                 }
 
                 // The on-disk coinsdb is now in a good state, create the cache
-                pcoinsTip.reset(new CCoinsViewCache(pcoinscatcher.get()));
+                // Behind it, the layer that writes flushes in the background
+                if (gArgs.GetBoolArg("-backgroundflush", DEFAULT_BACKGROUND_FLUSH)) {
+                    pcoinsflusher.reset(new CCoinsViewBackgroundFlush(pcoinscatcher.get(), pcoinsdbview.get()));
+                    pcoinsTip.reset(new CCoinsViewCache(pcoinsflusher.get()));
+                } else {
+                    pcoinsTip.reset(new CCoinsViewCache(pcoinscatcher.get()));
+                }
 
                 bool is_coinsview_empty = fReset || fReindexChainState || pcoinsTip->GetBestBlock().IsNull();
                 if (!is_coinsview_empty) {
@@ -1549,6 +1605,7 @@ bool AppInitMain()
                         LOCK(cs_main);
                         CBlockIndex* tip = chainActive.Tip();
                         RPCNotifyBlockChange(true, tip);
+                        RPCPublishTipSnapshot(true, tip);
                         if (tip && tip->nTime > GetAdjustedTime() + 2 * 60 * 60) {
                             strLoadError = _("The block database contains a block which appears to be from the future. "
                                     "This may be due to your computer's date and time being set incorrectly. "
@@ -1563,6 +1620,16 @@ bool AppInitMain()
                         break;
                     }
                 }
+
+                // PlexHive: Hive: Open the BCT locator index
+                if (gArgs.GetBoolArg("-bctindex", DEFAULT_BCTINDEX)) {
+                    LOCK(cs_main);
+                    pbctIndex.reset(new CBCTIndex(1 << 20, false, fReindex));
+                }
+
+                // PlexHive: Hive: Open the network bee population index
+                pbeePopIndex.reset(new CBeePopulationIndex(chainparams.GetConsensus(), 1 << 20, false, fReindex));
+                RegisterValidationInterface(pbeePopIndex.get());
             } catch (const std::exception& e) {
                 LogPrintf("%s\n", e.what());
                 strLoadError = _("Error opening block database");
@@ -1657,6 +1724,9 @@ bool AppInitMain()
     if (gArgs.IsArgSet("-blocknotify"))
         uiInterface.NotifyBlockTip.connect(BlockNotifyCallback);
 
+    // Publish each new tip for RPC methods that read it without cs_main
+    uiInterface.NotifyBlockTip.connect(&RPCPublishTipSnapshot);
+
     std::vector<fs::path> vImportFiles;
     for (const std::string& strFile : gArgs.GetArgs("-loadblock")) {
         vImportFiles.push_back(strFile);
@@ -1712,6 +1782,7 @@ bool AppInitMain()
     connOptions.nSendBufferMaxSize = 1000*gArgs.GetArg("-maxsendbuffer", DEFAULT_MAXSENDBUFFER);
     connOptions.nReceiveFloodSize = 1000*gArgs.GetArg("-maxreceivebuffer", DEFAULT_MAXRECEIVEBUFFER);
     connOptions.m_added_nodes = gArgs.GetArgs("-addnode");
+    connOptions.nNetThreads = gArgs.GetArg("-netthreads", DEFAULT_NET_THREADS);
 
     connOptions.nMaxOutboundTimeframe = nMaxOutboundTimeframe;
     connOptions.nMaxOutboundLimit = nMaxOutboundLimit;
@@ -1758,6 +1829,10 @@ bool AppInitMain()
 
     // ********************************************************* Step 12: finished
 
+    // PlexHive: Hive: Mining optimisations: Keep block templates ready for BusyBees, the pow miner and getblocktemplate
+    if (gArgs.GetBoolArg("-blocktemplatecache", DEFAULT_BLOCK_TEMPLATE_CACHE))
+        blockTemplateEngine.Start();
+
     // PlexHive: Hive: Start the mining thread
 #ifdef ENABLE_WALLET
     threadGroup.create_thread(boost::bind(&BeeKeeper, boost::cref(chainparams)));
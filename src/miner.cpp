@@ -6,6 +6,7 @@
 #include <miner.h>
 
 #include <amount.h>
+#include <blocktemplate.h>
 #include <chain.h>
 #include <chainparams.h>
 #include <coins.h>
@@ -37,6 +38,17 @@
 #include <sync.h>           // PlexHive: Hive
 #include <boost/thread.hpp> // PlexHive: Hive: Mining optimisations
 #include <crypto/minotaurx/yespower/yespower.h>  // PlexHive: MinotaurX+Hive1.2
+#include <beehash.h>        // PlexHive: Hive: Mining optimisations
+#include <crypto/sha256.h>                      // PlexHive: MinotaurX+Hive1.2: Pow miner
+#include <crypto/minotaurx/minotaur.h>          // PlexHive: MinotaurX+Hive1.2: Pow miner
+#include <crypto/minotaurx/yespowerarena.h>     // PlexHive: MinotaurX+Hive1.2: Pow miner
+#include <streams.h>                            // PlexHive: MinotaurX+Hive1.2: Pow miner
+#include <boost/bind.hpp>                       // PlexHive: MinotaurX+Hive1.2: Pow miner
+#include <condition_variable>                   // PlexHive: MinotaurX+Hive1.2: Pow miner
+#include <mutex>                                // PlexHive: MinotaurX+Hive1.2: Pow miner
+#include <map>                                  // PlexHive: Hive: Mining optimisations: Hive fast-submit
+#include <set>                                  // PlexHive: Hive: Mining optimisations: Hive fast-submit
+#include <thread>                               // PlexHive: Hive: Mining optimisations: Hive fast-submit
 
 
 static CCriticalSection cs_solution_vars;
@@ -44,6 +56,7 @@ std::atomic<bool> solutionFound;            // PlexHive: Hive: Mining optimisati
 std::atomic<bool> earlyAbort;               // PlexHive: Hive: Mining optimisations: Thread-safe atomic flag to signal early abort needed
 CBeeRange solvingRange;                     // PlexHive: Hive: Mining optimisations: The solving range (protected by mutex)
 uint32_t solvingBee;                        // PlexHive: Hive: Mining optimisations: The solving bee (protected by mutex)
+int64_t solvingTime;                        // PlexHive: Hive: Mining optimisations: When it was found, in micros (protected by mutex)
 
 //////////////////////////////////////////////////////////////////////////////
 //
@@ -82,7 +95,7 @@ BlockAssembler::Options::Options() {
     nBlockMaxWeight = DEFAULT_BLOCK_MAX_WEIGHT;
 }
 
-BlockAssembler::BlockAssembler(const CChainParams& params, const Options& options) : chainparams(params)
+BlockAssembler::BlockAssembler(const CChainParams& params, const Options& options) : chainparams(params), fCreatingSelection(false), fSelectionForHive(false), pselectionIn(nullptr)
 {
     blockMinFeeRate = options.blockMinFeeRate;
     // Limit weight to between 4K and MAX_BLOCK_WEIGHT-4K for sanity:
@@ -191,15 +204,31 @@ std::unique_ptr<CBlockTemplate> BlockAssembler::CreateNewBlock(const CScript& sc
     int nPackagesSelected = 0;
     int nDescendantsUpdated = 0;
     // PlexHive: Don't include BCTs in hivemined blocks
-    if (hiveProofScript)
+    if (hiveProofScript || fSelectionForHive)
         fIncludeBCTs = false;
 
-    addPackageTxs(nPackagesSelected, nDescendantsUpdated);
+    // PlexHive: Hive: Mining optimisations: Take blockTemplateEngine's selection for this tip where it has one ready.
+    // The block's still checked below, as what's been appended to the selection since it was built hasn't been
+    const CBlockTemplateEngine::Kind kind = hiveProofScript ? CBlockTemplateEngine::KIND_HIVE : CBlockTemplateEngine::KIND_POW;
+    bool fFromReadySelection = false;
+    if (pselectionIn) {
+        AddSelection(*pselectionIn);
+    } else if (!fCreatingSelection) {
+        CTemplateSelection selection;
+        if (blockTemplateEngine.GetSelection(kind, pindexPrev, fIncludeWitness, nBlockMaxWeight, blockMinFeeRate, selection)) {
+            AddSelection(selection);
+            fFromReadySelection = true;
+        }
+    }
+    if (!pselectionIn && !fFromReadySelection)
+        addPackageTxs(nPackagesSelected, nDescendantsUpdated);
 
     int64_t nTime1 = GetTimeMicros();
 
-    nLastBlockTx = nBlockTx;
-    nLastBlockWeight = nBlockWeight;
+    if (!fCreatingSelection) {
+        nLastBlockTx = nBlockTx;
+        nLastBlockWeight = nBlockWeight;
+    }
 
     // PlexHive: Hive: Create appropriate coinbase tx for pow or Hive block
     if (hiveProofScript) {
@@ -272,18 +301,134 @@ std::unique_ptr<CBlockTemplate> BlockAssembler::CreateNewBlock(const CScript& sc
     pblock->nNonce = hiveProofScript ? chainparams.GetConsensus().hiveNonceMarker : 0;
     pblocktemplate->vTxSigOpsCost[0] = WITNESS_SCALE_FACTOR * GetLegacySigOpCount(*pblock->vtx[0]);
 
+    // PlexHive: Hive: Mining optimisations: A Hive skeleton's scripts are placeholders, so it can't be checked here;
+    // CreateHiveSkeleton checked the selection it's made from
+    if (pselectionIn && !fCreatingSelection)
+        return std::move(pblocktemplate);
+
     CValidationState state;
     if (!TestBlockValidity(state, chainparams, *pblock, pindexPrev, false, false)) {
+        // PlexHive: Hive: Mining optimisations: Drop a ready selection that's gone bad, and select afresh
+        if (fFromReadySelection) {
+            LogPrintf("%s: Ready selection failed TestBlockValidity, selecting afresh: %s\n", __func__, FormatStateMessage(state));
+            blockTemplateEngine.Discard(kind, pindexPrev);
+            return CreateNewBlock(scriptPubKeyIn, fMineWitnessTx, hiveProofScript, powType);
+        }
         throw std::runtime_error(strprintf("%s: TestBlockValidity failed: %s", __func__, FormatStateMessage(state)));
     }
 
     int64_t nTime2 = GetTimeMicros();
 
+    if (fFromReadySelection) {
+        LogPrint(BCLog::BENCH, "CreateNewBlock() from ready selection: %.2fms (%u txs), validity: %.2fms (total %.2fms)\n", 0.001 * (nTime1 - nTimeStart), nBlockTx, 0.001 * (nTime2 - nTime1), 0.001 * (nTime2 - nTimeStart));
+        return std::move(pblocktemplate);
+    }
+
     LogPrint(BCLog::BENCH, "CreateNewBlock() packages: %.2fms (%d packages, %d updated descendants), validity: %.2fms (total %.2fms)\n", 0.001 * (nTime1 - nTimeStart), nPackagesSelected, nDescendantsUpdated, 0.001 * (nTime2 - nTime1), 0.001 * (nTime2 - nTimeStart));
 
     return std::move(pblocktemplate);
 }
 
+// PlexHive: Hive: Mining optimisations: The selection's checked in a sha256d pow block paying to anyone, so
+// there's no Hive proof needed; the transactions are valid in any block on the same tip whatever its coinbase
+bool BlockAssembler::CreateSelection(bool fHive, CTemplateSelection& selection)
+{
+    AssertLockHeld(cs_main);
+    AssertLockHeld(mempool.cs);
+
+    fCreatingSelection = true;
+    fSelectionForHive = fHive;
+    std::unique_ptr<CBlockTemplate> pblocktemplateSelected;
+    try {
+        pblocktemplateSelected = CreateNewBlock(CScript() << OP_TRUE, true, nullptr, POW_TYPE_SHA256);
+    } catch (const std::runtime_error& e) {
+        LogPrintf("%s: Couldn't create %s block: %s\n", __func__, fHive ? "Hive" : "pow", e.what());
+    }
+    fCreatingSelection = false;
+    fSelectionForHive = false;
+    if (!pblocktemplateSelected)
+        return false;
+
+    const CBlock& block = pblocktemplateSelected->block;
+    selection.vtx.clear();
+    selection.vtx.reserve(block.vtx.size() - 1);
+    for (size_t i = 1; i < block.vtx.size(); i++)
+        selection.vtx.push_back(CTemplateTx{block.vtx[i], pblocktemplateSelected->vTxFees[i], pblocktemplateSelected->vTxSigOpsCost[i], GetTransactionWeight(*block.vtx[i])});
+    selection.nBlockWeight = nBlockWeight;
+    selection.nBlockSigOpsCost = nBlockSigOpsCost;
+    selection.nFees = nFees;
+    selection.nHeight = nHeight;
+    selection.nLockTimeCutoff = nLockTimeCutoff;
+    selection.fIncludeWitness = fIncludeWitness;
+    selection.fIncludeBCTs = fIncludeBCTs;
+    selection.nBlockMaxWeight = nBlockMaxWeight;
+    selection.blockMinFeeRate = blockMinFeeRate;
+    return true;
+}
+
+// PlexHive: Hive: Mining optimisations: Checked in the same block CreateSelection checks a selection it makes in
+bool BlockAssembler::CheckSelection(bool fHive, const CTemplateSelection& selection)
+{
+    AssertLockHeld(cs_main);
+    AssertLockHeld(mempool.cs);
+
+    fCreatingSelection = true;
+    fSelectionForHive = fHive;
+    pselectionIn = &selection;
+    bool fValid = false;
+    try {
+        fValid = CreateNewBlock(CScript() << OP_TRUE, true, nullptr, POW_TYPE_SHA256) != nullptr;
+    } catch (const std::runtime_error& e) {
+        LogPrintf("%s: Ready %s selection isn't valid: %s\n", __func__, fHive ? "Hive" : "pow", e.what());
+    }
+    pselectionIn = nullptr;
+    fCreatingSelection = false;
+    fSelectionForHive = false;
+    return fValid;
+}
+
+// PlexHive: Hive: Mining optimisations: blockTemplateEngine's Hive selection is taken if it's ready and still valid, as
+// CreateNewBlock would
+std::unique_ptr<CBlockTemplate> BlockAssembler::CreateHiveSkeleton(const CScript& honeyScript, const CScript& hiveProofScript)
+{
+    AssertLockHeld(cs_main);
+    AssertLockHeld(mempool.cs);
+
+    const CBlockIndex* pindexPrev = chainActive.Tip();
+    CTemplateSelection selection;
+    bool fReady = blockTemplateEngine.GetSelection(CBlockTemplateEngine::KIND_HIVE, pindexPrev, IsWitnessEnabled(pindexPrev, chainparams.GetConsensus()), nBlockMaxWeight, blockMinFeeRate, selection);
+    if (fReady && !CheckSelection(true, selection)) {
+        blockTemplateEngine.Discard(CBlockTemplateEngine::KIND_HIVE, pindexPrev);
+        fReady = false;
+    }
+    if (!fReady && !CreateSelection(true, selection))
+        return nullptr;
+
+    pselectionIn = &selection;
+    std::unique_ptr<CBlockTemplate> pblocktemplateSkeleton;
+    try {
+        pblocktemplateSkeleton = CreateNewBlock(honeyScript, true, &hiveProofScript);
+    } catch (const std::runtime_error& e) {
+        LogPrintf("%s: Couldn't create Hive block: %s\n", __func__, e.what());
+    }
+    pselectionIn = nullptr;
+    return pblocktemplateSkeleton;
+}
+
+void BlockAssembler::AddSelection(const CTemplateSelection& selection)
+{
+    pblock->vtx.reserve(selection.vtx.size() + 1);
+    for (const CTemplateTx& entry : selection.vtx) {
+        pblock->vtx.emplace_back(entry.tx);
+        pblocktemplate->vTxFees.push_back(entry.nFee);
+        pblocktemplate->vTxSigOpsCost.push_back(entry.nSigOpsCost);
+    }
+    nBlockWeight = selection.nBlockWeight;
+    nBlockSigOpsCost = selection.nBlockSigOpsCost;
+    nBlockTx = selection.vtx.size();
+    nFees = selection.nFees;
+}
+
 void BlockAssembler::onlyUnconfirmed(CTxMemPool::setEntries& testSet)
 {
     for (CTxMemPool::setEntries::iterator iit = testSet.begin(); iit != testSet.end(); ) {
@@ -321,7 +466,7 @@ bool BlockAssembler::TestPackageTransactions(const CTxMemPool::setEntries& packa
         if (!fIncludeWitness && it->GetTx().HasWitness())
             return false;
         // PlexHive: Hive: Inhibit BCTs if required
-        if (!fIncludeBCTs && it->GetTx().IsBCT(consensusParams, GetScriptForDestination(DecodeDestination(consensusParams.beeCreationAddress))))
+        if (!fIncludeBCTs && it->GetTx().IsBCT(consensusParams, consensusParams.scriptPubKeyBCF))
             return false;
     }
     return true;
@@ -558,158 +703,556 @@ void IncrementExtraNonce(CBlock* pblock, const CBlockIndex* pindexPrev, unsigned
     pblock->hashMerkleRoot = BlockMerkleRoot(*pblock);
 }
 
+void CHiveLatency::Add(int64_t nMicros)
+{
+    nCount++;
+    nLastMicros = nMicros;
+    nMaxMicros = std::max(nMaxMicros, nMicros);
+    nTotalMicros += nMicros;
+    int nBucket = 0;
+    while (nBucket < NUM_BUCKETS - 1 && nMicros > BucketMax(nBucket))
+        nBucket++;
+    vBuckets[nBucket]++;
+}
+
+// PlexHive: Hive: Mining optimisations: Tip change notifications for the BeeKeeper, and cancellation of stale bee checks
+namespace {
+
+class CHiveTipWatcher : public CValidationInterface
+{
+private:
+    boost::mutex mut;
+    boost::condition_variable cond;
+    uint256 tipHash;                // Latest tip we've been told about (protected by mut)
+    int tipHeight;                  // (protected by mut)
+    int64_t tipTime;                // When we were told, in micros (protected by mut)
+    uint256 checkingTip;            // Tip a bee check is running against, or null if none (protected by mut)
+    bool fCheckEarlyAbort;          // Whether that check wants early aborts (protected by mut)
+    int64_t abortTime;              // When a running check was cancelled, in micros (protected by mut)
+    CHiveLatency tipToCheck;        // (protected by mut)
+    CHiveLatency blockToAbort;      // (protected by mut)
+    CHiveLatency solutionToSubmit;  // (protected by mut)
+
+    void CancelCheck(int64_t nNow) {
+        if (!checkingTip.IsNull() && fCheckEarlyAbort && checkingTip != tipHash && !earlyAbort.load()) {
+            abortTime = nNow;
+            earlyAbort.store(true);
+        }
+    }
+
+public:
+    CHiveTipWatcher() : tipHeight(-1), tipTime(0), fCheckEarlyAbort(false), abortTime(0) {}
+
+    // Start being told about tip changes, starting from the current tip if we haven't been told of one yet
+    void Register() {
+        RegisterValidationInterface(this);
+        LOCK(cs_main);
+        const CBlockIndex* pindexTip = chainActive.Tip();
+        boost::unique_lock<boost::mutex> lock(mut);
+        if (tipHash.IsNull() && pindexTip) {
+            tipHash = pindexTip->GetBlockHash();
+            tipHeight = pindexTip->nHeight;
+            tipTime = GetTimeMicros();
+        }
+    }
+
+    // Wait for the tip to move away from lastHash; returns the new tip's height. This is a boost interruption point.
+    int WaitForNewTip(uint256& lastHash) {
+        boost::unique_lock<boost::mutex> lock(mut);
+        while (tipHash == lastHash)
+            cond.wait(lock);
+        lastHash = tipHash;
+        return tipHeight;
+    }
+
+    // A bee check is about to start against pindexPrev. Returns false if the tip has already moved on.
+    bool BeginCheck(const CBlockIndex* pindexPrev, bool fEarlyAbort) {
+        boost::unique_lock<boost::mutex> lock(mut);
+        earlyAbort.store(false);
+        checkingTip = pindexPrev->GetBlockHash();
+        fCheckEarlyAbort = fEarlyAbort;
+        if (tipHash == checkingTip)
+            tipToCheck.Add(GetTimeMicros() - tipTime);
+        CancelCheck(GetTimeMicros());
+        return !earlyAbort.load();
+    }
+
+    // The bee check has finished; all bin threads have returned
+    void EndCheck() {
+        boost::unique_lock<boost::mutex> lock(mut);
+        if (earlyAbort.load() && abortTime)
+            blockToAbort.Add(GetTimeMicros() - abortTime);
+        checkingTip.SetNull();
+        abortTime = 0;
+    }
+
+    // A bee was found, and its block is about to be submitted
+    void Submitting(int64_t solutionTime) {
+        boost::unique_lock<boost::mutex> lock(mut);
+        solutionToSubmit.Add(GetTimeMicros() - solutionTime);
+    }
+
+    void GetLatencyStats(CHiveLatency& tipToCheckOut, CHiveLatency& blockToAbortOut, CHiveLatency& solutionToSubmitOut) {
+        boost::unique_lock<boost::mutex> lock(mut);
+        tipToCheckOut = tipToCheck;
+        blockToAbortOut = blockToAbort;
+        solutionToSubmitOut = solutionToSubmit;
+    }
+
+protected:
+    void UpdatedBlockTip(const CBlockIndex *pindexNew, const CBlockIndex *pindexFork, bool fInitialDownload) override {
+        boost::unique_lock<boost::mutex> lock(mut);
+        int64_t nNow = GetTimeMicros();
+        tipHash = pindexNew->GetBlockHash();
+        tipHeight = pindexNew->nHeight;
+        tipTime = nNow;
+        CancelCheck(nNow);
+        cond.notify_all();
+    }
+};
+
+CHiveTipWatcher hiveTipWatcher;
+
+// Ends a bee check on the tip watcher however BusyBees leaves it, thread interruption included
+class CHiveCheckScope
+{
+private:
+    bool fEnded;
+
+public:
+    CHiveCheckScope() : fEnded(false) {}
+    ~CHiveCheckScope() { End(); }
+
+    void End() {
+        if (!fEnded) {
+            fEnded = true;
+            hiveTipWatcher.EndCheck();
+        }
+    }
+};
+
+} // namespace
+
+void GetHiveLatencyStats(CHiveLatency& tipToCheck, CHiveLatency& blockToAbort, CHiveLatency& solutionToSubmit)
+{
+    hiveTipWatcher.GetLatencyStats(tipToCheck, blockToAbort, solutionToSubmit);
+}
+
+// PlexHive: Hive: Mining optimisations: Persistent bee check thread pool
+//
+// Bees are handed out in small chunks from a shared cursor, so a slow or busy
+// core only delays the round by one chunk. Threads (and their per-thread
+// Minotaur state) live across rounds.
+namespace {
+
+struct CBeeChunk
+{
+    size_t range;       // Index into CBeeCheckRound::ranges
+    int offset;
+    int count;
+};
+
+struct CBeeCheckRound
+{
+    std::vector<CBeeRange> ranges;
+    std::vector<CBeeChunk> chunks;
+    std::string deterministicRandString;
+    arith_uint256 beeHashTarget;
+    bool fMinotaur;
+    std::atomic<size_t> cursor;         // Next chunk to hand out
+    std::atomic<uint64_t> nBeesChecked;
+    int64_t nStartMicros;
+
+    CBeeCheckRound() : fMinotaur(false), cursor(0), nBeesChecked(0), nStartMicros(0) {}
+};
+
+class CBeeCheckPool
+{
+private:
+    boost::mutex mut;
+    boost::condition_variable condWork;
+    boost::condition_variable condDone;
+    boost::thread_group threads;
+    int nThreads;                               // Protected by mut
+    int nNice;                                  // Protected by mut
+    bool fStop;                                 // Protected by mut
+    uint64_t nRound;                            // Protected by mut
+    std::shared_ptr<CBeeCheckRound> round;      // Protected by mut
+    int nBusy;                                  // Workers still on the current round (protected by mut)
+    int64_t nFirstDoneMicros;                   // When the first worker ran out of chunks (protected by mut)
+    int64_t nLastDoneMicros;                    // When the last did (protected by mut)
+    std::atomic<bool> fInterrupted;             // Set if the waiting BeeKeeper is interrupted
+    std::atomic<bool> fNiceFailed;              // Set once a worker couldn't set nNice; it isn't tried again until nNice changes
+
+    void Worker(int threadID, uint64_t nLastRound);
+    void CheckChunk(CBeeCheckRound& r, const CBeeChunk& chunk, std::unique_ptr<CBeeHasher>& beeHasher, size_t& hasherRange);
+
+public:
+    CBeeCheckPool() : nThreads(0), nNice(0), fStop(false), nRound(0), nBusy(0), nFirstDoneMicros(0), nLastDoneMicros(0), fInterrupted(false), fNiceFailed(false) {}
+    ~CBeeCheckPool() { Stop(); }
+
+    void Resize(int nThreadsIn);
+    void Stop();
+    void SetNice(int nNiceIn)
+    {
+        boost::unique_lock<boost::mutex> lock(mut);
+        if (nNiceIn != nNice)
+            fNiceFailed = false;
+        nNice = nNiceIn;
+    }
+    int Size() { boost::unique_lock<boost::mutex> lock(mut); return nThreads; }
+
+    // Check all bees in the round, returning once a solution is found, an abort is signalled, or all bees have been checked
+    CHiveRoundStats Run(std::shared_ptr<CBeeCheckRound> r);
+};
+
+void CBeeCheckPool::Resize(int nThreadsIn)
+{
+    if (Size() == nThreadsIn)
+        return;
+    Stop();
+    boost::unique_lock<boost::mutex> lock(mut);
+    fStop = false;
+    nThreads = nThreadsIn;
+    for (int i = 0; i < nThreads; i++)
+        threads.create_thread(boost::bind(&CBeeCheckPool::Worker, this, i, nRound));   // Workers start waiting for the round after this one
+}
+
+void CBeeCheckPool::Stop()
+{
+    {
+        boost::unique_lock<boost::mutex> lock(mut);
+        fStop = true;
+        nThreads = 0;
+        condWork.notify_all();
+    }
+    threads.join_all();
+}
+
+CHiveRoundStats CBeeCheckPool::Run(std::shared_ptr<CBeeCheckRound> r)
+{
+    boost::unique_lock<boost::mutex> lock(mut);
+    r->nStartMicros = GetTimeMicros();
+    round = r;
+    nRound++;
+    nBusy = nThreads;
+    nFirstDoneMicros = nLastDoneMicros = 0;
+    fInterrupted.store(false);
+    condWork.notify_all();
+    try {
+        while (nBusy > 0)
+            condDone.wait(lock);
+    } catch (const boost::thread_interrupted&) {
+        // Shutting down; stop the workers early, and don't leave them holding the round
+        fInterrupted.store(true);
+        boost::this_thread::disable_interruption di;
+        while (nBusy > 0)
+            condDone.wait(lock);
+        round.reset();
+        throw;
+    }
+    round.reset();
+
+    CHiveRoundStats stats;
+    stats.nBees = r->nBeesChecked.load();
+    stats.nThreads = nThreads;
+    stats.nMicros = nLastDoneMicros - r->nStartMicros;
+    stats.nTailMicros = nLastDoneMicros - nFirstDoneMicros;
+    return stats;
+}
+
+void CBeeCheckPool::CheckChunk(CBeeCheckRound& r, const CBeeChunk& chunk, std::unique_ptr<CBeeHasher>& beeHasher, size_t& hasherRange)
+{
+    const CBeeRange& beeRange = r.ranges[chunk.range];
+    if (!beeHasher || hasherRange != chunk.range) {
+        beeHasher.reset(new CBeeHasher(r.deterministicRandString, beeRange.txid, r.fMinotaur));    // Serialize the range's common prefix once
+        hasherRange = chunk.range;
+    }
+    for (int i = chunk.offset; i < chunk.offset + chunk.count; i++) {
+        if (beeHasher->CheckBee(i, r.beeHashTarget)) {
+            LOCK(cs_solution_vars);     // Expensive mutex only happens at write-out
+            if (!solutionFound.load()) {
+                solvingRange = beeRange;
+                solvingBee = i;
+                solvingTime = GetTimeMicros();
+                solutionFound.store(true);
+            }
+            r.nBeesChecked += i - chunk.offset + 1;
+            return;
+        }
+    }
+    r.nBeesChecked += chunk.count;
+}
+
+void CBeeCheckPool::Worker(int threadID, uint64_t nLastRound)
+{
+    RenameThread(strprintf("hive-bees-%d", threadID).c_str());
+
+    int nAppliedNice = 0;
+
+    while (true) {
+        std::shared_ptr<CBeeCheckRound> r;
+        int nWantNice;
+        {
+            boost::unique_lock<boost::mutex> lock(mut);
+            while (!fStop && nRound == nLastRound)
+                condWork.wait(lock);
+            if (fStop)
+                return;
+            nLastRound = nRound;
+            r = round;
+            nWantNice = nNice;
+        }
+
+        // A failure is reported once, and not tried again on any worker, as it'll fail the same way every round
+        if (nWantNice != nAppliedNice && !fNiceFailed.load()) {
+            if (SetThreadNiceness(nWantNice))
+                nAppliedNice = nWantNice;
+            else if (!fNiceFailed.exchange(true))
+                LogPrintf("BeeCheckPool: Couldn't set niceness %d on the bee check threads; leaving it at %d\n", nWantNice, nAppliedNice);
+        }
+
+        // Pull chunks until they run out, someone finds a solution, or we're told to abort
+        std::unique_ptr<CBeeHasher> beeHasher;
+        size_t hasherRange = 0;
+        while (!solutionFound.load() && !earlyAbort.load() && !fInterrupted.load()) {
+            size_t next = r->cursor++;
+            if (next >= r->chunks.size())
+                break;
+            CheckChunk(*r, r->chunks[next], beeHasher, hasherRange);
+        }
+
+        boost::unique_lock<boost::mutex> lock(mut);
+        int64_t nNow = GetTimeMicros();
+        if (nFirstDoneMicros == 0)
+            nFirstDoneMicros = nNow;
+        nLastDoneMicros = nNow;
+        if (--nBusy == 0)
+            condDone.notify_all();
+    }
+}
+
+CBeeCheckPool beeCheckPool;
+
+CCriticalSection cs_hiveRoundStats;
+CHiveRoundStats lastHiveRoundStats;     // Protected by cs_hiveRoundStats
+
+} // namespace
+
+CHiveRoundStats GetLastHiveRoundStats()
+{
+    LOCK(cs_hiveRoundStats);
+    return lastHiveRoundStats;
+}
+
 // PlexHive: Hive: Bee management thread
+// PlexHive: Hive: Mining optimisations: Driven by tip change notifications rather than polling
 void BeeKeeper(const CChainParams& chainparams) {
     const Consensus::Params& consensusParams = chainparams.GetConsensus();
 
     LogPrintf("BeeKeeper: Thread started\n");
     RenameThread("hive-beekeeper");
 
-    int height;
+    hiveTipWatcher.Register();
+
+    uint256 tipHash;
     {
         LOCK(cs_main);
-        height = chainActive.Tip()->nHeight;
+        tipHash = chainActive.Tip()->GetBlockHash();
     }
 
     try {
         while (true) {
-            // PlexHive: Hive: Mining optimisations: Parameterised sleep time
-            int sleepTime = std::max((int64_t) 1, gArgs.GetArg("-hivecheckdelay", DEFAULT_HIVE_CHECK_DELAY));
-            MilliSleep(sleepTime);
-
-            int newHeight;
-            {
-                LOCK(cs_main);
-                newHeight = chainActive.Tip()->nHeight;
-            }
-            if (newHeight != height) {
-                // Height changed; release the bees!
-                height = newHeight;
-                try {
-                    BusyBees(consensusParams, height);
-                } catch (const std::runtime_error &e) {
-                    LogPrintf("! BeeKeeper: Error: %s\n", e.what());
-                }
+            int height = hiveTipWatcher.WaitForNewTip(tipHash);
+
+            // PlexHive: Hive: Mining optimisations: Parameterised delay between a tip change and the bee check
+            int sleepTime = std::max((int64_t) 0, gArgs.GetArg("-hivecheckdelay", DEFAULT_HIVE_CHECK_DELAY));
+            if (sleepTime > 0)
+                MilliSleep(sleepTime);
+
+            // Tip changed; release the bees!
+            try {
+                BusyBees(consensusParams, height);
+            } catch (const std::runtime_error &e) {
+                LogPrintf("! BeeKeeper: Error: %s\n", e.what());
             }
         }
     } catch (const boost::thread_interrupted&) {
+        UnregisterValidationInterface(&hiveTipWatcher);
+        beeCheckPool.Stop();
         LogPrintf("!!! BeeKeeper: FATAL: Thread interrupted\n");
         throw;
     }
 }
 
-// PlexHive: Hive: Mining optimisations: Thread to signal abort on new block
-void AbortWatchThread(int height) {
-    // Loop until any exit condition
-    while (true) {
-        // Yield to OS
-        MilliSleep(1);
+// PlexHive: Hive: Mining optimisations: Hive block fast-submit
+//
+// What a Hive block needs that doesn't depend on which bee solves is
+// prepared on its own thread while the bees are being checked: the message
+// proof for each honey address, as it only signs the tip's
+// deterministicRandString, the height of each BCT, and a skeleton block with
+// placeholder proof and honey scripts. A bee found then only needs the
+// coinbase filling in. Anything not ready by then is worked out as before.
+namespace {
+
+struct CHoneyProof
+{
+    CScript honeyScript;
+    std::vector<unsigned char> messageProof;
+};
 
-        // Check pre-existing abort conditions
-        if (solutionFound.load() || earlyAbort.load())
-            return;
+// Sign the message proof for honeyAddress. cs_wallet must be held.
+bool GetHoneyProof(CWallet* pwallet, const std::string& honeyAddress, const uint256& messageHash, CHoneyProof& proof)
+{
+    CTxDestination dest = DecodeDestination(honeyAddress);
+    if (!IsValidDestination(dest)) {
+        LogPrintf("BusyBees: Honey destination invalid\n");
+        return false;
+    }
 
-        // Get tip height, keeping lock scope as short as possible
-        int newHeight;
-        {
-            LOCK(cs_main);
-            newHeight = chainActive.Tip()->nHeight;
-        }
+    const CKeyID *keyID = boost::get<CKeyID>(&dest);
+    if (!keyID) {
+        LogPrintf("BusyBees: Wallet doesn't have privkey for honey destination\n");
+        return false;
+    }
 
-        // Check for abort from tip height change
-        if (newHeight != height) {
-            //LogPrintf("*** ABORT FIRE\n");
-            earlyAbort.store(true);
-            return;
-        }
+    CKey key;
+    if (!pwallet->GetKey(*keyID, key)) {
+        LogPrintf("BusyBees: Privkey unavailable\n");
+        return false;
+    }
+
+    if (!key.SignCompact(messageHash, proof.messageProof)) {
+        LogPrintf("BusyBees: Couldn't sign the bee proof!\n");
+        return false;
     }
+    proof.honeyScript = GetScriptForDestination(dest);
+    return true;
 }
 
-// PlexHive: Hive: Mining optimisations: Thread to check a single bin
-void CheckBin(int threadID, std::vector<CBeeRange> bin, std::string deterministicRandString, arith_uint256 beeHashTarget) {
-    // Iterate over ranges in this bin
-    int checkCount = 0;
-    for (std::vector<CBeeRange>::const_iterator it = bin.begin(); it != bin.end(); it++) {
-        CBeeRange beeRange = *it;
-        //LogPrintf("THREAD #%i: Checking %i-%i in %s\n", threadID, beeRange.offset, beeRange.offset + beeRange.count - 1, beeRange.txid);
-        // Iterate over bees in this range
-        for (int i = beeRange.offset; i < beeRange.offset + beeRange.count; i++) {
-            // Check abort conditions (Only every N bees. The atomic load is expensive, but much cheaper than a mutex - esp on Windows, see https://www.arangodb.com/2015/02/comparing-atomic-mutex-rwlocks/)
-            if(checkCount++ % 1000 == 0) {
-                if (solutionFound.load() || earlyAbort.load()) {
-                    //LogPrintf("THREAD #%i: Solution found elsewhere or early abort requested, ending early\n", threadID);
-                    return;
-                }
-            }
-            // Hash the bee
-            std::string hashHex = (CHashWriter(SER_GETHASH, 0) << deterministicRandString << beeRange.txid << i).GetHash().GetHex();
-            arith_uint256 beeHash = arith_uint256(hashHex);
-            // Compare to target and write out result if successful
-            if (beeHash < beeHashTarget) {
-                //LogPrintf("THREAD #%i: Solution found, returning\n", threadID);
-                LOCK(cs_solution_vars);                                 // Expensive mutex only happens at write-out
-                solutionFound.store(true);
-                solvingRange = beeRange;
-                solvingBee = i;
-                return;
-            }
-        }
+// Get the height of a BCT from its utxo. cs_main must be held.
+bool GetBCTHeight(const std::string& txid, uint32_t& bctHeight)
+{
+    COutPoint out(uint256S(txid), 0);
+    Coin coin;
+    if (!pcoinsTip || !pcoinsTip->GetCoin(out, coin)) {
+        LogPrintf("BusyBees: Couldn't get the bct utxo!\n");
+        return false;
     }
-    //LogPrintf("THREAD #%i: Out of tasks\n", threadID);
+    bctHeight = coin.nHeight;
+    return true;
 }
 
-// PlexHive: MinotaurX+Hive1.2: Thread to check a single bee bin
-void CheckBinMinotaur(int threadID, std::vector<CBeeRange> bin, std::string deterministicRandString, arith_uint256 beeHashTarget) {
-    // Create yespower thread-local storage
-    /*
-    static __thread yespower_local_t local;
-    yespower_init_local(&local);
-    */
+CScript GetHiveProofScript(uint32_t beeNonce, uint32_t bctHeight, bool communityContrib, const std::string& txid, const std::vector<unsigned char>& messageProof)
+{
+    unsigned char beeNonceEncoded[4];
+    WriteLE32(beeNonceEncoded, beeNonce);
+    std::vector<unsigned char> beeNonceVec(beeNonceEncoded, beeNonceEncoded + 4);
 
-    // Iterate over ranges in this bin
-    int checkCount = 0;
-    for (std::vector<CBeeRange>::const_iterator it = bin.begin(); it != bin.end(); it++) {
-        CBeeRange beeRange = *it;
-        //LogPrintf("THREAD #%i: Checking %i-%i in %s\n", threadID, beeRange.offset, beeRange.offset + beeRange.count - 1, beeRange.txid);
-        // Iterate over bees in this range
-        for (int i = beeRange.offset; i < beeRange.offset + beeRange.count; i++) {
-            // Check abort conditions (Only every N bees. The atomic load is expensive, but much cheaper than a mutex - esp on Windows, see https://www.arangodb.com/2015/02/comparing-atomic-mutex-rwlocks/)
-            if(checkCount++ % 1000 == 0) {
-                if (solutionFound.load() || earlyAbort.load()) {
-                    //LogPrintf("THREAD #%i: Solution found elsewhere or early abort requested, ending early\n", threadID);
-                    //yespower_free_local(&local);
-                    return;
-                }
-            }
+    unsigned char bctHeightEncoded[4];
+    WriteLE32(bctHeightEncoded, bctHeight);
+    std::vector<unsigned char> bctHeightVec(bctHeightEncoded, bctHeightEncoded + 4);
 
-            // Hash the bee
-            std::stringstream buf;
-            buf << deterministicRandString;
-            buf << beeRange.txid;
-            buf << i;
-            std::string hashString = buf.str();
+    std::vector<unsigned char> txidVec(txid.begin(), txid.end());
+    opcodetype communityContribFlag = communityContrib ? OP_TRUE : OP_FALSE;
 
-            uint256 beeHashUint = CBlockHeader::MinotaurHashString(hashString);
-            arith_uint256 beeHash(beeHashUint.ToString());
+    CScript hiveProofScript;
+    hiveProofScript << OP_RETURN << OP_BEE << beeNonceVec << bctHeightVec << communityContribFlag << txidVec << messageProof;
+    return hiveProofScript;
+}
 
-            // Compare to target and write out result if successful
-            if (beeHash < beeHashTarget) {
-                //LogPrintf("THREAD #%i: Solution found, returning\n", threadID);
-                LOCK(cs_solution_vars);     // Expensive mutex only happens at write-out
-                solutionFound.store(true);
-                solvingRange = beeRange;
-                solvingBee = i;
-                //yespower_free_local(&local);
+uint256 GetHoneyMessageHash(const std::string& deterministicRandString)
+{
+    CHashWriter ss(SER_GETHASH, 0);
+    ss << deterministicRandString;
+    return ss.GetHash();
+}
+
+class CHiveSubmitPrep
+{
+private:
+    std::thread thread;
+    std::atomic<bool> fCancel;
+
+    void Prepare(CWallet* pwallet, const CBlockIndex* pindexPrev, std::shared_ptr<const CBeeCheckRound> round);
+
+public:
+    // Only to be read once Finish has returned
+    std::map<std::string, CHoneyProof> honeyProofs;     // By honey address
+    std::set<std::string> failedHoneyAddresses;         // Honey addresses that couldn't be signed for, not tried again this round
+    std::map<std::string, uint32_t> bctHeights;         // By BCT txid
+    std::unique_ptr<CBlockTemplate> skeleton;           // Hive block on the tip the round is for
+    int64_t nMicros;                                    // Time spent preparing
+
+    CHiveSubmitPrep() : fCancel(false), nMicros(0) {}
+    ~CHiveSubmitPrep() { Finish(); }
+
+    void Start(CWallet* pwallet, const CBlockIndex* pindexPrev, std::shared_ptr<const CBeeCheckRound> round) {
+        thread = std::thread(&CHiveSubmitPrep::Prepare, this, pwallet, pindexPrev, round);
+    }
+
+    // Stop preparing, and wait for what's been prepared so far
+    void Finish() {
+        fCancel.store(true);
+        if (thread.joinable())
+            thread.join();
+    }
+};
+
+void CHiveSubmitPrep::Prepare(CWallet* pwallet, const CBlockIndex* pindexPrev, std::shared_ptr<const CBeeCheckRound> round)
+{
+    RenameThread("hive-prep");
+    int64_t nStart = GetTimeMicros();
+    const uint256 messageHash = GetHoneyMessageHash(round->deterministicRandString);
+
+    try {
+        {
+            LOCK(cs_main);
+            if (chainActive.Tip() != pindexPrev)
                 return;
+            for (const CBeeRange& range : round->ranges) {
+                uint32_t bctHeight;
+                if (!bctHeights.count(range.txid) && GetBCTHeight(range.txid, bctHeight))
+                    bctHeights[range.txid] = bctHeight;
             }
+        }
 
-            boost::this_thread::yield();
+        // Sign for honey addresses in the order their bees are checked, building the skeleton after the first
+        for (const CBeeRange& range : round->ranges) {
+            if (fCancel.load())
+                break;
+            if (failedHoneyAddresses.count(range.honeyAddress))
+                continue;
+            if (!honeyProofs.count(range.honeyAddress)) {
+                CHoneyProof proof;
+                LOCK(pwallet->cs_wallet);
+                if (!GetHoneyProof(pwallet, range.honeyAddress, messageHash, proof)) {
+                    failedHoneyAddresses.insert(range.honeyAddress);
+                    continue;
+                }
+                honeyProofs[range.honeyAddress] = std::move(proof);
+            }
+            if (!skeleton) {
+                // Placeholders the same size as the real scripts, so the block's weight doesn't change when they're filled in
+                const CHoneyProof& proof = honeyProofs[range.honeyAddress];
+                CScript placeholderProofScript = GetHiveProofScript(0, 0, range.communityContrib, range.txid, proof.messageProof);
+                LOCK2(cs_main, mempool.cs);
+                if (chainActive.Tip() != pindexPrev)
+                    break;
+                skeleton = BlockAssembler(Params()).CreateHiveSkeleton(proof.honeyScript, placeholderProofScript);
+                if (!skeleton)
+                    break;
+            }
         }
+    } catch (const std::exception& e) {
+        PrintExceptionContinue(&e, "hive-prep");
     }
-    //LogPrintf("THREAD #%i: Out of tasks\n", threadID);
-    //yespower_free_local(&local);
+
+    nMicros = GetTimeMicros() - nStart;
 }
 
+} // namespace
+
 // PlexHive: Hive: Attempt to mint the next block
 bool BusyBees(const Consensus::Params& consensusParams, int height) {
     bool verbose = LogAcceptCategory(BCLog::HIVE);
@@ -737,13 +1280,7 @@ bool BusyBees(const Consensus::Params& consensusParams, int height) {
 
     // PlexHive: Hive 1.1: Check that there aren't too many consecutive Hive blocks
     if (IsHive11Enabled(pindexPrev, consensusParams)) {
-        int hiveBlocksAtTip = 0;
-        CBlockIndex* pindexTemp = pindexPrev;
-        while (pindexTemp->GetBlockHeader().IsHiveMined(consensusParams)) {
-            assert(pindexTemp->pprev);
-            pindexTemp = pindexTemp->pprev;
-            hiveBlocksAtTip++;
-        }
+        int hiveBlocksAtTip = pindexPrev->nHiveRun;    // PlexHive: Hive: Mining optimisations: Tracked by the hive skip links
         if (hiveBlocksAtTip >= consensusParams.maxConsecutiveHiveBlocks) {
             LogPrintf("BusyBees: Skipping hive check (max Hive blocks without a POW block reached)\n");
             return false;
@@ -770,26 +1307,18 @@ bool BusyBees(const Consensus::Params& consensusParams, int height) {
 
     LogPrintf("********************* Hive: Bees at work *********************\n");
 
-    // Find deterministicRandString
-    std::string deterministicRandString = GetDeterministicRandString(pindexPrev);
+    // Find deterministicRandString and beeHashTarget; shared with CheckHiveProof via the parent block
+    std::shared_ptr<const CHiveProofInputs> proofInputs = GetHiveProofInputs(pindexPrev, consensusParams);
+    std::string deterministicRandString = proofInputs->RandString();
     if (verbose) LogPrintf("BusyBees: deterministicRandString   = %s\n", deterministicRandString);
 
-    // Find beeHashTarget
     arith_uint256 beeHashTarget;
-    beeHashTarget.SetCompact(GetNextHiveWorkRequired(pindexPrev, consensusParams));
+    beeHashTarget.SetCompact(proofInputs->nBeeBits);
     if (verbose) LogPrintf("BusyBees: beeHashTarget             = %s\n", beeHashTarget.ToString());
 
-    // Find bin size
-    std::vector<CBeeCreationTransactionInfo> potentialBcts = pwallet->GetBCTs(false, false, consensusParams);
-    std::vector<CBeeCreationTransactionInfo> bcts;
+    // Find the mature bees
     int totalBees = 0;
-    for (std::vector<CBeeCreationTransactionInfo>::const_iterator it = potentialBcts.begin(); it != potentialBcts.end(); it++) {
-        CBeeCreationTransactionInfo bct = *it;
-        if (bct.beeStatus != "mature")
-            continue;
-        bcts.push_back(bct);
-        totalBees += bct.beeCount;
-    }
+    std::vector<CBeeRange> matureRanges = pwallet->GetMatureBeeRanges(pindexPrev, consensusParams, totalBees);
 
     if (totalBees == 0) {
         LogPrint(BCLog::HIVE, "BusyBees: No mature bees found\n");
@@ -805,99 +1334,57 @@ bool BusyBees(const Consensus::Params& consensusParams, int height) {
     else if (threadCount == 0)
         threadCount = 1;
 
-    int beesPerBin = ceil(totalBees / (float)threadCount);  // We want to check this many bees per thread
-
-    // Bin the bees according to desired thead count
-    if (verbose) LogPrint(BCLog::HIVE, "BusyBees: Binning %i bees in %i bins (%i bees per bin)\n", totalBees, threadCount, beesPerBin);
-    std::vector<CBeeCreationTransactionInfo>::const_iterator bctIterator = bcts.begin();
-    CBeeCreationTransactionInfo bct = *bctIterator;
-    std::vector<std::vector<CBeeRange>> beeBins;
-    int beeOffset = 0;                                      // Track offset in current BCT
-    while(bctIterator != bcts.end()) {                      // Until we're out of BCTs
-        std::vector<CBeeRange> currentBin;                  // Create a new bin
-        int beesInBin = 0;
-        while (bctIterator != bcts.end()) {                 // Keep filling it until full
-            int spaceLeft = beesPerBin - beesInBin;
-            if (bct.beeCount - beeOffset <= spaceLeft) {    // If there's soom, add all the bees from this BCT...
-                CBeeRange range = {bct.txid, bct.honeyAddress, bct.communityContrib, beeOffset, bct.beeCount - beeOffset};
-                currentBin.push_back(range);
-
-                beesInBin += bct.beeCount - beeOffset;
-                beeOffset = 0;
-
-                do {                                        // ... and iterate to next BCT
-                    bctIterator++;
-                    if (bctIterator == bcts.end())
-                        break;
-                    bct = *bctIterator;
-                } while (bct.beeStatus != "mature");
-            } else {                                        // Can't fit the whole thing to current bin; add what we can fit and let the rest go in next bin
-                CBeeRange range = {bct.txid, bct.honeyAddress, bct.communityContrib, beeOffset, spaceLeft};
-                currentBin.push_back(range);
-                beeOffset += spaceLeft;
-                break;
-            }
-        }
-        beeBins.push_back(currentBin);
-    }
-
-    // Create a worker thread for each bin
-    if (verbose) LogPrintf("BusyBees: Running bins\n");
-    solutionFound.store(false);
-    earlyAbort.store(false);
-    std::vector<std::vector<CBeeRange>>::const_iterator beeBinIterator = beeBins.begin();
-    std::vector<boost::thread> binThreads;
-    int64_t checkTime = GetTimeMillis();
-    int binID = 0;
+    // PlexHive: Hive: Mining optimisations: Queue the mature bees as small chunks for the bee check pool
     bool minotaurXEnabled = IsMinotaurXEnabled(pindexPrev, consensusParams);    // PlexHive: MinotaurX+Hive1.2: Check if minotaurX enabled
-    while (beeBinIterator != beeBins.end()) {
-        std::vector<CBeeRange> beeBin = *beeBinIterator;
-
-        if (verbose) {
-            LogPrintf("BusyBees: Bin #%i\n", binID);
-            std::vector<CBeeRange>::const_iterator beeRangeIterator = beeBin.begin();
-            while (beeRangeIterator != beeBin.end()) {
-                CBeeRange beeRange = *beeRangeIterator;
-                LogPrintf("offset = %i, count = %i, txid = %s\n", beeRange.offset, beeRange.count, beeRange.txid);
-                beeRangeIterator++;
-            }
+    const int chunkSize = minotaurXEnabled ? HIVE_CHECK_CHUNK_MINOTAUR : HIVE_CHECK_CHUNK_SHA256;
+    std::shared_ptr<CBeeCheckRound> round = std::make_shared<CBeeCheckRound>();
+    round->deterministicRandString = deterministicRandString;
+    round->beeHashTarget = beeHashTarget;
+    round->fMinotaur = minotaurXEnabled;    // PlexHive: MinotaurX+Hive1.2: Use correct inner hash
+    round->ranges = std::move(matureRanges);
+    for (size_t i = 0; i < round->ranges.size(); i++) {
+        const CBeeRange& range = round->ranges[i];
+        for (int offset = 0; offset < range.count; offset += chunkSize) {
+            CBeeChunk chunk = {i, offset, std::min(chunkSize, range.count - offset)};
+            round->chunks.push_back(chunk);
         }
-        // PlexHive: MinotaurX+Hive1.2: Use correct inner hash
-        if (!minotaurXEnabled)
-            binThreads.push_back(boost::thread(CheckBin, binID++, beeBin, deterministicRandString, beeHashTarget));
-        else
-            binThreads.push_back(boost::thread(CheckBinMinotaur, binID++, beeBin, deterministicRandString, beeHashTarget));
-
-        beeBinIterator++;
     }
+    if (verbose) LogPrint(BCLog::HIVE, "BusyBees: Queued %i bees from %u BCTs in %u chunks for %i threads\n", totalBees, round->ranges.size(), round->chunks.size(), threadCount);
 
-    // Add an extra thread to watch external abort conditions (eg new incoming block)
-    bool useEarlyAbortThread = gArgs.GetBoolArg("-hiveearlyout", DEFAULT_HIVE_EARLY_OUT);
-    if (verbose && useEarlyAbortThread)
-        LogPrintf("BusyBees: Will use early-abort thread\n");
+    beeCheckPool.Resize(threadCount);
+    beeCheckPool.SetNice(gArgs.GetArg("-hivechecknice", DEFAULT_HIVE_CHECK_NICE));
 
-    boost::thread earlyAbortThread;
-    if (useEarlyAbortThread)
-        earlyAbortThread = boost::thread(AbortWatchThread, height);
+    // PlexHive: Hive: Mining optimisations: If -hiveearlyout is set, a tip change notification cancels the check via earlyAbort
+    bool useEarlyAbort = gArgs.GetBoolArg("-hiveearlyout", DEFAULT_HIVE_EARLY_OUT);
+    solutionFound.store(false);
+    CHiveCheckScope checkScope;
+    if (!hiveTipWatcher.BeginCheck(pindexPrev, useEarlyAbort)) {
+        LogPrintf("BusyBees: Chain state changed (check aborted before starting)\n");
+        return false;
+    }
+    if (verbose) LogPrintf("BusyBees: Running bee check\n");
+    int64_t checkTime = GetTimeMillis();
 
-    // Wait for bin worker threads to find a solution or abort (in which case the others will all stop), or to run out of bees
-    for(auto& t:binThreads)
-        t.join();
+    // PlexHive: Hive: Mining optimisations: Prepare the block while the bees are checked
+    CHiveSubmitPrep prep;
+    prep.Start(pwallet, pindexPrev, round);
 
-    binThreads.clear();
+    // Wait for the pool to find a solution or abort, or to run out of bees
+    CHiveRoundStats roundStats = beeCheckPool.Run(round);
+    checkScope.End();
+    {
+        LOCK(cs_hiveRoundStats);
+        lastHiveRoundStats = roundStats;
+    }
+    LogPrint(BCLog::HIVE, "BusyBees: Round checked %u bees in %.3fms with %i threads (%.0f bees/s, tail %.3fms)\n",
+        roundStats.nBees, roundStats.nMicros * 0.001, roundStats.nThreads, roundStats.BeesPerSec(), roundStats.nTailMicros * 0.001);
 
     checkTime = GetTimeMillis() - checkTime;
 
     // Handle early aborts
-    if (useEarlyAbortThread) {
-        if (earlyAbort.load()) {
-            LogPrintf("BusyBees: Chain state changed (check aborted after %ims)\n", checkTime);
-            return false;
-        } else {
-            // We didn't abort; stop abort thread now
-            earlyAbort.store(true);
-            earlyAbortThread.join();
-        }
+    if (earlyAbort.load()) {
+        LogPrintf("BusyBees: Chain state changed (check aborted after %ims)\n", checkTime);
+        return false;
     }
 
     // Check if a solution was found
@@ -907,66 +1394,49 @@ bool BusyBees(const Consensus::Params& consensusParams, int height) {
     }
     LogPrintf("BusyBees: Bee meets hash target (check aborted after %ims). Solution with bee #%i from BCT %s. Honey address is %s.\n", checkTime, solvingBee, solvingRange.txid, solvingRange.honeyAddress);
 
-    // Assemble the Hive proof script
-    std::vector<unsigned char> messageProofVec;
-    std::vector<unsigned char> txidVec(solvingRange.txid.begin(), solvingRange.txid.end());
-    CScript hiveProofScript;
-    uint32_t bctHeight;
-    {   // Don't lock longer than needed
-        LOCK2(cs_main, pwallet->cs_wallet);
-
-        CTxDestination dest = DecodeDestination(solvingRange.honeyAddress);
-        if (!IsValidDestination(dest)) {
-            LogPrintf("BusyBees: Honey destination invalid\n");
-            return false;
-        }
-
-        const CKeyID *keyID = boost::get<CKeyID>(&dest);
-        if (!keyID) {
-            LogPrintf("BusyBees: Wallet doesn't have privkey for honey destination\n");
-            return false;
-        }
-
-        CKey key;
-        if (!pwallet->GetKey(*keyID, key)) {
-            LogPrintf("BusyBees: Privkey unavailable\n");
-            return false;
-        }
-
-        CHashWriter ss(SER_GETHASH, 0);
-        ss << deterministicRandString;
-        uint256 mhash = ss.GetHash();
-        if (!key.SignCompact(mhash, messageProofVec)) {
-            LogPrintf("BusyBees: Couldn't sign the bee proof!\n");
+    // PlexHive: Hive: Mining optimisations: Take what's been prepared, and work out what hasn't
+    prep.Finish();
+    LogPrint(BCLog::HIVE, "BusyBees: Prepared %u honey proofs, %u BCT heights and %s skeleton in %.3fms\n",
+        prep.honeyProofs.size(), prep.bctHeights.size(), prep.skeleton ? "a" : "no", prep.nMicros * 0.001);
+
+    CHoneyProof honeyProof;
+    auto itProof = prep.honeyProofs.find(solvingRange.honeyAddress);
+    if (itProof != prep.honeyProofs.end()) {
+        honeyProof = itProof->second;
+    } else if (prep.failedHoneyAddresses.count(solvingRange.honeyAddress)) {
+        return false;   // Already failed, and logged, while preparing
+    } else {
+        LOCK(pwallet->cs_wallet);
+        if (!GetHoneyProof(pwallet, solvingRange.honeyAddress, GetHoneyMessageHash(deterministicRandString), honeyProof))
             return false;
-        }
-        if (verbose) LogPrintf("BusyBees: messageSig                = %s\n", HexStr(&messageProofVec[0], &messageProofVec[messageProofVec.size()]));
+    }
+    if (verbose) LogPrintf("BusyBees: messageSig                = %s\n", HexStr(honeyProof.messageProof.begin(), honeyProof.messageProof.end()));
 
-        COutPoint out(uint256S(solvingRange.txid), 0);
-        Coin coin;
-        if (!pcoinsTip || !pcoinsTip->GetCoin(out, coin)) {
-            LogPrintf("BusyBees: Couldn't get the bct utxo!\n");
+    uint32_t bctHeight;
+    auto itHeight = prep.bctHeights.find(solvingRange.txid);
+    if (itHeight != prep.bctHeights.end()) {
+        bctHeight = itHeight->second;
+    } else {
+        LOCK(cs_main);
+        if (!GetBCTHeight(solvingRange.txid, bctHeight))
             return false;
-        }
-        bctHeight = coin.nHeight;
     }
 
-    unsigned char beeNonceEncoded[4];
-    WriteLE32(beeNonceEncoded, solvingBee);
-    std::vector<unsigned char> beeNonceVec(beeNonceEncoded, beeNonceEncoded + 4);
-
-    unsigned char bctHeightEncoded[4];
-    WriteLE32(bctHeightEncoded, bctHeight);
-    std::vector<unsigned char> bctHeightVec(bctHeightEncoded, bctHeightEncoded + 4);
-
-    opcodetype communityContribFlag = solvingRange.communityContrib ? OP_TRUE : OP_FALSE;
-    hiveProofScript << OP_RETURN << OP_BEE << beeNonceVec << bctHeightVec << communityContribFlag << txidVec << messageProofVec;
-
-    // Create honey script from honey address
-    CScript honeyScript = GetScriptForDestination(DecodeDestination(solvingRange.honeyAddress));
-
-    // Create a Hive block
-    std::unique_ptr<CBlockTemplate> pblocktemplate(BlockAssembler(Params()).CreateNewBlock(honeyScript, true, &hiveProofScript));
+    // Assemble the Hive proof script
+    CScript hiveProofScript = GetHiveProofScript(solvingBee, bctHeight, solvingRange.communityContrib, solvingRange.txid, honeyProof.messageProof);
+
+    // Create a Hive block, filling in the skeleton if there is one
+    std::unique_ptr<CBlockTemplate> pblocktemplate;
+    if (prep.skeleton) {
+        pblocktemplate = std::move(prep.skeleton);
+        CMutableTransaction coinbaseTx(*pblocktemplate->block.vtx[0]);
+        coinbaseTx.vout[0].scriptPubKey = hiveProofScript;
+        coinbaseTx.vout[1].scriptPubKey = honeyProof.honeyScript;
+        pblocktemplate->block.vtx[0] = MakeTransactionRef(std::move(coinbaseTx));
+        UpdateTime(&pblocktemplate->block, consensusParams, pindexPrev);
+    } else {
+        pblocktemplate = BlockAssembler(Params()).CreateNewBlock(honeyProof.honeyScript, true, &hiveProofScript);
+    }
     if (!pblocktemplate.get()) {
         LogPrintf("BusyBees: Couldn't create block\n");
         return false;
@@ -990,6 +1460,8 @@ bool BusyBees(const Consensus::Params& consensusParams, int height) {
 
     // Commit and propagate the block
     std::shared_ptr<const CBlock> shared_pblock = std::make_shared<const CBlock>(*pblock);
+    hiveTipWatcher.Submitting(solvingTime);
+    LogPrint(BCLog::HIVE, "BusyBees: Submitting block %.3fms after the bee was found\n", (GetTimeMicros() - solvingTime) * 0.001);
     if (!ProcessNewBlock(Params(), shared_pblock, true, nullptr)) {
         LogPrintf("BusyBees: Block wasn't accepted\n");
         return false;
@@ -998,3 +1470,346 @@ bool BusyBees(const Consensus::Params& consensusParams, int height) {
     LogPrintf("BusyBees: ** Block mined\n");
     return true;
 }
+
+//////////////////////////////////////////////////////////////////////////////
+//
+// PlexHive: MinotaurX+Hive1.2: Built-in pow miner
+//
+// A control thread builds a block template and publishes it as a job; each
+// worker grinds its own slice of the 32-bit nonce space over the job's
+// serialized header. A new job is published when the tip changes (signalled
+// through the validation interface, not polled), when every worker has
+// exhausted its slice, or when the template gets old.
+//
+
+namespace {
+
+struct CPowMinerJob
+{
+    CBlock block;
+    arith_uint256 target;
+    std::atomic<bool> fAbandon;     // Solved, superseded or stopping; workers should drop it
+    std::atomic<int> nExhausted;    // Workers that have run out of nonces
+
+    CPowMinerJob() : fAbandon(false), nExhausted(0) {}
+};
+
+// Pre-fork blocks are hashed with scrypt, which isn't a POW_TYPE, so the hash counts have a slot of their own for it
+static const int POW_MINER_HASH_SCRYPT = NUM_BLOCK_TYPES;
+static const int POW_MINER_HASH_TYPES = NUM_BLOCK_TYPES + 1;
+
+class CPowMiner : public CValidationInterface
+{
+private:
+    std::mutex cs;
+    std::condition_variable cond;
+    boost::thread_group threads;
+    std::shared_ptr<CPowMinerJob> job;          // Current job (protected by cs)
+    bool fStop;                                 // Protected by cs
+    bool fTipChanged;                           // Protected by cs
+
+    std::mutex cs_control;                      // Serializes Start/Stop
+    int nThreads;
+    POW_TYPE powType;
+    CScript coinbaseScript;
+    unsigned int nExtraNonce;
+
+    std::atomic<bool> fRunning;
+    std::atomic<uint64_t> nBlocksFound;
+    std::atomic<uint64_t> nHashes[POW_MINER_HASH_TYPES];
+
+    CCriticalSection cs_stats;
+    int64_t nLastSampleTime;                    // Protected by cs_stats
+    uint64_t nLastSampleHashes[POW_MINER_HASH_TYPES];
+    double hashesPerSec[POW_MINER_HASH_TYPES];
+
+    void ControlThread();
+    void WorkerThread(int threadID);
+    bool PublishJob();
+    void StopThreads();
+
+public:
+    CPowMiner() : fStop(true), fTipChanged(false), nThreads(0), powType(POW_TYPE_SHA256), nExtraNonce(0), fRunning(false), nBlocksFound(0), nLastSampleTime(0) {
+        for (int i = 0; i < POW_MINER_HASH_TYPES; i++) {
+            nHashes[i] = 0;
+            nLastSampleHashes[i] = 0;
+            hashesPerSec[i] = 0;
+        }
+    }
+
+    void Start(int nThreadsIn, POW_TYPE powTypeIn, const CScript& coinbaseScriptIn);
+    void Stop();
+    CPowMinerStats GetStats();
+
+protected:
+    void UpdatedBlockTip(const CBlockIndex *pindexNew, const CBlockIndex *pindexFork, bool fInitialDownload) override {
+        std::lock_guard<std::mutex> lock(cs);
+        if (job && job->block.hashPrevBlock == pindexNew->GetBlockHash())
+            return;     // Already building on it
+        fTipChanged = true;
+        if (job)
+            job->fAbandon = true;
+        cond.notify_all();
+    }
+};
+
+void CPowMiner::Start(int nThreadsIn, POW_TYPE powTypeIn, const CScript& coinbaseScriptIn)
+{
+    std::lock_guard<std::mutex> control(cs_control);
+    StopThreads();
+
+    nThreads = nThreadsIn < 0 ? GetNumVirtualCores() : std::max(nThreadsIn, 1);
+    powType = powTypeIn;
+    coinbaseScript = coinbaseScriptIn;
+    {
+        std::lock_guard<std::mutex> lock(cs);
+        fStop = false;
+        fTipChanged = false;
+        job.reset();
+    }
+    {
+        LOCK(cs_stats);
+        nLastSampleTime = GetTimeMillis();
+        for (int i = 0; i < POW_MINER_HASH_TYPES; i++)
+            nLastSampleHashes[i] = nHashes[i].load();
+    }
+    fRunning = true;
+
+    RegisterValidationInterface(this);
+    threads.create_thread(boost::bind(&CPowMiner::ControlThread, this));
+    for (int i = 0; i < nThreads; i++)
+        threads.create_thread(boost::bind(&CPowMiner::WorkerThread, this, i));
+    LogPrintf("PowMiner: Started %d %s threads\n", nThreads, POW_TYPE_NAMES[powType]);
+}
+
+void CPowMiner::Stop()
+{
+    std::lock_guard<std::mutex> control(cs_control);
+    StopThreads();
+}
+
+void CPowMiner::StopThreads()
+{
+    {
+        std::lock_guard<std::mutex> lock(cs);
+        fStop = true;
+        if (job)
+            job->fAbandon = true;
+        cond.notify_all();
+    }
+    threads.join_all();
+    if (fRunning.exchange(false)) {
+        UnregisterValidationInterface(this);
+        LogPrintf("PowMiner: Stopped\n");
+    }
+}
+
+// Build a fresh template and hand it to the workers. Returns false if mining can't continue.
+bool CPowMiner::PublishJob()
+{
+    std::shared_ptr<CPowMinerJob> newJob = std::make_shared<CPowMinerJob>();
+    try {
+        std::unique_ptr<CBlockTemplate> pblocktemplate(BlockAssembler(Params()).CreateNewBlock(coinbaseScript, true, nullptr, powType));
+        if (!pblocktemplate.get()) {
+            LogPrintf("PowMiner: Couldn't create block\n");
+            return false;
+        }
+        newJob->block = pblocktemplate->block;
+    } catch (const std::runtime_error& e) {
+        LogPrintf("PowMiner: Error: %s\n", e.what());
+        return false;
+    }
+    {
+        // The tip may have moved on since the template was made, so use the block it builds on
+        LOCK(cs_main);
+        BlockMap::const_iterator mi = mapBlockIndex.find(newJob->block.hashPrevBlock);
+        if (mi == mapBlockIndex.end()) {
+            LogPrintf("PowMiner: Template's previous block %s not found\n", newJob->block.hashPrevBlock.ToString());
+            return false;
+        }
+        IncrementExtraNonce(&newJob->block, mi->second, nExtraNonce);
+    }
+    bool fNegative, fOverflow;
+    newJob->target.SetCompact(newJob->block.nBits, &fNegative, &fOverflow);
+    if (fNegative || fOverflow || newJob->target == 0) {
+        LogPrintf("PowMiner: Invalid nBits %08x\n", newJob->block.nBits);
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(cs);
+    if (job)
+        job->fAbandon = true;
+    job = newJob;
+    cond.notify_all();
+    return true;
+}
+
+void CPowMiner::ControlThread()
+{
+    RenameThread("plexhive-powminer");
+    while (true) {
+        {
+            std::lock_guard<std::mutex> lock(cs);
+            if (fStop)
+                return;
+            fTipChanged = false;
+        }
+        if (!PublishJob()) {
+            {
+                std::lock_guard<std::mutex> lock(cs);
+                fStop = true;
+                cond.notify_all();
+            }
+            if (fRunning.exchange(false)) {
+                UnregisterValidationInterface(this);
+                LogPrintf("PowMiner: Stopped, as a template couldn't be made\n");
+            }
+            return;
+        }
+
+        std::unique_lock<std::mutex> lock(cs);
+        std::shared_ptr<CPowMinerJob> current = job;
+        cond.wait_for(lock, std::chrono::seconds(POW_MINER_TEMPLATE_REFRESH_SECS), [&]{
+            return fStop || fTipChanged || current->fAbandon.load() || current->nExhausted.load() == nThreads;
+        });
+    }
+}
+
+void CPowMiner::WorkerThread(int threadID)
+{
+    RenameThread(strprintf("plexhive-powminer-%d", threadID).c_str());
+
+    MinotaurHasher minotaurHasher;
+    std::unique_ptr<YespowerArena> yespowerArena;   // Only allocated if we mine MinotaurX
+    std::shared_ptr<CPowMinerJob> myJob;
+
+    // This worker's slice of the nonce space
+    const uint32_t nonceBegin = ((uint64_t)1 << 32) * threadID / nThreads;
+    const uint32_t nonceLast = ((uint64_t)1 << 32) * (threadID + 1) / nThreads - 1;
+
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(cs);
+            cond.wait(lock, [&]{ return fStop || job != myJob; });
+            if (fStop)
+                return;
+            myJob = job;
+        }
+
+        // Pick the pow hash the same way CBlockHeader::GetPoWHash() does
+        const CBlock& block = myJob->block;
+        const bool fForked = block.nTime > Params().GetConsensus().powForkTime;
+        const bool fMinotaurX = fForked && block.nVersion < 0x20000000 && block.GetPoWType() == POW_TYPE_MINOTAURX;
+        const bool fSHA256 = fForked && !fMinotaurX;
+        if (fMinotaurX && !yespowerArena)
+            yespowerArena.reset(new YespowerArena());
+        const int hashType = fMinotaurX ? POW_TYPE_MINOTAURX : fSHA256 ? POW_TYPE_SHA256 : POW_MINER_HASH_SCRYPT;
+        const uint32_t checkInterval = fSHA256 ? 0x4000 : 16;
+        CBlockHeader legacyHeader = block.GetBlockHeader();
+
+        // Serialize the header once; only the nonce changes. For sha256d, the first 64 bytes are hashed once too.
+        std::vector<unsigned char> header;
+        CVectorWriter(SER_NETWORK, PROTOCOL_VERSION, header, 0, block.GetBlockHeader());
+        assert(header.size() == 80);
+        CSHA256 midstate;
+        midstate.Write(header.data(), 64);
+
+        bool fFound = false;
+        uint32_t nNonce = nonceBegin;
+        uint32_t nHashesSinceCheck = 0;
+        while (true) {
+            WriteLE32(&header[76], nNonce);
+            uint256 powHash;
+            if (fMinotaurX) {
+                powHash = minotaurHasher.Hash(header.data(), header.size(), true, yespowerArena->Get());
+            } else if (fSHA256) {
+                unsigned char buf[CSHA256::OUTPUT_SIZE];
+                CSHA256(midstate).Write(&header[64], 16).Finalize(buf);
+                CSHA256().Write(buf, sizeof(buf)).Finalize(powHash.begin());
+            } else {
+                legacyHeader.nNonce = nNonce;
+                powHash = legacyHeader.GetPoWHash();
+            }
+            nHashesSinceCheck++;
+            if (UintToArith256(powHash) <= myJob->target) {
+                fFound = true;
+                break;
+            }
+            if (nNonce == nonceLast)
+                break;
+            nNonce++;
+            if (nHashesSinceCheck == checkInterval) {
+                nHashes[hashType] += nHashesSinceCheck;
+                nHashesSinceCheck = 0;
+                if (myJob->fAbandon.load())
+                    break;
+            }
+        }
+        nHashes[hashType] += nHashesSinceCheck;
+
+        if (fFound && !myJob->fAbandon.exchange(true)) {
+            // First worker to solve this job submits it
+            std::shared_ptr<CBlock> pblock = std::make_shared<CBlock>(block);
+            pblock->nNonce = nNonce;
+            if (!CheckProofOfWork(pblock->GetPoWHash(yespowerArena ? yespowerArena->Get() : nullptr), pblock->nBits, Params().GetConsensus())) {
+                LogPrintf("PowMiner: Solution %s doesn't verify\n", pblock->GetHash().ToString());
+            } else if (!ProcessNewBlock(Params(), pblock, true, nullptr)) {
+                LogPrintf("PowMiner: Block %s wasn't accepted\n", pblock->GetHash().ToString());
+            } else {
+                nBlocksFound++;
+                LogPrintf("PowMiner: ** Block mined: %s\n", pblock->GetHash().ToString());
+            }
+        } else if (!fFound && !myJob->fAbandon.load()) {
+            myJob->nExhausted++;
+        }
+
+        std::lock_guard<std::mutex> lock(cs);
+        cond.notify_all();
+    }
+}
+
+CPowMinerStats CPowMiner::GetStats()
+{
+    CPowMinerStats stats;
+    {
+        std::lock_guard<std::mutex> lock(cs);
+        stats.fRunning = fRunning.load() && !fStop;     // The control thread stops mining if it can't build templates
+    }
+    stats.nThreads = stats.fRunning ? nThreads : 0;
+    stats.powType = powType;
+    stats.nBlocksFound = nBlocksFound.load();
+
+    LOCK(cs_stats);
+    int64_t nNow = GetTimeMillis();
+    if (nNow - nLastSampleTime >= 1000) {
+        for (int i = 0; i < POW_MINER_HASH_TYPES; i++) {
+            uint64_t nTotal = nHashes[i].load();
+            hashesPerSec[i] = nLastSampleTime ? (nTotal - nLastSampleHashes[i]) * 1000.0 / (nNow - nLastSampleTime) : 0;
+            nLastSampleHashes[i] = nTotal;
+        }
+        nLastSampleTime = nNow;
+    }
+    for (int i = 0; i < NUM_BLOCK_TYPES; i++)
+        stats.hashesPerSec[i] = hashesPerSec[i];
+    stats.scryptHashesPerSec = hashesPerSec[POW_MINER_HASH_SCRYPT];
+    return stats;
+}
+
+CPowMiner powMiner;
+
+} // namespace
+
+void StartPowMiner(int nThreads, POW_TYPE powType, const CScript& coinbaseScript)
+{
+    powMiner.Start(nThreads, powType, coinbaseScript);
+}
+
+void StopPowMiner()
+{
+    powMiner.Stop();
+}
+
+CPowMinerStats GetPowMinerStats()
+{
+    return powMiner.GetStats();
+}
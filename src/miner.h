@@ -17,9 +17,8 @@
 class CBlockIndex;
 class CChainParams;
 class CScript;
+struct CTemplateSelection;
 
-class arith_uint256;    // PlexHive: Hive: Mining optimisations
-struct CBeeRange;       // PlexHive: Hive: Mining optimisations
 
 namespace Consensus { struct Params; };
 
@@ -29,10 +28,17 @@ static const bool DEFAULT_PRINTPRIORITY = false;
 static const int DEFAULT_HIVE_CHECK_DELAY = 1;
 static const int DEFAULT_HIVE_THREADS = -2;
 static const bool DEFAULT_HIVE_EARLY_OUT = true;
+static const int DEFAULT_HIVE_CHECK_NICE = 10;          // Scheduling niceness for bee check threads
+static const int HIVE_CHECK_CHUNK_SHA256 = 4096;        // Bees handed to a bee check thread at a time
+static const int HIVE_CHECK_CHUNK_MINOTAUR = 32;
 
 // PlexHive: MinotaurX+Hive1.2
 static const bool DEFAULT_HIVE_CONTRIB_CF = true;
 
+// PlexHive: MinotaurX+Hive1.2: Built-in pow miner defaults
+static const int DEFAULT_GENERATE_THREADS = -1;             // All available cores
+static const int POW_MINER_TEMPLATE_REFRESH_SECS = 30;      // Rebuild the template this often to pick up new mempool txs
+
 struct CBlockTemplate
 {
     CBlock block;
@@ -157,6 +163,11 @@ private:
     int64_t nLockTimeCutoff;
     const CChainParams& chainparams;
 
+    // PlexHive: Hive: Mining optimisations: Set while selecting for blockTemplateEngine
+    bool fCreatingSelection;
+    bool fSelectionForHive;
+    const CTemplateSelection* pselectionIn;     // Selection to take instead, while creating a Hive skeleton or checking a ready selection
+
 public:
     struct Options {
         Options();
@@ -172,12 +183,31 @@ public:
     // PlexHive: MinotaurX+Hive1.2: Accept POW_TYPE arg
     std::unique_ptr<CBlockTemplate> CreateNewBlock(const CScript& scriptPubKeyIn, bool fMineWitnessTx=true, const CScript* hiveProofScript=nullptr, const POW_TYPE powType=POW_TYPE_SHA256);
 
+    /** PlexHive: Hive: Mining optimisations: Select transactions for the next block
+      * as CreateNewBlock would for a pow block, or a Hive block if fHive, and
+      * check them in a block, for blockTemplateEngine. Returns false if the
+      * block wasn't valid. cs_main and mempool.cs must be held. */
+    bool CreateSelection(bool fHive, CTemplateSelection& selection);
+
+    /** PlexHive: Hive: Mining optimisations: Create a Hive block with the given
+      * proof and honey scripts from a checked selection, without checking the
+      * block itself, so the scripts can be placeholders to fill in once a bee
+      * is found. A ready selection from blockTemplateEngine is checked first.
+      * Returns null if no selection could be made. cs_main and mempool.cs must
+      * be held. */
+    std::unique_ptr<CBlockTemplate> CreateHiveSkeleton(const CScript& honeyScript, const CScript& hiveProofScript);
+
 private:
     // utility functions
     /** Clear the block's state and prepare for assembling a new block */
     void resetBlock();
     /** Add a tx to the block */
     void AddToBlock(CTxMemPool::txiter iter);
+    /** PlexHive: Hive: Mining optimisations: Add the transactions of a selection from blockTemplateEngine to the block */
+    void AddSelection(const CTemplateSelection& selection);
+    /** PlexHive: Hive: Mining optimisations: Check a ready selection from blockTemplateEngine as CreateSelection
+      * checks the selections it makes, for a pow block, or a Hive block if fHive */
+    bool CheckSelection(bool fHive, const CTemplateSelection& selection);
 
     // Methods for how to add transactions to a block.
     /** Add transactions based on feerate including unconfirmed ancestors
@@ -212,8 +242,56 @@ int64_t UpdateTime(CBlockHeader* pblock, const Consensus::Params& consensusParam
 
 void BeeKeeper(const CChainParams& chainparams);                        // PlexHive: Hive: Bee management thread
 bool BusyBees(const Consensus::Params& consensusParams, int height);    // PlexHive: Hive: Attempt to mint the next block
-void CheckBin(int threadID, std::vector<CBeeRange> bin, std::string deterministicRandString, arith_uint256 beeHashTarget); // PlexHive: Hive: Mining optimisations: Thread to process a bin of beeranges
-void CheckBinMinotaurX(int threadID, std::vector<CBeeRange> bin, std::string deterministicRandString, arith_uint256 beeHashTarget); // PlexHive: MinotaurX+Hive1.2: Use minotaur inner hash for hive
-void AbortWatchThread(int height);                                      // PlexHive: Hive: Mining optimisations: Thread to watch for abort conditions
+
+// PlexHive: Hive: Mining optimisations: BeeKeeper reaction latencies
+struct CHiveLatency
+{
+    static const int NUM_BUCKETS = 24;      // Bucket i counts samples under 2^(i+1) micros, and the last everything above
+
+    uint64_t nCount;
+    int64_t nLastMicros;
+    int64_t nMaxMicros;
+    int64_t nTotalMicros;
+    uint64_t vBuckets[NUM_BUCKETS];
+
+    CHiveLatency() : nCount(0), nLastMicros(0), nMaxMicros(0), nTotalMicros(0), vBuckets() {}
+    void Add(int64_t nMicros);
+    /** Upper bound in micros of the samples in bucket i, or -1 if it has none */
+    static int64_t BucketMax(int i) { return i < NUM_BUCKETS - 1 ? ((int64_t)2 << i) - 1 : -1; }
+};
+
+/** Get latencies from tip change notification to bee check start, from new block to the bee check being abandoned, and from a bee being found to its block being submitted */
+void GetHiveLatencyStats(CHiveLatency& tipToCheck, CHiveLatency& blockToAbort, CHiveLatency& solutionToSubmit);
+
+// PlexHive: Hive: Mining optimisations: Outcome of a bee check round
+struct CHiveRoundStats
+{
+    uint64_t nBees;             // Bees checked (fewer than the hive's total if the round ended early)
+    int nThreads;
+    int64_t nMicros;            // Start of round to last thread finishing
+    int64_t nTailMicros;        // First thread running out of work to last thread finishing
+
+    CHiveRoundStats() : nBees(0), nThreads(0), nMicros(0), nTailMicros(0) {}
+    double BeesPerSec() const { return nMicros > 0 ? nBees * 1000000.0 / nMicros : 0; }
+};
+
+CHiveRoundStats GetLastHiveRoundStats();
+
+// PlexHive: MinotaurX+Hive1.2: Built-in multi-threaded pow miner, for driving regtest and testnet
+struct CPowMinerStats
+{
+    bool fRunning;
+    int nThreads;
+    POW_TYPE powType;
+    uint64_t nBlocksFound;                      // Since startup
+    double hashesPerSec[NUM_BLOCK_TYPES];       // Over the interval since the previous sample
+    double scryptHashesPerSec;                  // ... of pre-fork blocks, which are hashed with scrypt
+};
+
+/** Start (or restart) the pow miner with nThreads workers (-1 for all cores) mining powType blocks paying to coinbaseScript */
+void StartPowMiner(int nThreads, POW_TYPE powType, const CScript& coinbaseScript);
+/** Stop the pow miner and wait for its threads to exit */
+void StopPowMiner();
+CPowMinerStats GetPowMinerStats();
 
 #endif // BITCOIN_MINER_H
@@ -14,6 +14,7 @@
 #include <hash.h>
 #include <limitedmap.h>
 #include <netaddress.h>
+#include <netio.h>
 #include <policy/feerate.h>
 #include <protocol.h>
 #include <random.h>
@@ -114,7 +115,7 @@ struct CSerializedNetMsg
 };
 
 class NetEventsInterface;
-class CConnman
+class CConnman : private CNetIoHandler
 {
 public:
 
@@ -145,6 +146,7 @@ public:
         bool m_use_addrman_outgoing = true;
         std::vector<std::string> m_specified_outgoing;
         std::vector<std::string> m_added_nodes;
+        int nNetThreads = DEFAULT_NET_THREADS;
     };
 
     void Init(const Options& connOptions) {
@@ -168,6 +170,7 @@ public:
             LOCK(cs_vAddedNodes);
             vAddedNodes = connOptions.m_added_nodes;
         }
+        nNetThreads = connOptions.nNetThreads;
     }
 
     CConnman(uint64_t seed0, uint64_t seed1);
@@ -331,6 +334,17 @@ private:
     void ThreadOpenConnections(std::vector<std::string> connect);
     void ThreadMessageHandler();
     void AcceptConnection(const ListenSocket& hListenSocket);
+    void DisconnectNodes();
+    void NotifyNumConnectionsChanged(unsigned int& nPrevNodeCount);
+    void InactivityCheck(CNode* pnode);
+    /** Wait for and handle socket events, returning false if the thread's been interrupted */
+#ifdef USE_EPOLL
+    bool SocketHandlerEpoll();
+#else
+    bool SocketHandlerSelect();
+#endif
+    /** Start serving a new node's socket, before it's added to vNodes */
+    void AddNodeSocket(CNode* pnode);
     void ThreadSocketHandler();
     void ThreadDNSAddressSeed();
 
@@ -350,6 +364,17 @@ private:
     NodeId GetNewNodeId();
 
     size_t SocketSendData(CNode *pnode) const;
+    /**
+     * Receive what one recv() gives from pnode's socket, handing complete
+     * messages to the message handler. Returns false if nothing was read,
+     * as the socket would block or has closed.
+     */
+    bool SocketRecvData(CNode* pnode);
+
+    // CNetIoHandler, for the I/O threads
+    ReadResult SocketReadable(void* conn) override;
+    void SocketWritable(void* conn) override;
+    void SocketRemoved(void* conn) override;
     //!check is the banlist has unwritten changes
     bool BannedSetIsDirty();
     //!set the "dirty" flag for the banlist
@@ -429,6 +454,13 @@ private:
 
     std::thread threadDNSAddressSeed;
     std::thread threadSocketHandler;
+
+    /** Threads serving peers' sockets, where epoll's available */
+    int nNetThreads;
+#ifdef USE_EPOLL
+    std::unique_ptr<CNetIoThreads> netio;
+    int64_t nLastInactivityCheck;   // Only used by threadSocketHandler
+#endif
     std::thread threadOpenAddedConnections;
     std::thread threadOpenConnections;
     std::thread threadMessageHandler;
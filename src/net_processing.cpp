@@ -8,6 +8,7 @@
 #include <addrman.h>
 #include <arith_uint256.h>
 #include <blockencodings.h>
+#include <blockcache.h>
 #include <chainparams.h>
 #include <consensus/validation.h>
 #include <hash.h>
@@ -1107,8 +1108,14 @@ void static ProcessGetBlockData(CNode* pfrom, const Consensus::Params& consensus
     if (send && (mi->second->nStatus & BLOCK_HAVE_DATA))
     {
         std::shared_ptr<const CBlock> pblock;
+        SerializedBlockRef pserialized;
         if (a_recent_block && a_recent_block->GetHash() == (*mi).second->GetBlockHash()) {
             pblock = a_recent_block;
+        } else if (inv.type == MSG_BLOCK || inv.type == MSG_WITNESS_BLOCK) {
+            // Send the bytes other peers asking for this block were sent
+            pserialized = blockServeCache.Get((*mi).second, inv.type == MSG_WITNESS_BLOCK, consensusParams);
+            if (!pserialized)
+                assert(!"cannot load block from disk");
         } else {
             // Send block from disk
             std::shared_ptr<CBlock> pblockRead = std::make_shared<CBlock>();
@@ -1116,7 +1123,12 @@ void static ProcessGetBlockData(CNode* pfrom, const Consensus::Params& consensus
                 assert(!"cannot load block from disk");
             pblock = pblockRead;
         }
-        if (inv.type == MSG_BLOCK)
+        if (pserialized) {
+            CSerializedNetMsg msg;
+            msg.command = NetMsgType::BLOCK;
+            msg.data = *pserialized;
+            connman->PushMessage(pfrom, std::move(msg));
+        } else if (inv.type == MSG_BLOCK)
             connman->PushMessage(pfrom, msgMaker.Make(SERIALIZE_TRANSACTION_NO_WITNESS, NetMsgType::BLOCK, *pblock));
         else if (inv.type == MSG_WITNESS_BLOCK)
             connman->PushMessage(pfrom, msgMaker.Make(NetMsgType::BLOCK, *pblock));
@@ -2152,31 +2164,49 @@ bool static ProcessMessage(CNode* pfrom, const std::string& strCommand, CDataStr
                 tx.GetHash().ToString(),
                 mempool.size(), mempool.DynamicMemoryUsage() / 1000);
 
-            // Recursively process any orphan transactions that depended on this one
+            // Recursively process any orphan transactions that depended on this one.
+            // Each round accepts the orphans spending what the last round accepted
+            // as one batch, so their scripts are checked concurrently.
             std::set<NodeId> setMisbehaving;
             while (!vWorkQueue.empty()) {
-                auto itByPrev = mapOrphanTransactionsByPrev.find(vWorkQueue.front());
-                vWorkQueue.pop_front();
-                if (itByPrev == mapOrphanTransactionsByPrev.end())
-                    continue;
-                for (auto mi = itByPrev->second.begin();
-                     mi != itByPrev->second.end();
-                     ++mi)
-                {
-                    const CTransactionRef& porphanTx = (*mi)->second.tx;
-                    const CTransaction& orphanTx = *porphanTx;
+                std::vector<CTxToAccept> vOrphans;
+                std::vector<NodeId> vFromPeer;
+                std::set<uint256> setQueued;
+                for (const COutPoint& outpoint : vWorkQueue) {
+                    auto itByPrev = mapOrphanTransactionsByPrev.find(outpoint);
+                    if (itByPrev == mapOrphanTransactionsByPrev.end())
+                        continue;
+                    for (auto mi = itByPrev->second.begin();
+                         mi != itByPrev->second.end();
+                         ++mi)
+                    {
+                        const CTransactionRef& porphanTx = (*mi)->second.tx;
+                        NodeId fromPeer = (*mi)->second.fromPeer;
+                        if (setMisbehaving.count(fromPeer))
+                            continue;
+                        // An orphan spending several of the outputs is only tried once
+                        if (!setQueued.insert(porphanTx->GetHash()).second || mempool.exists(porphanTx->GetHash()))
+                            continue;
+                        vOrphans.emplace_back(porphanTx, GetTime());
+                        vFromPeer.push_back(fromPeer);
+                    }
+                }
+                vWorkQueue.clear();
+                if (vOrphans.empty())
+                    break;
+
+                AcceptToMemoryPoolMany(mempool, vOrphans, false /* bypass_limits */, 0 /* nAbsurdFee */, &lRemovedTxn);
+
+                for (size_t nOrphan = 0; nOrphan < vOrphans.size(); nOrphan++) {
+                    const CTransaction& orphanTx = *vOrphans[nOrphan].tx;
                     const uint256& orphanHash = orphanTx.GetHash();
-                    NodeId fromPeer = (*mi)->second.fromPeer;
-                    bool fMissingInputs2 = false;
+                    NodeId fromPeer = vFromPeer[nOrphan];
                     // Use a dummy CValidationState so someone can't setup nodes to counter-DoS based on orphan
                     // resolution (that is, feeding people an invalid transaction based on LegitTxX in order to get
                     // anyone relaying LegitTxX banned)
-                    CValidationState stateDummy;
-
+                    const CValidationState& stateDummy = vOrphans[nOrphan].state;
 
-                    if (setMisbehaving.count(fromPeer))
-                        continue;
-                    if (AcceptToMemoryPool(mempool, stateDummy, porphanTx, &fMissingInputs2, &lRemovedTxn, false /* bypass_limits */, 0 /* nAbsurdFee */)) {
+                    if (vOrphans[nOrphan].fAccepted) {
                         LogPrint(BCLog::MEMPOOL, "   accepted orphan tx %s\n", orphanHash.ToString());
                         RelayTransaction(orphanTx, connman);
                         for (unsigned int i = 0; i < orphanTx.vout.size(); i++) {
@@ -2184,7 +2214,12 @@ bool static ProcessMessage(CNode* pfrom, const std::string& strCommand, CDataStr
                         }
                         vEraseQueue.push_back(orphanHash);
                     }
-                    else if (!fMissingInputs2)
+                    else if (setMisbehaving.count(fromPeer))
+                    {
+                        // Left alone, as the peer's later orphans would have been had they been tried one at a time
+                        continue;
+                    }
+                    else if (!vOrphans[nOrphan].fMissingInputs)
                     {
                         int nDos = 0;
                         if (stateDummy.IsInvalid(nDos) && nDos > 0)
@@ -2206,8 +2241,8 @@ bool static ProcessMessage(CNode* pfrom, const std::string& strCommand, CDataStr
                             recentRejects->insert(orphanHash);
                         }
                     }
-                    mempool.check(pcoinsTip.get());
                 }
+                mempool.check(pcoinsTip.get());
             }
 
             for (uint256 hash : vEraseQueue)
@@ -0,0 +1,242 @@
+// Copyright (c) 2026 The PlexHive Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <netio.h>
+
+#ifdef USE_EPOLL
+
+#include <util.h>
+#include <utiltime.h>
+
+#include <algorithm>
+#include <assert.h>
+#include <errno.h>
+#include <functional>
+#include <mutex>
+#include <set>
+#include <string.h>
+#include <thread>
+#include <unordered_map>
+
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+/** epoll data of a thread's wakeup eventfd; connection ids are never negative */
+static const uint64_t WAKEUP_ID = ~(uint64_t)0;
+/** Events taken from epoll at once */
+static const int MAX_EPOLL_EVENTS = 256;
+
+struct CNetIoThreads::Shard
+{
+    int epfd;
+    int wakefd;
+    std::thread thread;
+
+    std::mutex cs;
+    std::unordered_map<int64_t, void*> mapConns;    // Guarded by cs
+    std::vector<void*> vRemoved;                    // Guarded by cs; connections removed and not yet handed back
+    bool fStop;                                     // Guarded by cs
+
+    // Only used by the shard's thread
+    std::set<int64_t> setReadMore;      // Left with more to read
+    std::set<int64_t> setReadPaused;    // Left unread, to try again
+    int64_t nLastRetry;
+
+    Shard() : epfd(-1), wakefd(-1), fStop(false), nLastRetry(0) {}
+
+    ~Shard()
+    {
+        if (epfd != -1)
+            close(epfd);
+        if (wakefd != -1)
+            close(wakefd);
+    }
+
+    void Wake()
+    {
+        uint64_t one = 1;
+        if (write(wakefd, &one, sizeof(one)) != sizeof(one) && errno != EAGAIN)
+            LogPrintf("%s: eventfd write failed: %s\n", __func__, strerror(errno));
+    }
+};
+
+CNetIoThreads::CNetIoThreads(CNetIoHandler& handlerIn) : handler(handlerIn) {}
+
+CNetIoThreads::~CNetIoThreads()
+{
+    Stop();
+}
+
+bool CNetIoThreads::Start(int nThreads)
+{
+    assert(shards.empty());
+    for (int i = 0; i < nThreads; i++) {
+        std::unique_ptr<Shard> shard(new Shard());
+        shard->epfd = epoll_create1(EPOLL_CLOEXEC);
+        shard->wakefd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (shard->epfd == -1 || shard->wakefd == -1) {
+            LogPrintf("%s: Couldn't create epoll instance: %s\n", __func__, strerror(errno));
+            Stop();
+            return false;
+        }
+        struct epoll_event event = {};
+        event.events = EPOLLIN;
+        event.data.u64 = WAKEUP_ID;
+        if (epoll_ctl(shard->epfd, EPOLL_CTL_ADD, shard->wakefd, &event) == -1) {
+            LogPrintf("%s: Couldn't wait on eventfd: %s\n", __func__, strerror(errno));
+            Stop();
+            return false;
+        }
+        shards.push_back(std::move(shard));
+    }
+    for (const std::unique_ptr<Shard>& shard : shards)
+        shard->thread = std::thread(&TraceThread<std::function<void()>>, "netio", std::function<void()>(std::bind(&CNetIoThreads::ThreadIo, this, std::ref(*shard))));
+    return true;
+}
+
+void CNetIoThreads::Stop()
+{
+    for (const std::unique_ptr<Shard>& shard : shards) {
+        {
+            std::lock_guard<std::mutex> lock(shard->cs);
+            shard->fStop = true;
+        }
+        if (shard->thread.joinable()) {
+            shard->Wake();
+            shard->thread.join();
+        }
+        for (void* conn : shard->vRemoved)
+            handler.SocketRemoved(conn);
+        for (const auto& entry : shard->mapConns)
+            handler.SocketRemoved(entry.second);
+    }
+    shards.clear();
+}
+
+bool CNetIoThreads::Add(int64_t id, SOCKET hSocket, void* conn)
+{
+    assert(id >= 0 && !shards.empty());
+    Shard& shard = *shards[id % shards.size()];
+    {
+        std::lock_guard<std::mutex> lock(shard.cs);
+        shard.mapConns[id] = conn;
+    }
+    // Registered after the connection's known, so no event for it can go unclaimed
+    struct epoll_event event = {};
+    event.events = EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLET;
+    event.data.u64 = id;
+    if (epoll_ctl(shard.epfd, EPOLL_CTL_ADD, hSocket, &event) == -1) {
+        LogPrintf("%s: Couldn't wait on socket: %s\n", __func__, strerror(errno));
+        std::lock_guard<std::mutex> lock(shard.cs);
+        shard.mapConns.erase(id);
+        return false;
+    }
+    return true;
+}
+
+void CNetIoThreads::Remove(int64_t id)
+{
+    Shard& shard = *shards[id % shards.size()];
+    {
+        std::lock_guard<std::mutex> lock(shard.cs);
+        auto it = shard.mapConns.find(id);
+        if (it == shard.mapConns.end())
+            return;
+        // The socket itself is left alone: it may already be closed, and its number reused
+        shard.vRemoved.push_back(it->second);
+        shard.mapConns.erase(it);
+    }
+    shard.Wake();
+}
+
+void CNetIoThreads::ThreadIo(Shard& shard)
+{
+    struct Ready {
+        int64_t id;
+        void* conn;
+        bool fRead;
+        bool fWrite;
+    };
+    std::vector<struct epoll_event> events(MAX_EPOLL_EVENTS);
+    std::vector<Ready> vReady;
+    std::vector<void*> vRemoved;
+
+    while (true) {
+        int nTimeout = -1;
+        if (!shard.setReadMore.empty())
+            nTimeout = 0;
+        else if (!shard.setReadPaused.empty())
+            nTimeout = std::max<int64_t>(0, shard.nLastRetry + NET_IO_RETRY_INTERVAL - GetTimeMillis());
+        int nEvents = epoll_wait(shard.epfd, events.data(), events.size(), nTimeout);
+        if (nEvents == -1) {
+            if (errno != EINTR)
+                LogPrintf("%s: epoll_wait failed: %s\n", __func__, strerror(errno));
+            nEvents = 0;
+        }
+
+        const int64_t nNow = GetTimeMillis();
+        const bool fRetryPaused = nNow >= shard.nLastRetry + NET_IO_RETRY_INTERVAL;
+        vReady.clear();
+        {
+            std::lock_guard<std::mutex> lock(shard.cs);
+            if (shard.fStop)
+                return;
+            vRemoved.swap(shard.vRemoved);
+
+            for (int i = 0; i < nEvents; i++) {
+                const struct epoll_event& event = events[i];
+                if (event.data.u64 == WAKEUP_ID) {
+                    uint64_t count;
+                    while (read(shard.wakefd, &count, sizeof(count)) == sizeof(count)) {}
+                    continue;
+                }
+                const int64_t id = event.data.u64;
+                auto it = shard.mapConns.find(id);
+                if (it == shard.mapConns.end())
+                    continue;
+                vReady.push_back(Ready{id, it->second, (event.events & (EPOLLIN | EPOLLRDHUP | EPOLLERR | EPOLLHUP)) != 0, (event.events & EPOLLOUT) != 0});
+            }
+
+            // Sockets left with data to read get no new event for it, so are read again here
+            std::set<int64_t> setRetry;
+            setRetry.swap(shard.setReadMore);
+            if (fRetryPaused) {
+                setRetry.insert(shard.setReadPaused.begin(), shard.setReadPaused.end());
+                shard.setReadPaused.clear();
+                shard.nLastRetry = nNow;
+            }
+            for (const int64_t id : setRetry) {
+                auto it = shard.mapConns.find(id);
+                if (it != shard.mapConns.end())
+                    vReady.push_back(Ready{id, it->second, true, false});
+            }
+        }
+
+        for (const Ready& ready : vReady) {
+            // Write first, so a peer that's stopped reading isn't sent more until it drains what it has
+            if (ready.fWrite)
+                handler.SocketWritable(ready.conn);
+            if (ready.fRead && !shard.setReadMore.count(ready.id)) {
+                switch (handler.SocketReadable(ready.conn)) {
+                case CNetIoHandler::READ_DONE:
+                    shard.setReadPaused.erase(ready.id);
+                    break;
+                case CNetIoHandler::READ_MORE:
+                    shard.setReadMore.insert(ready.id);
+                    break;
+                case CNetIoHandler::READ_PAUSED:
+                    shard.setReadPaused.insert(ready.id);
+                    break;
+                }
+            }
+        }
+
+        for (void* conn : vRemoved)
+            handler.SocketRemoved(conn);
+        vRemoved.clear();
+    }
+}
+
+#endif // USE_EPOLL
@@ -0,0 +1,96 @@
+// Copyright (c) 2026 The PlexHive Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_NETIO_H
+#define BITCOIN_NETIO_H
+
+#include <compat.h>
+
+#include <memory>
+#include <stdint.h>
+#include <vector>
+
+/** Default for -netthreads, the threads reading and writing peers' sockets */
+static const int DEFAULT_NET_THREADS = 2;
+static const int MAX_NET_THREADS = 16;
+/** How often a socket whose reading was paused is tried again, in milliseconds */
+static const int NET_IO_RETRY_INTERVAL = 50;
+
+/**
+ * What a CNetIoThreads does with the sockets it serves. Calls for one
+ * connection always come from the same thread, one at a time.
+ */
+class CNetIoHandler
+{
+public:
+    enum ReadResult {
+        READ_DONE,      //!< Read until the socket would block, or found it closed
+        READ_MORE,      //!< Stopped with more to read, to be called again once the others have had a turn
+        READ_PAUSED,    //!< Not reading for now, to be called again after NET_IO_RETRY_INTERVAL
+    };
+
+    virtual ~CNetIoHandler() {}
+
+    /** conn's socket has data to read, or an error or hangup to find */
+    virtual ReadResult SocketReadable(void* conn) = 0;
+    /** conn's socket has room to send more */
+    virtual void SocketWritable(void* conn) = 0;
+    /** conn's been removed, and no more calls will be made for it */
+    virtual void SocketRemoved(void* conn) = 0;
+};
+
+#ifdef USE_EPOLL
+
+/**
+ * Serves sockets from a pool of threads waiting on epoll.
+ *
+ * Each connection is given to one thread, by its id, and waited on
+ * edge-triggered for both reading and writing, so a thread's work per pass
+ * is in proportion to the sockets that became ready rather than to all it
+ * serves, and there's no limit on socket numbers as there is with select().
+ * As readiness is only reported when it changes, a handler has to read until
+ * the socket would block, or say why it didn't; sockets it left data on are
+ * called again on a later pass.
+ *
+ * A socket may be closed before its connection's removed; the kernel drops
+ * it from the epoll set on closing, and it isn't waited on again.
+ */
+class CNetIoThreads
+{
+private:
+    struct Shard;
+
+    CNetIoHandler& handler;
+    std::vector<std::unique_ptr<Shard>> shards;
+
+    void ThreadIo(Shard& shard);
+
+public:
+    explicit CNetIoThreads(CNetIoHandler& handlerIn);
+    ~CNetIoThreads();
+
+    CNetIoThreads(const CNetIoThreads&) = delete;
+    CNetIoThreads& operator=(const CNetIoThreads&) = delete;
+
+    /** Start nThreads threads, returning false if their epoll instances couldn't be created */
+    bool Start(int nThreads);
+    /** Stop the threads, and remove all connections */
+    void Stop();
+    int GetThreadCount() const { return shards.size(); }
+
+    /**
+     * Serve hSocket, which must be open and non-blocking, for connection id
+     * until Remove(id). Returns false if it couldn't be waited on.
+     */
+    bool Add(int64_t id, SOCKET hSocket, void* conn);
+    /**
+     * Stop serving connection id. Calls already under way for it may still
+     * be made until SocketRemoved(), once its thread's done with it.
+     */
+    void Remove(int64_t id);
+};
+
+#endif // USE_EPOLL
+
+#endif // BITCOIN_NETIO_H
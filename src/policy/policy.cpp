@@ -121,7 +121,7 @@ bool IsStandardTx(const CTransaction& tx, std::string& reason, const bool witnes
     txnouttype whichType;
 
     const Consensus::Params& consensusParams = Params().GetConsensus();     // PlexHive: Hive
-    CScript scriptPubKeyBCF = GetScriptForDestination(DecodeDestination(consensusParams.beeCreationAddress));   // PlexHive: Hive
+    const CScript& scriptPubKeyBCF = consensusParams.scriptPubKeyBCF;   // PlexHive: Hive
 
     for (const CTxOut& txout : tx.vout) {
         if (CScript::IsBCTScript(txout.scriptPubKey, scriptPubKeyBCF))      // PlexHive: Hive
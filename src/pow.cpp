@@ -18,8 +18,12 @@
 #include <sync.h>               // PlexHive: Hive
 #include <validation.h>         // PlexHive: Hive
 #include <utilstrencodings.h>   // PlexHive: Hive
+#include <beehash.h>            // PlexHive: Hive
+#include <beepopindex.h>        // PlexHive: Hive
+#include <bctindex.h>           // PlexHive: Hive
+#include <blockfilereader.h>    // PlexHive: Hive
 
-BeePopGraphPoint beePopGraph[1024*40];       // PlexHive: Hive
+#include <list>                 // PlexHive: Hive
 
 // PlexHive: MinotaurX+Hive1.2: Diff adjustment for pow algos (post-MinotaurX activation)
 // Modified LWMA-3
@@ -55,30 +59,25 @@ unsigned int GetNextWorkRequiredLWMA(const CBlockIndex* pindexLast, const CBlock
     int64_t sumWeightedSolvetimes = 0, j = 0, blocksFound = 0;
 
     // Find previousTimestamp (N blocks of this blocktype back), and build list of wanted-type blocks as we go
+    // PlexHive: Hive: Hop straight between blocks of this type with the hive skip links
     std::vector<const CBlockIndex*> wantedBlocks;
     const CBlockIndex* blockPreviousTimestamp = pindexLast;
+    if (blockPreviousTimestamp->IsHiveMined(params) || blockPreviousTimestamp->GetPoWType() != powType)
+        blockPreviousTimestamp = blockPreviousTimestamp->pprevPoWType[powType];
     while (blocksFound < N) {
         // Reached forkpoint before finding N blocks of correct powtype? Return min
-        if (blockPreviousTimestamp->GetBlockHeader().nVersion >= 0x20000000) {
-            if (verbose) LogPrintf("* GetNextWorkRequiredLWMA: Allowing %s pow limit (previousTime calc reached forkpoint at height %i)\n", POW_TYPE_NAMES[powType], blockPreviousTimestamp->nHeight);
+        if (!blockPreviousTimestamp || pindexLast->nLastLegacyVersionHeight >= blockPreviousTimestamp->nHeight) {
+            if (verbose) LogPrintf("* GetNextWorkRequiredLWMA: Allowing %s pow limit (previousTime calc reached forkpoint at height %i)\n", POW_TYPE_NAMES[powType], pindexLast->nLastLegacyVersionHeight);
             return powLimit.GetCompact();
         }
 
-        // Wrong block type? Skip
-        if (blockPreviousTimestamp->GetBlockHeader().IsHiveMined(params) || blockPreviousTimestamp->GetBlockHeader().GetPoWType() != powType) {
-            assert (blockPreviousTimestamp->pprev);
-            blockPreviousTimestamp = blockPreviousTimestamp->pprev;
-            continue;
-        }
-    
         wantedBlocks.push_back(blockPreviousTimestamp);
 
         blocksFound++;
         if (blocksFound == N)   // Don't step to next one if we're at the one we want
             break;
 
-        assert (blockPreviousTimestamp->pprev);
-        blockPreviousTimestamp = blockPreviousTimestamp->pprev;
+        blockPreviousTimestamp = blockPreviousTimestamp->pprevPoWType[powType];
     }
     previousTimestamp = blockPreviousTimestamp->GetBlockTime();
     //if (verbose) LogPrintf("* GetNextWorkRequiredLWMA: previousTime: First in period is %s at height %i\n", blockPreviousTimestamp->GetBlockHeader().GetHash().ToString().c_str(), blockPreviousTimestamp->nHeight);
@@ -131,10 +130,9 @@ unsigned int DarkGravityWave(const CBlockIndex* pindexLast, const CBlockHeader *
 
     // PlexHive: Hive 1.1: Skip over Hivemined blocks at tip
     if (IsHive11Enabled(pindexLast, params)) {
-        while (pindexLast->GetBlockHeader().IsHiveMined(params)) {
-            //LogPrintf("DarkGravityWave: Skipping hivemined block at %i\n", pindex->nHeight);
-            assert(pindexLast->pprev); // should never fail
-            pindexLast = pindexLast->pprev;
+        if (pindexLast->IsHiveMined(params)) {
+            pindexLast = pindexLast->pprevPoW;  // PlexHive: Hive: Follow the hive skip link
+            assert(pindexLast); // should never fail
         }
     }
 
@@ -147,10 +145,9 @@ unsigned int DarkGravityWave(const CBlockIndex* pindexLast, const CBlockHeader *
 
     for (unsigned int nCountBlocks = 1; nCountBlocks <= nPastBlocks; nCountBlocks++) {
         // PlexHive: Hive: Skip over Hivemined blocks; we only want to consider PoW blocks
-        while (pindex->GetBlockHeader().IsHiveMined(params)) {
-            //LogPrintf("DarkGravityWave: Skipping hivemined block at %i\n", pindex->nHeight);
-            assert(pindex->pprev); // should never fail
-            pindex = pindex->pprev;
+        if (pindex->IsHiveMined(params)) {
+            pindex = pindex->pprevPoW;  // PlexHive: Hive: Follow the hive skip link
+            assert(pindex); // should never fail
         }
 
         arith_uint256 bnTarget = arith_uint256().SetCompact(pindex->nBits);
@@ -314,14 +311,21 @@ unsigned int GetNextHive11WorkRequired(const CBlockIndex* pindexLast, const Cons
     int totalBlockCount = 0;
 
     // Step back till we have found 24 hive blocks, or we ran out...
-    while (hiveBlockCount < params.hiveDifficultyWindow && pindexLast->pprev && pindexLast->nHeight >= params.minHiveCheckBlock) {
-        if (pindexLast->GetBlockHeader().IsHiveMined(params)) {
-            beeHashTarget += arith_uint256().SetCompact(pindexLast->nBits);
-            hiveBlockCount++;
-        }
-        totalBlockCount++;
-        pindexLast = pindexLast->pprev;
-    }
+    // PlexHive: Hive: Visit only the hive blocks, via the hive skip links. Blocks below lowestHeight
+    // (genesis, or below minHiveCheckBlock) end the walk.
+    const int lowestHeight = std::max(params.minHiveCheckBlock, 1);
+    const CBlockIndex* pindexHive = pindexLast->IsHiveMined(params) ? pindexLast : pindexLast->pprevHive;
+    const CBlockIndex* pindexOldest = nullptr;
+    while (hiveBlockCount < params.hiveDifficultyWindow && pindexHive && pindexHive->nHeight >= lowestHeight) {
+        beeHashTarget += arith_uint256().SetCompact(pindexHive->nBits);
+        hiveBlockCount++;
+        pindexOldest = pindexHive;
+        pindexHive = pindexHive->pprevHive;
+    }
+    if (hiveBlockCount == params.hiveDifficultyWindow)
+        totalBlockCount = pindexLast->nHeight - pindexOldest->nHeight + 1;
+    else
+        totalBlockCount = std::max(pindexLast->nHeight - lowestHeight + 1, 0);
 
     if (hiveBlockCount == 0) {          // Should only happen when chain is starting
         LogPrintf("GetNextHive11WorkRequired: No previous hive blocks found.\n");
@@ -350,19 +354,22 @@ unsigned int GetNextHive12WorkRequired(const CBlockIndex* pindexLast, const Cons
     int totalBlockCount = 0;
 
     // Step back till we have found 24 hive blocks, or we ran out...
-    while (hiveBlockCount < params.hiveDifficultyWindow && pindexLast->pprev && IsMinotaurXEnabled(pindexLast, params)) {        
-        if (pindexLast->GetBlockHeader().IsHiveMined(params)) {
-            beeHashTarget += arith_uint256().SetCompact(pindexLast->nBits);
-            hiveBlockCount++;
-        }
-        totalBlockCount++;
-        pindexLast = pindexLast->pprev;
+    // PlexHive: Hive: Visit only the hive blocks, via the hive skip links. MinotaurX activation is
+    // permanent, so if a hive block has it enabled, so do all the blocks after it.
+    const CBlockIndex* pindexHive = pindexLast->IsHiveMined(params) ? pindexLast : pindexLast->pprevHive;
+    const CBlockIndex* pindexOldest = nullptr;
+    while (hiveBlockCount < params.hiveDifficultyWindow && pindexHive && pindexHive->pprev && IsMinotaurXEnabled(pindexHive, params)) {
+        beeHashTarget += arith_uint256().SetCompact(pindexHive->nBits);
+        hiveBlockCount++;
+        pindexOldest = pindexHive;
+        pindexHive = pindexHive->pprevHive;
     }
 
     if (hiveBlockCount < params.hiveDifficultyWindow) {          // Should only happen when chain is starting
         LogPrintf("GetNextHive12WorkRequired: Insufficient hive blocks.\n");
         return bnPowLimit.GetCompact();
     }
+    totalBlockCount = pindexLast->nHeight - pindexOldest->nHeight + 1;
 
     beeHashTarget /= hiveBlockCount;    // Average the bee hash targets in window
 
@@ -392,24 +399,15 @@ unsigned int GetNextHiveWorkRequired(const CBlockIndex* pindexLast, const Consen
 
     //LogPrintf("GetNextHiveWorkRequired: Height     = %i\n", pindexLast->nHeight);
 
-    int numPowBlocks = 0;
-    CBlockHeader block;
-    while (true) {
-        if (!pindexLast->pprev || pindexLast->nHeight < params.minHiveCheckBlock) {   // Ran out of blocks without finding a Hive block? Return min target
-            LogPrintf("GetNextHiveWorkRequired: No hivemined blocks found in history\n");
-            //LogPrintf("GetNextHiveWorkRequired: This target= %s\n", bnPowLimit.ToString());
-            return bnPowLimit.GetCompact();
-        }
-
-        block = pindexLast->GetBlockHeader();
-        if (block.IsHiveMined(params)) {  // Found the last Hive block; pick up its bee hash target
-            beeHashTarget.SetCompact(block.nBits);
-            break;
-        }
-
-        pindexLast = pindexLast->pprev;
-        numPowBlocks++;
+    // PlexHive: Hive: Jump to the last Hive block with the hive skip links
+    const CBlockIndex* pindexHive = pindexLast->IsHiveMined(params) ? pindexLast : pindexLast->pprevHive;
+    if (!pindexHive || !pindexHive->pprev || pindexHive->nHeight < params.minHiveCheckBlock) {   // Ran out of blocks without finding a Hive block? Return min target
+        LogPrintf("GetNextHiveWorkRequired: No hivemined blocks found in history\n");
+        //LogPrintf("GetNextHiveWorkRequired: This target= %s\n", bnPowLimit.ToString());
+        return bnPowLimit.GetCompact();
     }
+    beeHashTarget.SetCompact(pindexHive->nBits);    // Found the last Hive block; pick up its bee hash target
+    int numPowBlocks = pindexLast->nHeight - pindexHive->nHeight;
 
     //LogPrintf("GetNextHiveWorkRequired: powBlocks  = %i\n", numPowBlocks);
     if (numPowBlocks == 0)
@@ -432,7 +430,7 @@ unsigned int GetNextHiveWorkRequired(const CBlockIndex* pindexLast, const Consen
 }
 
 // PlexHive: Hive: Get count of all live and gestating BCTs on the network
-bool GetNetworkHiveInfo(int& immatureBees, int& immatureBCTs, int& matureBees, int& matureBCTs, CAmount& potentialLifespanRewards, const Consensus::Params& consensusParams, bool recalcGraph) {
+bool GetNetworkHiveInfo(int& immatureBees, int& immatureBCTs, int& matureBees, int& matureBCTs, CAmount& potentialLifespanRewards, const Consensus::Params& consensusParams, std::vector<BeePopGraphPoint>* popGraph) {
     int totalBeeLifespan = consensusParams.beeLifespanBlocks + consensusParams.beeGestationBlocks;
     immatureBees = immatureBCTs = matureBees = matureBCTs = 0;
     
@@ -451,101 +449,127 @@ bool GetNetworkHiveInfo(int& immatureBees, int& immatureBCTs, int& matureBees, i
     else
         potentialLifespanRewards = (consensusParams.beeLifespanBlocks * blockReward) / consensusParams.hiveBlockSpacingTargetTypical;
 
-    if (recalcGraph) {
-        for (int i = 0; i < totalBeeLifespan; i++) {
-            beePopGraph[i].immaturePop = 0;
-            beePopGraph[i].maturePop = 0;
-        }
-    }
+    if (popGraph)
+        popGraph->assign(totalBeeLifespan, BeePopGraphPoint{0, 0});
 
     if (IsInitialBlockDownload())   // Refuse if we're downloading
         return false;
 
-    // Count bees in next blockCount blocks
-    CBlock block;
-    CScript scriptPubKeyBCF = GetScriptForDestination(DecodeDestination(consensusParams.beeCreationAddress));
-    CScript scriptPubKeyCF = GetScriptForDestination(DecodeDestination(consensusParams.hiveCommunityAddress));
-
+    // PlexHive: Hive: Count bees in the last totalBeeLifespan blocks from the population index
+    std::vector<CBeePopEntry> entries;
+    CSequentialBlockReader blockReader(consensusParams);
     for (int i = 0; i < totalBeeLifespan; i++) {
-        if (fHavePruned && !(pindexPrev->nStatus & BLOCK_HAVE_DATA) && pindexPrev->nTx > 0) {
-            LogPrintf("! GetNetworkHiveInfo: Warn: Block not available (pruned data); can't calculate network bee count.");
+        CBeePopEntry entry;
+        if (!GetBlockBees(pindexPrev, consensusParams, entry, &blockReader))
             return false;
-        }
 
-        if (!pindexPrev->GetBlockHeader().IsHiveMined(consensusParams)) {                          // Don't check Hivemined blocks (no BCTs will be found in them)
-            if (!ReadBlockFromDisk(block, pindexPrev, consensusParams)) {
-                LogPrintf("! GetNetworkHiveInfo: Warn: Block not available (not found on disk); can't calculate network bee count.");
-                return false;
-            }
-            int blockHeight = pindexPrev->nHeight;
-            CAmount beeCost = GetBeeCost(blockHeight, consensusParams);
-            if (block.vtx.size() > 0) {
-                for(const auto& tx : block.vtx) {
-                    CAmount beeFeePaid;
-                    if (tx->IsBCT(consensusParams, scriptPubKeyBCF, &beeFeePaid)) {                 // If it's a BCT, total its bees
-                        if (tx->vout.size() > 1 && tx->vout[1].scriptPubKey == scriptPubKeyCF) {    // If it has a community fund contrib...
-                            CAmount donationAmount = tx->vout[1].nValue;
-                            CAmount expectedDonationAmount = (beeFeePaid + donationAmount) / consensusParams.communityContribFactor;  // ...check for valid donation amount
-                            // PlexHive: MinotaurX+Hive1.2
-                            if (IsMinotaurXEnabled(pindexPrev, consensusParams))
-                                expectedDonationAmount += expectedDonationAmount >> 1;
-                            if (donationAmount != expectedDonationAmount)
-                                continue;
-                            beeFeePaid += donationAmount;                                           // Add donation amount back to total paid
-                        }
-                        int beeCount = beeFeePaid / beeCost;
-                        if (i < consensusParams.beeGestationBlocks) {
-                            immatureBees += beeCount;
-                            immatureBCTs++;
-                        } else {
-                            matureBees += beeCount; 
-                            matureBCTs++;
-                        }
-
-                        // Add these bees to pop graph
-                        if (recalcGraph) {
-                            /*
-                            int beeStart = blockHeight + consensusParams.beeGestationBlocks;
-                            int beeStop = beeStart + consensusParams.beeLifespanBlocks;
-                            beeStart -= tipHeight;
-                            beeStop -= tipHeight;
-                            for (int j = beeStart; j < beeStop; j++) {
-                                if (j > 0 && j < totalBeeLifespan) {
-                                    if (i < consensusParams.beeGestationBlocks) // THIS IS WRONG
-                                        beePopGraph[j].immaturePop += beeCount;
-                                    else
-                                        beePopGraph[j].maturePop += beeCount;
-                                }
-                            }*/
-                            int beeBornBlock = blockHeight;
-                            int beeMaturesBlock = beeBornBlock + consensusParams.beeGestationBlocks;
-                            int beeDiesBlock = beeMaturesBlock + consensusParams.beeLifespanBlocks;
-                            for (int j = beeBornBlock; j < beeDiesBlock; j++) {
-                                int graphPos = j - tipHeight;
-                                if (graphPos > 0 && graphPos < totalBeeLifespan) {
-                                    if (j < beeMaturesBlock)
-                                        beePopGraph[graphPos].immaturePop += beeCount;
-                                    else
-                                        beePopGraph[graphPos].maturePop += beeCount;
-                                }
-                            }
-                        }
-                    }
-                }
+        if (entry.nBCTs > 0) {
+            if (i < consensusParams.beeGestationBlocks) {
+                immatureBees += entry.nBees;
+                immatureBCTs += entry.nBCTs;
+            } else {
+                matureBees += entry.nBees;
+                matureBCTs += entry.nBCTs;
             }
+            entries.push_back(entry);
         }
 
         if (!pindexPrev->pprev)     // Check we didn't run out of blocks
-            return true;
+            break;
 
         pindexPrev = pindexPrev->pprev;
     }
 
+    if (popGraph)
+        BuildBeePopGraph(entries, tipHeight, consensusParams, *popGraph);
+
+    return true;
+}
+
+std::string CHiveProofInputs::RandString() const
+{
+    std::string deterministicRandString;
+    for (const uint256& hash : vRandHashes)
+        deterministicRandString += hash.GetHex();
+    return deterministicRandString;
+}
+
+// PlexHive: Hive: Proof inputs for the parents Hive blocks were most recently checked or mined on, most
+// recent first. Only the tip and its competitors are asked for in practice, so a few will do.
+static const size_t HIVE_PROOF_INPUTS_CACHE_SIZE = 8;
+static std::list<std::pair<uint256, std::shared_ptr<const CHiveProofInputs>>> listHiveProofInputs;   // Guarded by cs_main
+
+// PlexHive: Hive: Get the proof inputs for Hive blocks built on pindexPrev, working them out if they aren't cached
+std::shared_ptr<const CHiveProofInputs> GetHiveProofInputs(const CBlockIndex* pindexPrev, const Consensus::Params& consensusParams)
+{
+    LOCK(cs_main);
+    const uint256 hashPrev = pindexPrev->GetBlockHash();
+    for (auto it = listHiveProofInputs.begin(); it != listHiveProofInputs.end(); it++) {
+        if (it->first == hashPrev) {
+            listHiveProofInputs.splice(listHiveProofInputs.begin(), listHiveProofInputs, it);
+            return it->second;
+        }
+    }
+
+    std::shared_ptr<CHiveProofInputs> inputs = std::make_shared<CHiveProofInputs>();
+    GetDeterministicRandHashes(pindexPrev, inputs->vRandHashes);
+    CHashWriter ss(SER_GETHASH, 0);
+    ss << inputs->RandString();
+    inputs->randStringHash = ss.GetHash();
+    inputs->nBeeBits = GetNextHiveWorkRequired(pindexPrev, consensusParams);
+    inputs->fMinotaurX = IsMinotaurXEnabled(pindexPrev, consensusParams);
+
+    listHiveProofInputs.emplace_front(hashPrev, inputs);
+    if (listHiveProofInputs.size() > HIVE_PROOF_INPUTS_CACHE_SIZE)
+        listHiveProofInputs.pop_back();
+    return inputs;
+}
+
+// PlexHive: Hive: Check the bee hash and message signature of a Hive proof
+bool CHiveProofCheck::operator()() const
+{
+    bool verbose = LogAcceptCategory(BCLog::HIVE);
+
+    arith_uint256 beeHashTarget;
+    beeHashTarget.SetCompact(inputs->nBeeBits);
+
+    // PlexHive: MinotaurX+Hive1.2: Use the correct inner Hive hash
+    // PlexHive: Hive: Share the miner's bee hash kernel
+    arith_uint256 beeHash = CBeeHasher(inputs->RandString(), txidStr, inputs->fMinotaurX).GetBeeHash(beeNonce);
+    if (!inputs->fMinotaurX) {
+        if (verbose)
+            LogPrintf("CheckHiveProof: beeHash             = %s\n", beeHash.GetHex());
+        if (beeHash >= beeHashTarget) {
+            LogPrintf("CheckHiveProof: Bee does not meet hash target!\n");
+            return false;
+        }
+    } else {
+        if (verbose)
+            LogPrintf("CheckHive12Proof: beeHash           = %s\n", beeHash.GetHex());
+        if (beeHash >= beeHashTarget) {
+            LogPrintf("CheckHive12Proof: Bee does not meet hash target!\n");
+            return false;
+        }
+    }
+
+    // Verify the message sig
+    CPubKey pubkey;
+    if (!pubkey.RecoverCompact(inputs->randStringHash, messageSig)) {
+        LogPrintf("CheckHiveProof: Couldn't recover pubkey from hash\n");
+        return false;
+    }
+    if (pubkey.GetID() != keyID) {
+        LogPrintf("CheckHiveProof: Signature mismatch! GetID() = %s, *keyID = %s\n", pubkey.GetID().ToString(), keyID.ToString());
+        return false;
+    }
+
     return true;
 }
 
 // PlexHive: Hive: Check the hive proof for given block
-bool CheckHiveProof(const CBlock* pblock, const Consensus::Params& consensusParams) {
+// PlexHive: Hive: If pvChecks is given, the bee hash and signature checks are appended to it for
+// the caller to run, rather than run here
+bool CheckHiveProof(const CBlock* pblock, const Consensus::Params& consensusParams, std::vector<CHiveProofCheck>* pvChecks) {
     bool verbose = LogAcceptCategory(BCLog::HIVE);
 
     if (verbose)
@@ -556,8 +580,9 @@ bool CheckHiveProof(const CBlock* pblock, const Consensus::Params& consensusPara
     CBlockIndex* pindexPrev;
     {
         LOCK(cs_main);
-        pindexPrev = mapBlockIndex[pblock->hashPrevBlock];
-        blockHeight = pindexPrev->nHeight + 1;
+        BlockMap::iterator mi = mapBlockIndex.find(pblock->hashPrevBlock);
+        pindexPrev = mi == mapBlockIndex.end() ? nullptr : mi->second;
+        blockHeight = pindexPrev ? pindexPrev->nHeight + 1 : 0;
     }
     if (!pindexPrev) {
         LogPrintf("CheckHiveProof: Couldn't get previous block's CBlockIndex!\n");
@@ -574,13 +599,7 @@ bool CheckHiveProof(const CBlock* pblock, const Consensus::Params& consensusPara
 
     // PlexHive: Hive 1.1: Check that there aren't too many consecutive Hive blocks
     if (IsHive11Enabled(pindexPrev, consensusParams)) {
-        int hiveBlocksAtTip = 0;
-        CBlockIndex* pindexTemp = pindexPrev;
-        while (pindexTemp->GetBlockHeader().IsHiveMined(consensusParams)) {
-            assert(pindexTemp->pprev);
-            pindexTemp = pindexTemp->pprev;
-            hiveBlocksAtTip++;
-        }
+        int hiveBlocksAtTip = pindexPrev->nHiveRun;    // PlexHive: Hive: Tracked by the hive skip links
         if (hiveBlocksAtTip >= consensusParams.maxConsecutiveHiveBlocks) {
             LogPrintf("CheckHiveProof: Too many Hive blocks without a POW block.\n");
             return false;
@@ -593,7 +612,7 @@ bool CheckHiveProof(const CBlock* pblock, const Consensus::Params& consensusPara
     }
 
     // Block mustn't include any BCTs
-    CScript scriptPubKeyBCF = GetScriptForDestination(DecodeDestination(consensusParams.beeCreationAddress));
+    const CScript& scriptPubKeyBCF = consensusParams.scriptPubKeyBCF;
     if (pblock->vtx.size() > 1)
         for (unsigned int i=1; i < pblock->vtx.size(); i++)
             if (pblock->vtx[i]->IsBCT(consensusParams, scriptPubKeyBCF)) {
@@ -648,35 +667,13 @@ bool CheckHiveProof(const CBlock* pblock, const Consensus::Params& consensusPara
     if (verbose)
         LogPrintf("CheckHiveProof: bctTxId             = %s\n", txidStr);
 
-    // Check bee hash against target
-    std::string deterministicRandString = GetDeterministicRandString(pindexPrev);
-    if (verbose)
-        LogPrintf("CheckHiveProof: detRandString       = %s\n", deterministicRandString);
-    arith_uint256 beeHashTarget;
-    beeHashTarget.SetCompact(GetNextHiveWorkRequired(pindexPrev, consensusParams));
-    if (verbose)
-        LogPrintf("CheckHiveProof: beeHashTarget       = %s\n", beeHashTarget.ToString());
-    
-    // PlexHive: MinotaurX+Hive1.2: Use the correct inner Hive hash
-    if (!IsMinotaurXEnabled(pindexPrev, consensusParams)) {
-        std::string hashHex = (CHashWriter(SER_GETHASH, 0) << deterministicRandString << txidStr << beeNonce).GetHash().GetHex();
-        arith_uint256 beeHash = arith_uint256(hashHex);
-        if (verbose)
-            LogPrintf("CheckHiveProof: beeHash             = %s\n", beeHash.GetHex());
-        if (beeHash >= beeHashTarget) {
-            LogPrintf("CheckHiveProof: Bee does not meet hash target!\n");
-            return false;
-        }
-    } else {
-        arith_uint256 beeHash(CBlockHeader::MinotaurHashArbitrary(std::string(deterministicRandString + txidStr + std::to_string(beeNonce)).c_str()).ToString());
-        if (verbose)
-            LogPrintf("CheckHive12Proof: beeHash           = %s\n", beeHash.GetHex());
-        if (beeHash >= beeHashTarget) {
-            LogPrintf("CheckHive12Proof: Bee does not meet hash target!\n");
-            return false;
-        }
+    // Get the rand string and bee hash target shared by all Hive blocks on this parent
+    std::shared_ptr<const CHiveProofInputs> proofInputs = GetHiveProofInputs(pindexPrev, consensusParams);
+    if (verbose) {
+        LogPrintf("CheckHiveProof: detRandString       = %s\n", proofInputs->RandString());
+        LogPrintf("CheckHiveProof: beeHashTarget       = %s\n", arith_uint256().SetCompact(proofInputs->nBeeBits).ToString());
     }
-    
+
     // Grab the message sig (bytes 79-end; byte 78 is size)
     std::vector<unsigned char> messageSig(&txCoinbase->vout[0].scriptPubKey[79], &txCoinbase->vout[0].scriptPubKey[79 + 65]);
     if (verbose)
@@ -695,24 +692,17 @@ bool CheckHiveProof(const CBlock* pblock, const Consensus::Params& consensusPara
     if (verbose)
         LogPrintf("CheckHiveProof: honeyAddress        = %s\n", EncodeDestination(honeyDestination));
 
-    // Verify the message sig
+    // Check the bee hash against the target, and verify the message sig
     const CKeyID *keyID = boost::get<CKeyID>(&honeyDestination);
     if (!keyID) {
         LogPrintf("CheckHiveProof: Can't get pubkey for honey address\n");
         return false;
     }
-    CHashWriter ss(SER_GETHASH, 0);
-    ss << deterministicRandString;
-    uint256 mhash = ss.GetHash();
-    CPubKey pubkey;
-    if (!pubkey.RecoverCompact(mhash, messageSig)) {
-        LogPrintf("CheckHiveProof: Couldn't recover pubkey from hash\n");
-        return false;
-    }
-    if (pubkey.GetID() != *keyID) {
-        LogPrintf("CheckHiveProof: Signature mismatch! GetID() = %s, *keyID = %s\n", pubkey.GetID().ToString(), (*keyID).ToString());
+    CHiveProofCheck proofCheck(proofInputs, txidStr, beeNonce, messageSig, *keyID);
+    if (pvChecks)
+        pvChecks->push_back(std::move(proofCheck));
+    else if (!proofCheck())
         return false;
-    }
 
     // Grab the BCT utxo
     bool deepDrill = false;
@@ -728,6 +718,8 @@ bool CheckHiveProof(const CBlock* pblock, const Consensus::Params& consensusPara
         Coin coin;
         CTransactionRef bct = nullptr;
         CBlockIndex foundAt;
+        CBCTIndexEntry bctEntry;                                            // PlexHive: Hive: BCT locator index entry, if one was used
+        bool haveBctEntry = false;
 
         if (pcoinsTip && pcoinsTip->GetCoin(outBeeCreation, coin)) {        // First try the UTXO set (this pathway will hit on incoming blocks)
             if (verbose)
@@ -736,6 +728,14 @@ bool CheckHiveProof(const CBlock* pblock, const Consensus::Params& consensusPara
             bctScriptPubKey = coin.out.scriptPubKey;
             bctFoundHeight = coin.nHeight;
             bctWasMinotaurXEnabled = IsMinotaurXEnabled(chainActive[bctFoundHeight], consensusParams);  // PlexHive: MinotaurX+Hive1.2: Track whether Hive 1.2 was enabled at BCT creation time
+        } else if (pbctIndex && pbctIndex->Lookup(outBeeCreation.hash, pindexPrev, bctEntry)) {    // PlexHive: Hive: Then the BCT locator index
+            if (verbose)
+                LogPrintf("CheckHiveProof: Using BCT index for outBeeCreation\n");
+            haveBctEntry = true;
+            bctValue = bctEntry.nBeeFee;
+            bctScriptPubKey = bctEntry.BCTScript(scriptPubKeyBCF);
+            bctFoundHeight = bctEntry.nHeight;
+            bctWasMinotaurXEnabled = IsMinotaurXEnabled(pindexPrev->GetAncestor(bctFoundHeight), consensusParams);
         } else {                                                            // UTXO set isn't available when eg reindexing, so drill into block db (not too bad, since Alice put her BCT height in the coinbase tx)
             if (verbose)
                 LogPrintf("! CheckHiveProof: Warn: Using deep drill for outBeeCreation\n");
@@ -751,10 +751,21 @@ bool CheckHiveProof(const CBlock* pblock, const Consensus::Params& consensusPara
         }
 
         if (communityContrib) {
-            CScript scriptPubKeyCF = GetScriptForDestination(DecodeDestination(consensusParams.hiveCommunityAddress));
+            const CScript& scriptPubKeyCF = consensusParams.scriptPubKeyCF;
             CAmount donationAmount;
 
-            if(bct == nullptr) {                                                                // If we dont have a ref to the BCT
+            if (!haveBctEntry && bct == nullptr && pbctIndex)                                   // PlexHive: Hive: If the bee creation output was in the UTXO set, this one may not be
+                haveBctEntry = pbctIndex->Lookup(outCommFund.hash, pindexPrev, bctEntry);
+
+            if (haveBctEntry) {                                                                 // PlexHive: Hive: The BCT locator index holds what the deep drill would find
+                if (verbose)
+                    LogPrintf("CheckHiveProof: Using BCT index for outCommFund\n");
+                if (!bctEntry.fCommunityContrib) {
+                    LogPrintf("CheckHiveProof: Community contrib was indicated but not found\n");
+                    return false;
+                }
+                donationAmount = bctEntry.nCommunityContrib;
+            } else if(bct == nullptr) {                                                         // If we dont have a ref to the BCT
                 if (pcoinsTip && pcoinsTip->GetCoin(outCommFund, coin)) {                       // First try UTXO set
                     if (verbose)
                         LogPrintf("CheckHiveProof: Using UTXO set for outCommFund\n");
@@ -8,8 +8,12 @@
 
 #include <consensus/params.h>
 #include <primitives/block.h>   // PlexHive: MinotaurX+Hive1.2: For POW_TYPE
+#include <pubkey.h>             // PlexHive: Hive: For CKeyID
 
+#include <memory>
 #include <stdint.h>
+#include <string>
+#include <vector>
 
 class CBlockHeader;
 class CBlockIndex;
@@ -22,14 +26,60 @@ struct BeePopGraphPoint {
     int maturePop;
 };
 
+/**
+ * PlexHive: Hive: What every Hive proof built on a given block shares. Worked out once per parent block by
+ * GetHiveProofInputs(), which keeps the most recently used few.
+ */
+struct CHiveProofInputs
+{
+    std::vector<uint256> vRandHashes;   // Block hashes making up the deterministic random string, raw
+    uint256 randStringHash;             // Hash of the serialized random string; what bee owners sign
+    unsigned int nBeeBits;              // Bee hash target
+    bool fMinotaurX;                    // Whether the Hive 1.2 inner hash is in use
+
+    /** The deterministic random string, as hashed with each bee */
+    std::string RandString() const;
+};
+
+/**
+ * PlexHive: Hive: Closure for the parts of a Hive proof that don't need chain state, so they can run on
+ * the script check threads: the bee hash against the bee hash target, and the message signature against
+ * the honey address.
+ */
+class CHiveProofCheck
+{
+private:
+    std::shared_ptr<const CHiveProofInputs> inputs;
+    std::string txidStr;
+    uint32_t beeNonce;
+    std::vector<unsigned char> messageSig;
+    CKeyID keyID;
+
+public:
+    CHiveProofCheck() : beeNonce(0) {}
+    CHiveProofCheck(std::shared_ptr<const CHiveProofInputs> inputsIn, const std::string& txidStrIn, uint32_t beeNonceIn, const std::vector<unsigned char>& messageSigIn, const CKeyID& keyIDIn) :
+        inputs(inputsIn), txidStr(txidStrIn), beeNonce(beeNonceIn), messageSig(messageSigIn), keyID(keyIDIn) {}
+
+    bool operator()() const;
+
+    void swap(CHiveProofCheck& check) {
+        std::swap(inputs, check.inputs);
+        std::swap(txidStr, check.txidStr);
+        std::swap(beeNonce, check.beeNonce);
+        std::swap(messageSig, check.messageSig);
+        std::swap(keyID, check.keyID);
+    }
+};
+
 unsigned int GetNextWorkRequired(const CBlockIndex* pindexLast, const CBlockHeader *pblock, const Consensus::Params&);
 unsigned int CalculateNextWorkRequired(const CBlockIndex* pindexLast, int64_t nFirstBlockTime, const Consensus::Params&);
 unsigned int DarkGravityWave(const CBlockIndex* pindexLast, const Consensus::Params& params);                               // PlexHive: PLHV (DGW) diff adjust implementation
 unsigned int GetNextWorkRequiredLTC(const CBlockIndex* pindexLast, const CBlockHeader *pblock, const Consensus::Params&);   // PlexHive: LTC diff adjust implementation
 unsigned int GetNextHiveWorkRequired(const CBlockIndex* pindexLast, const Consensus::Params& params);                       // PlexHive: Hive: Get the current Bee Hash Target
 unsigned int GetNextWorkRequiredLWMA(const CBlockIndex* pindexLast, const CBlockHeader *pblock, const Consensus::Params& params, const POW_TYPE powType); // PlexHive: MinotaurX+Hive1.2: LWMA difficulty adjustment for all pow types
-bool CheckHiveProof(const CBlock* pblock, const Consensus::Params& params);                                                 // PlexHive: Hive: Check the hive proof for given block
-bool GetNetworkHiveInfo(int& immatureBees, int& immatureBCTs, int& matureBees, int& matureBCTs, CAmount& potentialLifespanRewards, const Consensus::Params& consensusParams, bool recalcGraph = false); // PlexHive: Hive: Get count of all live and gestating BCTs on the network
+bool CheckHiveProof(const CBlock* pblock, const Consensus::Params& params, std::vector<CHiveProofCheck>* pvChecks = nullptr);  // PlexHive: Hive: Check the hive proof for given block, optionally leaving the bee hash and signature checks to the caller
+std::shared_ptr<const CHiveProofInputs> GetHiveProofInputs(const CBlockIndex* pindexPrev, const Consensus::Params& params);  // PlexHive: Hive: Get the proof inputs for Hive blocks built on pindexPrev
+bool GetNetworkHiveInfo(int& immatureBees, int& immatureBCTs, int& matureBees, int& matureBCTs, CAmount& potentialLifespanRewards, const Consensus::Params& consensusParams, std::vector<BeePopGraphPoint>* popGraph = nullptr); // PlexHive: Hive: Get count of all live and gestating BCTs on the network, and optionally the population graph
 
 /** Check whether a block hash satisfies the proof-of-work requirement specified by nBits */
 bool CheckProofOfWork(uint256 hash, unsigned int nBits, const Consensus::Params&);
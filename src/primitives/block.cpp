@@ -13,9 +13,19 @@
 #include <chainparams.h>    // PlexHive: Hive
 
 #include <crypto/minotaurx/minotaur.h>  // PlexHive: MinotaurX+Hive1.2
+#include <crypto/minotaurx/yespowerarena.h> // PlexHive: MinotaurX+Hive1.2
 #include <validation.h>                 // PlexHive: MinotaurX+Hive1.2
 #include <util.h>                       // PlexHive: MinotaurX+Hive1.2
 
+// PlexHive: MinotaurX+Hive1.2: Per-thread Minotaur state, reused across hashes
+static thread_local MinotaurHasher minotaurHasher;
+
+// PlexHive: MinotaurX+Hive1.2: Yespower memory for threads that don't bring their own; allocated on first MinotaurX hash, freed on thread exit
+static yespower_local_t* ThreadYespowerLocal() {
+    static thread_local YespowerArena arena;
+    return arena.Get();
+}
+
 uint256 CBlockHeader::GetHash() const
 {
     return SerializeHash(*this);
@@ -34,16 +44,16 @@ uint256 CBlockHeader::MinotaurXHashStringWithLocal(std::string data, yespower_lo
 
 // PlexHive: MinotaurX+Hive1.2: Hash arbitrary data with classical Minotaur
 uint256 CBlockHeader::MinotaurHashArbitrary(const char* data) {
-    return Minotaur(data, data + strlen(data), false);
+    return minotaurHasher.Hash(data, strlen(data), false);
 }
 
 // PlexHive: MinotaurX+Hive1.2: Hash a string with classical Minotaur
 uint256 CBlockHeader::MinotaurHashString(std::string data) {
-    return Minotaur(data.begin(), data.end(), false);
+    return minotaurHasher.Hash(data.data(), data.size(), false);
 }
 
 // PlexHive: MinotaurX+Hive1.2: Get pow hash based on block type and UASF activation
-uint256 CBlockHeader::GetPoWHash() const
+uint256 CBlockHeader::GetPoWHash(yespower_local_t *local) const
 {
     // PlexHive: After powForkTime, the pow hash may be sha256 or MinotaurX
     if (nTime > Params().GetConsensus().powForkTime) {
@@ -55,7 +65,7 @@ uint256 CBlockHeader::GetPoWHash() const
                 return GetHash();
                 break;
             case POW_TYPE_MINOTAURX:
-                return Minotaur(BEGIN(nVersion), END(nNonce), true);
+                return minotaurHasher.Hash(BEGIN(nVersion), END(nNonce) - BEGIN(nVersion), true, local ? local : ThreadYespowerLocal());
                 break;
             default:                                                // Don't crash the client on invalid blockType, just return a bad hash
                 return HIGH_HASH;
@@ -83,7 +83,8 @@ public:
 
     uint256 GetHash() const;
 
-    uint256 GetPoWHash() const;
+    // PlexHive: MinotaurX+Hive1.2: Optionally, use the caller's yespower memory (see YespowerArena); otherwise the thread's own
+    uint256 GetPoWHash(yespower_local_t *local = nullptr) const;
 
     // PlexHive: MinotaurX+Hive1.2: Hashing utils
     /*
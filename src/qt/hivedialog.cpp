@@ -228,7 +228,7 @@ void HiveDialog::updateData(bool forceGlobalSummaryUpdate) {
 
     if (forceGlobalSummaryUpdate || chainActive.Tip()->nHeight >= lastGlobalCheckHeight + 10) { // Don't update global summary every block
         int globalImmatureBees, globalImmatureBCTs, globalMatureBees, globalMatureBCTs;
-        if (!GetNetworkHiveInfo(globalImmatureBees, globalImmatureBCTs, globalMatureBees, globalMatureBCTs, potentialRewards, consensusParams, true)) {
+        if (!GetNetworkHiveInfo(globalImmatureBees, globalImmatureBCTs, globalMatureBees, globalMatureBCTs, potentialRewards, consensusParams, &beePopGraphPoints)) {
             ui->globalHiveSummary->hide();
             ui->globalHiveSummaryError->show();
         } else {
@@ -403,10 +403,10 @@ void HiveDialog::updateGraph() {
     QVector<QCPGraphData> dataImmature(totalLifespan);
     for (int i = 0; i < totalLifespan; i++) {
         dataImmature[i].key = now + consensusParams.nPowTargetSpacing / 2 * i;
-        dataImmature[i].value = (double)beePopGraph[i].immaturePop;
+        dataImmature[i].value = (double)beePopGraphPoints[i].immaturePop;
 
         dataMature[i].key = dataImmature[i].key;
-        dataMature[i].value = (double)beePopGraph[i].maturePop;
+        dataMature[i].value = (double)beePopGraphPoints[i].maturePop;
     }
     ui->beePopGraph->graph(0)->data()->set(dataImmature);
     ui->beePopGraph->graph(1)->data()->set(dataMature);
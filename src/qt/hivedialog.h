@@ -32,8 +32,6 @@ QT_BEGIN_NAMESPACE
 class QModelIndex;
 QT_END_NAMESPACE
 
-extern BeePopGraphPoint beePopGraph[1024*40];
-
 class QCPAxisTickerGI : public QCPAxisTicker 
 {
 public:
@@ -86,6 +84,7 @@ private:
     int immature, mature, dead, blocksFound;
     CAmount rewardsPaid, cost, profit;
     CAmount potentialRewards;
+    std::vector<BeePopGraphPoint> beePopGraphPoints;
     CAmount currentBalance;
     double beePopIndex;
     int lastGlobalCheckHeight;
@@ -127,7 +127,7 @@ QList<TransactionRecord> TransactionRecord::decomposeTransaction(const CWallet *
 
                 CTxDestination address;
                 // PlexHive: Hive: Check for a BCT
-                if (CScript::IsBCTScript(txout.scriptPubKey, GetScriptForDestination(DecodeDestination(Params().GetConsensus().beeCreationAddress)))) {
+                if (CScript::IsBCTScript(txout.scriptPubKey, Params().GetConsensus().scriptPubKeyBCF)) {
                     sub.type = TransactionRecord::HiveBeeCreation;
                 }
                 else if (ExtractDestination(txout.scriptPubKey, address))
@@ -7,6 +7,7 @@
 #include <rpc/blockchain.h>
 
 #include <amount.h>
+#include <blockcache.h>
 #include <chain.h>
 #include <chainparams.h>
 #include <checkpoints.h>
@@ -47,6 +48,10 @@ static std::mutex cs_blockchange;
 static std::condition_variable cond_blockchange;
 static CUpdatedBlock latestblock;
 
+// PlexHive: Hive: Mining optimisations: The published chain tip
+static std::mutex cs_tipsnapshot;
+static std::shared_ptr<const CRPCTipSnapshot> tipSnapshot;
+
 extern void TxToJSON(const CTransaction& tx, const uint256 hashBlock, UniValue& entry);
 
 /* Calculate the difficulty for a given block index,
@@ -68,29 +73,30 @@ double GetDifficulty(const CChain& chain, const CBlockIndex* blockindex, bool ge
 
     // PlexHive: Hive: If tip is PoW and we want hivemined, step back until we find a Hive block
     // PlexHive: Hive 1.1: Allow there to be multiple hive blocks in the way
+    // PlexHive: Hive: Mining optimisations: Use the hive skip links rather than stepping back block by block
     if (getHiveDifficulty) {
-        while (!blockindex->GetBlockHeader().IsHiveMined(consensusParams)) {
-            if (!blockindex->pprev || blockindex->nHeight < consensusParams.minHiveCheckBlock) {   // Ran out of blocks without finding a Hive block? Return min target
+        if (!blockindex->IsHiveMined(consensusParams)) {
+            const CBlockIndex* pindexHive = blockindex->pprevHive;
+            if (!pindexHive || pindexHive->nHeight + 1 < consensusParams.minHiveCheckBlock) {   // Ran out of blocks without finding a Hive block? Return min target
                 LogPrint(BCLog::HIVE, "GetDifficulty: No hivemined blocks found in history\n");
                 return 1.0;
             }
-
-            blockindex = blockindex->pprev;
+            blockindex = pindexHive;
         }
     } else {
         // PlexHive: MinotaurX+Hive1.2: Skip over incorrect powTypes
         if (IsMinotaurXEnabled(blockindex, consensusParams)) {
-            while (blockindex->GetBlockHeader().IsHiveMined(consensusParams) || blockindex->GetBlockHeader().GetPoWType() != powType) {
-                assert (blockindex->pprev);
-                blockindex = blockindex->pprev;
-                if (!IsMinotaurXEnabled(blockindex, consensusParams)) {
+            if (blockindex->IsHiveMined(consensusParams) || blockindex->GetPoWType() != powType) {
+                blockindex = blockindex->pprevPoWType[powType];
+                // MinotaurX activation is permanent, so only the block we land on needs checking
+                if (!blockindex || !IsMinotaurXEnabled(blockindex, consensusParams)) {
                     return 0;
                 }
             }
         } else {
-            while (blockindex->GetBlockHeader().IsHiveMined(consensusParams)) {
-                assert (blockindex->pprev);
-                blockindex = blockindex->pprev;
+            if (blockindex->IsHiveMined(consensusParams)) {
+                blockindex = blockindex->pprevPoW;
+                assert (blockindex);
             }
         }
     }
@@ -229,8 +235,8 @@ UniValue getblockcount(const JSONRPCRequest& request)
             + HelpExampleRpc("getblockcount", "")
         );
 
-    LOCK(cs_main);
-    return chainActive.Height();
+    // PlexHive: Hive: Mining optimisations: Read the published tip, rather than waiting on cs_main
+    return GetRPCTipSnapshot(false)->nHeight;
 }
 
 UniValue getbestblockhash(const JSONRPCRequest& request)
@@ -246,8 +252,8 @@ UniValue getbestblockhash(const JSONRPCRequest& request)
             + HelpExampleRpc("getbestblockhash", "")
         );
 
-    LOCK(cs_main);
-    return chainActive.Tip()->GetBlockHash().GetHex();
+    // PlexHive: Hive: Mining optimisations: Read the published tip, rather than waiting on cs_main
+    return GetRPCTipSnapshot(false)->hashBestBlock.GetHex();
 }
 
 void RPCNotifyBlockChange(bool ibd, const CBlockIndex * pindex)
@@ -260,6 +266,60 @@ void RPCNotifyBlockChange(bool ibd, const CBlockIndex * pindex)
     cond_blockchange.notify_all();
 }
 
+// PlexHive: Hive: Mining optimisations: Describe the active tip. cs_main must be held
+static std::shared_ptr<const CRPCTipSnapshot> MakeRPCTipSnapshot(bool fDifficulties)
+{
+    AssertLockHeld(cs_main);
+    std::shared_ptr<CRPCTipSnapshot> tip = std::make_shared<CRPCTipSnapshot>();
+    const CBlockIndex* pindex = chainActive.Tip();
+    const Consensus::Params& consensusParams = Params().GetConsensus();
+    tip->nHeight = chainActive.Height();
+    tip->hashBestBlock = pindex ? pindex->GetBlockHash() : uint256();
+    tip->fMinotaurXEnabled = pindex && IsMinotaurXEnabled(pindex, consensusParams);
+    tip->fHiveEnabled = pindex && IsHiveEnabled(pindex, consensusParams);
+    tip->fDifficulties = fDifficulties;
+    for (unsigned int i = 0; i < NUM_BLOCK_TYPES; i++)
+        tip->dDifficulty[i] = (fDifficulties && (i == POW_TYPE_SHA256 || tip->fMinotaurXEnabled)) ? GetDifficulty(nullptr, false, (POW_TYPE)i) : 0;
+    tip->dHiveDifficulty = (fDifficulties && tip->fHiveEnabled) ? GetDifficulty(nullptr, true) : 0;
+    tip->nMempoolSize = mempool.size();
+    tip->nMempoolBytes = mempool.GetTotalTxSize();
+    tip->nTime = GetTime();
+    return tip;
+}
+
+std::shared_ptr<const CRPCTipSnapshot> GetRPCTipSnapshot(bool fDifficulties)
+{
+    {
+        std::lock_guard<std::mutex> lock(cs_tipsnapshot);
+        if (tipSnapshot && (tipSnapshot->fDifficulties || !fDifficulties))
+            return tipSnapshot;
+    }
+    // A tip published during initial block download is completed for the first reader that needs the
+    // difficulties, and republished if it's still the tip, so later readers needn't work them out again
+    LOCK(cs_main);
+    std::shared_ptr<const CRPCTipSnapshot> tip = MakeRPCTipSnapshot(fDifficulties);
+    std::lock_guard<std::mutex> lock(cs_tipsnapshot);
+    if (fDifficulties && tipSnapshot && tipSnapshot->hashBestBlock == tip->hashBestBlock)
+        tipSnapshot = tip;
+    return tip;
+}
+
+void RPCPublishTipSnapshot(bool ibd, const CBlockIndex* pindex)
+{
+    if (!pindex) {
+        std::lock_guard<std::mutex> lock(cs_tipsnapshot);
+        tipSnapshot.reset();
+        return;
+    }
+    // Tip notifications are made without cs_main, so may come out of order; describing the
+    // active tip, and publishing it, under cs_main means the last published is always the latest.
+    // During initial block download, the difficulties are left for a reader to ask for.
+    LOCK(cs_main);
+    std::shared_ptr<const CRPCTipSnapshot> tip = MakeRPCTipSnapshot(!ibd);
+    std::lock_guard<std::mutex> lock(cs_tipsnapshot);
+    tipSnapshot = tip;
+}
+
 UniValue waitfornewblock(const JSONRPCRequest& request)
 {
     if (request.fHelp || request.params.size() > 1)
@@ -429,11 +489,12 @@ UniValue getdifficulty(const JSONRPCRequest& request)
     if (!algoFound)
         throw JSONRPCError(RPC_INVALID_PARAMETER, "Invalid pow algorithm requested");
 
-    if (!IsMinotaurXEnabled(chainActive.Tip(), Params().GetConsensus()) && powType != POW_TYPE_SHA256)
+    // PlexHive: Hive: Mining optimisations: Read the published tip, rather than waiting on cs_main
+    std::shared_ptr<const CRPCTipSnapshot> tip = GetRPCTipSnapshot();
+    if (!tip->fMinotaurXEnabled && powType != POW_TYPE_SHA256)
         throw JSONRPCError(RPC_INVALID_PARAMETER, "Non sha256d algo requested but minotaurx not enabled");
 
-    LOCK(cs_main);
-    return GetDifficulty(nullptr, false, powType);
+    return tip->dDifficulty[powType];
 }
 
 // PlexHive: Hive: Get hive difficulty
@@ -450,16 +511,57 @@ UniValue gethivedifficulty(const JSONRPCRequest& request)
             + HelpExampleRpc("gethivedifficulty", "")
         );
 
-    CBlockIndex* pindexPrev = chainActive.Tip();
-    assert(pindexPrev != nullptr);
-    if (!IsHiveEnabled(pindexPrev, Params().GetConsensus()))
+    // PlexHive: Hive: Mining optimisations: Read the published tip, rather than waiting on cs_main
+    std::shared_ptr<const CRPCTipSnapshot> tip = GetRPCTipSnapshot();
+    if (!tip->fHiveEnabled)
         throw std::runtime_error(
             "Error: The Hive is not yet enabled on the network"
         );
 
+    return tip->dHiveDifficulty;
+}
 
-    LOCK(cs_main);
-    return GetDifficulty(nullptr, true);
+// PlexHive: Hive: Mining optimisations: Report the published tip in one call
+UniValue gettipsnapshot(const JSONRPCRequest& request)
+{
+    if (request.fHelp || request.params.size() != 0)
+        throw std::runtime_error(
+            "gettipsnapshot\n"
+            "\nReturns the chain tip as last published to RPC methods that read it without waiting on block processing.\n"
+            "\nResult:\n"
+            "{\n"
+            "  \"height\": xxxxx,             (numeric) The height of the tip\n"
+            "  \"bestblockhash\": \"hex\",     (string) The hash of the tip\n"
+            "  \"difficulty\": {               (json object) The proof-of-work difficulty of each pow algorithm enabled\n"
+            "    \"algo\": n.nnn,              (numeric) The difficulty as a multiple of the minimum difficulty\n"
+            "    ...\n"
+            "  },\n"
+            "  \"hivedifficulty\": n.nnn,     (numeric) The Hive difficulty, if the Hive's enabled\n"
+            "  \"mempoolsize\": xxxxx,        (numeric) Mempool transactions when the tip was published\n"
+            "  \"mempoolbytes\": xxxxx,       (numeric) Their total virtual size\n"
+            "  \"time\": xxxxx                (numeric) When the tip was published, in seconds since epoch (Jan 1 1970 GMT)\n"
+            "}\n"
+            "\nExamples:\n"
+            + HelpExampleCli("gettipsnapshot", "")
+            + HelpExampleRpc("gettipsnapshot", "")
+        );
+
+    std::shared_ptr<const CRPCTipSnapshot> tip = GetRPCTipSnapshot();
+    UniValue ret(UniValue::VOBJ);
+    ret.push_back(Pair("height", tip->nHeight));
+    ret.push_back(Pair("bestblockhash", tip->hashBestBlock.GetHex()));
+    UniValue difficulty(UniValue::VOBJ);
+    for (unsigned int i = 0; i < NUM_BLOCK_TYPES; i++) {
+        if (i == POW_TYPE_SHA256 || tip->fMinotaurXEnabled)
+            difficulty.push_back(Pair(POW_TYPE_NAMES[i], tip->dDifficulty[i]));
+    }
+    ret.push_back(Pair("difficulty", difficulty));
+    if (tip->fHiveEnabled)
+        ret.push_back(Pair("hivedifficulty", tip->dHiveDifficulty));
+    ret.push_back(Pair("mempoolsize", tip->nMempoolSize));
+    ret.push_back(Pair("mempoolbytes", tip->nMempoolBytes));
+    ret.push_back(Pair("time", tip->nTime));
+    return ret;
 }
 
 std::string EntryDescriptionString()
@@ -899,6 +1001,15 @@ UniValue getblock(const JSONRPCRequest& request)
     if (fHavePruned && !(pblockindex->nStatus & BLOCK_HAVE_DATA) && pblockindex->nTx > 0)
         throw JSONRPCError(RPC_MISC_ERROR, "Block not available (pruned data)");
 
+    // PlexHive: Hive: Mining optimisations: Serve raw blocks from the serialized block cache
+    if (verbosity <= 0)
+    {
+        SerializedBlockRef pserialized = blockServeCache.Get(pblockindex, !(RPCSerializationFlags() & SERIALIZE_TRANSACTION_NO_WITNESS), Params().GetConsensus());
+        if (!pserialized)
+            throw JSONRPCError(RPC_MISC_ERROR, "Block not found on disk");
+        return HexStr(pserialized->begin(), pserialized->end());
+    }
+
     if (!ReadBlockFromDisk(block, pblockindex, Params().GetConsensus()))
         // Block not found on disk. This could be because we have the block
         // header in our index but don't have the block (for example if a
@@ -907,14 +1018,6 @@ UniValue getblock(const JSONRPCRequest& request)
         // block).
         throw JSONRPCError(RPC_MISC_ERROR, "Block not found on disk");
 
-    if (verbosity <= 0)
-    {
-        CDataStream ssBlock(SER_NETWORK, PROTOCOL_VERSION | RPCSerializationFlags());
-        ssBlock << block;
-        std::string strHex = HexStr(ssBlock.begin(), ssBlock.end());
-        return strHex;
-    }
-
     return blockToJSON(block, pblockindex, verbosity >= 2);
 }
 
@@ -1519,6 +1622,77 @@ UniValue getmempoolinfo(const JSONRPCRequest& request)
     return mempoolInfoToJSON();
 }
 
+// PlexHive: Hive: Mining optimisations: Report how well the serialized block cache is doing
+UniValue getblockcacheinfo(const JSONRPCRequest& request)
+{
+    if (request.fHelp || request.params.size() != 0)
+        throw std::runtime_error(
+            "getblockcacheinfo\n"
+            "\nReturns details on the cache of serialized blocks served to peers, REST and getblock.\n"
+            "\nResult:\n"
+            "{\n"
+            "  \"hits\": xxxxx,               (numeric) Requests served from the cache\n"
+            "  \"misses\": xxxxx,             (numeric) Requests that read the block from disk\n"
+            "  \"hitrate\": x.xxx,            (numeric) Fraction of requests served from the cache\n"
+            "  \"size\": xxxxx,               (numeric) Serialized blocks held\n"
+            "  \"usage\": xxxxx,              (numeric) Total memory usage for the cache\n"
+            "  \"maxusage\": xxxxx            (numeric) Maximum memory usage for the cache\n"
+            "}\n"
+            "\nExamples:\n"
+            + HelpExampleCli("getblockcacheinfo", "")
+            + HelpExampleRpc("getblockcacheinfo", "")
+        );
+
+    CSerializedBlockCache::Stats stats = blockServeCache.GetStats();
+    UniValue ret(UniValue::VOBJ);
+    ret.push_back(Pair("hits", stats.nHits));
+    ret.push_back(Pair("misses", stats.nMisses));
+    ret.push_back(Pair("hitrate", stats.nHits + stats.nMisses > 0 ? (double)stats.nHits / (stats.nHits + stats.nMisses) : 0.0));
+    ret.push_back(Pair("size", (uint64_t)stats.nEntries));
+    ret.push_back(Pair("usage", (uint64_t)stats.nUsage));
+    ret.push_back(Pair("maxusage", (uint64_t)stats.nMaxUsage));
+    return ret;
+}
+
+// PlexHive: Hive: Mining optimisations: Report how long coins flushes take, and how long block connection waits on them
+UniValue getcoinsflushinfo(const JSONRPCRequest& request)
+{
+    if (request.fHelp || request.params.size() != 0)
+        throw std::runtime_error(
+            "getcoinsflushinfo\n"
+            "\nReturns details on writes of the coins cache to the database made in the background.\n"
+            "\nResult:\n"
+            "{\n"
+            "  \"enabled\": true|false,       (boolean) Whether flushes are written in the background (-backgroundflush)\n"
+            "  \"pending\": true|false,       (boolean) Whether a flush is being written now\n"
+            "  \"flushes\": xxxxx,            (numeric) Flushes written in the background\n"
+            "  \"lastflushcoins\": xxxxx,     (numeric) Coins handed over by the last flush\n"
+            "  \"lastflushtime\": xxxxx,      (numeric) Time the last flush took to write, in milliseconds\n"
+            "  \"totalflushtime\": xxxxx,     (numeric) Time all flushes took to write, in milliseconds\n"
+            "  \"laststalltime\": xxxxx,      (numeric) Time the last wait for a flush to finish took, in milliseconds\n"
+            "  \"totalstalltime\": xxxxx      (numeric) Time spent waiting for flushes to finish, in milliseconds\n"
+            "}\n"
+            "\nExamples:\n"
+            + HelpExampleCli("getcoinsflushinfo", "")
+            + HelpExampleRpc("getcoinsflushinfo", "")
+        );
+
+    LOCK(cs_main);
+    UniValue ret(UniValue::VOBJ);
+    ret.push_back(Pair("enabled", pcoinsflusher != nullptr));
+    CCoinsViewBackgroundFlush::Stats stats = {};
+    if (pcoinsflusher)
+        stats = pcoinsflusher->GetStats();
+    ret.push_back(Pair("pending", stats.fPending));
+    ret.push_back(Pair("flushes", stats.nFlushes));
+    ret.push_back(Pair("lastflushcoins", stats.nLastFlushCoins));
+    ret.push_back(Pair("lastflushtime", stats.nLastFlushTime / 1000));
+    ret.push_back(Pair("totalflushtime", stats.nTotalFlushTime / 1000));
+    ret.push_back(Pair("laststalltime", stats.nLastStallTime / 1000));
+    ret.push_back(Pair("totalstalltime", stats.nTotalStallTime / 1000));
+    return ret;
+}
+
 UniValue preciousblock(const JSONRPCRequest& request)
 {
     if (request.fHelp || request.params.size() != 1)
@@ -1738,9 +1912,11 @@ static const CRPCCommand commands[] =
     { "blockchain",         "getbestblockhash",       &getbestblockhash,       {} },
     { "blockchain",         "getblockcount",          &getblockcount,          {} },
     { "blockchain",         "getblock",               &getblock,               {"blockhash","verbosity|verbose"} },
+    { "blockchain",         "getblockcacheinfo",      &getblockcacheinfo,      {} },
     { "blockchain",         "getblockhash",           &getblockhash,           {"height"} },
     { "blockchain",         "getblockheader",         &getblockheader,         {"blockhash","verbose"} },
     { "blockchain",         "getchaintips",           &getchaintips,           {} },
+    { "blockchain",         "getcoinsflushinfo",      &getcoinsflushinfo,      {} },
     { "blockchain",         "getdifficulty",          &getdifficulty,          {} },
     { "blockchain",         "gethivedifficulty",      &gethivedifficulty,      {} },        // PlexHive: Get Hive difficulty
     { "blockchain",         "getmempoolancestors",    &getmempoolancestors,    {"txid","verbose"} },
@@ -1750,6 +1926,7 @@ static const CRPCCommand commands[] =
     { "blockchain",         "getrawmempool",          &getrawmempool,          {"verbose"} },
     { "blockchain",         "gettxout",               &gettxout,               {"txid","n","include_mempool"} },
     { "blockchain",         "gettxoutsetinfo",        &gettxoutsetinfo,        {} },
+    { "blockchain",         "gettipsnapshot",         &gettipsnapshot,         {} },
     { "blockchain",         "pruneblockchain",        &pruneblockchain,        {"height"} },
     { "blockchain",         "savemempool",            &savemempool,            {} },
     { "blockchain",         "verifychain",            &verifychain,            {"checklevel","nblocks"} },
@@ -5,6 +5,12 @@
 #ifndef BITCOIN_RPC_BLOCKCHAIN_H
 #define BITCOIN_RPC_BLOCKCHAIN_H
 
+#include <primitives/block.h>
+#include <uint256.h>
+
+#include <memory>
+#include <stdint.h>
+
 class CBlock;
 class CBlockIndex;
 class UniValue;
@@ -24,6 +30,33 @@ double GetDifficulty(const CBlockIndex* blockindex = nullptr, bool getHiveDiffic
 /** Callback for when block tip changed. */
 void RPCNotifyBlockChange(bool ibd, const CBlockIndex *);
 
+/** PlexHive: Hive: Mining optimisations: The chain tip as published for RPC methods that read it without cs_main */
+struct CRPCTipSnapshot
+{
+    int nHeight;
+    uint256 hashBestBlock;
+    bool fMinotaurXEnabled;
+    bool fHiveEnabled;
+    bool fDifficulties;                     // Whether the difficulties are filled in; not while published in IBD
+    double dDifficulty[NUM_BLOCK_TYPES];    // Of each pow type; 0 for those not enabled
+    double dHiveDifficulty;                 // 0 if the Hive isn't enabled
+    uint64_t nMempoolSize;                  // Mempool transactions when published
+    uint64_t nMempoolBytes;                 // ... and their total size
+    int64_t nTime;                          // When published
+};
+
+/**
+ * Get the published chain tip, or if none is, one made now under cs_main.
+ * Published tips are immutable, and replaced whole as the tip changes. One
+ * published during initial block download has its difficulties worked out
+ * when it's first read by a caller that wants them (fDifficulties).
+ */
+std::shared_ptr<const CRPCTipSnapshot> GetRPCTipSnapshot(bool fDifficulties = true);
+
+/** Callback for when block tip changed: publish the new tip, or withdraw it if there's no pindex.
+ *  During initial block download, the difficulties aren't worked out until it's read. */
+void RPCPublishTipSnapshot(bool ibd, const CBlockIndex* pindex);
+
 /** Block description to JSON */
 UniValue blockToJSON(const CBlock& block, const CBlockIndex* blockindex, bool txDetails = false);
 
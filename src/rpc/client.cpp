@@ -105,6 +105,8 @@ static const CRPCConvertParam vRPCConvertParams[] =
     { "sethiveparams", 0, "hivecheckdelay"},        // PlexHive: Hive: Mining optimisations: Set hive mining params
     { "sethiveparams", 1, "hivecheckthreads"},      // PlexHive: Hive: Mining optimisations: Set hive mining params
     { "sethiveparams", 2, "hiveearlyabort"},        // PlexHive: Hive: Mining optimisations: Set hive mining params
+    { "setgenerate", 0, "generate" },               // PlexHive: MinotaurX+Hive1.2: Built-in pow miner
+    { "setgenerate", 2, "genproclimit" },           // PlexHive: MinotaurX+Hive1.2: Built-in pow miner
     { "decoderawtransaction", 1, "iswitness" },
     { "signrawtransaction", 1, "prevtxs" },
     { "signrawtransaction", 2, "privkeys" },
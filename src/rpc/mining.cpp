@@ -5,12 +5,14 @@
 
 #include <base58.h>
 #include <amount.h>
+#include <blocktemplate.h>
 #include <chain.h>
 #include <chainparams.h>
 #include <consensus/consensus.h>
 #include <consensus/params.h>
 #include <consensus/validation.h>
 #include <core_io.h>
+#include <crypto/minotaurx/yespowerarena.h>    // PlexHive: MinotaurX+Hive1.2
 #include <init.h>
 #include <validation.h>
 #include <miner.h>
@@ -121,7 +123,7 @@ UniValue sethiveparams(const JSONRPCRequest& request)
             "sethiveparams ( hivecheckdelay, hivecheckthreads, hiveearlyout )\n"
             "\nSet hivemining optimisation parameters.\n"
             "\nArguments:\n"
-            "1. hivecheckdelay     (numeric, required, default=1) Time between Hive checks in ms. This should be left at default unless performance degradation is observed.\n"
+            "1. hivecheckdelay     (numeric, required, default=1) Delay in ms between a new block arriving and the Hive check starting. This should be left at default unless performance degradation is observed.\n"
             "2. hivecheckthreads   (numeric, required, default=-2) Number of threads to use when checking bees, -1 for all available cores, or -2 for one less than all available cores.\n"
             "3. hiveearlyout       (boolean, required, default=true) Abort Hive checking as quickly as possible when a new block comes in. This should be left enabled unless performance degradation is observed.\n"
             "\nExamples:\n"
@@ -136,6 +138,27 @@ UniValue sethiveparams(const JSONRPCRequest& request)
     return NullUniValue;
 }
 
+// PlexHive: Hive: Mining optimisations: Summarise a BeeKeeper reaction latency
+static UniValue HiveLatencyToJSON(const CHiveLatency& latency)
+{
+    UniValue obj(UniValue::VOBJ);
+    obj.push_back(Pair("count", latency.nCount));
+    obj.push_back(Pair("last", latency.nLastMicros));
+    obj.push_back(Pair("avg", latency.nCount ? latency.nTotalMicros / (int64_t)latency.nCount : 0));
+    obj.push_back(Pair("max", latency.nMaxMicros));
+    UniValue histogram(UniValue::VARR);
+    for (int i = 0; i < CHiveLatency::NUM_BUCKETS; i++) {
+        if (!latency.vBuckets[i])
+            continue;
+        UniValue bucket(UniValue::VOBJ);
+        bucket.push_back(Pair("upto", CHiveLatency::BucketMax(i)));
+        bucket.push_back(Pair("count", latency.vBuckets[i]));
+        histogram.push_back(bucket);
+    }
+    obj.push_back(Pair("histogram", histogram));
+    return obj;
+}
+
 // PlexHive: Hive: Mining optimisations: Get hive mining params
 UniValue gethiveparams(const JSONRPCRequest& request)
 {
@@ -145,9 +168,33 @@ UniValue gethiveparams(const JSONRPCRequest& request)
             "\nGet hivemining optimisation parameters.\n"
             "\nResult:\n"
             "{\n"
-            "  \"hivecheckdelay\" : n,             (numeric) Time between Hive checks in ms. This should be left at default unless performance degradation is observed.\n"
+            "  \"hivecheckdelay\" : n,             (numeric) Delay in ms between a new block arriving and the Hive check starting. This should be left at default unless performance degradation is observed.\n"
             "  \"hivecheckthreads\" : n,           (numeric) Number of threads to use when checking bees, -1 for all available cores, or -2 for one less than all available cores.\n"
             "  \"hiveearlyout\" : true|false,      (boolean) Abort Hive checking as quickly as possible when a new block comes in. This should be left enabled unless performance degradation is observed.\n"
+            "  \"hivechecknice\" : n,              (numeric) Scheduling niceness of bee checking threads.\n"
+            "  \"lastround\" : {                   (json object) The most recent bee check\n"
+            "    \"bees\" : n,                     (numeric) Bees checked\n"
+            "    \"threads\" : n,                  (numeric) Threads used\n"
+            "    \"ms\" : x.xxx,                   (numeric) Time taken\n"
+            "    \"beespersec\" : x.xxx,           (numeric) Bees checked per second\n"
+            "    \"tailms\" : x.xxx                (numeric) Time between the first and last threads running out of work\n"
+            "  },\n"
+            "  \"latency\" : {                     (json object) How quickly the Hive miner reacts to new blocks, in microseconds\n"
+            "    \"tiptocheck\" : {                (json object) From tip change notification to the bee check starting\n"
+            "      \"count\" : n,                  (numeric) Number of samples\n"
+            "      \"last\" : n,                   (numeric) Most recent sample\n"
+            "      \"avg\" : n,                    (numeric) Mean of all samples\n"
+            "      \"max\" : n,                    (numeric) Largest sample\n"
+            "      \"histogram\" : [               (json array) Sample counts, leaving out empty buckets\n"
+            "        {\n"
+            "          \"upto\" : n,               (numeric) Largest sample counted in the bucket, or -1 for the last bucket\n"
+            "          \"count\" : n               (numeric) Number of samples in the bucket\n"
+            "        }, ...\n"
+            "      ]\n"
+            "    },\n"
+            "    \"blocktoabort\" : { ... },       (json object) From a new block arriving mid-check to all bee check threads stopping\n"
+            "    \"solutiontosubmit\" : { ... }    (json object) From a bee meeting the target to its block being submitted\n"
+            "  }\n"
             "}\n"
             "\nExamples:\n"
             + HelpExampleCli("gethiveparams", "")
@@ -159,6 +206,27 @@ UniValue gethiveparams(const JSONRPCRequest& request)
     obj.push_back(Pair("hivecheckthreads", gArgs.GetArg("-hivecheckthreads", DEFAULT_HIVE_THREADS)));
     obj.push_back(Pair("hiveearlyout", gArgs.GetBoolArg("-hiveearlyout", DEFAULT_HIVE_EARLY_OUT) ? "true" : "false"));
 
+    obj.push_back(Pair("hivechecknice", gArgs.GetArg("-hivechecknice", DEFAULT_HIVE_CHECK_NICE)));
+
+    // PlexHive: Hive: Mining optimisations: Bee check pool throughput
+    CHiveRoundStats roundStats = GetLastHiveRoundStats();
+    UniValue lastRound(UniValue::VOBJ);
+    lastRound.push_back(Pair("bees", roundStats.nBees));
+    lastRound.push_back(Pair("threads", roundStats.nThreads));
+    lastRound.push_back(Pair("ms", roundStats.nMicros * 0.001));
+    lastRound.push_back(Pair("beespersec", roundStats.BeesPerSec()));
+    lastRound.push_back(Pair("tailms", roundStats.nTailMicros * 0.001));
+    obj.push_back(Pair("lastround", lastRound));
+
+    // PlexHive: Hive: Mining optimisations: Reaction latencies
+    CHiveLatency tipToCheck, blockToAbort, solutionToSubmit;
+    GetHiveLatencyStats(tipToCheck, blockToAbort, solutionToSubmit);
+    UniValue latency(UniValue::VOBJ);
+    latency.push_back(Pair("tiptocheck", HiveLatencyToJSON(tipToCheck)));
+    latency.push_back(Pair("blocktoabort", HiveLatencyToJSON(blockToAbort)));
+    latency.push_back(Pair("solutiontosubmit", HiveLatencyToJSON(solutionToSubmit)));
+    obj.push_back(Pair("latency", latency));
+
     return obj;
 }
 
@@ -215,6 +283,7 @@ UniValue generateBlocks(std::shared_ptr<CReserveScript> coinbaseScript, int nGen
         nHeightEnd = nHeight+nGenerate;
     }
     unsigned int nExtraNonce = 0;
+    std::unique_ptr<YespowerArena> yespowerArena;   // PlexHive: MinotaurX+Hive1.2: Working memory for MinotaurX attempts, allocated when first needed
     UniValue blockHashes(UniValue::VARR);
     while (nHeight < nHeightEnd)
     {
@@ -226,7 +295,10 @@ UniValue generateBlocks(std::shared_ptr<CReserveScript> coinbaseScript, int nGen
             LOCK(cs_main);
             IncrementExtraNonce(pblock, chainActive.Tip(), nExtraNonce);
         }
-        while (nMaxTries > 0 && pblock->nNonce < nInnerLoopCount && !CheckProofOfWork(pblock->GetPoWHash(), pblock->nBits, Params().GetConsensus())) {
+        if (!yespowerArena && pblock->GetPoWType() == POW_TYPE_MINOTAURX)
+            yespowerArena.reset(new YespowerArena());
+        yespower_local_t *yespowerLocal = yespowerArena ? yespowerArena->Get() : nullptr;
+        while (nMaxTries > 0 && pblock->nNonce < nInnerLoopCount && !CheckProofOfWork(pblock->GetPoWHash(yespowerLocal), pblock->nBits, Params().GetConsensus())) {
             ++pblock->nNonce;
             --nMaxTries;
         }
@@ -285,6 +357,64 @@ UniValue generatetoaddress(const JSONRPCRequest& request)
     return generateBlocks(coinbaseScript, nGenerate, nMaxTries, false);
 }
 
+// PlexHive: MinotaurX+Hive1.2: Control the built-in pow miner
+UniValue setgenerate(const JSONRPCRequest& request)
+{
+    if (request.fHelp || request.params.size() < 1 || request.params.size() > 4)
+        throw std::runtime_error(
+            "setgenerate generate ( \"address\" genproclimit \"powalgo\" )\n"
+            "\nStart or stop the built-in pow miner, which mines in the background until stopped.\n"
+            "Progress is reported by getmininginfo.\n"
+            "\nArguments:\n"
+            "1. generate         (boolean, required) Set to true to start mining, false to stop.\n"
+            "2. \"address\"        (string, required to start) The address to send newly generated plexhive to.\n"
+            "3. genproclimit     (numeric, optional) Number of mining threads, -1 for all available cores (default: " + std::to_string(DEFAULT_GENERATE_THREADS) + ").\n"
+            "4. \"powalgo\"        (string, optional) This can be set to \"sha256d\" or \"minotaurx\". If omitted, the -powalgo conf option is used.\n"
+            "\nExamples:\n"
+            "\nMine with 4 threads\n"
+            + HelpExampleCli("setgenerate", "true \"myaddress\" 4") +
+            "\nStop mining\n"
+            + HelpExampleCli("setgenerate", "false") +
+            "\nAs a json rpc call\n"
+            + HelpExampleRpc("setgenerate", "true, \"myaddress\", 4")
+        );
+
+    if (!request.params[0].get_bool()) {
+        StopPowMiner();
+        return NullUniValue;
+    }
+
+    if (request.params[1].isNull())
+        throw JSONRPCError(RPC_INVALID_PARAMETER, "An address is required to start mining");
+    CTxDestination destination = DecodeDestination(request.params[1].get_str());
+    if (!IsValidDestination(destination))
+        throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "Error: Invalid address");
+
+    int nThreads = request.params[2].isNull() ? DEFAULT_GENERATE_THREADS : request.params[2].get_int();
+
+    std::string strAlgo = request.params[3].isNull() ? gArgs.GetArg("-powalgo", DEFAULT_POW_TYPE) : request.params[3].get_str();
+    bool algoFound = false;
+    POW_TYPE powType;
+    for (unsigned int i = 0; i < NUM_BLOCK_TYPES; i++) {
+        if (strAlgo == POW_TYPE_NAMES[i]) {
+            powType = (POW_TYPE)i;
+            algoFound = true;
+            break;
+        }
+    }
+    if (!algoFound)
+        throw JSONRPCError(RPC_INVALID_PARAMETER, "Invalid pow algorithm requested");
+
+    {
+        LOCK(cs_main);
+        if (powType != POW_TYPE_SHA256 && !IsMinotaurXEnabled(chainActive.Tip(), Params().GetConsensus()))
+            throw JSONRPCError(RPC_MISC_ERROR, "Error: Won't mine non-sha256 blocks before MinotaurX activation");
+    }
+
+    StartPowMiner(nThreads, powType, GetScriptForDestination(destination));
+    return NullUniValue;
+}
+
 UniValue getmininginfo(const JSONRPCRequest& request)
 {
     if (request.fHelp || request.params.size() != 0)
@@ -301,6 +431,15 @@ UniValue getmininginfo(const JSONRPCRequest& request)
             "  \"networkhashps\": nnn,      (numeric) The network hashes per second\n"
             "  \"pooledtx\": n              (numeric) The size of the mempool\n"
             "  \"chain\": \"xxxx\",           (string) current network name as defined in BIP70 (main, test, regtest)\n"
+            "  \"generate\": true|false     (boolean) If the built-in pow miner is running (see setgenerate)\n"       // PlexHive: MinotaurX+Hive1.2
+            "  \"genproclimit\": n          (numeric) The number of pow miner threads running\n"
+            "  \"genpowalgo\": \"xxxx\"      (string) The pow algorithm being mined\n"
+            "  \"genblocksfound\": n        (numeric) Blocks mined by the pow miner since startup\n"
+            "  \"hashespersec\": {          (json object) The pow miner's recent hash rate, per pow algorithm\n"
+            "      \"sha256d\": xxx,\n"
+            "      \"minotaurx\": xxx,\n"
+            "      \"scrypt\": xxx           (numeric) Pre-fork blocks\n"
+            "  }\n"
             "  \"warnings\": \"...\"          (string) any network and blockchain warnings\n"
             "  \"errors\": \"...\"            (string) DEPRECATED. Same as warnings. Only shown when plexhived is started with -deprecatedrpc=getmininginfo\n"
             "}\n"
@@ -322,6 +461,17 @@ UniValue getmininginfo(const JSONRPCRequest& request)
     obj.push_back(Pair("networkhashps",    getnetworkhashps(request)));
     obj.push_back(Pair("pooledtx",         (uint64_t)mempool.size()));
     obj.push_back(Pair("chain",            Params().NetworkIDString()));
+    // PlexHive: MinotaurX+Hive1.2: Built-in pow miner
+    CPowMinerStats minerStats = GetPowMinerStats();
+    obj.push_back(Pair("generate",         minerStats.fRunning));
+    obj.push_back(Pair("genproclimit",     minerStats.nThreads));
+    obj.push_back(Pair("genpowalgo",       POW_TYPE_NAMES[minerStats.powType]));
+    obj.push_back(Pair("genblocksfound",   minerStats.nBlocksFound));
+    UniValue hashesPerSec(UniValue::VOBJ);
+    for (unsigned int i = 0; i < NUM_BLOCK_TYPES; i++)
+        hashesPerSec.push_back(Pair(POW_TYPE_NAMES[i], minerStats.hashesPerSec[i]));
+    hashesPerSec.push_back(Pair("scrypt", minerStats.scryptHashesPerSec));
+    obj.push_back(Pair("hashespersec",     hashesPerSec));
     if (IsDeprecatedRPCEnabled("getmininginfo")) {
         obj.push_back(Pair("errors",       GetWarnings("statusbar")));
     } else {
@@ -598,6 +748,8 @@ UniValue getblocktemplate(const JSONRPCRequest& request)
         // Release the wallet and main lock while waiting
         LEAVE_CRITICAL_SECTION(cs_main);
         {
+            // PlexHive: Hive: Mining optimisations: And the RPC dispatch lock, so a long poll doesn't hold up exclusive methods
+            CRPCDispatchUnlock dispatchUnlock;
             checktxtime = std::chrono::steady_clock::now() + std::chrono::minutes(1);
 
             WaitableLock lock(csBestBlock);
@@ -633,8 +785,10 @@ UniValue getblocktemplate(const JSONRPCRequest& request)
     // a segwit-block to a non-segwit caller.
     static bool fLastTemplateSupportsSegwit = true;
     static POW_TYPE lastPowType = NUM_BLOCK_TYPES;  // PlexHive: MinotaurX+Hive1.2
+    // PlexHive: Hive: Mining optimisations: Where blockTemplateEngine has a selection ready for this tip, mempool changes are picked up straight away
     if (pindexPrev != chainActive.Tip() ||
-        (mempool.GetTransactionsUpdated() != nTransactionsUpdatedLast && GetTime() - nStart > 5) ||
+        (mempool.GetTransactionsUpdated() != nTransactionsUpdatedLast && (GetTime() - nStart > 5 ||
+            blockTemplateEngine.HasSelection(CBlockTemplateEngine::KIND_POW, chainActive.Tip(), fSupportsSegwit && IsWitnessEnabled(chainActive.Tip(), Params().GetConsensus())))) ||
         fLastTemplateSupportsSegwit != fSupportsSegwit ||
         lastPowType != powType) // PlexHive: MinotaurX+Hive1.2: Include powType check in cache refresh condition
     {
@@ -1112,6 +1266,7 @@ static const CRPCCommand commands[] =
 
 
     { "generating",         "generatetoaddress",      &generatetoaddress,      {"nblocks","address","maxtries"} },
+    { "generating",         "setgenerate",            &setgenerate,            {"generate","address","genproclimit","powalgo"} },    // PlexHive: MinotaurX+Hive1.2: Built-in pow miner
 
     { "util",               "estimatefee",            &estimatefee,            {"nblocks"} },
     { "util",               "estimatesmartfee",       &estimatesmartfee,       {"conf_target", "estimate_mode"} },
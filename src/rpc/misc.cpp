@@ -7,6 +7,7 @@
 #include <chain.h>
 #include <clientversion.h>
 #include <core_io.h>
+#include <crypto/minotaurx/yespowerarena.h>    // PlexHive: MinotaurX+Hive1.2
 #include <crypto/ripemd160.h>
 #include <init.h>
 #include <validation.h>
@@ -458,6 +459,18 @@ static UniValue RPCLockedMemoryInfo()
     return obj;
 }
 
+// PlexHive: MinotaurX+Hive1.2: Yespower working memory held by validation, RPC and mining threads
+static UniValue RPCYespowerMemoryInfo()
+{
+    YespowerArenaStats stats = GetYespowerArenaStats();
+    UniValue obj(UniValue::VOBJ);
+    obj.push_back(Pair("arenas", uint64_t(stats.arenas)));
+    obj.push_back(Pair("hugepage_arenas", uint64_t(stats.hugepage_arenas)));
+    obj.push_back(Pair("used", uint64_t(stats.used)));
+    obj.push_back(Pair("peak", uint64_t(stats.peak)));
+    return obj;
+}
+
 #ifdef HAVE_MALLOC_INFO
 static std::string RPCMallocInfo()
 {
@@ -499,6 +512,12 @@ UniValue getmemoryinfo(const JSONRPCRequest& request)
             "    \"locked\": xxxxxx,       (numeric) Amount of bytes that succeeded locking. If this number is smaller than total, locking pages failed at some point and key data could be swapped to disk.\n"
             "    \"chunks_used\": xxxxx,   (numeric) Number allocated chunks\n"
             "    \"chunks_free\": xxxxx,   (numeric) Number unused chunks\n"
+            "  },\n"
+            "  \"yespower\": {             (json object) Information about MinotaurX working memory\n"
+            "    \"arenas\": xx,           (numeric) Number of threads holding working memory\n"
+            "    \"hugepage_arenas\": xx,  (numeric) How many of those are backed by huge pages\n"
+            "    \"used\": xxxxx,          (numeric) Number of bytes held\n"
+            "    \"peak\": xxxxx,          (numeric) Highest number of bytes held since startup\n"
             "  }\n"
             "}\n"
             "\nResult (mode \"mallocinfo\"):\n"
@@ -512,6 +531,7 @@ UniValue getmemoryinfo(const JSONRPCRequest& request)
     if (mode == "stats") {
         UniValue obj(UniValue::VOBJ);
         obj.push_back(Pair("locked", RPCLockedMemoryInfo()));
+        obj.push_back(Pair("yespower", RPCYespowerMemoryInfo()));    // PlexHive: MinotaurX+Hive1.2
         return obj;
     } else if (mode == "mallocinfo") {
 #ifdef HAVE_MALLOC_INFO
@@ -7,6 +7,7 @@
 
 #include <base58.h>
 #include <fs.h>
+#include <httpserver.h>
 #include <init.h>
 #include <random.h>
 #include <sync.h>
@@ -19,6 +20,7 @@
 #include <boost/algorithm/string/case_conv.hpp> // for to_upper()
 #include <boost/algorithm/string/classification.hpp>
 #include <boost/algorithm/string/split.hpp>
+#include <boost/thread/shared_mutex.hpp>
 
 #include <memory> // for unique_ptr
 #include <unordered_map>
@@ -31,6 +33,13 @@ static CCriticalSection cs_rpcWarmup;
 static RPCTimerInterface* timerInterface = nullptr;
 /* Map of name to timer. */
 static std::map<std::string, std::unique_ptr<RPCTimerBase> > deadlineTimers;
+/* PlexHive: Hive: Mining optimisations: Shared by chain readers, taken alone by exclusive methods */
+static boost::shared_mutex cs_rpcDispatch;
+/* The share of cs_rpcDispatch held by the chain reader this thread is running, if any */
+static thread_local boost::shared_lock<boost::shared_mutex>* plockRPCDispatchRead = nullptr;
+/* Stats of each method called */
+static CCriticalSection cs_rpcStats;
+static std::map<std::string, CRPCMethodStats> mapRPCStats;
 
 static struct CRPCSignals
 {
@@ -256,6 +265,67 @@ UniValue uptime(const JSONRPCRequest& jsonRequest)
     return GetTime() - GetStartupTime();
 }
 
+// PlexHive: Hive: Mining optimisations: Report how calls to each method are doing
+UniValue getrpcstats(const JSONRPCRequest& jsonRequest)
+{
+    if (jsonRequest.fHelp || jsonRequest.params.size() != 0)
+        throw std::runtime_error(
+            "getrpcstats\n"
+            "\nReturns details on the RPC work queue, and on calls to each method made so far.\n"
+            "\nResult:\n"
+            "{\n"
+            "  \"workqueue\": {                (json object) Requests waiting for an RPC thread, if the HTTP server's running\n"
+            "    \"depth\": xxxxx,              (numeric) Requests waiting now\n"
+            "    \"peakdepth\": xxxxx,          (numeric) Most requests that have waited at once\n"
+            "    \"maxdepth\": xxxxx            (numeric) Most requests that may wait (-rpcworkqueue)\n"
+            "  },\n"
+            "  \"methods\": {\n"
+            "    \"method\": {                  (json object) A method called so far\n"
+            "      \"concurrency\": \"xxxx\",     (string) How its calls run alongside others: lockfree, chainread or exclusive\n"
+            "      \"calls\": xxxxx,            (numeric) Calls finished\n"
+            "      \"errors\": xxxxx,           (numeric) Calls that returned an error\n"
+            "      \"running\": xxxxx,          (numeric) Calls running now\n"
+            "      \"waiting\": xxxxx,          (numeric) Calls waiting for other methods' calls to finish now\n"
+            "      \"maxwaiting\": xxxxx,       (numeric) Most calls that have waited at once\n"
+            "      \"totalwaittime\": xxxxx,    (numeric) Time calls waited for others', in microseconds\n"
+            "      \"totaltime\": xxxxx,        (numeric) Time calls ran for, in microseconds\n"
+            "      \"maxtime\": xxxxx           (numeric) Longest a call ran for, in microseconds\n"
+            "    }, ...\n"
+            "  }\n"
+            "}\n"
+            "\nExamples:\n"
+            + HelpExampleCli("getrpcstats", "")
+            + HelpExampleRpc("getrpcstats", "")
+        );
+
+    UniValue ret(UniValue::VOBJ);
+    size_t depth, peak, max;
+    if (GetHTTPWorkQueueDepth(depth, peak, max)) {
+        UniValue queue(UniValue::VOBJ);
+        queue.push_back(Pair("depth", (uint64_t)depth));
+        queue.push_back(Pair("peakdepth", (uint64_t)peak));
+        queue.push_back(Pair("maxdepth", (uint64_t)max));
+        ret.push_back(Pair("workqueue", queue));
+    }
+    UniValue methods(UniValue::VOBJ);
+    for (const auto& entry : GetRPCStats()) {
+        const CRPCMethodStats& stats = entry.second;
+        UniValue method(UniValue::VOBJ);
+        method.push_back(Pair("concurrency", RPCConcurrencyName(GetRPCConcurrency(entry.first))));
+        method.push_back(Pair("calls", stats.nCalls));
+        method.push_back(Pair("errors", stats.nErrors));
+        method.push_back(Pair("running", stats.nRunning));
+        method.push_back(Pair("waiting", stats.nWaiting));
+        method.push_back(Pair("maxwaiting", stats.nMaxWaiting));
+        method.push_back(Pair("totalwaittime", stats.nWaitMicros));
+        method.push_back(Pair("totaltime", stats.nRunMicros));
+        method.push_back(Pair("maxtime", stats.nMaxRunMicros));
+        methods.push_back(Pair(entry.first, method));
+    }
+    ret.push_back(Pair("methods", methods));
+    return ret;
+}
+
 /**
  * Call Table
  */
@@ -266,6 +336,7 @@ static const CRPCCommand vRPCCommands[] =
     { "control",            "help",                   &help,                   {"command"}  },
     { "control",            "stop",                   &stop,                   {}  },
     { "control",            "uptime",                 &uptime,                 {}  },
+    { "control",            "getrpcstats",            &getrpcstats,            {}  },
 };
 
 CRPCTable::CRPCTable()
@@ -469,6 +540,126 @@ static inline JSONRPCRequest transformNamedArguments(const JSONRPCRequest& in, c
     return out;
 }
 
+// PlexHive: Hive: Mining optimisations: Methods that aren't chain readers. Those that wait for the chain
+// to change, or stop or abort others, mustn't hold up an exclusive method, or be held up behind one.
+static const std::map<std::string, RPCConcurrency> mapRPCConcurrency = {
+    { "help",                   RPC_LOCK_FREE },
+    { "stop",                   RPC_LOCK_FREE },
+    { "uptime",                 RPC_LOCK_FREE },
+    { "getrpcstats",            RPC_LOCK_FREE },
+    { "getbestblockhash",       RPC_LOCK_FREE },
+    { "getblockcount",          RPC_LOCK_FREE },
+    { "getdifficulty",          RPC_LOCK_FREE },
+    { "gethivedifficulty",      RPC_LOCK_FREE },
+    { "gettipsnapshot",         RPC_LOCK_FREE },
+    { "getblockcacheinfo",      RPC_LOCK_FREE },
+    { "getmempoolinfo",         RPC_LOCK_FREE },
+    { "getmemoryinfo",          RPC_LOCK_FREE },
+    { "waitfornewblock",        RPC_LOCK_FREE },
+    { "waitforblock",           RPC_LOCK_FREE },
+    { "waitforblockheight",     RPC_LOCK_FREE },
+    { "syncwithvalidationinterfacequeue", RPC_LOCK_FREE },
+    { "abortrescan",            RPC_LOCK_FREE },
+    { "echo",                   RPC_LOCK_FREE },
+    { "echojson",               RPC_LOCK_FREE },
+    { "invalidateblock",        RPC_EXCLUSIVE },
+    { "reconsiderblock",        RPC_EXCLUSIVE },
+    { "preciousblock",          RPC_EXCLUSIVE },
+    { "pruneblockchain",        RPC_EXCLUSIVE },
+    { "setmocktime",            RPC_EXCLUSIVE },
+    { "rescanblockchain",       RPC_EXCLUSIVE },
+    { "importprivkey",          RPC_EXCLUSIVE },
+    { "importaddress",          RPC_EXCLUSIVE },
+    { "importpubkey",           RPC_EXCLUSIVE },
+    { "importwallet",           RPC_EXCLUSIVE },
+    { "importmulti",            RPC_EXCLUSIVE },
+    { "importprunedfunds",      RPC_EXCLUSIVE },
+    { "removeprunedfunds",      RPC_EXCLUSIVE },
+};
+
+RPCConcurrency GetRPCConcurrency(const std::string& method)
+{
+    auto it = mapRPCConcurrency.find(method);
+    return it == mapRPCConcurrency.end() ? RPC_CHAIN_READ : it->second;
+}
+
+std::string RPCConcurrencyName(RPCConcurrency concurrency)
+{
+    if (concurrency == RPC_LOCK_FREE)
+        return "lockfree";
+    if (concurrency == RPC_EXCLUSIVE)
+        return "exclusive";
+    return "chainread";
+}
+
+CRPCDispatchUnlock::CRPCDispatchUnlock() : fReleased(false)
+{
+    if (plockRPCDispatchRead && plockRPCDispatchRead->owns_lock()) {
+        plockRPCDispatchRead->unlock();
+        fReleased = true;
+    }
+}
+
+CRPCDispatchUnlock::~CRPCDispatchUnlock()
+{
+    if (fReleased)
+        plockRPCDispatchRead->lock();
+}
+
+std::map<std::string, CRPCMethodStats> GetRPCStats()
+{
+    LOCK(cs_rpcStats);
+    return mapRPCStats;
+}
+
+/** Counts a call in its method's stats from when it's dispatched until it's done */
+class CRPCCallScope
+{
+private:
+    CRPCMethodStats* pstats;
+    int64_t nTimeQueued;
+    int64_t nTimeStart;
+    boost::shared_lock<boost::shared_mutex>* plockReadPrev;
+
+public:
+    bool fError;
+
+    explicit CRPCCallScope(const std::string& method) : nTimeQueued(GetTimeMicros()), nTimeStart(0), plockReadPrev(plockRPCDispatchRead), fError(true)
+    {
+        LOCK(cs_rpcStats);
+        pstats = &mapRPCStats[method];
+        pstats->nWaiting++;
+        pstats->nMaxWaiting = std::max(pstats->nMaxWaiting, pstats->nWaiting);
+    }
+
+    /** The call has the dispatch lock, and runs now. plockRead is its share, if it's a chain reader */
+    void Started(boost::shared_lock<boost::shared_mutex>* plockRead)
+    {
+        plockRPCDispatchRead = plockRead;
+        nTimeStart = GetTimeMicros();
+        LOCK(cs_rpcStats);
+        pstats->nWaiting--;
+        pstats->nRunning++;
+        pstats->nWaitMicros += nTimeStart - nTimeQueued;
+    }
+
+    ~CRPCCallScope()
+    {
+        plockRPCDispatchRead = plockReadPrev;
+        int64_t nTime = nTimeStart ? GetTimeMicros() - nTimeStart : 0;
+        LOCK(cs_rpcStats);
+        if (nTimeStart)
+            pstats->nRunning--;
+        else
+            pstats->nWaiting--;
+        pstats->nCalls++;
+        if (fError)
+            pstats->nErrors++;
+        pstats->nRunMicros += nTime;
+        pstats->nMaxRunMicros = std::max(pstats->nMaxRunMicros, nTime);
+    }
+};
+
 UniValue CRPCTable::execute(const JSONRPCRequest &request) const
 {
     // Return immediately if in warmup
@@ -485,14 +676,28 @@ UniValue CRPCTable::execute(const JSONRPCRequest &request) const
 
     g_rpcSignals.PreCommand(*pcmd);
 
+    // PlexHive: Hive: Mining optimisations: Take the dispatch lock as the method's concurrency class needs
+    CRPCCallScope call(pcmd->name);
+    RPCConcurrency concurrency = GetRPCConcurrency(pcmd->name);
+    boost::shared_lock<boost::shared_mutex> lockRead(cs_rpcDispatch, boost::defer_lock);
+    boost::unique_lock<boost::shared_mutex> lockExclusive(cs_rpcDispatch, boost::defer_lock);
+    if (concurrency == RPC_CHAIN_READ)
+        lockRead.lock();
+    else if (concurrency == RPC_EXCLUSIVE)
+        lockExclusive.lock();
+    call.Started(lockRead.owns_lock() ? &lockRead : nullptr);
+
     try
     {
         // Execute, convert arguments to array if necessary
+        UniValue result;
         if (request.params.isObject()) {
-            return pcmd->actor(transformNamedArguments(request, pcmd->argNames));
+            result = pcmd->actor(transformNamedArguments(request, pcmd->argNames));
         } else {
-            return pcmd->actor(request);
+            result = pcmd->actor(request);
         }
+        call.fError = false;
+        return result;
     }
     catch (const std::exception& e)
     {
@@ -173,6 +173,62 @@ public:
 
 bool IsDeprecatedRPCEnabled(const std::string& method);
 
+/**
+ * PlexHive: Hive: Mining optimisations: How a method's calls may run
+ * alongside other calls. Chain readers share a dispatch lock that exclusive
+ * methods take alone, so a method changing or rescanning the chain is never
+ * seen half done by another call. Lock-free methods don't take it: they're
+ * served from the published tip (see GetRPCTipSnapshot), don't need cs_main,
+ * or only wait for the chain to change, and they're never held up behind an
+ * exclusive method. A chain reader that also waits for the chain to change
+ * lets its share go for the wait with CRPCDispatchUnlock.
+ */
+enum RPCConcurrency
+{
+    RPC_LOCK_FREE,
+    RPC_CHAIN_READ,
+    RPC_EXCLUSIVE,
+};
+
+RPCConcurrency GetRPCConcurrency(const std::string& method);
+std::string RPCConcurrencyName(RPCConcurrency concurrency);
+
+/**
+ * Releases the calling chain reader's share of the dispatch lock for its
+ * lifetime, and takes it back after. Exclusive methods can run in between,
+ * so no chain state may be carried across it. cs_main must not be held.
+ */
+class CRPCDispatchUnlock
+{
+private:
+    bool fReleased;
+
+public:
+    CRPCDispatchUnlock();
+    ~CRPCDispatchUnlock();
+
+    CRPCDispatchUnlock(const CRPCDispatchUnlock&) = delete;
+    CRPCDispatchUnlock& operator=(const CRPCDispatchUnlock&) = delete;
+};
+
+/** Calls made to a method through CRPCTable::execute */
+struct CRPCMethodStats
+{
+    uint64_t nCalls;            // Calls finished
+    uint64_t nErrors;           // ... that threw
+    int64_t nWaitMicros;        // Total time calls waited for the dispatch lock
+    int64_t nRunMicros;         // Total time calls ran for
+    int64_t nMaxRunMicros;      // Longest a call ran for
+    int nRunning;               // Calls running now
+    int nWaiting;               // Calls waiting for the dispatch lock now
+    int nMaxWaiting;            // Most calls that have waited at once
+
+    CRPCMethodStats() : nCalls(0), nErrors(0), nWaitMicros(0), nRunMicros(0), nMaxRunMicros(0), nRunning(0), nWaiting(0), nMaxWaiting(0) {}
+};
+
+/** Get the stats of each method called so far */
+std::map<std::string, CRPCMethodStats> GetRPCStats();
+
 extern CRPCTable tableRPC;
 
 /**
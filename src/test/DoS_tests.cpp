@@ -5,8 +5,10 @@
 // Unit tests for denial-of-service detection/prevention code
 
 #include <chainparams.h>
+#include <hash.h>
 #include <keystore.h>
 #include <net.h>
+#include <netmessagemaker.h>
 #include <net_processing.h>
 #include <pow.h>
 #include <script/sign.h>
@@ -382,4 +384,87 @@ BOOST_AUTO_TEST_CASE(DoS_mapOrphans)
     BOOST_CHECK(mapOrphanTransactions.empty());
 }
 
+// Hand node a tx message, as the socket handler would once it had read it
+static void QueueTxMessage(CNode& node, const CTransactionRef& tx)
+{
+    CSerializedNetMsg msg = CNetMsgMaker(PROTOCOL_VERSION).Make(NetMsgType::TX, *tx);
+    CMessageHeader hdr(Params().MessageStart(), msg.command.c_str(), msg.data.size());
+    uint256 hash = Hash(msg.data.begin(), msg.data.end());
+    memcpy(hdr.pchChecksum, hash.begin(), CMessageHeader::CHECKSUM_SIZE);
+    CDataStream header(SER_NETWORK, INIT_PROTO_VERSION);
+    header << hdr;
+
+    CNetMessage netmsg(Params().MessageStart(), SER_NETWORK, INIT_PROTO_VERSION);
+    BOOST_REQUIRE_EQUAL(netmsg.readHeader(header.data(), header.size()), (int)header.size());
+    BOOST_REQUIRE_EQUAL(netmsg.readData((const char*)msg.data.data(), msg.data.size()), (int)msg.data.size());
+    BOOST_REQUIRE(netmsg.complete());
+    LOCK(node.cs_vProcessMsg);
+    node.vProcessMsg.push_back(netmsg);
+    node.nProcessQueueSize += msg.data.size() + CMessageHeader::HEADER_SIZE;
+}
+
+// Orphans are resolved in batches when a relayed parent arrives: each round
+// accepts the orphans spending the last round's transactions, and a peer
+// that sent an invalid one is still punished
+BOOST_FIXTURE_TEST_CASE(DoS_orphans_resolved_in_batches, TestChain100Setup)
+{
+    std::atomic<bool> interruptDummy(false);
+    connman->ClearBanned();
+
+    std::vector<std::unique_ptr<CNode>> vNodes;
+    for (uint32_t i = 1; i <= 2; i++) {
+        vNodes.emplace_back(new CNode(id++, NODE_NETWORK, 0, INVALID_SOCKET, CAddress(ip(0xa0b0c100 | i), NODE_NONE), 0, 0, CAddress(), "", true));
+        CNode& node = *vNodes.back();
+        node.SetSendVersion(PROTOCOL_VERSION);
+        node.SetRecvVersion(PROTOCOL_VERSION);
+        peerLogic->InitializeNode(&node);
+        node.nVersion = PROTOCOL_VERSION;
+        node.fSuccessfullyConnected = true;
+    }
+    CNode& honest = *vNodes[0];
+    CNode& attacker = *vNodes[1];
+
+    CScript scriptPubKey = CScript() << ToByteVector(coinbaseKey.GetPubKey()) << OP_CHECKSIG;
+    CTransactionRef parent = SpendSigned(coinbaseTxns[0], scriptPubKey, coinbaseKey, CENT);
+    CTransactionRef child = SpendSigned(*parent, scriptPubKey, coinbaseKey, CENT);
+    CTransactionRef grandchild = SpendSigned(*child, scriptPubKey, coinbaseKey, CENT);
+    CTransactionRef childBadSig = SpendSigned(*parent, scriptPubKey, coinbaseKey, 2 * CENT, true);
+
+    // Without their parent, all three are kept as orphans
+    QueueTxMessage(honest, grandchild);
+    QueueTxMessage(honest, child);
+    QueueTxMessage(attacker, childBadSig);
+    while (peerLogic->ProcessMessages(&honest, interruptDummy)) {}
+    while (peerLogic->ProcessMessages(&attacker, interruptDummy)) {}
+    {
+        LOCK2(cs_main, mempool.cs);
+        BOOST_CHECK_EQUAL(mapOrphanTransactions.size(), 3U);
+        BOOST_CHECK_EQUAL(mempool.size(), 0U);
+    }
+
+    // The parent brings in the child and grandchild, and the invalid child is dropped
+    QueueTxMessage(honest, parent);
+    while (peerLogic->ProcessMessages(&honest, interruptDummy)) {}
+    {
+        LOCK2(cs_main, mempool.cs);
+        BOOST_CHECK(mempool.exists(parent->GetHash()));
+        BOOST_CHECK(mempool.exists(child->GetHash()));
+        BOOST_CHECK(mempool.exists(grandchild->GetHash()));
+        BOOST_CHECK(!mempool.exists(childBadSig->GetHash()));
+        BOOST_CHECK_EQUAL(mempool.size(), 3U);
+        BOOST_CHECK(mapOrphanTransactions.empty());
+    }
+
+    for (CNode* pnode : {&honest, &attacker}) {
+        LOCK(pnode->cs_sendProcessing);
+        peerLogic->SendMessages(pnode, interruptDummy);
+    }
+    BOOST_CHECK(!connman->IsBanned(honest.addr));
+    BOOST_CHECK(connman->IsBanned(attacker.addr));
+
+    bool dummy;
+    for (const std::unique_ptr<CNode>& pnode : vNodes)
+        peerLogic->FinalizeNode(pnode->GetId(), dummy);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,91 @@
+// Copyright (c) 2026 The PlexHive Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <bctindex.h>
+#include <chain.h>
+#include <chainparams.h>
+#include <primitives/block.h>
+#include <random.h>
+#include <test/test_bitcoin.h>
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_FIXTURE_TEST_SUITE(bctindex_tests, BasicTestingSetup)
+
+static CTransactionRef MakeBCT(const Consensus::Params& consensusParams, CAmount beeFee, const CScript& scriptPubKeyHoney, CAmount communityContrib)
+{
+    CMutableTransaction tx;
+    tx.vin.resize(1);
+    tx.vin[0].prevout = COutPoint(InsecureRand256(), 0);
+    tx.vout.resize(communityContrib ? 2 : 1);
+    tx.vout[0].nValue = beeFee;
+    tx.vout[0].scriptPubKey = consensusParams.scriptPubKeyBCF;
+    tx.vout[0].scriptPubKey << OP_RETURN << OP_BEE;
+    tx.vout[0].scriptPubKey.insert(tx.vout[0].scriptPubKey.end(), scriptPubKeyHoney.begin(), scriptPubKeyHoney.end());
+    if (communityContrib) {
+        tx.vout[1].nValue = communityContrib;
+        tx.vout[1].scriptPubKey = consensusParams.scriptPubKeyCF;
+    }
+    return MakeTransactionRef(tx);
+}
+
+BOOST_AUTO_TEST_CASE(bctindex_lookup)
+{
+    const Consensus::Params& consensusParams = Params().GetConsensus();
+    CBCTIndex index(1 << 20, true);
+
+    // A chain of 100 blocks, and a fork from height 50
+    std::vector<uint256> hashes(150);
+    std::vector<CBlockIndex> chain(100), fork(50);
+    for (int i = 0; i < 150; i++) {
+        CBlockIndex& block = i < 100 ? chain[i] : fork[i - 100];
+        block.nHeight = i < 100 ? i : i - 50;
+        block.pprev = block.nHeight == 0 ? nullptr : i == 100 ? &chain[49] : &block - 1;
+        hashes[i] = InsecureRand256();
+        block.phashBlock = &hashes[i];
+        block.BuildSkip();
+    }
+
+    CScript scriptPubKeyHoney = CScript() << OP_DUP << OP_HASH160 << ToByteVector(uint160()) << OP_EQUALVERIFY << OP_CHECKSIG;
+    CTransactionRef bct = MakeBCT(consensusParams, 12345, scriptPubKeyHoney, 0);
+    CTransactionRef bctContrib = MakeBCT(consensusParams, 20000, scriptPubKeyHoney, 777);
+    CMutableTransaction notBCT(*bct);
+    notBCT.vout[0].scriptPubKey = scriptPubKeyHoney;
+
+    CBlock block;
+    CMutableTransaction coinbase;
+    coinbase.vin.resize(1);
+    coinbase.vout.resize(1);
+    block.vtx.push_back(MakeTransactionRef(coinbase));
+    block.vtx.push_back(bct);
+    block.vtx.push_back(bctContrib);
+    block.vtx.push_back(MakeTransactionRef(notBCT));
+    BOOST_CHECK(index.WriteBlock(block, &chain[60], consensusParams));
+
+    CBCTIndexEntry entry;
+    BOOST_CHECK(index.Lookup(bct->GetHash(), &chain[99], entry));
+    BOOST_CHECK_EQUAL(entry.nHeight, 60);
+    BOOST_CHECK(entry.hashBlock == hashes[60]);
+    BOOST_CHECK_EQUAL(entry.nBeeFee, 12345);
+    BOOST_CHECK(!entry.fCommunityContrib);
+    BOOST_CHECK(entry.BCTScript(consensusParams.scriptPubKeyBCF) == bct->vout[0].scriptPubKey);
+
+    BOOST_CHECK(index.Lookup(bctContrib->GetHash(), &chain[60], entry));
+    BOOST_CHECK(entry.fCommunityContrib);
+    BOOST_CHECK_EQUAL(entry.nCommunityContrib, 777);
+
+    BOOST_CHECK(!index.Lookup(notBCT.GetHash(), &chain[99], entry));
+
+    // Not visible from before its block, nor from a branch that doesn't hold it
+    BOOST_CHECK(!index.Lookup(bct->GetHash(), &chain[59], entry));
+    BOOST_CHECK(!index.Lookup(bct->GetHash(), &fork[49], entry));
+
+    // Once reconfirmed on the fork, it's visible from there but no longer from the old chain
+    BOOST_CHECK(index.WriteBlock(block, &fork[20], consensusParams));
+    BOOST_CHECK(index.Lookup(bct->GetHash(), &fork[49], entry));
+    BOOST_CHECK_EQUAL(entry.nHeight, 70);
+    BOOST_CHECK(!index.Lookup(bct->GetHash(), &chain[99], entry));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
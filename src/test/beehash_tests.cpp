@@ -0,0 +1,62 @@
+// Copyright (c) 2026 The PlexHive Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <arith_uint256.h>
+#include <beehash.h>
+#include <hash.h>
+#include <primitives/block.h>
+#include <test/test_bitcoin.h>
+
+#include <sstream>
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_FIXTURE_TEST_SUITE(beehash_tests, BasicTestingSetup)
+
+static const std::string detRandString =
+    "5f2e7ab91d3c4a0e8f6b2d1c9a7e3f05b4c8d2e6f1a3b5c7d9e0f2a4b6c8d0e2"
+    "0e1d2c3b4a5968778695a4b3c2d1e0f0f1e2d3c4b5a69788796a5b4c3d2e1f00";
+static const std::string bctTxid = "8a7c2e5d9b1f3a6c4e0d8b2f7a5c3e1d9b7f5a3c1e0d2b4f6a8c0e2d4b6f8a0c";
+static const uint32_t beeNonces[] = { 0, 1, 9, 10, 99, 100, 12345, 999999, 1000000, 2147483647, 4294967295 };
+
+// Reference formulations, as the miner and CheckHiveProof computed them before CBeeHasher
+static arith_uint256 LegacySHA256dBeeHash(int nonce)
+{
+    std::string hashHex = (CHashWriter(SER_GETHASH, 0) << detRandString << bctTxid << nonce).GetHash().GetHex();
+    return arith_uint256(hashHex);
+}
+
+static arith_uint256 LegacyMinotaurBeeHash(uint32_t nonce)
+{
+    std::stringstream buf;
+    buf << detRandString << bctTxid << nonce;
+    return arith_uint256(CBlockHeader::MinotaurHashString(buf.str()).ToString());
+}
+
+BOOST_AUTO_TEST_CASE(beehash_sha256d_matches_legacy)
+{
+    CBeeHasher hasher(detRandString, bctTxid, false);
+    for (uint32_t nonce : beeNonces)
+        BOOST_CHECK(hasher.GetBeeHash(nonce) == LegacySHA256dBeeHash(nonce));
+}
+
+BOOST_AUTO_TEST_CASE(beehash_minotaur_matches_legacy)
+{
+    CBeeHasher hasher(detRandString, bctTxid, true);
+    for (uint32_t nonce : beeNonces)
+        BOOST_CHECK(hasher.GetBeeHash(nonce) == LegacyMinotaurBeeHash(nonce));
+
+    // Reusing the buffer with a shorter nonce mustn't leave stale digits behind
+    BOOST_CHECK(hasher.GetBeeHash(7) == LegacyMinotaurBeeHash(7));
+}
+
+BOOST_AUTO_TEST_CASE(beehash_check_bee)
+{
+    CBeeHasher hasher(detRandString, bctTxid, true);
+    arith_uint256 beeHash = hasher.GetBeeHash(42);
+    BOOST_CHECK(!hasher.CheckBee(42, beeHash));
+    BOOST_CHECK(hasher.CheckBee(42, beeHash + 1));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
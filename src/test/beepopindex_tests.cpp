@@ -0,0 +1,106 @@
+// Copyright (c) 2026 The PlexHive Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <beepopindex.h>
+#include <chain.h>
+#include <chainparams.h>
+#include <random.h>
+#include <test/test_bitcoin.h>
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_FIXTURE_TEST_SUITE(beepopindex_tests, BasicTestingSetup)
+
+// Reference formulation, as GetNetworkHiveInfo filled the global beePopGraph before the population index
+static std::vector<BeePopGraphPoint> NaiveBeePopGraph(const std::vector<CBeePopEntry>& entries, int tipHeight, const Consensus::Params& consensusParams)
+{
+    int totalBeeLifespan = consensusParams.beeGestationBlocks + consensusParams.beeLifespanBlocks;
+    std::vector<BeePopGraphPoint> graph(totalBeeLifespan, BeePopGraphPoint{0, 0});
+    for (const CBeePopEntry& entry : entries) {
+        int beeBornBlock = entry.nHeight;
+        int beeMaturesBlock = beeBornBlock + consensusParams.beeGestationBlocks;
+        int beeDiesBlock = beeMaturesBlock + consensusParams.beeLifespanBlocks;
+        for (int j = beeBornBlock; j < beeDiesBlock; j++) {
+            int graphPos = j - tipHeight;
+            if (graphPos > 0 && graphPos < totalBeeLifespan) {
+                if (j < beeMaturesBlock)
+                    graph[graphPos].immaturePop += entry.nBees;
+                else
+                    graph[graphPos].maturePop += entry.nBees;
+            }
+        }
+    }
+    return graph;
+}
+
+BOOST_AUTO_TEST_CASE(beepop_graph_matches_naive)
+{
+    Consensus::Params consensusParams;
+    consensusParams.beeGestationBlocks = 40;
+    consensusParams.beeLifespanBlocks = 200;
+    const int tipHeight = 10000;
+
+    std::vector<CBeePopEntry> entries;
+    for (int height = tipHeight - 239; height <= tipHeight; height++) {
+        if (InsecureRandBits(2))
+            continue;
+        CBeePopEntry entry;
+        entry.nHeight = height;
+        entry.nBees = InsecureRandRange(1000) + 1;
+        entry.nBCTs = 1;
+        entries.push_back(entry);
+    }
+
+    std::vector<BeePopGraphPoint> graph;
+    BuildBeePopGraph(entries, tipHeight, consensusParams, graph);
+    std::vector<BeePopGraphPoint> expected = NaiveBeePopGraph(entries, tipHeight, consensusParams);
+    BOOST_CHECK_EQUAL(graph.size(), expected.size());
+    for (size_t i = 0; i < graph.size(); i++) {
+        BOOST_CHECK_EQUAL(graph[i].immaturePop, expected[i].immaturePop);
+        BOOST_CHECK_EQUAL(graph[i].maturePop, expected[i].maturePop);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(beepop_index_ring)
+{
+    const Consensus::Params& consensusParams = Params().GetConsensus();
+    const int window = consensusParams.beeGestationBlocks + consensusParams.beeLifespanBlocks;
+    CBeePopulationIndex index(consensusParams, 1 << 20, true);
+
+    uint256 hashA = InsecureRand256(), hashB = InsecureRand256(), hashC = InsecureRand256();
+    CBlockIndex blockA, blockB, blockC;
+    blockA.nHeight = 5000;
+    blockA.phashBlock = &hashA;
+    blockB.nHeight = 5000;          // A competing block at the same height
+    blockB.phashBlock = &hashB;
+    blockC.nHeight = 5000 + window; // Shares A's slot in the ring
+    blockC.phashBlock = &hashC;
+
+    CBeePopEntry entry;
+    BOOST_CHECK(!index.Lookup(&blockA, entry));
+
+    CBeePopEntry stored;
+    stored.nHeight = blockA.nHeight;
+    stored.hashBlock = hashA;
+    stored.nBees = 123;
+    stored.nBCTs = 2;
+    index.Store(stored);
+    BOOST_CHECK(index.Lookup(&blockA, entry));
+    BOOST_CHECK_EQUAL(entry.nBees, 123);
+    BOOST_CHECK_EQUAL(entry.nBCTs, 2);
+
+    // A block reorged in at the same height, or one a full window later, mustn't see A's entry
+    BOOST_CHECK(!index.Lookup(&blockB, entry));
+    BOOST_CHECK(!index.Lookup(&blockC, entry));
+
+    stored.nHeight = blockC.nHeight;
+    stored.hashBlock = hashC;
+    stored.nBees = 7;
+    index.Store(stored);
+    BOOST_CHECK(!index.Lookup(&blockA, entry));
+    BOOST_CHECK(index.Lookup(&blockC, entry));
+    BOOST_CHECK_EQUAL(entry.nBees, 7);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,65 @@
+// Copyright (c) 2026 The PlexHive Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <blockcache.h>
+#include <chain.h>
+#include <chainparams.h>
+#include <primitives/block.h>
+#include <validation.h>
+#include <test/test_bitcoin.h>
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_FIXTURE_TEST_SUITE(blockcache_tests, TestingSetup)
+
+BOOST_AUTO_TEST_CASE(blockcache_get)
+{
+    const Consensus::Params& consensusParams = Params().GetConsensus();
+    const CBlock& genesis = Params().GenesisBlock();
+    const CBlockIndex* pindex;
+    {
+        LOCK(cs_main);
+        pindex = chainActive.Genesis();
+    }
+    BOOST_REQUIRE(pindex);
+
+    CSerializedBlockCache cache;
+
+    // A miss reads the block and serializes it as the network would
+    SerializedBlockRef witness = cache.Get(pindex, true, consensusParams);
+    BOOST_REQUIRE(witness);
+    BOOST_CHECK(*witness == *CSerializedBlockCache::Serialize(genesis, true));
+    SerializedBlockRef noWitness = cache.Get(pindex, false, consensusParams);
+    BOOST_REQUIRE(noWitness);
+    BOOST_CHECK(*noWitness == *CSerializedBlockCache::Serialize(genesis, false));
+
+    CSerializedBlockCache::Stats stats = cache.GetStats();
+    BOOST_CHECK_EQUAL(stats.nHits, 0U);
+    BOOST_CHECK_EQUAL(stats.nMisses, 2U);
+    BOOST_CHECK_EQUAL(stats.nEntries, 2U);
+    BOOST_CHECK(stats.nUsage > witness->size() + noWitness->size());
+
+    // A hit hands back the same bytes
+    BOOST_CHECK(cache.Get(pindex, true, consensusParams) == witness);
+    stats = cache.GetStats();
+    BOOST_CHECK_EQUAL(stats.nHits, 1U);
+    BOOST_CHECK_EQUAL(stats.nMisses, 2U);
+
+    // Shrinking the budget evicts least recently used first
+    cache.SetMaxUsage(stats.nUsage - 1);
+    stats = cache.GetStats();
+    BOOST_CHECK_EQUAL(stats.nEntries, 1U);
+    BOOST_CHECK(cache.Get(pindex, true, consensusParams) == witness);
+    BOOST_CHECK_EQUAL(cache.GetStats().nHits, 2U);
+
+    // With no budget, blocks are still served but never kept
+    cache.SetMaxUsage(0);
+    BOOST_CHECK_EQUAL(cache.GetStats().nEntries, 0U);
+    BOOST_CHECK(*cache.Get(pindex, true, consensusParams) == *witness);
+    stats = cache.GetStats();
+    BOOST_CHECK_EQUAL(stats.nEntries, 0U);
+    BOOST_CHECK_EQUAL(stats.nUsage, 0U);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,132 @@
+// Copyright (c) 2026 The PlexHive Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <blockfilereader.h>
+#include <chainparams.h>
+#include <clientversion.h>
+#include <consensus/merkle.h>
+#include <fs.h>
+#include <primitives/block.h>
+#include <streams.h>
+#include <validation.h>
+#include <test/test_bitcoin.h>
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_FIXTURE_TEST_SUITE(blockfilereader_tests, TestingSetup)
+
+static CBlock MakeBlock(uint32_t nNonce)
+{
+    CMutableTransaction coinbase;
+    coinbase.vin.resize(1);
+    coinbase.vin[0].scriptSig = CScript() << nNonce << OP_0;
+    coinbase.vout.resize(1);
+    CBlock block;
+    block.vtx.push_back(MakeTransactionRef(coinbase));
+    block.hashMerkleRoot = BlockMerkleRoot(block);
+    block.nNonce = nNonce;
+    return block;
+}
+
+// Append a block to block file nFile, as WriteBlockToDisk does, but with the given size in its record header
+static CDiskBlockPos AppendBlock(int nFile, const CBlock& block, unsigned int nSize)
+{
+    FILE* file = OpenBlockFile(CDiskBlockPos(nFile, 0));
+    BOOST_REQUIRE(file);
+    fseek(file, 0, SEEK_END);
+    CAutoFile fileout(file, SER_DISK, CLIENT_VERSION);
+    fileout << FLATDATA(Params().MessageStart()) << nSize;
+    CDiskBlockPos pos(nFile, ftell(fileout.Get()));
+    fileout << block;
+    return pos;
+}
+
+static CDiskBlockPos AppendBlock(int nFile, const CBlock& block)
+{
+    return AppendBlock(nFile, block, ::GetSerializeSize(block, SER_DISK, CLIENT_VERSION));
+}
+
+// Block files can't be mapped on Windows, where every mapped read reports failure
+#ifndef WIN32
+BOOST_AUTO_TEST_CASE(blockfilereader_read)
+{
+    CBlockFileReader reader(2);
+    CBlock block1 = MakeBlock(1), block2 = MakeBlock(2);
+    CDiskBlockPos pos1 = AppendBlock(1000, block1);
+    CDiskBlockPos pos2 = AppendBlock(1000, block2);
+
+    CBlock block;
+    BOOST_CHECK(reader.ReadBlock(block, pos1));
+    BOOST_CHECK(block.GetHash() == block1.GetHash());
+    BOOST_CHECK(reader.ReadBlock(block, pos2));
+    BOOST_CHECK(block.GetHash() == block2.GetHash());
+
+    // Positions that can't hold a block, and files that don't exist, are reported rather than mapped
+    BOOST_CHECK(!reader.ReadBlock(block, CDiskBlockPos()));
+    BOOST_CHECK(!reader.ReadBlock(block, CDiskBlockPos(1000, 4)));
+    BOOST_CHECK(!reader.ReadBlock(block, CDiskBlockPos(1001, pos1.nPos)));
+}
+
+BOOST_AUTO_TEST_CASE(blockfilereader_remap)
+{
+    CBlockFileReader reader(2);
+    CBlock block1 = MakeBlock(1), block2 = MakeBlock(2);
+    CDiskBlockPos pos1 = AppendBlock(1000, block1);
+
+    CBlock block;
+    BOOST_CHECK(reader.ReadBlock(block, pos1));
+
+    // A block appended after the file was mapped lies past the mapping, so the file is mapped afresh
+    CDiskBlockPos pos2 = AppendBlock(1000, block2);
+    BOOST_CHECK(reader.ReadBlock(block, pos2));
+    BOOST_CHECK(block.GetHash() == block2.GetHash());
+    BOOST_CHECK(reader.ReadBlock(block, pos1));
+    BOOST_CHECK(block.GetHash() == block1.GetHash());
+}
+
+BOOST_AUTO_TEST_CASE(blockfilereader_invalidate)
+{
+    CBlockFileReader reader(2);
+    CBlock block1 = MakeBlock(1);
+    CDiskBlockPos pos1 = AppendBlock(1000, block1);
+    CDiskBlockPos pos2 = AppendBlock(1001, block1);
+
+    CBlock block;
+    BOOST_CHECK(reader.ReadBlock(block, pos1));
+    BOOST_CHECK(reader.ReadBlock(block, pos2));
+
+    // A mapping outlives its file's removal until it's invalidated
+    fs::remove(GetBlockPosFilename(pos1, "blk"));
+    BOOST_CHECK(reader.ReadBlock(block, pos1));
+    reader.Invalidate(pos1.nFile);
+    BOOST_CHECK(!reader.ReadBlock(block, pos1));
+
+    // Other files' mappings are left alone, until they're all cleared
+    fs::remove(GetBlockPosFilename(pos2, "blk"));
+    BOOST_CHECK(reader.ReadBlock(block, pos2));
+    reader.Clear();
+    BOOST_CHECK(!reader.ReadBlock(block, pos2));
+}
+
+#endif // WIN32
+
+BOOST_AUTO_TEST_CASE(blockfilereader_fallback)
+{
+    const Consensus::Params& consensusParams = Params().GetConsensus();
+    CBlock block1 = MakeBlock(1);
+
+    // A record header understating the block's size makes the mapped read run out of data,
+    // while reading the file doesn't look at the size
+    CDiskBlockPos pos = AppendBlock(1002, block1, 10);
+    CBlock block;
+#ifndef WIN32
+    CBlockFileReader reader(2);
+    BOOST_CHECK_THROW(reader.ReadBlock(block, pos), std::ios_base::failure);
+#endif
+
+    BOOST_CHECK(ReadBlockFromDisk(block, pos, consensusParams, false));
+    BOOST_CHECK(block.GetHash() == block1.GetHash());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,114 @@
+// Copyright (c) 2026 The PlexHive Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <blockprefetch.h>
+#include <chain.h>
+#include <chainparams.h>
+#include <coins.h>
+#include <key.h>
+#include <script/standard.h>
+#include <validation.h>
+#include <test/test_bitcoin.h>
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_FIXTURE_TEST_SUITE(blockprefetch_tests, TestChain100Setup)
+
+BOOST_AUTO_TEST_CASE(blockprefetch_take)
+{
+    const Consensus::Params& consensusParams = Params().GetConsensus();
+    CScript scriptPubKey = CScript() << ToByteVector(coinbaseKey.GetPubKey()) << OP_CHECKSIG;
+
+    // A block spending a coinbase, and the output of that spend
+    CTransactionRef tx0 = SpendSigned(coinbaseTxns[0], scriptPubKey, coinbaseKey, CENT);
+    CTransactionRef tx1 = SpendSigned(*tx0, scriptPubKey, coinbaseKey, CENT);
+    std::vector<CMutableTransaction> txns = {CMutableTransaction(*tx0), CMutableTransaction(*tx1)};
+
+    CBlock block = CreateAndProcessBlock(txns, scriptPubKey);
+    const CBlockIndex* pindex;
+    {
+        LOCK(cs_main);
+        pindex = chainActive.Tip();
+    }
+    BOOST_REQUIRE(pindex->GetBlockHash() == block.GetHash());
+
+    // Prefetch from a view that still has the coinbase unspent, as it was before the block connected
+    const COutPoint coinbaseOut(coinbaseTxns[0].GetHash(), 0);
+    CCoinsView viewEmpty;
+    CCoinsViewCache viewBase(&viewEmpty);
+    viewBase.AddCoin(coinbaseOut, Coin(coinbaseTxns[0].vout[0], 1, true), false);
+    const std::vector<const CBlockIndex*> vpindex = {pindex->pprev, pindex};
+
+    CBlockPrefetcher prefetcher;
+    {
+        LOCK(cs_main);
+        // Without threads, nothing is prefetched
+        prefetcher.Prefetch(vpindex, &viewBase, consensusParams);
+        BOOST_CHECK(!prefetcher.Take(pindex));
+    }
+
+    prefetcher.Start(2);
+    BOOST_CHECK(prefetcher.IsRunning());
+    {
+        LOCK(cs_main);
+        prefetcher.Prefetch(vpindex, &viewBase, consensusParams);
+        // Only the blocks after the first are prepared
+        BOOST_CHECK(!prefetcher.Take(pindex->pprev));
+
+        std::unique_ptr<CPrefetchedBlock> prefetched = prefetcher.Take(pindex);
+        BOOST_REQUIRE(prefetched);
+        BOOST_CHECK(prefetched->pblock->GetHash() == block.GetHash());
+        BOOST_REQUIRE_EQUAL(prefetched->txdata.size(), block.vtx.size());
+        PrecomputedTransactionData txdata(*block.vtx[1]);
+        BOOST_CHECK(prefetched->txdata[1].hashPrevouts == txdata.hashPrevouts);
+        BOOST_CHECK(prefetched->txdata[1].hashOutputs == txdata.hashOutputs);
+
+        // The spend of the block's own output isn't looked up
+        BOOST_CHECK_EQUAL(prefetched->nInputsLooked, 1U);
+        BOOST_REQUIRE_EQUAL(prefetched->coins.size(), 1U);
+        BOOST_CHECK(prefetched->coins[0].first == coinbaseOut);
+        BOOST_CHECK(prefetched->coins[0].second.out == coinbaseTxns[0].vout[0]);
+
+        // Taken once only
+        BOOST_CHECK(!prefetcher.Take(pindex));
+
+        // A flush below the tip cache while the block's prepared makes the coins looked up stale
+        prefetcher.Prefetch(vpindex, &viewBase, consensusParams);
+        prefetcher.CoinsFlushed();
+        prefetched = prefetcher.Take(pindex);
+        BOOST_REQUIRE(prefetched);
+        BOOST_CHECK(prefetched->pblock->GetHash() == block.GetHash());
+        BOOST_CHECK(prefetched->coins.empty());
+
+        // Blocks no longer due are dropped
+        prefetcher.Prefetch(vpindex, &viewBase, consensusParams);
+        prefetcher.Prefetch({pindex->pprev}, &viewBase, consensusParams);
+        BOOST_CHECK(!prefetcher.Take(pindex));
+    }
+
+    prefetcher.Stop();
+    BOOST_CHECK(!prefetcher.IsRunning());
+}
+
+BOOST_AUTO_TEST_CASE(blockprefetch_add_fetched_coin)
+{
+    const COutPoint outpoint(coinbaseTxns[0].GetHash(), 0);
+    CCoinsView viewEmpty;
+    CCoinsViewCache cache(&viewEmpty);
+
+    // A coin added as fetched is clean, so isn't flushed and can be uncached
+    cache.AddFetchedCoin(outpoint, Coin(coinbaseTxns[0].vout[0], 1, true));
+    BOOST_CHECK(cache.HaveCoinInCache(outpoint));
+    BOOST_CHECK(cache.DynamicMemoryUsage() > 0);
+    cache.Uncache(outpoint);
+    BOOST_CHECK(!cache.HaveCoinInCache(outpoint));
+
+    // An entry already in the cache wins
+    cache.AddFetchedCoin(outpoint, Coin(coinbaseTxns[0].vout[0], 1, true));
+    BOOST_CHECK(cache.SpendCoin(outpoint));
+    cache.AddFetchedCoin(outpoint, Coin(coinbaseTxns[0].vout[0], 1, true));
+    BOOST_CHECK(!cache.HaveCoinInCache(outpoint));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
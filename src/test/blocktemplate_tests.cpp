@@ -0,0 +1,147 @@
+// Copyright (c) 2026 The PlexHive Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <blocktemplate.h>
+#include <chainparams.h>
+#include <consensus/validation.h>
+#include <key.h>
+#include <miner.h>
+#include <pow.h>
+#include <script/standard.h>
+#include <txmempool.h>
+#include <validation.h>
+#include <test/test_bitcoin.h>
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_FIXTURE_TEST_SUITE(blocktemplate_tests, TestChain100Setup)
+
+static bool ToMemPool(const CTransactionRef& tx)
+{
+    LOCK(cs_main);
+    CValidationState state;
+    return AcceptToMemoryPool(mempool, state, tx, nullptr, nullptr, true, 0);
+}
+
+static bool InTemplate(const CBlockTemplate& tmpl, const CTransactionRef& tx)
+{
+    for (const CTransactionRef& txBlock : tmpl.block.vtx) {
+        if (txBlock->GetHash() == tx->GetHash())
+            return true;
+    }
+    return false;
+}
+
+BOOST_AUTO_TEST_CASE(blocktemplate_follows_mempool)
+{
+    const CChainParams& chainparams = Params();
+    CScript scriptPubKey = CScript() << ToByteVector(coinbaseKey.GetPubKey()) << OP_CHECKSIG;
+
+    CTransactionRef tx0 = SpendSigned(coinbaseTxns[0], scriptPubKey, coinbaseKey, CENT);
+    CTransactionRef tx1 = SpendSigned(coinbaseTxns[1], scriptPubKey, coinbaseKey, CENT);
+    BOOST_REQUIRE(ToMemPool(tx0));
+
+    // Without the engine running, nothing's served from it
+    blockTemplateEngine.Rebuild();
+    std::unique_ptr<CBlockTemplate> tmpl = BlockAssembler(chainparams).CreateNewBlock(scriptPubKey);
+    BOOST_REQUIRE(tmpl);
+    BOOST_CHECK(InTemplate(*tmpl, tx0));
+    BOOST_CHECK_EQUAL(blockTemplateEngine.GetStats().nServed, 0);
+
+    blockTemplateEngine.Start();
+    blockTemplateEngine.Rebuild();
+    CBlockTemplateEngine::Stats stats = blockTemplateEngine.GetStats();
+    BOOST_CHECK(stats.nBuilds >= 1);
+
+    // A built selection is served, whatever the pow type
+    tmpl = BlockAssembler(chainparams).CreateNewBlock(scriptPubKey, true, nullptr, POW_TYPE_MINOTAURX);
+    BOOST_REQUIRE(tmpl);
+    BOOST_CHECK(InTemplate(*tmpl, tx0));
+    BOOST_CHECK_EQUAL(blockTemplateEngine.GetStats().nServed, stats.nServed + 1);
+
+    // Transactions added with their parents selected are appended, children of selected ones included
+    CTransactionRef tx0Child = SpendSigned(*tx0, scriptPubKey, coinbaseKey, CENT);
+    BOOST_REQUIRE(ToMemPool(tx1));
+    BOOST_REQUIRE(ToMemPool(tx0Child));
+    BOOST_CHECK_EQUAL(blockTemplateEngine.GetStats().nAppended, stats.nAppended + 2);
+    tmpl = BlockAssembler(chainparams).CreateNewBlock(scriptPubKey);
+    BOOST_REQUIRE(tmpl);
+    BOOST_CHECK(InTemplate(*tmpl, tx1));
+    BOOST_CHECK(InTemplate(*tmpl, tx0Child));
+    BOOST_CHECK_EQUAL(tmpl->block.vtx.size(), 4);
+    BOOST_CHECK_EQUAL(tmpl->vTxFees[0], -3 * CENT);
+
+    // Removing a transaction takes its descendants out of the template with it
+    {
+        LOCK(mempool.cs);
+        mempool.removeRecursive(*tx0);
+    }
+    tmpl = BlockAssembler(chainparams).CreateNewBlock(scriptPubKey);
+    BOOST_REQUIRE(tmpl);
+    BOOST_CHECK(!InTemplate(*tmpl, tx0));
+    BOOST_CHECK(!InTemplate(*tmpl, tx0Child));
+    BOOST_CHECK(InTemplate(*tmpl, tx1));
+    BOOST_CHECK_EQUAL(tmpl->vTxFees[0], -CENT);
+    BOOST_CHECK_EQUAL(blockTemplateEngine.GetStats().nRemoved, stats.nRemoved + 2);
+
+    // A template served from the selection connects
+    CBlock& block = tmpl->block;
+    unsigned int extraNonce = 0;
+    {
+        LOCK(cs_main);
+        IncrementExtraNonce(&block, chainActive.Tip(), extraNonce);
+    }
+    while (!CheckProofOfWork(block.GetPoWHash(), block.nBits, chainparams.GetConsensus())) ++block.nNonce;
+    BOOST_CHECK(ProcessNewBlock(chainparams, std::make_shared<const CBlock>(block), true, nullptr));
+    {
+        LOCK(cs_main);
+        BOOST_CHECK(chainActive.Tip()->GetBlockHash() == block.GetHash());
+    }
+    BOOST_CHECK_EQUAL(mempool.size(), 0);
+
+    // Once stopped, templates are assembled afresh
+    stats = blockTemplateEngine.GetStats();
+    blockTemplateEngine.Stop();
+    BOOST_CHECK(!blockTemplateEngine.IsRunning());
+    tmpl = BlockAssembler(chainparams).CreateNewBlock(scriptPubKey);
+    BOOST_REQUIRE(tmpl);
+    BOOST_CHECK_EQUAL(tmpl->block.vtx.size(), 1);
+    BOOST_CHECK_EQUAL(blockTemplateEngine.GetStats().nServed, stats.nServed);
+}
+
+BOOST_AUTO_TEST_CASE(blocktemplate_checks_served_selection)
+{
+    const CChainParams& chainparams = Params();
+    CScript scriptPubKey = CScript() << ToByteVector(coinbaseKey.GetPubKey()) << OP_CHECKSIG;
+
+    CTransactionRef tx0 = SpendSigned(coinbaseTxns[0], scriptPubKey, coinbaseKey, CENT);
+    BOOST_REQUIRE(ToMemPool(tx0));
+    blockTemplateEngine.Start();
+    blockTemplateEngine.Rebuild();
+    CBlockTemplateEngine::Stats stats = blockTemplateEngine.GetStats();
+
+    // A child the mempool took unchecked is appended to the selection, but the template made from it is still checked
+    CTransactionRef txBad = SpendSigned(*tx0, scriptPubKey, coinbaseKey, CENT, true);
+    {
+        LOCK2(cs_main, mempool.cs);
+        TestMemPoolEntryHelper entry;
+        mempool.addUnchecked(txBad->GetHash(), entry.Fee(CENT).FromTx(*txBad));
+    }
+    BOOST_CHECK_EQUAL(blockTemplateEngine.GetStats().nAppended, stats.nAppended + 1);
+    BOOST_CHECK_THROW(BlockAssembler(chainparams).CreateNewBlock(scriptPubKey), std::runtime_error);
+
+    // Without it, templates are valid again
+    {
+        LOCK(mempool.cs);
+        mempool.removeRecursive(*txBad);
+    }
+    std::unique_ptr<CBlockTemplate> tmpl = BlockAssembler(chainparams).CreateNewBlock(scriptPubKey);
+    BOOST_REQUIRE(tmpl);
+    BOOST_CHECK(InTemplate(*tmpl, tx0));
+    BOOST_CHECK(!InTemplate(*tmpl, txBad));
+
+    blockTemplateEngine.Stop();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
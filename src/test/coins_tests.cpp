@@ -4,6 +4,7 @@
 
 #include <coins.h>
 #include <script/standard.h>
+#include <txdb.h>
 #include <uint256.h>
 #include <undo.h>
 #include <utilstrencodings.h>
@@ -855,4 +856,81 @@ BOOST_AUTO_TEST_CASE(ccoins_write)
                     CheckWriteCoins(parent_value, child_value, parent_value, parent_flags, child_flags, parent_flags);
 }
 
+static size_t CountDirty(const CCoinsViewCacheTest& cache)
+{
+    size_t count = 0;
+    for (const auto& entry : cache.map())
+        count += (entry.second.flags & CCoinsCacheEntry::DIRTY) ? 1 : 0;
+    return count;
+}
+
+// A background flush reaches the database, and the cache sees the flushed coins through the frozen
+// layer until it does
+BOOST_FIXTURE_TEST_CASE(ccoins_background_flush, TestingSetup)
+{
+    CCoinsViewDB db(1 << 20, true, true);
+    CCoinsViewBackgroundFlush flusher(&db, &db);
+    CCoinsViewCacheTest cache(&flusher);
+
+    std::vector<COutPoint> outpoints(4);
+    for (COutPoint& outpoint : outpoints)
+        outpoint = COutPoint(InsecureRand256(), 0);
+    Coin coin;
+    coin.out.nValue = 50;
+    coin.out.scriptPubKey = CScript() << OP_TRUE;
+    coin.nHeight = 1;
+
+    cache.AddCoin(outpoints[0], Coin(coin), false);
+    cache.AddCoin(outpoints[1], Coin(coin), false);
+    uint256 hashFirst = InsecureRand256();
+    cache.SetBestBlock(hashFirst);
+    BOOST_CHECK_EQUAL(CountDirty(cache), 2U);
+    BOOST_CHECK(flusher.FlushInBackground(cache));
+    BOOST_CHECK_EQUAL(CountDirty(cache), 0U);
+    BOOST_CHECK_EQUAL(cache.GetCacheSize(), 0U);
+    BOOST_CHECK(cache.HaveCoin(outpoints[0]));
+    BOOST_CHECK(flusher.Wait());
+    BOOST_CHECK(db.HaveCoin(outpoints[0]));
+    BOOST_CHECK(db.HaveCoin(outpoints[1]));
+    BOOST_CHECK(db.GetBestBlock() == hashFirst);
+
+    // Whether or not the write has finished, the spend and the new coin are visible below the cache
+    BOOST_CHECK(cache.SpendCoin(outpoints[0]));
+    cache.AddCoin(outpoints[2], Coin(coin), false);
+    uint256 hashSecond = InsecureRand256();
+    cache.SetBestBlock(hashSecond);
+    BOOST_CHECK_EQUAL(CountDirty(cache), 2U);
+    BOOST_CHECK(flusher.FlushInBackground(cache));
+    BOOST_CHECK_EQUAL(CountDirty(cache), 0U);
+    BOOST_CHECK(!flusher.HaveCoin(outpoints[0]));
+    BOOST_CHECK(flusher.HaveCoin(outpoints[1]));
+    BOOST_CHECK(flusher.HaveCoin(outpoints[2]));
+    BOOST_CHECK(flusher.GetBestBlock() == hashSecond);
+    BOOST_CHECK(flusher.DynamicMemoryUsage() > 0 || !flusher.GetStats().fPending);
+
+    // Once the write finishes, the database holds what was flushed and nothing's left frozen
+    BOOST_CHECK(flusher.Wait());
+    BOOST_CHECK(!flusher.GetStats().fPending);
+    BOOST_CHECK_EQUAL(flusher.DynamicMemoryUsage(), 0U);
+    BOOST_CHECK(!db.HaveCoin(outpoints[0]));
+    BOOST_CHECK(db.HaveCoin(outpoints[1]));
+    BOOST_CHECK(db.HaveCoin(outpoints[2]));
+    BOOST_CHECK(db.GetBestBlock() == hashSecond);
+
+    // A synchronous flush waits for the background one, then writes straight through
+    cache.AddCoin(outpoints[3], Coin(coin), false);
+    BOOST_CHECK(cache.Flush());
+    BOOST_CHECK(!db.HaveCoin(outpoints[0]));
+    BOOST_CHECK(db.HaveCoin(outpoints[1]));
+    BOOST_CHECK(db.HaveCoin(outpoints[2]));
+    BOOST_CHECK(db.HaveCoin(outpoints[3]));
+    BOOST_CHECK(db.GetBestBlock() == hashSecond);
+
+    CCoinsViewBackgroundFlush::Stats stats = flusher.GetStats();
+    BOOST_CHECK(!stats.fPending);
+    BOOST_CHECK_EQUAL(stats.nFlushes, 2);
+    BOOST_CHECK_EQUAL(stats.nLastFlushCoins, 2);
+    BOOST_CHECK(!flusher.HasFailed());
+}
+
 BOOST_AUTO_TEST_SUITE_END()
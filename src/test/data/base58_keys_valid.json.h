@@ -0,0 +1,3 @@
+namespace json_tests{
+static unsigned const char base58_keys_valid[] = {
+};};
@@ -0,0 +1,132 @@
+// Copyright (c) 2026 The PlexHive Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <flathashmap.h>
+#include <test/test_bitcoin.h>
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_FIXTURE_TEST_SUITE(flathashmap_tests, BasicTestingSetup)
+
+// Sends every key to one of a handful of buckets, so probe runs get long and cross erased buckets
+struct CollidingHasher
+{
+    size_t operator()(int key) const { return key % 7; }
+};
+
+template <typename Hash>
+static void CheckAgainstUnorderedMap()
+{
+    flathashmap<int, std::string, Hash> map;
+    std::unordered_map<int, std::string> reference;
+
+    for (int i = 0; i < 20000; i++) {
+        int key = InsecureRandRange(1000);
+        switch (InsecureRandRange(4)) {
+        case 0: {
+            auto inserted = map.emplace(key, std::to_string(i));
+            auto expected = reference.emplace(key, std::to_string(i));
+            BOOST_CHECK_EQUAL(inserted.second, expected.second);
+            BOOST_CHECK_EQUAL(inserted.first->second, expected.first->second);
+            break;
+        }
+        case 1:
+            BOOST_CHECK_EQUAL(map.erase(key), reference.erase(key));
+            break;
+        case 2: {
+            auto it = map.find(key);
+            auto expected = reference.find(key);
+            BOOST_CHECK_EQUAL(it == map.end(), expected == reference.end());
+            if (expected != reference.end())
+                BOOST_CHECK_EQUAL(it->second, expected->second);
+            break;
+        }
+        case 3:
+            map[key] += "x";
+            reference[key] += "x";
+            break;
+        }
+        BOOST_CHECK_EQUAL(map.size(), reference.size());
+
+        // Erasing while iterating, as BatchWrite does, must visit every element once
+        if (i % 2000 == 0) {
+            for (auto it = map.begin(); it != map.end(); ) {
+                if (it->first % 2) {
+                    BOOST_CHECK_EQUAL(reference.erase(it->first), 1U);
+                    it = map.erase(it);
+                } else {
+                    it++;
+                }
+            }
+            BOOST_CHECK_EQUAL(map.size(), reference.size());
+        }
+    }
+
+    size_t count = 0;
+    for (const auto& entry : map) {
+        BOOST_CHECK_EQUAL(reference.at(entry.first), entry.second);
+        count++;
+    }
+    BOOST_CHECK_EQUAL(count, reference.size());
+}
+
+BOOST_AUTO_TEST_CASE(flathashmap_matches_unordered_map)
+{
+    CheckAgainstUnorderedMap<std::hash<int>>();
+    CheckAgainstUnorderedMap<CollidingHasher>();
+}
+
+BOOST_AUTO_TEST_CASE(flathashmap_references_and_usage)
+{
+    flathashmap<int, std::string> map;
+    BOOST_CHECK_EQUAL(memusage::DynamicUsage(map), 0U);
+
+    // Values don't move when the table grows
+    std::string* value = &map[0];
+    for (int i = 1; i < 10000; i++)
+        map.emplace(i, "");
+    BOOST_CHECK(value == &map[0]);
+    BOOST_CHECK(memusage::DynamicUsage(map) > 10000 * sizeof(std::pair<const int, std::string>));
+
+    // Erased nodes are reused rather than allocated afresh
+    size_t usage = memusage::DynamicUsage(map);
+    for (int i = 0; i < 5000; i++)
+        BOOST_CHECK_EQUAL(map.erase(i), 1U);
+    for (int i = 10000; i < 15000; i++)
+        map.emplace(i, "");
+    BOOST_CHECK_EQUAL(memusage::DynamicUsage(map), usage);
+
+    map.clear();
+    BOOST_CHECK(map.empty());
+    BOOST_CHECK(map.begin() == map.end());
+    BOOST_CHECK_EQUAL(memusage::DynamicUsage(map), 0U);
+}
+
+BOOST_AUTO_TEST_CASE(flathashmap_emplace_existing)
+{
+    // Emplacing a key that's already present leaves the table alone, even when inserting would grow it.
+    // Growing moves elements between buckets, which shows in the iteration order.
+    flathashmap<uint32_t, int> map;
+    for (int i = 0; i < 1000; i++) {
+        uint32_t key = InsecureRand32();
+        if (!map.emplace(key, i).second)
+            continue;
+        std::vector<uint32_t> before, after;
+        for (const auto& entry : map)
+            before.push_back(entry.first);
+
+        auto result = map.emplace(key, -1);
+        BOOST_CHECK(!result.second);
+        BOOST_CHECK_EQUAL(result.first->second, i);
+        for (const auto& entry : map)
+            after.push_back(entry.first);
+        BOOST_CHECK(before == after);
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
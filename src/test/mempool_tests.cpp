@@ -571,4 +571,80 @@ BOOST_AUTO_TEST_CASE(MempoolSizeLimitTest)
     SetMockTime(0);
 }
 
+
+// Ancestor and descendant walks over a deep chain ending in a diamond, reached by more than one path
+BOOST_AUTO_TEST_CASE(MempoolDeepChainTest)
+{
+    CTxMemPool pool;
+    TestMemPoolEntryHelper entry;
+    LOCK(pool.cs);
+
+    std::vector<CTransactionRef> vChain;
+    uint256 hashPrev;
+    for (int i = 0; i < 30; i++) {
+        CMutableTransaction tx;
+        tx.vin.resize(1);
+        tx.vin[0].prevout = COutPoint(hashPrev, 0);
+        tx.vin[0].scriptSig = CScript() << i;
+        tx.vout.resize(2);
+        for (CTxOut& out : tx.vout) {
+            out.scriptPubKey = CScript() << OP_1 << OP_EQUAL;
+            out.nValue = COIN;
+        }
+        vChain.push_back(MakeTransactionRef(tx));
+        pool.addUnchecked(tx.GetHash(), entry.Fee(1000LL).FromTx(tx));
+        hashPrev = tx.GetHash();
+    }
+    CMutableTransaction side1, side2, join;
+    side1.vin.resize(1);
+    side1.vin[0].prevout = COutPoint(hashPrev, 0);
+    side1.vout.resize(1);
+    side1.vout[0].nValue = COIN;
+    side2.vin.resize(1);
+    side2.vin[0].prevout = COutPoint(hashPrev, 1);
+    side2.vout.resize(1);
+    side2.vout[0].nValue = COIN;
+    join.vin.resize(2);
+    join.vin[0].prevout = COutPoint(side1.GetHash(), 0);
+    join.vin[1].prevout = COutPoint(side2.GetHash(), 0);
+    join.vout.resize(1);
+    join.vout[0].nValue = COIN;
+    pool.addUnchecked(side1.GetHash(), entry.FromTx(side1));
+    pool.addUnchecked(side2.GetHash(), entry.FromTx(side2));
+    pool.addUnchecked(join.GetHash(), entry.FromTx(join));
+
+    CTxMemPool::txiter itFirst = pool.mapTx.find(vChain[0]->GetHash());
+    CTxMemPool::txiter itJoin = pool.mapTx.find(join.GetHash());
+    BOOST_CHECK_EQUAL(itJoin->GetCountWithAncestors(), 33);
+    BOOST_CHECK_EQUAL(itFirst->GetCountWithDescendants(), 33);
+
+    // Ancestors reached by both sides of the diamond are counted once
+    CMutableTransaction child;
+    child.vin.resize(1);
+    child.vin[0].prevout = COutPoint(join.GetHash(), 0);
+    child.vout.resize(1);
+    child.vout[0].nValue = COIN;
+    CTxMemPool::setEntries setAncestors;
+    std::string errString;
+    const uint64_t nNoLimit = std::numeric_limits<uint64_t>::max();
+    BOOST_CHECK(pool.CalculateMemPoolAncestors(entry.FromTx(child), setAncestors, nNoLimit, nNoLimit, nNoLimit, nNoLimit, errString));
+    BOOST_CHECK_EQUAL(setAncestors.size(), 33);
+
+    // Over the limit, from the parent's ancestor state alone
+    setAncestors.clear();
+    BOOST_CHECK(!pool.CalculateMemPoolAncestors(entry.FromTx(child), setAncestors, 25, nNoLimit, nNoLimit, nNoLimit, errString));
+    BOOST_CHECK_EQUAL(errString, "too many unconfirmed ancestors [limit: 25]");
+
+    // Confirming the chain a transaction at a time leaves the rest's state right
+    pool.removeForBlock({vChain[0]}, 1);
+    BOOST_CHECK_EQUAL(pool.mapTx.find(vChain[1]->GetHash())->GetCountWithAncestors(), 1);
+    BOOST_CHECK_EQUAL(pool.mapTx.find(vChain[1]->GetHash())->GetCountWithDescendants(), 32);
+    BOOST_CHECK_EQUAL(pool.mapTx.find(join.GetHash())->GetCountWithAncestors(), 32);
+    for (size_t i = 1; i < vChain.size(); i++)
+        pool.removeForBlock({vChain[i]}, 1);
+    BOOST_CHECK_EQUAL(pool.mapTx.find(join.GetHash())->GetCountWithAncestors(), 3);
+    BOOST_CHECK_EQUAL(pool.mapTx.find(side1.GetHash())->GetCountWithDescendants(), 2);
+    BOOST_CHECK_EQUAL(pool.size(), 3);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
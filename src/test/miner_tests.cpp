@@ -20,6 +20,7 @@
 
 #include <test/test_bitcoin.h>
 
+#include <limits>
 #include <memory>
 
 #include <boost/test/unit_test.hpp>
@@ -520,4 +521,26 @@ BOOST_AUTO_TEST_CASE(CreateNewBlock_validity)
     fCheckpointsEnabled = true;
 }
 
+// PlexHive: Hive: Mining optimisations
+BOOST_AUTO_TEST_CASE(hive_latency_histogram)
+{
+    CHiveLatency latency;
+    latency.Add(0);
+    latency.Add(1);
+    latency.Add(2);
+    latency.Add(1000);
+    latency.Add(1023);
+    latency.Add(1024);
+    latency.Add(std::numeric_limits<int64_t>::max());
+
+    BOOST_CHECK_EQUAL(latency.nCount, 7);
+    BOOST_CHECK_EQUAL(latency.vBuckets[0], 2);      // Up to 1us
+    BOOST_CHECK_EQUAL(latency.vBuckets[1], 1);      // Up to 3us
+    BOOST_CHECK_EQUAL(latency.vBuckets[9], 2);      // Up to 1023us
+    BOOST_CHECK_EQUAL(latency.vBuckets[10], 1);     // Up to 2047us
+    BOOST_CHECK_EQUAL(latency.vBuckets[CHiveLatency::NUM_BUCKETS - 1], 1);
+    BOOST_CHECK_EQUAL(CHiveLatency::BucketMax(9), 1023);
+    BOOST_CHECK_EQUAL(CHiveLatency::BucketMax(CHiveLatency::NUM_BUCKETS - 1), -1);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
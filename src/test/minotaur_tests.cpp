@@ -0,0 +1,81 @@
+// Copyright (c) 2026 The PlexHive Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <crypto/minotaurx/minotaur.h>
+#include <crypto/minotaurx/yespowerarena.h>
+#include <primitives/block.h>
+#include <test/test_bitcoin.h>
+#include <uint256.h>
+
+#include <string.h>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_FIXTURE_TEST_SUITE(minotaur_tests, BasicTestingSetup)
+
+// MinotaurHasher must give the same results as the original recursive Minotaur()
+BOOST_AUTO_TEST_CASE(minotaur_hasher_matches_minotaur)
+{
+    MinotaurHasher hasher;
+    for (size_t len = 0; len <= 200; len++) {
+        std::vector<unsigned char> data(len);
+        for (unsigned char& c : data)
+            c = InsecureRandBits(8);
+        BOOST_CHECK_EQUAL(hasher.Hash(data.data(), data.size(), false).ToString(), Minotaur(data.begin(), data.end(), false).ToString());
+    }
+}
+
+BOOST_AUTO_TEST_CASE(minotaurx_hasher_matches_minotaur)
+{
+    MinotaurHasher hasher;
+    yespower_local_t local;
+    yespower_init_local(&local);
+    for (int i = 0; i < 4; i++) {
+        std::vector<unsigned char> header(80);
+        for (unsigned char& c : header)
+            c = InsecureRandBits(8);
+        uint256 expected = Minotaur(header.begin(), header.end(), true);
+        BOOST_CHECK_EQUAL(hasher.Hash(header.data(), header.size(), true).ToString(), expected.ToString());
+        BOOST_CHECK_EQUAL(hasher.Hash(header.data(), header.size(), true, &local).ToString(), expected.ToString());
+    }
+    yespower_free_local(&local);
+}
+
+BOOST_AUTO_TEST_CASE(yespower_arena)
+{
+    YespowerArenaStats before = GetYespowerArenaStats();
+    {
+        YespowerArena arena;
+        BOOST_CHECK(arena.Size() >= YespowerMemoryNeeded(yespower_params));
+        YespowerArenaStats during = GetYespowerArenaStats();
+        BOOST_CHECK_EQUAL(during.arenas, before.arenas + 1);
+        BOOST_CHECK_EQUAL(during.used, before.used + arena.Size());
+        BOOST_CHECK(during.peak >= during.used);
+
+        // Hashes match the internally-managed memory, and yespower is happy with the arena as sized
+        void *base = arena.Get()->base;
+        MinotaurHasher hasher;
+        for (int i = 0; i < 2; i++) {
+            std::vector<unsigned char> header(80);
+            for (unsigned char& c : header)
+                c = InsecureRandBits(8);
+            BOOST_CHECK_EQUAL(hasher.Hash(header.data(), header.size(), true, arena.Get()).ToString(), hasher.Hash(header.data(), header.size(), true).ToString());
+        }
+        BOOST_CHECK(arena.Get()->base == base);
+    }
+    YespowerArenaStats after = GetYespowerArenaStats();
+    BOOST_CHECK_EQUAL(after.arenas, before.arenas);
+    BOOST_CHECK_EQUAL(after.used, before.used);
+}
+
+BOOST_AUTO_TEST_CASE(minotaur_block_hashes)
+{
+    // The CBlockHeader helpers route through the per-thread hasher
+    const char* data = "et in arcadia ego";
+    BOOST_CHECK_EQUAL(CBlockHeader::MinotaurHashArbitrary(data).ToString(), Minotaur(data, data + strlen(data), false).ToString());
+    BOOST_CHECK_EQUAL(CBlockHeader::MinotaurHashString(std::string(data)).ToString(), Minotaur(data, data + strlen(data), false).ToString());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
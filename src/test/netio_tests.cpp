@@ -0,0 +1,149 @@
+// Copyright (c) 2026 The PlexHive Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <netio.h>
+#include <test/test_bitcoin.h>
+
+#include <boost/test/unit_test.hpp>
+
+#ifdef USE_EPOLL
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+
+#include <sys/socket.h>
+#include <unistd.h>
+
+// Records what's read from each connection, each conn being a pointer to its socket
+class RecordingHandler : public CNetIoHandler
+{
+public:
+    std::mutex cs;
+    std::condition_variable cond;
+    std::string strRead;
+    bool fPaused = false;
+    int nPausedCalls = 0;
+    int nWritable = 0;
+    int nRemoved = 0;
+
+    ReadResult SocketReadable(void* conn) override
+    {
+        const int fd = *static_cast<int*>(conn);
+        std::lock_guard<std::mutex> lock(cs);
+        if (fPaused) {
+            nPausedCalls++;
+            cond.notify_all();
+            return READ_PAUSED;
+        }
+        char buf[3];
+        ssize_t nBytes = recv(fd, buf, sizeof(buf), MSG_DONTWAIT);
+        if (nBytes > 0)
+            strRead.append(buf, nBytes);
+        cond.notify_all();
+        // Read a little at a time, leaving the rest for later passes
+        return nBytes > 0 ? READ_MORE : READ_DONE;
+    }
+
+    void SocketWritable(void* conn) override
+    {
+        std::lock_guard<std::mutex> lock(cs);
+        nWritable++;
+        cond.notify_all();
+    }
+
+    void SocketRemoved(void* conn) override
+    {
+        std::lock_guard<std::mutex> lock(cs);
+        nRemoved++;
+        cond.notify_all();
+    }
+
+    template <typename Pred>
+    bool WaitFor(Pred pred)
+    {
+        std::unique_lock<std::mutex> lock(cs);
+        return cond.wait_for(lock, std::chrono::seconds(10), pred);
+    }
+};
+
+BOOST_FIXTURE_TEST_SUITE(netio_tests, BasicTestingSetup)
+
+BOOST_AUTO_TEST_CASE(netio_read_remove)
+{
+    RecordingHandler handler;
+    CNetIoThreads netio(handler);
+    BOOST_REQUIRE(netio.Start(2));
+    BOOST_CHECK_EQUAL(netio.GetThreadCount(), 2);
+
+    int fds[2];
+    BOOST_REQUIRE(socketpair(AF_UNIX, SOCK_STREAM, 0, fds) == 0);
+    int served = fds[0];
+    BOOST_REQUIRE(netio.Add(7, served, &served));
+
+    // A new socket has room to write
+    BOOST_CHECK(handler.WaitFor([&handler] { return handler.nWritable > 0; }));
+
+    // Everything sent is read, although the handler reads only a few bytes per call
+    const std::string strMsg = "the quick brown fox";
+    BOOST_REQUIRE(send(fds[1], strMsg.data(), strMsg.size(), MSG_NOSIGNAL) == (ssize_t)strMsg.size());
+    BOOST_CHECK(handler.WaitFor([&] { return handler.strRead == strMsg; }));
+
+    // A paused socket is tried again until it reads
+    {
+        std::lock_guard<std::mutex> lock(handler.cs);
+        handler.fPaused = true;
+    }
+    BOOST_REQUIRE(send(fds[1], "!", 1, MSG_NOSIGNAL) == 1);
+    BOOST_CHECK(handler.WaitFor([&handler] { return handler.nPausedCalls >= 2; }));
+    {
+        std::lock_guard<std::mutex> lock(handler.cs);
+        handler.fPaused = false;
+    }
+    BOOST_CHECK(handler.WaitFor([&] { return handler.strRead == strMsg + "!"; }));
+
+    // Removed connections are handed back once, and not read again
+    netio.Remove(7);
+    BOOST_CHECK(handler.WaitFor([&handler] { return handler.nRemoved == 1; }));
+    netio.Remove(7);
+    BOOST_REQUIRE(send(fds[1], "?", 1, MSG_NOSIGNAL) == 1);
+    MilliSleep(2 * NET_IO_RETRY_INTERVAL);
+    {
+        std::lock_guard<std::mutex> lock(handler.cs);
+        BOOST_CHECK_EQUAL(handler.strRead, strMsg + "!");
+    }
+
+    netio.Stop();
+    BOOST_CHECK_EQUAL(handler.nRemoved, 1);
+    close(fds[0]);
+    close(fds[1]);
+}
+
+BOOST_AUTO_TEST_CASE(netio_stop_removes)
+{
+    RecordingHandler handler;
+    CNetIoThreads netio(handler);
+    BOOST_REQUIRE(netio.Start(1));
+
+    int fds[2];
+    BOOST_REQUIRE(socketpair(AF_UNIX, SOCK_STREAM, 0, fds) == 0);
+    int served = fds[0];
+    BOOST_REQUIRE(netio.Add(0, served, &served));
+
+    // An invalid socket isn't added
+    int invalid = -1;
+    BOOST_CHECK(!netio.Add(1, invalid, &invalid));
+
+    // Connections left when stopping are handed back
+    netio.Stop();
+    BOOST_CHECK_EQUAL(handler.nRemoved, 1);
+    BOOST_CHECK_EQUAL(netio.GetThreadCount(), 0);
+    close(fds[0]);
+    close(fds[1]);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+#endif // USE_EPOLL
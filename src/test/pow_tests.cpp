@@ -4,12 +4,18 @@
 
 #include <chain.h>
 #include <chainparams.h>
+#include <checkqueue.h>
+#include <consensus/merkle.h>
+#include <consensus/validation.h>
 #include <pow.h>
 #include <random.h>
+#include <streams.h>
 #include <util.h>
+#include <validation.h>
 #include <test/test_bitcoin.h>
 
 #include <boost/test/unit_test.hpp>
+#include <boost/thread/thread.hpp>
 
 BOOST_FIXTURE_TEST_SUITE(pow_tests, BasicTestingSetup)
 
@@ -83,4 +89,106 @@ BOOST_AUTO_TEST_CASE(GetBlockProofEquivalentTime_test)
     }
 }
 
+/* PlexHive: MinotaurX+Hive1.2: Batched header proof of work checks must agree with checking each header */
+BOOST_AUTO_TEST_CASE(check_headers_pow)
+{
+    const Consensus::Params& consensusParams = Params().GetConsensus();
+    std::vector<CBlockHeader> headers(40);
+    for (size_t i = 0; i < headers.size(); i++) {
+        CBlockHeader& header = headers[i];
+        header.nVersion = POW_TYPE_SHA256 << 16;
+        header.hashMerkleRoot = InsecureRand256();
+        header.nTime = consensusParams.powForkTime + 1;
+        header.nBits = UintToArith256(consensusParams.powTypeLimits[POW_TYPE_MINOTAURX]).GetCompact();
+        if (i % 3 != 0) // Leave every third header (almost certainly) failing
+            while (!CheckProofOfWork(header.GetPoWHash(), header.nBits, consensusParams))
+                header.nNonce++;
+    }
+
+    CCheckQueue<CHeaderPoWCheck> queue(8);
+    boost::thread_group tg;
+    for (int i = 0; i < 3; i++)
+        tg.create_thread([&]{queue.Thread();});
+
+    for (CCheckQueue<CHeaderPoWCheck>* pqueue : {(CCheckQueue<CHeaderPoWCheck>*)nullptr, &queue}) {
+        // Stops at the first bad header; nothing unchecked is marked valid
+        std::vector<unsigned char> vPoWValid(headers.size(), 0);
+        vPoWValid[0] = 1;   // Skipped, so left alone
+        BOOST_CHECK(!CheckHeadersPoW(headers, consensusParams, vPoWValid, pqueue));
+        BOOST_CHECK_EQUAL(vPoWValid[0], 1);
+        BOOST_CHECK_EQUAL(vPoWValid[1], 1);  // Checked in this thread
+        for (size_t i = 1; i < headers.size(); i++)
+            if (vPoWValid[i])
+                BOOST_CHECK(CheckProofOfWork(headers[i].GetPoWHash(), headers[i].nBits, consensusParams));
+        if (!pqueue) {
+            BOOST_CHECK_EQUAL(vPoWValid[2], 1);
+            for (size_t i = 3; i < headers.size(); i++)
+                BOOST_CHECK_EQUAL(vPoWValid[i], 0);
+        }
+
+        // A bad first header is caught before anything else is hashed
+        std::fill(vPoWValid.begin(), vPoWValid.end(), 0);
+        BOOST_CHECK(!CheckHeadersPoW(headers, consensusParams, vPoWValid, pqueue));
+        for (size_t i = 0; i < headers.size(); i++)
+            BOOST_CHECK_EQUAL(vPoWValid[i], 0);
+
+        // All good
+        for (size_t i = 0; i < headers.size(); i++)
+            vPoWValid[i] = i % 3 == 0;
+        BOOST_CHECK(CheckHeadersPoW(headers, consensusParams, vPoWValid, pqueue));
+        for (size_t i = 0; i < headers.size(); i++)
+            BOOST_CHECK_EQUAL(vPoWValid[i], 1);
+    }
+
+    tg.interrupt_all();
+    tg.join_all();
+}
+
+// The Hive proof is checked once per block. A block with a bad proof shows where it's run: CheckBlock runs it, but
+// not again once the block's checked, and reads for connecting skip it.
+BOOST_FIXTURE_TEST_CASE(hive_proof_checked_once, TestingSetup)
+{
+    const Consensus::Params& consensusParams = Params().GetConsensus();
+    CMutableTransaction coinbase;
+    coinbase.vin.resize(1);
+    coinbase.vin[0].scriptSig = CScript() << 1 << OP_0;
+    coinbase.vout.resize(1);
+    CBlock block;
+    block.vtx.push_back(MakeTransactionRef(coinbase));
+    block.hashPrevBlock = InsecureRand256();    // Unknown, so the proof fails wherever it's run
+    block.hashMerkleRoot = BlockMerkleRoot(block);
+    block.nNonce = consensusParams.hiveNonceMarker;
+
+    // Checked when it arrives
+    CValidationState state;
+    std::vector<CHiveProofCheck> vHiveChecks;
+    BOOST_CHECK(!CheckBlock(block, state, consensusParams, true, true, &vHiveChecks));
+    BOOST_CHECK_EQUAL(state.GetRejectReason(), "bad-hive-proof");
+    BOOST_CHECK(!block.fChecked);
+
+    // Not checked again by ConnectBlock once it's passed
+    block.fChecked = true;
+    CValidationState stateConnect;
+    BOOST_CHECK(CheckBlock(block, stateConnect, consensusParams, true, true, &vHiveChecks));
+    BOOST_CHECK(vHiveChecks.empty());
+
+    // Not checked when read back to connect, leaving it to ConnectBlock
+    uint256 hash = block.GetHash();
+    CBlockIndex index;
+    index.phashBlock = &hash;
+    index.nFile = 1000;
+    index.nDataPos = 0;
+    index.nStatus = BLOCK_HAVE_DATA | BLOCK_VALID_TRANSACTIONS;
+    {
+        CAutoFile fileout(OpenBlockFile(index.GetBlockPos()), SER_DISK, CLIENT_VERSION);
+        BOOST_REQUIRE(!fileout.IsNull());
+        fileout << block;
+    }
+    CBlock blockRead;
+    BOOST_CHECK(!ReadBlockFromDisk(blockRead, &index, consensusParams));
+    BOOST_CHECK(ReadBlockFromDisk(blockRead, &index, consensusParams, false));
+    BOOST_CHECK(blockRead.GetHash() == hash);
+    BOOST_CHECK(!blockRead.fChecked);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
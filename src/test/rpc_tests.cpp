@@ -5,12 +5,20 @@
 #include <rpc/server.h>
 #include <rpc/client.h>
 
+#include <rpc/blockchain.h>
+
 #include <base58.h>
 #include <core_io.h>
 #include <netbase.h>
+#include <validation.h>
 
 #include <test/test_bitcoin.h>
 
+#include <condition_variable>
+#include <future>
+#include <mutex>
+#include <thread>
+
 #include <boost/algorithm/string.hpp>
 #include <boost/test/unit_test.hpp>
 
@@ -351,4 +359,133 @@ BOOST_AUTO_TEST_CASE(rpc_convert_values_generatetoaddress)
     BOOST_CHECK_EQUAL(result[2].get_int(), 9);
 }
 
+BOOST_AUTO_TEST_CASE(rpc_concurrency_stats)
+{
+    BOOST_CHECK_EQUAL(GetRPCConcurrency("getblockcount"), RPC_LOCK_FREE);
+    BOOST_CHECK_EQUAL(GetRPCConcurrency("getblock"), RPC_CHAIN_READ);
+    BOOST_CHECK_EQUAL(GetRPCConcurrency("invalidateblock"), RPC_EXCLUSIVE);
+
+    if (RPCIsInWarmup(nullptr))
+        SetRPCWarmupFinished();
+    std::map<std::string, CRPCMethodStats> before = GetRPCStats();
+
+    JSONRPCRequest request;
+    request.strMethod = "getblockcount";
+    request.params = UniValue(UniValue::VARR);
+    BOOST_CHECK_NO_THROW(tableRPC.execute(request));
+    BOOST_CHECK_NO_THROW(tableRPC.execute(request));
+    request.strMethod = "getblockhash";
+    request.params.push_back(-1);
+    BOOST_CHECK_THROW(tableRPC.execute(request), UniValue);
+
+    // Each call's counted once it's done, errors and all
+    std::map<std::string, CRPCMethodStats> after = GetRPCStats();
+    BOOST_CHECK_EQUAL(after["getblockcount"].nCalls, before["getblockcount"].nCalls + 2);
+    BOOST_CHECK_EQUAL(after["getblockcount"].nErrors, before["getblockcount"].nErrors);
+    BOOST_CHECK_EQUAL(after["getblockhash"].nCalls, before["getblockhash"].nCalls + 1);
+    BOOST_CHECK_EQUAL(after["getblockhash"].nErrors, before["getblockhash"].nErrors + 1);
+    BOOST_CHECK_EQUAL(after["getblockhash"].nRunning, 0);
+    BOOST_CHECK_EQUAL(after["getblockhash"].nWaiting, 0);
+    BOOST_CHECK(after["getblockhash"].nMaxWaiting >= 1);
+
+    UniValue r = CallRPC("getrpcstats");
+    UniValue method = find_value(find_value(r.get_obj(), "methods").get_obj(), "getblockcount");
+    BOOST_CHECK_EQUAL(find_value(method.get_obj(), "concurrency").get_str(), "lockfree");
+    BOOST_CHECK_EQUAL(find_value(method.get_obj(), "calls").get_int64(), (int64_t)after["getblockcount"].nCalls);
+}
+
+// A chain reader that lets its share of the dispatch lock go, as getblocktemplate does for a long poll
+static std::mutex csDispatchTest;
+static std::condition_variable cvDispatchTest;
+static bool fDispatchTestReleased = false;
+static bool fDispatchTestDone = false;
+
+static UniValue dispatchtest(const JSONRPCRequest& request)
+{
+    CRPCDispatchUnlock dispatchUnlock;
+    std::unique_lock<std::mutex> lock(csDispatchTest);
+    fDispatchTestReleased = true;
+    cvDispatchTest.notify_all();
+    cvDispatchTest.wait(lock, [] { return fDispatchTestDone; });
+    return NullUniValue;
+}
+
+static const CRPCCommand commandDispatchTest = { "test", "dispatchtest", &dispatchtest, {} };
+
+BOOST_AUTO_TEST_CASE(rpc_dispatch_unlock)
+{
+    // A long poll is a chain reader; only its wait lets exclusive methods by
+    BOOST_CHECK_EQUAL(GetRPCConcurrency("getblocktemplate"), RPC_CHAIN_READ);
+    BOOST_CHECK_EQUAL(GetRPCConcurrency("dispatchtest"), RPC_CHAIN_READ);
+
+    if (RPCIsInWarmup(nullptr))
+        SetRPCWarmupFinished();
+    // Its own table, so the method isn't left registered for the tests that follow
+    CRPCTable tableTest;
+    tableTest.appendCommand("dispatchtest", &commandDispatchTest);
+
+    JSONRPCRequest request;
+    request.strMethod = "dispatchtest";
+    request.params = UniValue(UniValue::VARR);
+    std::thread reader([&tableTest, &request] { tableTest.execute(request); });
+    {
+        std::unique_lock<std::mutex> lock(csDispatchTest);
+        cvDispatchTest.wait(lock, [] { return fDispatchTestReleased; });
+    }
+
+    // An exclusive method runs while the reader waits
+    std::string strReconsider = "reconsiderblock " + Params().GenesisBlock().GetHash().GetHex();
+    std::future<void> exclusive = std::async(std::launch::async, [&strReconsider] { CallRPC(strReconsider); });
+    BOOST_CHECK(exclusive.wait_for(std::chrono::seconds(60)) == std::future_status::ready);
+
+    {
+        std::unique_lock<std::mutex> lock(csDispatchTest);
+        fDispatchTestDone = true;
+        cvDispatchTest.notify_all();
+    }
+    reader.join();
+    exclusive.get();
+    BOOST_CHECK_EQUAL(GetRPCStats()["dispatchtest"].nCalls, 1U);
+}
+
+BOOST_FIXTURE_TEST_CASE(rpc_tip_snapshot, TestChain100Setup)
+{
+    CScript scriptPubKey = CScript() << ToByteVector(coinbaseKey.GetPubKey()) << OP_CHECKSIG;
+
+    // With no tip published, the active chain's read
+    BOOST_CHECK_EQUAL(CallRPC("getblockcount").get_int(), 100);
+
+    // A published tip is served until the next is
+    RPCPublishTipSnapshot(false, chainActive.Tip());
+    uint256 hashPublished = chainActive.Tip()->GetBlockHash();
+    CreateAndProcessBlock({}, scriptPubKey);
+    BOOST_CHECK_EQUAL(CallRPC("getblockcount").get_int(), 100);
+    BOOST_CHECK_EQUAL(CallRPC("getbestblockhash").get_str(), hashPublished.GetHex());
+
+    RPCPublishTipSnapshot(false, chainActive.Tip());
+    BOOST_CHECK_EQUAL(CallRPC("getblockcount").get_int(), 101);
+    UniValue r = CallRPC("gettipsnapshot");
+    BOOST_CHECK_EQUAL(find_value(r.get_obj(), "height").get_int(), 101);
+    BOOST_CHECK_EQUAL(find_value(r.get_obj(), "bestblockhash").get_str(), chainActive.Tip()->GetBlockHash().GetHex());
+    {
+        LOCK(cs_main);
+        BOOST_CHECK_EQUAL(CallRPC("getdifficulty sha256d").get_real(), GetDifficulty(nullptr, false, POW_TYPE_SHA256));
+    }
+
+    // One published during initial block download gets its difficulties once they're asked for
+    RPCPublishTipSnapshot(true, chainActive.Tip());
+    BOOST_CHECK_EQUAL(CallRPC("getblockcount").get_int(), 101);
+    BOOST_CHECK(!GetRPCTipSnapshot(false)->fDifficulties);
+    {
+        LOCK(cs_main);
+        BOOST_CHECK_EQUAL(CallRPC("getdifficulty sha256d").get_real(), GetDifficulty(nullptr, false, POW_TYPE_SHA256));
+    }
+    BOOST_CHECK(GetRPCTipSnapshot(false)->fDifficulties);
+
+    // Once withdrawn, the active chain's read again
+    RPCPublishTipSnapshot(false, nullptr);
+    CreateAndProcessBlock({}, scriptPubKey);
+    BOOST_CHECK_EQUAL(CallRPC("getblockcount").get_int(), 102);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
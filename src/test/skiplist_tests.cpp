@@ -3,7 +3,9 @@
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
 #include <chain.h>
+#include <chainparams.h>
 #include <util.h>
+#include <validation.h>
 #include <test/test_bitcoin.h>
 
 #include <vector>
@@ -177,4 +179,87 @@ BOOST_AUTO_TEST_CASE(findearliestatleast_edge_test)
     BOOST_CHECK(!chain.FindEarliestAtLeast(int64_t(std::numeric_limits<unsigned int>::max()) + 1));
 }
 
+BOOST_AUTO_TEST_CASE(hiveskip_test)
+{
+    // Check the hive skip links against a walk back through pprev
+    const Consensus::Params& consensusParams = Params().GetConsensus();
+    std::vector<CBlockIndex> vIndex(10000);
+    for (size_t i = 0; i < vIndex.size(); i++) {
+        vIndex[i].nHeight = i;
+        vIndex[i].pprev = (i == 0) ? nullptr : &vIndex[i - 1];
+        bool fHive = i > 0 && InsecureRandBits(1);
+        vIndex[i].nNonce = fHive ? consensusParams.hiveNonceMarker : consensusParams.hiveNonceMarker + 1;
+        // Mostly MinotaurX-style versions carrying a pow type, with the occasional legacy version
+        if (InsecureRandRange(50) == 0)
+            vIndex[i].nVersion = 0x20000000;
+        else
+            vIndex[i].nVersion = 0x10000000 | (InsecureRandRange(NUM_BLOCK_TYPES) << 16);
+        vIndex[i].BuildHiveSkip(consensusParams);
+    }
+
+    for (int i = 0; i < 1000; i++) {
+        const CBlockIndex* pindex = &vIndex[InsecureRandRange(vIndex.size())];
+
+        const CBlockIndex* pprevHive = nullptr;
+        const CBlockIndex* pprevPoW = nullptr;
+        const CBlockIndex* pprevPoWType[NUM_BLOCK_TYPES] = {};
+        for (const CBlockIndex* pwalk = pindex->pprev; pwalk; pwalk = pwalk->pprev) {
+            if (pwalk->GetBlockHeader().IsHiveMined(consensusParams)) {
+                if (!pprevHive) pprevHive = pwalk;
+            } else {
+                if (!pprevPoW) pprevPoW = pwalk;
+                POW_TYPE powType = pwalk->GetBlockHeader().GetPoWType();
+                if (!pprevPoWType[powType]) pprevPoWType[powType] = pwalk;
+            }
+        }
+        int nHiveRun = 0;
+        for (const CBlockIndex* pwalk = pindex; pwalk && pwalk->GetBlockHeader().IsHiveMined(consensusParams); pwalk = pwalk->pprev)
+            nHiveRun++;
+        int nLastLegacyVersionHeight = -1;
+        for (const CBlockIndex* pwalk = pindex; pwalk; pwalk = pwalk->pprev) {
+            if (pwalk->nVersion >= 0x20000000) {
+                nLastLegacyVersionHeight = pwalk->nHeight;
+                break;
+            }
+        }
+
+        BOOST_CHECK(pindex->pprevHive == pprevHive);
+        BOOST_CHECK(pindex->pprevPoW == pprevPoW);
+        for (int j = 0; j < NUM_BLOCK_TYPES; j++)
+            BOOST_CHECK(pindex->pprevPoWType[j] == pprevPoWType[j]);
+        BOOST_CHECK_EQUAL(pindex->nHiveRun, nHiveRun);
+        BOOST_CHECK_EQUAL(pindex->nLastLegacyVersionHeight, nLastLegacyVersionHeight);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(detrandstring_test)
+{
+    // The skip list lookup must match the original walk back through pprev
+    std::vector<uint256> vHashes(13000);
+    std::vector<CBlockIndex> vIndex(vHashes.size());
+    for (size_t i = 0; i < vIndex.size(); i++) {
+        vHashes[i] = InsecureRand256();
+        vIndex[i].phashBlock = &vHashes[i];
+        vIndex[i].nHeight = i;
+        vIndex[i].pprev = (i == 0) ? nullptr : &vIndex[i - 1];
+        vIndex[i].BuildSkip();
+    }
+
+    for (int i = 0; i < 100; i++) {
+        const CBlockIndex* pindex = &vIndex[i < 20 ? i * 650 : InsecureRandRange(vIndex.size())];
+
+        std::string expected;
+        const int heights[] = { 0, 13, 173, 471, 1363, 12103 };
+        int hits = 0, steps = 0;
+        for (const CBlockIndex* pwalk = pindex; pwalk && hits < 6; pwalk = pwalk->pprev, steps++) {
+            if (steps == heights[hits]) {
+                expected += pwalk->phashBlock->GetHex();
+                hits++;
+            }
+        }
+
+        BOOST_CHECK_EQUAL(GetDeterministicRandString(pindex), expected);
+    }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -120,4 +120,31 @@ BOOST_AUTO_TEST_CASE(streams_serializedata_xor)
             std::string(ds.begin(), ds.end()));  
 }         
 
+BOOST_AUTO_TEST_CASE(streams_span_reader)
+{
+    // Reads in place match CDataStream, and running off the end throws
+    CDataStream ss(SER_DISK, 0);
+    uint32_t a = 0x01020304;
+    uint64_t b = 0x05060708090a0b0cULL;
+    std::vector<unsigned char> c = {1, 2, 3};
+    ss << a << b << c;
+
+    const unsigned char* pbegin = (const unsigned char*)ss.data();
+    CSpanReader reader(SER_DISK, 0, pbegin, pbegin + ss.size());
+    uint32_t a2;
+    uint64_t b2;
+    std::vector<unsigned char> c2;
+    reader >> a2 >> b2 >> c2;
+    BOOST_CHECK_EQUAL(a2, a);
+    BOOST_CHECK_EQUAL(b2, b);
+    BOOST_CHECK(c2 == c);
+    BOOST_CHECK(reader.empty());
+    BOOST_CHECK_THROW(reader >> a2, std::ios_base::failure);
+
+    CSpanReader shortReader(SER_DISK, 0, pbegin, pbegin + 6);
+    shortReader >> a2;
+    BOOST_CHECK_EQUAL(shortReader.size(), 2U);
+    BOOST_CHECK_THROW(shortReader >> a2, std::ios_base::failure);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
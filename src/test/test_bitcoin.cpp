@@ -15,6 +15,7 @@
 #include <streams.h>
 #include <rpc/server.h>
 #include <rpc/register.h>
+#include <script/interpreter.h>
 #include <script/sigcache.h>
 
 #include <memory>
@@ -90,6 +91,8 @@ TestingSetup::TestingSetup(const std::string& chainName) : BasicTestingSetup(cha
         nScriptCheckThreads = 3;
         for (int i=0; i < nScriptCheckThreads-1; i++)
             threadGroup.create_thread(&ThreadScriptCheck);
+        for (int i=0; i < nScriptCheckThreads-1; i++)
+            threadGroup.create_thread(&ThreadTxAcceptCheck);
         g_connman = std::unique_ptr<CConnman>(new CConnman(0x1337, 0x1337)); // Deterministic randomness for tests.
         connman = g_connman.get();
         peerLogic.reset(new PeerLogicValidation(connman, scheduler));
@@ -161,6 +164,27 @@ TestChain100Setup::~TestChain100Setup()
 {
 }
 
+CTransactionRef SpendSigned(const CTransaction& txPrev, const CScript& scriptPubKey, const CKey& key, CAmount nFee, bool fBadSig)
+{
+    CMutableTransaction tx;
+    tx.nVersion = 1;
+    tx.vin.resize(1);
+    tx.vin[0].prevout = COutPoint(txPrev.GetHash(), 0);
+    tx.vout.resize(1);
+    tx.vout[0].nValue = txPrev.vout[0].nValue - nFee;
+    tx.vout[0].scriptPubKey = scriptPubKey;
+
+    std::vector<unsigned char> vchSig;
+    uint256 hash = SignatureHash(txPrev.vout[0].scriptPubKey, tx, 0, SIGHASH_ALL | SIGHASH_FORKID, 0, SIGVERSION_BASE);    // PlexHive: Replay attack protection
+    if (!key.Sign(hash, vchSig))
+        throw std::runtime_error("SpendSigned: signing failed.");
+    if (fBadSig)
+        vchSig[10] ^= 1;
+    vchSig.push_back((unsigned char)SIGHASH_ALL | SIGHASH_FORKID);
+    tx.vin[0].scriptSig << vchSig;
+    return MakeTransactionRef(tx);
+}
+
 
 CTxMemPoolEntry TestMemPoolEntryHelper::FromTx(const CMutableTransaction &tx) {
     CTransaction txn(tx);
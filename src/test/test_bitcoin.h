@@ -89,6 +89,10 @@ struct TestChain100Setup : public TestingSetup {
     CKey coinbaseKey; // private/public key needed to spend coinbase transactions
 };
 
+// Spend txPrev's first output to scriptPubKey, signed with key, paying nFee.
+// fBadSig spoils the signature.
+CTransactionRef SpendSigned(const CTransaction& txPrev, const CScript& scriptPubKey, const CKey& key, CAmount nFee, bool fBadSig = false);
+
 class CTxMemPoolEntry;
 
 struct TestMemPoolEntryHelper
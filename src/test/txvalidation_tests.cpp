@@ -58,4 +58,66 @@ BOOST_FIXTURE_TEST_CASE(tx_mempool_reject_coinbase, TestChain100Setup)
     BOOST_CHECK_EQUAL(nDoS, 100);
 }
 
+/**
+ * Ensure that a batch accepted together ends up as if accepted one at a time.
+ */
+BOOST_FIXTURE_TEST_CASE(tx_mempool_accept_many, TestChain100Setup)
+{
+    CScript scriptPubKey = CScript() << ToByteVector(coinbaseKey.GetPubKey()) << OP_CHECKSIG;
+
+    CTransactionRef spend0 = SpendSigned(coinbaseTxns[0], scriptPubKey, coinbaseKey, CENT);
+    CTransactionRef spend1 = SpendSigned(coinbaseTxns[1], scriptPubKey, coinbaseKey, CENT);
+    CTransactionRef spend0Child = SpendSigned(*spend0, scriptPubKey, coinbaseKey, CENT);
+    CTransactionRef spend0Double = SpendSigned(coinbaseTxns[0], scriptPubKey, coinbaseKey, 2 * CENT);
+    CTransactionRef spend2BadSig = SpendSigned(coinbaseTxns[2], scriptPubKey, coinbaseKey, CENT, true);
+    CTransactionRef spend3 = SpendSigned(coinbaseTxns[3], scriptPubKey, coinbaseKey, CENT);
+    CTransactionRef coinbase = MakeTransactionRef(coinbaseTxns[4]);
+
+    {
+        LOCK(cs_main);
+        CValidationState state;
+        BOOST_CHECK(AcceptToMemoryPool(mempool, state, spend3, nullptr, nullptr, false, 0));
+    }
+
+    std::vector<CTxToAccept> vTxs;
+    for (const CTransactionRef& tx : {spend0Child, spend0, spend1, spend0Double, spend2BadSig, spend3, coinbase})
+        vTxs.emplace_back(tx, GetTime());
+    AcceptToMemoryPoolMany(mempool, vTxs, false /* bypass_limits */, 0 /* nAbsurdFee */);
+
+    // A child ahead of its parent in the batch is an orphan, as it would be on its own
+    BOOST_CHECK(!vTxs[0].fAccepted);
+    BOOST_CHECK(vTxs[0].fMissingInputs);
+    BOOST_CHECK(vTxs[0].state.IsValid());
+
+    // Independent spends go in
+    BOOST_CHECK(vTxs[1].fAccepted);
+    BOOST_CHECK(vTxs[2].fAccepted);
+    BOOST_CHECK(mempool.exists(spend0->GetHash()));
+    BOOST_CHECK(mempool.exists(spend1->GetHash()));
+
+    // A double spend of one accepted earlier in the batch conflicts with it
+    BOOST_CHECK(!vTxs[3].fAccepted);
+    BOOST_CHECK_EQUAL(vTxs[3].state.GetRejectReason(), "txn-mempool-conflict");
+
+    int nDoS;
+    BOOST_CHECK(!vTxs[4].fAccepted);
+    BOOST_CHECK(vTxs[4].state.IsInvalid(nDoS));
+    BOOST_CHECK_EQUAL(nDoS, 100);
+
+    BOOST_CHECK(!vTxs[5].fAccepted);
+    BOOST_CHECK_EQUAL(vTxs[5].state.GetRejectReason(), "txn-already-in-mempool");
+
+    BOOST_CHECK(!vTxs[6].fAccepted);
+    BOOST_CHECK_EQUAL(vTxs[6].state.GetRejectReason(), "coinbase");
+
+    BOOST_CHECK_EQUAL(mempool.size(), 3);
+
+    // With its parent in, the child goes in too
+    std::vector<CTxToAccept> vChild;
+    vChild.emplace_back(spend0Child, GetTime());
+    AcceptToMemoryPoolMany(mempool, vChild, false /* bypass_limits */, 0 /* nAbsurdFee */);
+    BOOST_CHECK(vChild[0].fAccepted);
+    BOOST_CHECK_EQUAL(mempool.size(), 4);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
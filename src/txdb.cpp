@@ -82,6 +82,12 @@ std::vector<uint256> CCoinsViewDB::GetHeadBlocks() const {
 }
 
 bool CCoinsViewDB::BatchWrite(CCoinsMap &mapCoins, const uint256 &hashBlock) {
+    bool ret = WriteCoins(mapCoins, hashBlock);
+    mapCoins.clear();
+    return ret;
+}
+
+bool CCoinsViewDB::WriteCoins(const CCoinsMap &mapCoins, const uint256 &hashBlock) {
     CDBBatch batch(db);
     size_t count = 0;
     size_t changed = 0;
@@ -106,7 +112,7 @@ bool CCoinsViewDB::BatchWrite(CCoinsMap &mapCoins, const uint256 &hashBlock) {
     batch.Erase(DB_BEST_BLOCK);
     batch.Write(DB_HEAD_BLOCKS, std::vector<uint256>{hashBlock, old_tip});
 
-    for (CCoinsMap::iterator it = mapCoins.begin(); it != mapCoins.end();) {
+    for (CCoinsMap::const_iterator it = mapCoins.begin(); it != mapCoins.end(); it++) {
         if (it->second.flags & CCoinsCacheEntry::DIRTY) {
             CoinEntry entry(&it->first);
             if (it->second.coin.IsSpent())
@@ -116,8 +122,6 @@ bool CCoinsViewDB::BatchWrite(CCoinsMap &mapCoins, const uint256 &hashBlock) {
             changed++;
         }
         count++;
-        CCoinsMap::iterator itOld = it++;
-        mapCoins.erase(itOld);
         if (batch.SizeEstimate() > batch_size) {
             LogPrint(BCLog::COINDB, "Writing partial batch of %.2f MiB\n", batch.SizeEstimate() * (1.0 / 1048576.0));
             db.WriteBatch(batch);
@@ -147,6 +151,171 @@ size_t CCoinsViewDB::EstimateSize() const
     return db.EstimateSize(DB_COIN, (char)(DB_COIN+1));
 }
 
+CCoinsViewBackgroundFlush::CCoinsViewBackgroundFlush(CCoinsView* baseIn, CCoinsViewDB* dbIn) :
+    CCoinsViewBacked(baseIn), db(dbIn), nFrozenUsage(0), fPending(false), fFailed(false), fStop(false), fNextInBackground(false),
+    nFlushes(0), nLastFlushCoins(0), nLastFlushTime(0), nTotalFlushTime(0), nLastStallTime(0), nTotalStallTime(0)
+{
+    thread = std::thread(&TraceThread<std::function<void()>>, "coinsflush", std::function<void()>(std::bind(&CCoinsViewBackgroundFlush::ThreadFlush, this)));
+}
+
+CCoinsViewBackgroundFlush::~CCoinsViewBackgroundFlush()
+{
+    {
+        WaitableLock lock(cs);
+        fStop = true;
+    }
+    cond.notify_all();
+    thread.join();    // Finishes any flush in flight first
+}
+
+void CCoinsViewBackgroundFlush::ThreadFlush()
+{
+    WaitableLock lock(cs);
+    while (true) {
+        cond.wait(lock, [this] { return fPending || fStop; });
+        if (!fPending)
+            return;
+
+        // mapFrozen is left alone while fPending, so it can be read here and by GetCoin at once
+        const uint256 hashBlock = hashFrozen;
+        lock.unlock();
+        int64_t nStart = GetTimeMicros();
+        bool fOk;
+        try {
+            fOk = db->WriteCoins(mapFrozen, hashBlock);
+        } catch (const std::exception& e) {
+            LogPrintf("%s: Error writing to coin database: %s\n", __func__, e.what());
+            fOk = false;
+        }
+        int64_t nTime = GetTimeMicros() - nStart;
+        lock.lock();
+
+        LogPrint(BCLog::BENCH, "Background flush of %u coins to %s: %.2fms\n", mapFrozen.size(), hashBlock.ToString(), nTime * 0.001);
+        nLastFlushCoins = mapFrozen.size();
+        nLastFlushTime = nTime;
+        nTotalFlushTime += nTime;
+        nFlushes++;
+        if (!fOk) {
+            LogPrintf("%s: Background flush to %s failed\n", __func__, hashBlock.ToString());
+            fFailed = true;
+        }
+        mapFrozen.clear();
+        nFrozenUsage = 0;
+        fPending = false;
+        cond.notify_all();
+    }
+}
+
+bool CCoinsViewBackgroundFlush::WaitForFlush(WaitableLock& lock)
+{
+    if (fPending) {
+        int64_t nStart = GetTimeMicros();
+        cond.wait(lock, [this] { return !fPending; });
+        nLastStallTime = GetTimeMicros() - nStart;
+        nTotalStallTime += nLastStallTime;
+        LogPrint(BCLog::BENCH, "Waited %.2fms for background flush\n", nLastStallTime * 0.001);
+    }
+    return !fFailed;
+}
+
+bool CCoinsViewBackgroundFlush::GetCoin(const COutPoint &outpoint, Coin &coin) const
+{
+    {
+        WaitableLock lock(cs);
+        if (fPending) {
+            CCoinsMap::const_iterator it = mapFrozen.find(outpoint);
+            if (it != mapFrozen.end()) {
+                if (it->second.coin.IsSpent())
+                    return false;
+                coin = it->second.coin;
+                return true;
+            }
+        }
+    }
+    // Coins not in the frozen layer aren't being written, so the database has them as they are
+    return base->GetCoin(outpoint, coin);
+}
+
+bool CCoinsViewBackgroundFlush::HaveCoin(const COutPoint &outpoint) const
+{
+    {
+        WaitableLock lock(cs);
+        if (fPending) {
+            CCoinsMap::const_iterator it = mapFrozen.find(outpoint);
+            if (it != mapFrozen.end())
+                return !it->second.coin.IsSpent();
+        }
+    }
+    return base->HaveCoin(outpoint);
+}
+
+uint256 CCoinsViewBackgroundFlush::GetBestBlock() const
+{
+    {
+        WaitableLock lock(cs);
+        if (fPending)
+            return hashFrozen;
+    }
+    return base->GetBestBlock();
+}
+
+bool CCoinsViewBackgroundFlush::BatchWrite(CCoinsMap &mapCoins, const uint256 &hashBlock)
+{
+    WaitableLock lock(cs);
+    if (!WaitForFlush(lock))
+        return false;
+
+    if (!fNextInBackground) {
+        lock.unlock();
+        return base->BatchWrite(mapCoins, hashBlock);
+    }
+
+    mapFrozen.swap(mapCoins);
+    hashFrozen = hashBlock;
+    fPending = true;
+    cond.notify_all();
+    return true;
+}
+
+bool CCoinsViewBackgroundFlush::FlushInBackground(CCoinsViewCache& cache)
+{
+    size_t nUsage = cache.DynamicMemoryUsage();
+    {
+        WaitableLock lock(cs);
+        fNextInBackground = true;
+    }
+    bool fOk = cache.Flush();
+    WaitableLock lock(cs);
+    fNextInBackground = false;
+    if (fOk && fPending)
+        nFrozenUsage = nUsage;
+    return fOk;
+}
+
+bool CCoinsViewBackgroundFlush::Wait()
+{
+    WaitableLock lock(cs);
+    return WaitForFlush(lock);
+}
+
+bool CCoinsViewBackgroundFlush::HasFailed() const
+{
+    WaitableLock lock(cs);
+    return fFailed;
+}
+
+size_t CCoinsViewBackgroundFlush::DynamicMemoryUsage() const
+{
+    WaitableLock lock(cs);
+    return nFrozenUsage;
+}
+
+CCoinsViewBackgroundFlush::Stats CCoinsViewBackgroundFlush::GetStats() const
+{
+    WaitableLock lock(cs);
+    return Stats{fPending, nFlushes, nLastFlushCoins, nLastFlushTime, nTotalFlushTime, nLastStallTime, nTotalStallTime};
+}
+
 CBlockTreeDB::CBlockTreeDB(size_t nCacheSize, bool fMemory, bool fWipe) : CDBWrapper(GetDataDir() / "blocks" / "index", nCacheSize, fMemory, fWipe) {
 }
 
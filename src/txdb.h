@@ -9,9 +9,11 @@
 #include <coins.h>
 #include <dbwrapper.h>
 #include <chain.h>
+#include <sync.h>
 
 #include <map>
 #include <string>
+#include <thread>
 #include <utility>
 #include <vector>
 
@@ -29,6 +31,8 @@ static const int64_t nDefaultDbBatchSize = 16 << 20;
 static const int64_t nMaxDbCache = sizeof(void*) > 4 ? 16384 : 1024;
 //! min. -dbcache (MiB)
 static const int64_t nMinDbCache = 4;
+//! -backgroundflush default
+static const bool DEFAULT_BACKGROUND_FLUSH = true;
 //! Max memory allocated to block tree DB specific cache, if no -txindex (MiB)
 static const int64_t nMaxBlockDBCache = 2;
 //! Max memory allocated to block tree DB specific cache, if -txindex (MiB)
@@ -78,11 +82,86 @@ public:
     bool BatchWrite(CCoinsMap &mapCoins, const uint256 &hashBlock) override;
     CCoinsViewCursor *Cursor() const override;
 
+    //! Write mapCoins' dirty entries as BatchWrite does, without modifying mapCoins
+    bool WriteCoins(const CCoinsMap &mapCoins, const uint256 &hashBlock);
+
     //! Attempt to update from an older database format. Returns whether an error occurred.
     bool Upgrade();
     size_t EstimateSize() const override;
 };
 
+/**
+ * Coins view between pcoinsTip and the coin database that writes flushes out on
+ * a background thread.
+ *
+ * FlushInBackground() takes over the whole of a cache's contents in constant
+ * time as a frozen layer, which a background thread writes to the database
+ * in -dbbatchsize batches while the emptied cache carries on taking block
+ * connections. Reads that miss the cache see the frozen layer before the
+ * database, so nothing is lost in between. Only one flush is in flight at a
+ * time; another flush first waits for it, and that wait is counted as
+ * stall time. The database's head blocks marker covers a crash mid-write,
+ * as for a synchronous flush. A failed background write is reported by
+ * HasFailed() and by the next flush.
+ */
+class CCoinsViewBackgroundFlush final : public CCoinsViewBacked
+{
+private:
+    CCoinsViewDB* db;
+
+    mutable CWaitableCriticalSection cs;
+    CConditionVariable cond;
+    CCoinsMap mapFrozen;    // Coins being written; not modified while fPending
+    uint256 hashFrozen;
+    size_t nFrozenUsage;
+    bool fPending;
+    bool fFailed;
+    bool fStop;
+    bool fNextInBackground;
+
+    int64_t nFlushes;
+    int64_t nLastFlushCoins;
+    int64_t nLastFlushTime;     // Microseconds
+    int64_t nTotalFlushTime;
+    int64_t nLastStallTime;
+    int64_t nTotalStallTime;
+
+    std::thread thread;
+
+    void ThreadFlush();
+    /** Wait until no flush is in flight, returning false if the last one failed */
+    bool WaitForFlush(WaitableLock& lock);
+
+public:
+    CCoinsViewBackgroundFlush(CCoinsView* baseIn, CCoinsViewDB* dbIn);
+    ~CCoinsViewBackgroundFlush();
+
+    bool GetCoin(const COutPoint &outpoint, Coin &coin) const override;
+    bool HaveCoin(const COutPoint &outpoint) const override;
+    uint256 GetBestBlock() const override;
+    bool BatchWrite(CCoinsMap &mapCoins, const uint256 &hashBlock) override;
+
+    /** Flush cache into this view, leaving the write to the database to the background thread */
+    bool FlushInBackground(CCoinsViewCache& cache);
+    /** Wait for any flush in flight to finish, returning false if it failed */
+    bool Wait();
+    bool HasFailed() const;
+    /** Memory held by a flush in flight */
+    size_t DynamicMemoryUsage() const;
+
+    struct Stats
+    {
+        bool fPending;
+        int64_t nFlushes;
+        int64_t nLastFlushCoins;
+        int64_t nLastFlushTime;
+        int64_t nTotalFlushTime;
+        int64_t nLastStallTime;
+        int64_t nTotalStallTime;
+    };
+    Stats GetStats() const;
+};
+
 /** Specialization of CCoinsViewCursor to iterate over a CCoinsViewDB */
 class CCoinsViewDBCursor: public CCoinsViewCursor
 {
@@ -128,6 +128,7 @@ public:
     int64_t GetSigOpCostWithAncestors() const { return nSigOpCostWithAncestors; }
 
     mutable size_t vTxHashesIdx; //!< Index in mempool's vTxHashes
+    mutable uint64_t nEpoch;     //!< Epoch of the last mempool traversal to reach this entry
 };
 
 // Helpers for modifying CTxMemPool::mapTx, which is a boost multi_index.
@@ -495,7 +496,7 @@ public:
     const setEntries & GetMemPoolParents(txiter entry) const;
     const setEntries & GetMemPoolChildren(txiter entry) const;
 private:
-    typedef std::map<txiter, setEntries, CompareIteratorByHash> cacheMap;
+    typedef std::map<txiter, std::vector<txiter>, CompareIteratorByHash> cacheMap;
 
     struct TxLinks {
         setEntries parents;
@@ -508,6 +509,40 @@ private:
     void UpdateParent(txiter entry, txiter parent, bool add);
     void UpdateChild(txiter entry, txiter child, bool add);
 
+    /**
+     * Walks of mapLinks mark each entry they reach with the epoch they run in,
+     * rather than collect the entries in a setEntries, and stage what's left to
+     * walk in vEpochStage, which is kept between walks. An EpochGuard starts a
+     * fresh epoch for a walk and ends it; only one can be live at a time.
+     * Guarded by cs.
+     */
+    mutable uint64_t nEpoch;
+    mutable bool fHasEpochGuard;
+    mutable std::vector<txiter> vEpochStage;
+
+    class EpochGuard
+    {
+    private:
+        const CTxMemPool& pool;
+
+    public:
+        explicit EpochGuard(const CTxMemPool& poolIn);
+        ~EpochGuard();
+
+        EpochGuard(const EpochGuard&) = delete;
+        EpochGuard& operator=(const EpochGuard&) = delete;
+    };
+
+    /** Whether it's been reached in the live epoch, marking it as reached if not */
+    bool Visited(txiter it) const
+    {
+        assert(fHasEpochGuard);
+        if (it->nEpoch >= nEpoch)
+            return true;
+        it->nEpoch = nEpoch;
+        return false;
+    }
+
     std::vector<indexed_transaction_set::const_iterator> GetSortedDepthAndScore() const;
 
 public:
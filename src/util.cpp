@@ -27,6 +27,9 @@
 
 #define _POSIX_C_SOURCE 200112L
 
+#include <sys/syscall.h>    // PlexHive: Hive: For SetThreadNiceness
+#include <unistd.h>
+
 #endif // __linux__
 
 #include <algorithm>
@@ -941,6 +944,22 @@ int GetNumVirtualCores() {
     return boost::thread::hardware_concurrency();
 }
 
+// PlexHive: Hive: Set the calling thread's scheduling niceness
+bool SetThreadNiceness(int nice)
+{
+#ifdef WIN32
+    int priority = nice <= 0 ? THREAD_PRIORITY_NORMAL : nice < 10 ? THREAD_PRIORITY_BELOW_NORMAL : nice < 19 ? THREAD_PRIORITY_LOWEST : THREAD_PRIORITY_IDLE;
+    return SetThreadPriority(GetCurrentThread(), priority) != 0;
+#elif defined(__linux__)
+    // On Linux, PRIO_PROCESS with a thread id applies to that thread alone
+    return setpriority(PRIO_PROCESS, syscall(SYS_gettid), nice) == 0;
+#else
+    // Elsewhere, setpriority() would renice the whole process
+    (void)nice;
+    return false;
+#endif
+}
+
 int GetNumCores()
 {
 #if BOOST_VERSION >= 105600
@@ -311,6 +311,12 @@ std::string HelpMessageOpt(const std::string& option, const std::string& message
 int GetNumCores();
 int GetNumVirtualCores();   // PlexHive: Hive: Mining Optimisations: Return number of virt cores
 
+/**
+ * PlexHive: Hive: Set the calling thread's scheduling niceness (0-19, higher is lower priority).
+ * Returns false if unsupported on this platform or not permitted (eg lowering it again).
+ */
+bool SetThreadNiceness(int nice);
+
 void RenameThread(const char* name);
 
 /**
@@ -6,6 +6,9 @@
 #include <validation.h>
 
 #include <arith_uint256.h>
+#include <bctindex.h>
+#include <blockfilereader.h>
+#include <blockprefetch.h>
 #include <chain.h>
 #include <chainparams.h>
 #include <checkpoints.h>
@@ -162,13 +165,14 @@ public:
 
     bool ActivateBestChain(CValidationState &state, const CChainParams& chainparams, std::shared_ptr<const CBlock> pblock);
 
-    bool AcceptBlockHeader(const CBlockHeader& block, CValidationState& state, const CChainParams& chainparams, CBlockIndex** ppindex);
+    bool AcceptBlockHeader(const CBlockHeader& block, CValidationState& state, const CChainParams& chainparams, CBlockIndex** ppindex, bool fCheckPOW = true);
     bool AcceptBlock(const std::shared_ptr<const CBlock>& pblock, CValidationState& state, const CChainParams& chainparams, CBlockIndex** ppindex, bool fRequested, const CDiskBlockPos* dbp, bool* fNewBlock);
 
     // Block (dis)connection on a given view:
     DisconnectResult DisconnectBlock(const CBlock& block, const CBlockIndex* pindex, CCoinsViewCache& view);
     bool ConnectBlock(const CBlock& block, CValidationState& state, CBlockIndex* pindex,
-                    CCoinsViewCache& view, const CChainParams& chainparams, bool fJustCheck = false);
+                    CCoinsViewCache& view, const CChainParams& chainparams, bool fJustCheck = false,
+                    const std::vector<PrecomputedTransactionData>* ptxdata = nullptr);
 
     // Block disconnection on our pcoinsTip:
     bool DisconnectTip(CValidationState& state, const CChainParams& chainparams, DisconnectedBlockTransactions *disconnectpool);
@@ -222,6 +226,7 @@ bool fIsBareMultisigStd = DEFAULT_PERMIT_BAREMULTISIG;
 bool fRequireStandard = true;
 bool fCheckBlockIndex = false;
 bool fCheckpointsEnabled = DEFAULT_CHECKPOINTS_ENABLED;
+bool fParanoidBlockReads = DEFAULT_PARANOID_BLOCK_READS;
 size_t nCoinCacheUsage = 5000 * 300;
 uint64_t nPruneTarget = 0;
 int64_t nMaxTipAge = DEFAULT_MAX_TIP_AGE;
@@ -285,6 +290,7 @@ CBlockIndex* FindForkInGlobalIndex(const CChain& chain, const CBlockLocator& loc
 }
 
 std::unique_ptr<CCoinsViewDB> pcoinsdbview;
+std::unique_ptr<CCoinsViewBackgroundFlush> pcoinsflusher;
 std::unique_ptr<CCoinsViewCache> pcoinsTip;
 std::unique_ptr<CBlockTreeDB> pblocktree;
 
@@ -548,18 +554,52 @@ static bool CheckInputsFromMempoolAndCache(const CTransaction& tx, CValidationSt
     return CheckInputs(tx, state, view, true, flags, cacheSigStore, true, txdata);
 }
 
-static bool AcceptToMemoryPoolWorker(const CChainParams& chainparams, CTxMemPool& pool, CValidationState& state, const CTransactionRef& ptx,
-                              bool* pfMissingInputs, int64_t nAcceptTime, std::list<CTransactionRef>* plTxnReplaced,
-                              bool bypass_limits, const CAmount& nAbsurdFee, std::vector<COutPoint>& coins_to_uncache)
+namespace {
+
+/**
+ * A transaction on its way into the mempool, and what each stage of accepting
+ * it works out for the next. AcceptToMemoryPoolWorker runs the stages one after
+ * another under the locks; AcceptToMemoryPoolMany runs the context-free and
+ * script checks of a batch outside them.
+ */
+struct CTxAcceptWorkspace
 {
-    const CTransaction& tx = *ptx;
-    const uint256 hash = tx.GetHash();
-    AssertLockHeld(cs_main);
-    LOCK(pool.cs); // mempool "read lock" (held through GetMainSignals().TransactionAddedToMempool())
-    if (pfMissingInputs) {
-        *pfMissingInputs = false;
-    }
+    const CTransactionRef ptx;
+    CValidationState& state;
+    bool* pfMissingInputs;
+    const int64_t nAcceptTime;
+    std::list<CTransactionRef>* plTxnReplaced;
+    const bool bypass_limits;
+    const CAmount nAbsurdFee;
+    std::vector<COutPoint>& coins_to_uncache;
+
+    // Worked out by MemPoolPreChecks
+    CCoinsView dummy;
+    CCoinsViewCache view;           // The coins spent, with a dummy backend once looked up
+    std::unique_ptr<CTxMemPoolEntry> entry;
+    CTxMemPool::setEntries setAncestors;
+    std::set<uint256> setConflicts;
+    CTxMemPool::setEntries allConflicting;
+    CAmount nModifiedFees;
+    CAmount nConflictingFees;
+    size_t nConflictingSize;
+    unsigned int scriptVerifyFlags;
+    unsigned int currentBlockScriptVerifyFlags;
+    std::unique_ptr<PrecomputedTransactionData> txdata;
+
+    // Result of a CTxAcceptCheck
+    bool fChecksPassed;
+
+    CTxAcceptWorkspace(const CTransactionRef& ptxIn, CValidationState& stateIn, bool* pfMissingInputsIn, int64_t nAcceptTimeIn,
+                       std::list<CTransactionRef>* plTxnReplacedIn, bool bypass_limitsIn, CAmount nAbsurdFeeIn, std::vector<COutPoint>& coins_to_uncacheIn) :
+        ptx(ptxIn), state(stateIn), pfMissingInputs(pfMissingInputsIn), nAcceptTime(nAcceptTimeIn), plTxnReplaced(plTxnReplacedIn),
+        bypass_limits(bypass_limitsIn), nAbsurdFee(nAbsurdFeeIn), coins_to_uncache(coins_to_uncacheIn), view(&dummy),
+        nModifiedFees(0), nConflictingFees(0), nConflictingSize(0), scriptVerifyFlags(0), currentBlockScriptVerifyFlags(0), fChecksPassed(false) {}
+};
 
+/** Checks that don't depend on the chain or the mempool */
+bool MemPoolContextFreeChecks(const CTransaction& tx, CValidationState& state)
+{
     if (!CheckTransaction(tx, state))
         return false; // state filled in by CheckTransaction
 
@@ -567,6 +607,20 @@ static bool AcceptToMemoryPoolWorker(const CChainParams& chainparams, CTxMemPool
     if (tx.IsCoinBase())
         return state.DoS(100, false, REJECT_INVALID, "coinbase");
 
+    return true;
+}
+
+/** Checks against the tip and the mempool, short of the scripts. cs_main and pool.cs must be held. */
+bool MemPoolPreChecks(const CChainParams& chainparams, CTxMemPool& pool, CTxAcceptWorkspace& ws)
+{
+    AssertLockHeld(cs_main);
+    AssertLockHeld(pool.cs);
+    const CTransactionRef& ptx = ws.ptx;
+    const CTransaction& tx = *ptx;
+    const uint256 hash = tx.GetHash();
+    CValidationState& state = ws.state;
+    CCoinsViewCache& view = ws.view;
+
     // Reject transactions with witness before segregated witness activates (override with -prematurewitness)
     bool witnessEnabled = IsWitnessEnabled(chainActive.Tip(), chainparams.GetConsensus());
     if (!gArgs.GetBoolArg("-prematurewitness", false) && tx.HasWitness() && !witnessEnabled) {
@@ -590,7 +644,7 @@ static bool AcceptToMemoryPoolWorker(const CChainParams& chainparams, CTxMemPool
     }
 
     // Check for conflicts with in-memory transactions
-    std::set<uint256> setConflicts;
+    std::set<uint256>& setConflicts = ws.setConflicts;
     for (const CTxIn &txin : tx.vin)
     {
         auto itConflicting = pool.mapNextTx.find(txin.prevout);
@@ -632,352 +686,421 @@ static bool AcceptToMemoryPoolWorker(const CChainParams& chainparams, CTxMemPool
         }
     }
 
-    {
-        CCoinsView dummy;
-        CCoinsViewCache view(&dummy);
-
-        LockPoints lp;
-        CCoinsViewMemPool viewMemPool(pcoinsTip.get(), pool);
-        view.SetBackend(viewMemPool);
+    LockPoints lp;
+    CCoinsViewMemPool viewMemPool(pcoinsTip.get(), pool);
+    view.SetBackend(viewMemPool);
 
-        // do all inputs exist?
-        for (const CTxIn txin : tx.vin) {
-            if (!pcoinsTip->HaveCoinInCache(txin.prevout)) {
-                coins_to_uncache.push_back(txin.prevout);
-            }
-            if (!view.HaveCoin(txin.prevout)) {
-                // Are inputs missing because we already have the tx?
-                for (size_t out = 0; out < tx.vout.size(); out++) {
-                    // Optimistically just do efficient check of cache for outputs
-                    if (pcoinsTip->HaveCoinInCache(COutPoint(hash, out))) {
-                        return state.Invalid(false, REJECT_DUPLICATE, "txn-already-known");
-                    }
-                }
-                // Otherwise assume this might be an orphan tx for which we just haven't seen parents yet
-                if (pfMissingInputs) {
-                    *pfMissingInputs = true;
+    // do all inputs exist?
+    for (const CTxIn txin : tx.vin) {
+        if (!pcoinsTip->HaveCoinInCache(txin.prevout)) {
+            ws.coins_to_uncache.push_back(txin.prevout);
+        }
+        if (!view.HaveCoin(txin.prevout)) {
+            // Are inputs missing because we already have the tx?
+            for (size_t out = 0; out < tx.vout.size(); out++) {
+                // Optimistically just do efficient check of cache for outputs
+                if (pcoinsTip->HaveCoinInCache(COutPoint(hash, out))) {
+                    return state.Invalid(false, REJECT_DUPLICATE, "txn-already-known");
                 }
-                return false; // fMissingInputs and !state.IsInvalid() is used to detect this condition, don't set state.Invalid()
             }
+            // Otherwise assume this might be an orphan tx for which we just haven't seen parents yet
+            if (ws.pfMissingInputs) {
+                *ws.pfMissingInputs = true;
+            }
+            return false; // fMissingInputs and !state.IsInvalid() is used to detect this condition, don't set state.Invalid()
         }
+    }
 
-        // Bring the best block into scope
-        view.GetBestBlock();
+    // Bring the best block into scope
+    view.GetBestBlock();
 
-        // we have all inputs cached now, so switch back to dummy, so we don't need to keep lock on mempool
-        view.SetBackend(dummy);
+    // we have all inputs cached now, so switch back to dummy, so we don't need to keep lock on mempool
+    view.SetBackend(ws.dummy);
 
-        // Only accept BIP68 sequence locked transactions that can be mined in the next
-        // block; we don't want our mempool filled up with transactions that can't
-        // be mined yet.
-        // Must keep pool.cs for this unless we change CheckSequenceLocks to take a
-        // CoinsViewCache instead of create its own
-        if (!CheckSequenceLocks(tx, STANDARD_LOCKTIME_VERIFY_FLAGS, &lp))
-            return state.DoS(0, false, REJECT_NONSTANDARD, "non-BIP68-final");
+    // Only accept BIP68 sequence locked transactions that can be mined in the next
+    // block; we don't want our mempool filled up with transactions that can't
+    // be mined yet.
+    // Must keep pool.cs for this unless we change CheckSequenceLocks to take a
+    // CoinsViewCache instead of create its own
+    if (!CheckSequenceLocks(tx, STANDARD_LOCKTIME_VERIFY_FLAGS, &lp))
+        return state.DoS(0, false, REJECT_NONSTANDARD, "non-BIP68-final");
 
-        CAmount nFees = 0;
-        if (!Consensus::CheckTxInputs(tx, state, view, GetSpendHeight(view), nFees)) {
-            return error("%s: Consensus::CheckTxInputs: %s, %s", __func__, tx.GetHash().ToString(), FormatStateMessage(state));
-        }
+    CAmount nFees = 0;
+    if (!Consensus::CheckTxInputs(tx, state, view, GetSpendHeight(view), nFees)) {
+        return error("%s: Consensus::CheckTxInputs: %s, %s", __func__, tx.GetHash().ToString(), FormatStateMessage(state));
+    }
 
-        // Check for non-standard pay-to-script-hash in inputs
-        if (fRequireStandard && !AreInputsStandard(tx, view))
-            return state.Invalid(false, REJECT_NONSTANDARD, "bad-txns-nonstandard-inputs");
+    // Check for non-standard pay-to-script-hash in inputs
+    if (fRequireStandard && !AreInputsStandard(tx, view))
+        return state.Invalid(false, REJECT_NONSTANDARD, "bad-txns-nonstandard-inputs");
 
-        // Check for non-standard witness in P2WSH
-        if (tx.HasWitness() && fRequireStandard && !IsWitnessStandard(tx, view))
-            return state.DoS(0, false, REJECT_NONSTANDARD, "bad-witness-nonstandard", true);
+    // Check for non-standard witness in P2WSH
+    if (tx.HasWitness() && fRequireStandard && !IsWitnessStandard(tx, view))
+        return state.DoS(0, false, REJECT_NONSTANDARD, "bad-witness-nonstandard", true);
 
-        int64_t nSigOpsCost = GetTransactionSigOpCost(tx, view, STANDARD_SCRIPT_VERIFY_FLAGS);
+    int64_t nSigOpsCost = GetTransactionSigOpCost(tx, view, STANDARD_SCRIPT_VERIFY_FLAGS);
 
-        // nModifiedFees includes any fee deltas from PrioritiseTransaction
-        CAmount nModifiedFees = nFees;
-        pool.ApplyDelta(hash, nModifiedFees);
+    // nModifiedFees includes any fee deltas from PrioritiseTransaction
+    CAmount& nModifiedFees = ws.nModifiedFees;
+    nModifiedFees = nFees;
+    pool.ApplyDelta(hash, nModifiedFees);
 
-        // Keep track of transactions that spend a coinbase, which we re-scan
-        // during reorgs to ensure COINBASE_MATURITY is still met.
-        bool fSpendsCoinbase = false;
-        for (const CTxIn &txin : tx.vin) {
-            const Coin &coin = view.AccessCoin(txin.prevout);
-            if (coin.IsCoinBase()) {
-                fSpendsCoinbase = true;
-                break;
-            }
+    // Keep track of transactions that spend a coinbase, which we re-scan
+    // during reorgs to ensure COINBASE_MATURITY is still met.
+    bool fSpendsCoinbase = false;
+    for (const CTxIn &txin : tx.vin) {
+        const Coin &coin = view.AccessCoin(txin.prevout);
+        if (coin.IsCoinBase()) {
+            fSpendsCoinbase = true;
+            break;
         }
+    }
 
-        CTxMemPoolEntry entry(ptx, nFees, nAcceptTime, chainActive.Height(),
-                              fSpendsCoinbase, nSigOpsCost, lp);
-        unsigned int nSize = entry.GetTxSize();
+    ws.entry.reset(new CTxMemPoolEntry(ptx, nFees, ws.nAcceptTime, chainActive.Height(),
+                                       fSpendsCoinbase, nSigOpsCost, lp));
+    unsigned int nSize = ws.entry->GetTxSize();
 
-        // Check that the transaction doesn't have an excessive number of
-        // sigops, making it impossible to mine. Since the coinbase transaction
-        // itself can contain sigops MAX_STANDARD_TX_SIGOPS is less than
-        // MAX_BLOCK_SIGOPS; we still consider this an invalid rather than
-        // merely non-standard transaction.
-        if (nSigOpsCost > MAX_STANDARD_TX_SIGOPS_COST)
-            return state.DoS(0, false, REJECT_NONSTANDARD, "bad-txns-too-many-sigops", false,
-                strprintf("%d", nSigOpsCost));
+    // Check that the transaction doesn't have an excessive number of
+    // sigops, making it impossible to mine. Since the coinbase transaction
+    // itself can contain sigops MAX_STANDARD_TX_SIGOPS is less than
+    // MAX_BLOCK_SIGOPS; we still consider this an invalid rather than
+    // merely non-standard transaction.
+    if (nSigOpsCost > MAX_STANDARD_TX_SIGOPS_COST)
+        return state.DoS(0, false, REJECT_NONSTANDARD, "bad-txns-too-many-sigops", false,
+            strprintf("%d", nSigOpsCost));
 
-        CAmount mempoolRejectFee = pool.GetMinFee(gArgs.GetArg("-maxmempool", DEFAULT_MAX_MEMPOOL_SIZE) * 1000000).GetFee(nSize);
-        if (!bypass_limits && mempoolRejectFee > 0 && nModifiedFees < mempoolRejectFee) {
-            return state.DoS(0, false, REJECT_INSUFFICIENTFEE, "mempool min fee not met", false, strprintf("%d < %d", nFees, mempoolRejectFee));
-        }
+    CAmount mempoolRejectFee = pool.GetMinFee(gArgs.GetArg("-maxmempool", DEFAULT_MAX_MEMPOOL_SIZE) * 1000000).GetFee(nSize);
+    if (!ws.bypass_limits && mempoolRejectFee > 0 && nModifiedFees < mempoolRejectFee) {
+        return state.DoS(0, false, REJECT_INSUFFICIENTFEE, "mempool min fee not met", false, strprintf("%d < %d", nFees, mempoolRejectFee));
+    }
 
-        // No transactions are allowed below minRelayTxFee except from disconnected blocks
-        if (!bypass_limits && nModifiedFees < ::minRelayTxFee.GetFee(nSize)) {
-            return state.DoS(0, false, REJECT_INSUFFICIENTFEE, "min relay fee not met");
-        }
+    // No transactions are allowed below minRelayTxFee except from disconnected blocks
+    if (!ws.bypass_limits && nModifiedFees < ::minRelayTxFee.GetFee(nSize)) {
+        return state.DoS(0, false, REJECT_INSUFFICIENTFEE, "min relay fee not met");
+    }
 
-        if (nAbsurdFee && nFees > nAbsurdFee)
-            return state.Invalid(false,
-                REJECT_HIGHFEE, "absurdly-high-fee",
-                strprintf("%d > %d", nFees, nAbsurdFee));
+    if (ws.nAbsurdFee && nFees > ws.nAbsurdFee)
+        return state.Invalid(false,
+            REJECT_HIGHFEE, "absurdly-high-fee",
+            strprintf("%d > %d", nFees, ws.nAbsurdFee));
 
-        // Calculate in-mempool ancestors, up to a limit.
-        CTxMemPool::setEntries setAncestors;
-        size_t nLimitAncestors = gArgs.GetArg("-limitancestorcount", DEFAULT_ANCESTOR_LIMIT);
-        size_t nLimitAncestorSize = gArgs.GetArg("-limitancestorsize", DEFAULT_ANCESTOR_SIZE_LIMIT)*1000;
-        size_t nLimitDescendants = gArgs.GetArg("-limitdescendantcount", DEFAULT_DESCENDANT_LIMIT);
-        size_t nLimitDescendantSize = gArgs.GetArg("-limitdescendantsize", DEFAULT_DESCENDANT_SIZE_LIMIT)*1000;
-        std::string errString;
-        if (!pool.CalculateMemPoolAncestors(entry, setAncestors, nLimitAncestors, nLimitAncestorSize, nLimitDescendants, nLimitDescendantSize, errString)) {
-            return state.DoS(0, false, REJECT_NONSTANDARD, "too-long-mempool-chain", false, errString);
-        }
+    // Calculate in-mempool ancestors, up to a limit.
+    CTxMemPool::setEntries& setAncestors = ws.setAncestors;
+    size_t nLimitAncestors = gArgs.GetArg("-limitancestorcount", DEFAULT_ANCESTOR_LIMIT);
+    size_t nLimitAncestorSize = gArgs.GetArg("-limitancestorsize", DEFAULT_ANCESTOR_SIZE_LIMIT)*1000;
+    size_t nLimitDescendants = gArgs.GetArg("-limitdescendantcount", DEFAULT_DESCENDANT_LIMIT);
+    size_t nLimitDescendantSize = gArgs.GetArg("-limitdescendantsize", DEFAULT_DESCENDANT_SIZE_LIMIT)*1000;
+    std::string errString;
+    if (!pool.CalculateMemPoolAncestors(*ws.entry, setAncestors, nLimitAncestors, nLimitAncestorSize, nLimitDescendants, nLimitDescendantSize, errString)) {
+        return state.DoS(0, false, REJECT_NONSTANDARD, "too-long-mempool-chain", false, errString);
+    }
 
-        // A transaction that spends outputs that would be replaced by it is invalid. Now
-        // that we have the set of all ancestors we can detect this
-        // pathological case by making sure setConflicts and setAncestors don't
-        // intersect.
-        for (CTxMemPool::txiter ancestorIt : setAncestors)
+    // A transaction that spends outputs that would be replaced by it is invalid. Now
+    // that we have the set of all ancestors we can detect this
+    // pathological case by making sure setConflicts and setAncestors don't
+    // intersect.
+    for (CTxMemPool::txiter ancestorIt : setAncestors)
+    {
+        const uint256 &hashAncestor = ancestorIt->GetTx().GetHash();
+        if (setConflicts.count(hashAncestor))
         {
-            const uint256 &hashAncestor = ancestorIt->GetTx().GetHash();
-            if (setConflicts.count(hashAncestor))
-            {
-                return state.DoS(10, false,
-                                 REJECT_INVALID, "bad-txns-spends-conflicting-tx", false,
-                                 strprintf("%s spends conflicting transaction %s",
-                                           hash.ToString(),
-                                           hashAncestor.ToString()));
-            }
-        }
-
-        // Check if it's economically rational to mine this transaction rather
-        // than the ones it replaces.
-        CAmount nConflictingFees = 0;
-        size_t nConflictingSize = 0;
-        uint64_t nConflictingCount = 0;
-        CTxMemPool::setEntries allConflicting;
-
-        // If we don't hold the lock allConflicting might be incomplete; the
-        // subsequent RemoveStaged() and addUnchecked() calls don't guarantee
-        // mempool consistency for us.
-        const bool fReplacementTransaction = setConflicts.size();
-        if (fReplacementTransaction)
+            return state.DoS(10, false,
+                             REJECT_INVALID, "bad-txns-spends-conflicting-tx", false,
+                             strprintf("%s spends conflicting transaction %s",
+                                       hash.ToString(),
+                                       hashAncestor.ToString()));
+        }
+    }
+
+    // Check if it's economically rational to mine this transaction rather
+    // than the ones it replaces.
+    CAmount& nConflictingFees = ws.nConflictingFees;
+    size_t& nConflictingSize = ws.nConflictingSize;
+    uint64_t nConflictingCount = 0;
+    CTxMemPool::setEntries& allConflicting = ws.allConflicting;
+
+    // If we don't hold the lock allConflicting might be incomplete; the
+    // subsequent RemoveStaged() and addUnchecked() calls don't guarantee
+    // mempool consistency for us.
+    const bool fReplacementTransaction = setConflicts.size();
+    if (fReplacementTransaction)
+    {
+        CFeeRate newFeeRate(nModifiedFees, nSize);
+        std::set<uint256> setConflictsParents;
+        const int maxDescendantsToVisit = 100;
+        CTxMemPool::setEntries setIterConflicting;
+        for (const uint256 &hashConflicting : setConflicts)
         {
-            CFeeRate newFeeRate(nModifiedFees, nSize);
-            std::set<uint256> setConflictsParents;
-            const int maxDescendantsToVisit = 100;
-            CTxMemPool::setEntries setIterConflicting;
-            for (const uint256 &hashConflicting : setConflicts)
-            {
-                CTxMemPool::txiter mi = pool.mapTx.find(hashConflicting);
-                if (mi == pool.mapTx.end())
-                    continue;
-
-                // Save these to avoid repeated lookups
-                setIterConflicting.insert(mi);
-
-                // Don't allow the replacement to reduce the feerate of the
-                // mempool.
-                //
-                // We usually don't want to accept replacements with lower
-                // feerates than what they replaced as that would lower the
-                // feerate of the next block. Requiring that the feerate always
-                // be increased is also an easy-to-reason about way to prevent
-                // DoS attacks via replacements.
-                //
-                // The mining code doesn't (currently) take children into
-                // account (CPFP) so we only consider the feerates of
-                // transactions being directly replaced, not their indirect
-                // descendants. While that does mean high feerate children are
-                // ignored when deciding whether or not to replace, we do
-                // require the replacement to pay more overall fees too,
-                // mitigating most cases.
-                CFeeRate oldFeeRate(mi->GetModifiedFee(), mi->GetTxSize());
-                if (newFeeRate <= oldFeeRate)
-                {
-                    return state.DoS(0, false,
-                            REJECT_INSUFFICIENTFEE, "insufficient fee", false,
-                            strprintf("rejecting replacement %s; new feerate %s <= old feerate %s",
-                                  hash.ToString(),
-                                  newFeeRate.ToString(),
-                                  oldFeeRate.ToString()));
-                }
-
-                for (const CTxIn &txin : mi->GetTx().vin)
-                {
-                    setConflictsParents.insert(txin.prevout.hash);
-                }
+            CTxMemPool::txiter mi = pool.mapTx.find(hashConflicting);
+            if (mi == pool.mapTx.end())
+                continue;
 
-                nConflictingCount += mi->GetCountWithDescendants();
-            }
-            // This potentially overestimates the number of actual descendants
-            // but we just want to be conservative to avoid doing too much
-            // work.
-            if (nConflictingCount <= maxDescendantsToVisit) {
-                // If not too many to replace, then calculate the set of
-                // transactions that would have to be evicted
-                for (CTxMemPool::txiter it : setIterConflicting) {
-                    pool.CalculateDescendants(it, allConflicting);
-                }
-                for (CTxMemPool::txiter it : allConflicting) {
-                    nConflictingFees += it->GetModifiedFee();
-                    nConflictingSize += it->GetTxSize();
-                }
-            } else {
+            // Save these to avoid repeated lookups
+            setIterConflicting.insert(mi);
+
+            // Don't allow the replacement to reduce the feerate of the
+            // mempool.
+            //
+            // We usually don't want to accept replacements with lower
+            // feerates than what they replaced as that would lower the
+            // feerate of the next block. Requiring that the feerate always
+            // be increased is also an easy-to-reason about way to prevent
+            // DoS attacks via replacements.
+            //
+            // The mining code doesn't (currently) take children into
+            // account (CPFP) so we only consider the feerates of
+            // transactions being directly replaced, not their indirect
+            // descendants. While that does mean high feerate children are
+            // ignored when deciding whether or not to replace, we do
+            // require the replacement to pay more overall fees too,
+            // mitigating most cases.
+            CFeeRate oldFeeRate(mi->GetModifiedFee(), mi->GetTxSize());
+            if (newFeeRate <= oldFeeRate)
+            {
                 return state.DoS(0, false,
-                        REJECT_NONSTANDARD, "too many potential replacements", false,
-                        strprintf("rejecting replacement %s; too many potential replacements (%d > %d)\n",
-                            hash.ToString(),
-                            nConflictingCount,
-                            maxDescendantsToVisit));
+                        REJECT_INSUFFICIENTFEE, "insufficient fee", false,
+                        strprintf("rejecting replacement %s; new feerate %s <= old feerate %s",
+                              hash.ToString(),
+                              newFeeRate.ToString(),
+                              oldFeeRate.ToString()));
             }
 
-            for (unsigned int j = 0; j < tx.vin.size(); j++)
+            for (const CTxIn &txin : mi->GetTx().vin)
             {
-                // We don't want to accept replacements that require low
-                // feerate junk to be mined first. Ideally we'd keep track of
-                // the ancestor feerates and make the decision based on that,
-                // but for now requiring all new inputs to be confirmed works.
-                if (!setConflictsParents.count(tx.vin[j].prevout.hash))
-                {
-                    // Rather than check the UTXO set - potentially expensive -
-                    // it's cheaper to just check if the new input refers to a
-                    // tx that's in the mempool.
-                    if (pool.mapTx.find(tx.vin[j].prevout.hash) != pool.mapTx.end())
-                        return state.DoS(0, false,
-                                         REJECT_NONSTANDARD, "replacement-adds-unconfirmed", false,
-                                         strprintf("replacement %s adds unconfirmed input, idx %d",
-                                                  hash.ToString(), j));
-                }
+                setConflictsParents.insert(txin.prevout.hash);
             }
 
-            // The replacement must pay greater fees than the transactions it
-            // replaces - if we did the bandwidth used by those conflicting
-            // transactions would not be paid for.
-            if (nModifiedFees < nConflictingFees)
-            {
-                return state.DoS(0, false,
-                                 REJECT_INSUFFICIENTFEE, "insufficient fee", false,
-                                 strprintf("rejecting replacement %s, less fees than conflicting txs; %s < %s",
-                                          hash.ToString(), FormatMoney(nModifiedFees), FormatMoney(nConflictingFees)));
+            nConflictingCount += mi->GetCountWithDescendants();
+        }
+        // This potentially overestimates the number of actual descendants
+        // but we just want to be conservative to avoid doing too much
+        // work.
+        if (nConflictingCount <= maxDescendantsToVisit) {
+            // If not too many to replace, then calculate the set of
+            // transactions that would have to be evicted
+            for (CTxMemPool::txiter it : setIterConflicting) {
+                pool.CalculateDescendants(it, allConflicting);
+            }
+            for (CTxMemPool::txiter it : allConflicting) {
+                nConflictingFees += it->GetModifiedFee();
+                nConflictingSize += it->GetTxSize();
             }
+        } else {
+            return state.DoS(0, false,
+                    REJECT_NONSTANDARD, "too many potential replacements", false,
+                    strprintf("rejecting replacement %s; too many potential replacements (%d > %d)\n",
+                        hash.ToString(),
+                        nConflictingCount,
+                        maxDescendantsToVisit));
+        }
 
-            // Finally in addition to paying more fees than the conflicts the
-            // new transaction must pay for its own bandwidth.
-            CAmount nDeltaFees = nModifiedFees - nConflictingFees;
-            if (nDeltaFees < ::incrementalRelayFee.GetFee(nSize))
+        for (unsigned int j = 0; j < tx.vin.size(); j++)
+        {
+            // We don't want to accept replacements that require low
+            // feerate junk to be mined first. Ideally we'd keep track of
+            // the ancestor feerates and make the decision based on that,
+            // but for now requiring all new inputs to be confirmed works.
+            if (!setConflictsParents.count(tx.vin[j].prevout.hash))
             {
-                return state.DoS(0, false,
-                        REJECT_INSUFFICIENTFEE, "insufficient fee", false,
-                        strprintf("rejecting replacement %s, not enough additional fees to relay; %s < %s",
-                              hash.ToString(),
-                              FormatMoney(nDeltaFees),
-                              FormatMoney(::incrementalRelayFee.GetFee(nSize))));
+                // Rather than check the UTXO set - potentially expensive -
+                // it's cheaper to just check if the new input refers to a
+                // tx that's in the mempool.
+                if (pool.mapTx.find(tx.vin[j].prevout.hash) != pool.mapTx.end())
+                    return state.DoS(0, false,
+                                     REJECT_NONSTANDARD, "replacement-adds-unconfirmed", false,
+                                     strprintf("replacement %s adds unconfirmed input, idx %d",
+                                              hash.ToString(), j));
             }
         }
 
-        unsigned int scriptVerifyFlags = STANDARD_SCRIPT_VERIFY_FLAGS;
-        if (!chainparams.RequireStandard()) {
-            scriptVerifyFlags = gArgs.GetArg("-promiscuousmempoolflags", scriptVerifyFlags);
+        // The replacement must pay greater fees than the transactions it
+        // replaces - if we did the bandwidth used by those conflicting
+        // transactions would not be paid for.
+        if (nModifiedFees < nConflictingFees)
+        {
+            return state.DoS(0, false,
+                             REJECT_INSUFFICIENTFEE, "insufficient fee", false,
+                             strprintf("rejecting replacement %s, less fees than conflicting txs; %s < %s",
+                                      hash.ToString(), FormatMoney(nModifiedFees), FormatMoney(nConflictingFees)));
         }
 
-        // Check against previous transactions
-        // This is done last to help prevent CPU exhaustion denial-of-service attacks.
-        PrecomputedTransactionData txdata(tx);
-        if (!CheckInputs(tx, state, view, true, scriptVerifyFlags, true, false, txdata)) {
-            // SCRIPT_VERIFY_CLEANSTACK requires SCRIPT_VERIFY_WITNESS, so we
-            // need to turn both off, and compare against just turning off CLEANSTACK
-            // to see if the failure is specifically due to witness validation.
-            CValidationState stateDummy; // Want reported failures to be from first CheckInputs
-            if (!tx.HasWitness() && CheckInputs(tx, stateDummy, view, true, scriptVerifyFlags & ~(SCRIPT_VERIFY_WITNESS | SCRIPT_VERIFY_CLEANSTACK), true, false, txdata) &&
-                !CheckInputs(tx, stateDummy, view, true, scriptVerifyFlags & ~SCRIPT_VERIFY_CLEANSTACK, true, false, txdata)) {
-                // Only the witness is missing, so the transaction itself may be fine.
-                state.SetCorruptionPossible();
-            }
-            return false; // state filled in by CheckInputs
-        }
-
-        // Check again against the current block tip's script verification
-        // flags to cache our script execution flags. This is, of course,
-        // useless if the next block has different script flags from the
-        // previous one, but because the cache tracks script flags for us it
-        // will auto-invalidate and we'll just have a few blocks of extra
-        // misses on soft-fork activation.
-        //
-        // This is also useful in case of bugs in the standard flags that cause
-        // transactions to pass as valid when they're actually invalid. For
-        // instance the STRICTENC flag was incorrectly allowing certain
-        // CHECKSIG NOT scripts to pass, even though they were invalid.
-        //
-        // There is a similar check in CreateNewBlock() to prevent creating
-        // invalid blocks (using TestBlockValidity), however allowing such
-        // transactions into the mempool can be exploited as a DoS attack.
-        unsigned int currentBlockScriptVerifyFlags = GetBlockScriptFlags(chainActive.Tip(), Params().GetConsensus());
-        if (!CheckInputsFromMempoolAndCache(tx, state, view, pool, currentBlockScriptVerifyFlags, true, txdata))
+        // Finally in addition to paying more fees than the conflicts the
+        // new transaction must pay for its own bandwidth.
+        CAmount nDeltaFees = nModifiedFees - nConflictingFees;
+        if (nDeltaFees < ::incrementalRelayFee.GetFee(nSize))
         {
-            // If we're using promiscuousmempoolflags, we may hit this normally
-            // Check if current block has some flags that scriptVerifyFlags
-            // does not before printing an ominous warning
-            if (!(~scriptVerifyFlags & currentBlockScriptVerifyFlags)) {
-                return error("%s: BUG! PLEASE REPORT THIS! ConnectInputs failed against latest-block but not STANDARD flags %s, %s",
-                    __func__, hash.ToString(), FormatStateMessage(state));
+            return state.DoS(0, false,
+                    REJECT_INSUFFICIENTFEE, "insufficient fee", false,
+                    strprintf("rejecting replacement %s, not enough additional fees to relay; %s < %s",
+                          hash.ToString(),
+                          FormatMoney(nDeltaFees),
+                          FormatMoney(::incrementalRelayFee.GetFee(nSize))));
+        }
+    }
+
+    ws.scriptVerifyFlags = STANDARD_SCRIPT_VERIFY_FLAGS;
+    if (!chainparams.RequireStandard()) {
+        ws.scriptVerifyFlags = gArgs.GetArg("-promiscuousmempoolflags", ws.scriptVerifyFlags);
+    }
+    ws.currentBlockScriptVerifyFlags = GetBlockScriptFlags(chainActive.Tip(), Params().GetConsensus());
+
+    return true;
+}
+
+/**
+ * Check the scripts against the policy flags. Needs no locks: the coins are
+ * in ws.view, and the signature and script execution caches are thread safe.
+ */
+bool MemPoolPolicyScriptChecks(CTxAcceptWorkspace& ws)
+{
+    const CTransaction& tx = *ws.ptx;
+    CValidationState& state = ws.state;
+    const CCoinsViewCache& view = ws.view;
+    const unsigned int scriptVerifyFlags = ws.scriptVerifyFlags;
+    if (!ws.txdata)
+        ws.txdata.reset(new PrecomputedTransactionData(tx));
+    PrecomputedTransactionData& txdata = *ws.txdata;
+
+    // Check against previous transactions
+    // This is done last to help prevent CPU exhaustion denial-of-service attacks.
+    if (!CheckInputs(tx, state, view, true, scriptVerifyFlags, true, false, txdata)) {
+        // SCRIPT_VERIFY_CLEANSTACK requires SCRIPT_VERIFY_WITNESS, so we
+        // need to turn both off, and compare against just turning off CLEANSTACK
+        // to see if the failure is specifically due to witness validation.
+        CValidationState stateDummy; // Want reported failures to be from first CheckInputs
+        if (!tx.HasWitness() && CheckInputs(tx, stateDummy, view, true, scriptVerifyFlags & ~(SCRIPT_VERIFY_WITNESS | SCRIPT_VERIFY_CLEANSTACK), true, false, txdata) &&
+            !CheckInputs(tx, stateDummy, view, true, scriptVerifyFlags & ~SCRIPT_VERIFY_CLEANSTACK, true, false, txdata)) {
+            // Only the witness is missing, so the transaction itself may be fine.
+            state.SetCorruptionPossible();
+        }
+        return false; // state filled in by CheckInputs
+    }
+
+    return true;
+}
+
+/**
+ * Check the scripts again against the current block flags. If pool is given,
+ * cs_main and pool.cs must be held, and the coins are first checked against
+ * it and pcoinsTip; otherwise no locks are needed.
+ */
+bool MemPoolConsensusScriptChecks(CTxAcceptWorkspace& ws, CTxMemPool* pool)
+{
+    const CTransaction& tx = *ws.ptx;
+    CValidationState& state = ws.state;
+    const CCoinsViewCache& view = ws.view;
+    const unsigned int scriptVerifyFlags = ws.scriptVerifyFlags;
+    const unsigned int currentBlockScriptVerifyFlags = ws.currentBlockScriptVerifyFlags;
+    PrecomputedTransactionData& txdata = *ws.txdata;
+
+    // Check again against the current block tip's script verification
+    // flags to cache our script execution flags. This is, of course,
+    // useless if the next block has different script flags from the
+    // previous one, but because the cache tracks script flags for us it
+    // will auto-invalidate and we'll just have a few blocks of extra
+    // misses on soft-fork activation.
+    //
+    // This is also useful in case of bugs in the standard flags that cause
+    // transactions to pass as valid when they're actually invalid. For
+    // instance the STRICTENC flag was incorrectly allowing certain
+    // CHECKSIG NOT scripts to pass, even though they were invalid.
+    //
+    // There is a similar check in CreateNewBlock() to prevent creating
+    // invalid blocks (using TestBlockValidity), however allowing such
+    // transactions into the mempool can be exploited as a DoS attack.
+    if (pool ? !CheckInputsFromMempoolAndCache(tx, state, view, *pool, currentBlockScriptVerifyFlags, true, txdata) :
+               !CheckInputs(tx, state, view, true, currentBlockScriptVerifyFlags, true, true, txdata))
+    {
+        // If we're using promiscuousmempoolflags, we may hit this normally
+        // Check if current block has some flags that scriptVerifyFlags
+        // does not before printing an ominous warning
+        if (!(~scriptVerifyFlags & currentBlockScriptVerifyFlags)) {
+            return error("%s: BUG! PLEASE REPORT THIS! ConnectInputs failed against latest-block but not STANDARD flags %s, %s",
+                __func__, tx.GetHash().ToString(), FormatStateMessage(state));
+        } else {
+            if (!CheckInputs(tx, state, view, true, MANDATORY_SCRIPT_VERIFY_FLAGS, true, false, txdata)) {
+                return error("%s: ConnectInputs failed against MANDATORY but not STANDARD flags due to promiscuous mempool %s, %s",
+                    __func__, tx.GetHash().ToString(), FormatStateMessage(state));
             } else {
-                if (!CheckInputs(tx, state, view, true, MANDATORY_SCRIPT_VERIFY_FLAGS, true, false, txdata)) {
-                    return error("%s: ConnectInputs failed against MANDATORY but not STANDARD flags due to promiscuous mempool %s, %s",
-                        __func__, hash.ToString(), FormatStateMessage(state));
-                } else {
-                    LogPrintf("Warning: -promiscuousmempool flags set to not include currently enforced soft forks, this may break mining or otherwise cause instability!\n");
-                }
+                LogPrintf("Warning: -promiscuousmempool flags set to not include currently enforced soft forks, this may break mining or otherwise cause instability!\n");
             }
         }
+    }
 
-        // Remove conflicting transactions from the mempool
-        for (const CTxMemPool::txiter it : allConflicting)
-        {
-            LogPrint(BCLog::MEMPOOL, "replacing tx %s with %s for %s PLHV additional fees, %d delta bytes\n",
-                    it->GetTx().GetHash().ToString(),
-                    hash.ToString(),
-                    FormatMoney(nModifiedFees - nConflictingFees),
-                    (int)nSize - (int)nConflictingSize);
-            if (plTxnReplaced)
-                plTxnReplaced->push_back(it->GetSharedTx());
-        }
-        pool.RemoveStaged(allConflicting, false, MemPoolRemovalReason::REPLACED);
+    return true;
+}
 
-        // This transaction should only count for fee estimation if:
-        // - it isn't a BIP 125 replacement transaction (may not be widely supported)
-        // - it's not being readded during a reorg which bypasses typical mempool fee limits
-        // - the node is not behind
-        // - the transaction is not dependent on any other transactions in the mempool
-        bool validForFeeEstimation = !fReplacementTransaction && !bypass_limits && IsCurrentForFeeEstimation() && pool.HasNoInputsOf(tx);
+/** Replace any conflicts and add the transaction to the mempool. cs_main and pool.cs must be held. */
+bool MemPoolFinalize(CTxMemPool& pool, CTxAcceptWorkspace& ws)
+{
+    AssertLockHeld(cs_main);
+    AssertLockHeld(pool.cs);
+    const CTransaction& tx = *ws.ptx;
+    const uint256 hash = tx.GetHash();
+    CValidationState& state = ws.state;
+    const bool fReplacementTransaction = ws.setConflicts.size();
+    const unsigned int nSize = ws.entry->GetTxSize();
 
-        // Store transaction in memory
-        pool.addUnchecked(hash, entry, setAncestors, validForFeeEstimation);
+    // Remove conflicting transactions from the mempool
+    for (const CTxMemPool::txiter it : ws.allConflicting)
+    {
+        LogPrint(BCLog::MEMPOOL, "replacing tx %s with %s for %s PLHV additional fees, %d delta bytes\n",
+                it->GetTx().GetHash().ToString(),
+                hash.ToString(),
+                FormatMoney(ws.nModifiedFees - ws.nConflictingFees),
+                (int)nSize - (int)ws.nConflictingSize);
+        if (ws.plTxnReplaced)
+            ws.plTxnReplaced->push_back(it->GetSharedTx());
+    }
+    pool.RemoveStaged(ws.allConflicting, false, MemPoolRemovalReason::REPLACED);
 
-        // trim mempool and check if tx was trimmed
-        if (!bypass_limits) {
-            LimitMempoolSize(pool, gArgs.GetArg("-maxmempool", DEFAULT_MAX_MEMPOOL_SIZE) * 1000000, gArgs.GetArg("-mempoolexpiry", DEFAULT_MEMPOOL_EXPIRY) * 60 * 60);
-            if (!pool.exists(hash))
-                return state.DoS(0, false, REJECT_INSUFFICIENTFEE, "mempool full");
-        }
+    // This transaction should only count for fee estimation if:
+    // - it isn't a BIP 125 replacement transaction (may not be widely supported)
+    // - it's not being readded during a reorg which bypasses typical mempool fee limits
+    // - the node is not behind
+    // - the transaction is not dependent on any other transactions in the mempool
+    bool validForFeeEstimation = !fReplacementTransaction && !ws.bypass_limits && IsCurrentForFeeEstimation() && pool.HasNoInputsOf(tx);
+
+    // Store transaction in memory
+    pool.addUnchecked(hash, *ws.entry, ws.setAncestors, validForFeeEstimation);
+
+    // trim mempool and check if tx was trimmed
+    if (!ws.bypass_limits) {
+        LimitMempoolSize(pool, gArgs.GetArg("-maxmempool", DEFAULT_MAX_MEMPOOL_SIZE) * 1000000, gArgs.GetArg("-mempoolexpiry", DEFAULT_MEMPOOL_EXPIRY) * 60 * 60);
+        if (!pool.exists(hash))
+            return state.DoS(0, false, REJECT_INSUFFICIENTFEE, "mempool full");
     }
 
-    GetMainSignals().TransactionAddedToMempool(ptx);
+    GetMainSignals().TransactionAddedToMempool(ws.ptx);
 
     return true;
 }
 
+} // namespace
+
+static bool AcceptToMemoryPoolWorker(const CChainParams& chainparams, CTxMemPool& pool, CValidationState& state, const CTransactionRef& ptx,
+                              bool* pfMissingInputs, int64_t nAcceptTime, std::list<CTransactionRef>* plTxnReplaced,
+                              bool bypass_limits, const CAmount& nAbsurdFee, std::vector<COutPoint>& coins_to_uncache)
+{
+    AssertLockHeld(cs_main);
+    LOCK(pool.cs); // mempool "read lock" (held through GetMainSignals().TransactionAddedToMempool())
+    if (pfMissingInputs) {
+        *pfMissingInputs = false;
+    }
+
+    if (!MemPoolContextFreeChecks(*ptx, state))
+        return false;
+
+    CTxAcceptWorkspace ws(ptx, state, pfMissingInputs, nAcceptTime, plTxnReplaced, bypass_limits, nAbsurdFee, coins_to_uncache);
+    if (!MemPoolPreChecks(chainparams, pool, ws))
+        return false;
+    if (!MemPoolPolicyScriptChecks(ws))
+        return false;
+    if (!MemPoolConsensusScriptChecks(ws, &pool))
+        return false;
+    return MemPoolFinalize(pool, ws);
+}
+
 /** (try to) add transaction to memory pool with a specified acceptance time **/
 static bool AcceptToMemoryPoolWithTime(const CChainParams& chainparams, CTxMemPool& pool, CValidationState &state, const CTransactionRef &tx,
                         bool* pfMissingInputs, int64_t nAcceptTime, std::list<CTransactionRef>* plTxnReplaced,
@@ -1003,6 +1126,184 @@ bool AcceptToMemoryPool(CTxMemPool& pool, CValidationState &state, const CTransa
     return AcceptToMemoryPoolWithTime(chainparams, pool, state, tx, pfMissingInputs, GetTime(), plTxnReplaced, bypass_limits, nAbsurdFee);
 }
 
+namespace {
+
+/**
+ * Closure representing one stage of accepting a transaction of a batch that
+ * needs no locks. The result is written to the workspace rather than returned,
+ * so a bad transaction doesn't stop the rest of the batch being checked.
+ */
+class CTxAcceptCheck
+{
+public:
+    enum Stage {
+        CONTEXT_FREE,   // MemPoolContextFreeChecks, and precomputing the signature hashes' parts
+        SCRIPTS         // MemPoolPolicyScriptChecks and MemPoolConsensusScriptChecks
+    };
+
+private:
+    CTxAcceptWorkspace *pws;
+    Stage stage;
+
+public:
+    CTxAcceptCheck(): pws(nullptr), stage(CONTEXT_FREE) {}
+    CTxAcceptCheck(CTxAcceptWorkspace& wsIn, Stage stageIn) : pws(&wsIn), stage(stageIn) {}
+
+    bool operator()() {
+        if (stage == CONTEXT_FREE) {
+            pws->fChecksPassed = MemPoolContextFreeChecks(*pws->ptx, pws->state);
+            if (pws->fChecksPassed)
+                pws->txdata.reset(new PrecomputedTransactionData(*pws->ptx));
+        } else {
+            pws->fChecksPassed = MemPoolPolicyScriptChecks(*pws) && MemPoolConsensusScriptChecks(*pws, nullptr);
+        }
+        return true;
+    }
+
+    void swap(CTxAcceptCheck &check) {
+        std::swap(pws, check.pws);
+        std::swap(stage, check.stage);
+    }
+};
+
+/**
+ * With cs_main and pool.cs held again, whether what MemPoolPreChecks worked
+ * out on pindexTip still holds: the same tip, no new spends of the inputs,
+ * the same in-mempool parents, and room for the transaction. If so its
+ * ancestors are brought up to date for MemPoolFinalize.
+ */
+bool MemPoolStillValid(CTxMemPool& pool, CTxAcceptWorkspace& ws, const CBlockIndex* pindexTip)
+{
+    AssertLockHeld(cs_main);
+    AssertLockHeld(pool.cs);
+    const CTransaction& tx = *ws.ptx;
+    if (chainActive.Tip() != pindexTip || pool.exists(tx.GetHash()))
+        return false;
+    for (const CTxIn& txin : tx.vin) {
+        if (pool.mapNextTx.count(txin.prevout))
+            return false;
+        const bool fFromMempool = ws.view.AccessCoin(txin.prevout).nHeight == MEMPOOL_HEIGHT;
+        if (pool.exists(txin.prevout.hash) != fFromMempool)
+            return false;
+    }
+
+    if (!ws.bypass_limits) {
+        CAmount mempoolRejectFee = pool.GetMinFee(gArgs.GetArg("-maxmempool", DEFAULT_MAX_MEMPOOL_SIZE) * 1000000).GetFee(ws.entry->GetTxSize());
+        if (mempoolRejectFee > 0 && ws.nModifiedFees < mempoolRejectFee)
+            return false;
+    }
+
+    ws.setAncestors.clear();
+    size_t nLimitAncestors = gArgs.GetArg("-limitancestorcount", DEFAULT_ANCESTOR_LIMIT);
+    size_t nLimitAncestorSize = gArgs.GetArg("-limitancestorsize", DEFAULT_ANCESTOR_SIZE_LIMIT)*1000;
+    size_t nLimitDescendants = gArgs.GetArg("-limitdescendantcount", DEFAULT_DESCENDANT_LIMIT);
+    size_t nLimitDescendantSize = gArgs.GetArg("-limitdescendantsize", DEFAULT_DESCENDANT_SIZE_LIMIT)*1000;
+    std::string errString;
+    return pool.CalculateMemPoolAncestors(*ws.entry, ws.setAncestors, nLimitAncestors, nLimitAncestorSize, nLimitDescendants, nLimitDescendantSize, errString);
+}
+
+/** Run stage's check for each workspace in vpws, on pqueue's threads if one is given, or in the calling thread otherwise */
+void RunTxAcceptChecks(const std::vector<CTxAcceptWorkspace*>& vpws, CTxAcceptCheck::Stage stage, CCheckQueue<CTxAcceptCheck>* pqueue)
+{
+    std::vector<CTxAcceptCheck> vChecks;
+    vChecks.reserve(vpws.size());
+    for (CTxAcceptWorkspace* pws : vpws)
+        vChecks.emplace_back(*pws, stage);
+
+    if (!pqueue) {
+        for (CTxAcceptCheck& check : vChecks)
+            check();
+        return;
+    }
+    CCheckQueueControl<CTxAcceptCheck> control(pqueue);
+    control.Add(vChecks);
+    control.Wait();
+}
+
+} // namespace
+
+// Each check is a whole transaction's scripts, so keep batches small
+static CCheckQueue<CTxAcceptCheck> txacceptqueue(16);
+
+void ThreadTxAcceptCheck() {
+    RenameThread("plexhive-txaccept");
+    txacceptqueue.Thread();
+}
+
+void AcceptToMemoryPoolMany(CTxMemPool& pool, std::vector<CTxToAccept>& vTxs, bool bypass_limits, const CAmount nAbsurdFee,
+                            std::list<CTransactionRef>* plTxnReplaced)
+{
+    const CChainParams& chainparams = Params();
+    CCheckQueue<CTxAcceptCheck>* pqueue = nScriptCheckThreads ? &txacceptqueue : nullptr;
+
+    std::vector<std::vector<COutPoint>> vCoinsToUncache(vTxs.size());
+    std::vector<std::unique_ptr<CTxAcceptWorkspace>> vWorkspaces(vTxs.size());
+    std::vector<CTxAcceptWorkspace*> vpwsChecking;
+    vpwsChecking.reserve(vTxs.size());
+    for (size_t i = 0; i < vTxs.size(); i++) {
+        CTxToAccept& txToAccept = vTxs[i];
+        txToAccept.state = CValidationState();
+        txToAccept.fMissingInputs = false;
+        txToAccept.fAccepted = false;
+        vWorkspaces[i].reset(new CTxAcceptWorkspace(txToAccept.tx, txToAccept.state, &txToAccept.fMissingInputs, txToAccept.nAcceptTime,
+                                                    plTxnReplaced, bypass_limits, nAbsurdFee, vCoinsToUncache[i]));
+        vpwsChecking.push_back(vWorkspaces[i].get());
+    }
+    RunTxAcceptChecks(vpwsChecking, CTxAcceptCheck::CONTEXT_FREE, pqueue);
+
+    // Look up the coins each spends, and make the checks against the tip and
+    // mempool. Those spending others in the batch, or replacing transactions,
+    // are left to AcceptToMemoryPoolWorker once the ones before are in.
+    const CBlockIndex* pindexTip;
+    std::vector<bool> vSerial(vTxs.size(), false);
+    vpwsChecking.clear();
+    {
+        LOCK2(cs_main, pool.cs);
+        pindexTip = chainActive.Tip();
+        for (size_t i = 0; i < vTxs.size(); i++) {
+            CTxAcceptWorkspace& ws = *vWorkspaces[i];
+            if (!ws.fChecksPassed)
+                continue;
+            ws.fChecksPassed = false;
+            if (!MemPoolPreChecks(chainparams, pool, ws)) {
+                vSerial[i] = vTxs[i].fMissingInputs;
+                continue;
+            }
+            if (!ws.setConflicts.empty()) {
+                vSerial[i] = true;
+                continue;
+            }
+            vpwsChecking.push_back(&ws);
+        }
+    }
+
+    RunTxAcceptChecks(vpwsChecking, CTxAcceptCheck::SCRIPTS, pqueue);
+
+    {
+        LOCK2(cs_main, pool.cs);
+        for (size_t i = 0; i < vTxs.size(); i++) {
+            CTxToAccept& txToAccept = vTxs[i];
+            CTxAcceptWorkspace& ws = *vWorkspaces[i];
+            if (ws.fChecksPassed && MemPoolStillValid(pool, ws, pindexTip)) {
+                txToAccept.fAccepted = MemPoolFinalize(pool, ws);
+            } else if (ws.fChecksPassed || vSerial[i]) {
+                // The signature and script execution caches hold what was checked already
+                txToAccept.state = CValidationState();
+                txToAccept.fAccepted = AcceptToMemoryPoolWorker(chainparams, pool, txToAccept.state, txToAccept.tx, &txToAccept.fMissingInputs,
+                                                                txToAccept.nAcceptTime, plTxnReplaced, bypass_limits, nAbsurdFee, vCoinsToUncache[i]);
+            }
+            if (!txToAccept.fAccepted) {
+                for (const COutPoint& outpoint : vCoinsToUncache[i])
+                    pcoinsTip->Uncache(outpoint);
+            }
+        }
+    }
+
+    // After we've (potentially) uncached entries, ensure our coins cache is still within its size limits
+    CValidationState stateDummy;
+    FlushStateToDisk(chainparams, stateDummy, FLUSH_STATE_PERIODIC);
+}
+
 /**
  * Return transaction in txOut, and if it was found inside a block, its hash is placed in hashBlock.
  * If blockIndex is provided, the transaction is fetched from the corresponding block.
@@ -1094,23 +1395,39 @@ static bool WriteBlockToDisk(const CBlock& block, CDiskBlockPos& pos, const CMes
     return true;
 }
 
-bool ReadBlockFromDisk(CBlock& block, const CDiskBlockPos& pos, const Consensus::Params& consensusParams)
+bool ReadBlockFromDisk(CBlock& block, const CDiskBlockPos& pos, const Consensus::Params& consensusParams, bool fCheckProof)
 {
     block.SetNull();
 
-    // Open history file to read
-    CAutoFile filein(OpenBlockFile(pos, true), SER_DISK, CLIENT_VERSION);
-    if (filein.IsNull())
-        return error("ReadBlockFromDisk: OpenBlockFile failed for %s", pos.ToString());
-
-    // Read block
+    // Read straight from the mapped block file where possible, falling back to reading the file, which
+    // reports the error if the block really can't be read
+    bool fMapped = false;
     try {
-        filein >> block;
+        fMapped = blockFileReader.ReadBlock(block, pos);
     }
     catch (const std::exception& e) {
-        return error("%s: Deserialize or I/O error - %s at %s", __func__, e.what(), pos.ToString());
+        LogPrintf("%s: Mapped read failed - %s at %s\n", __func__, e.what(), pos.ToString());
+        block.SetNull();
+    }
+
+    if (!fMapped) {
+        // Open history file to read
+        CAutoFile filein(OpenBlockFile(pos, true), SER_DISK, CLIENT_VERSION);
+        if (filein.IsNull())
+            return error("ReadBlockFromDisk: OpenBlockFile failed for %s", pos.ToString());
+
+        // Read block
+        try {
+            filein >> block;
+        }
+        catch (const std::exception& e) {
+            return error("%s: Deserialize or I/O error - %s at %s", __func__, e.what(), pos.ToString());
+        }
     }
 
+    if (!fCheckProof)
+        return true;
+
     // PlexHive: Hive: Check PoW or Hive work depending on blocktype
     if (block.IsHiveMined(consensusParams)) {
         if (!CheckHiveProof(&block, consensusParams))
@@ -1123,15 +1440,19 @@ bool ReadBlockFromDisk(CBlock& block, const CDiskBlockPos& pos, const Consensus:
     return true;
 }
 
-bool ReadBlockFromDisk(CBlock& block, const CBlockIndex* pindex, const Consensus::Params& consensusParams)
+bool ReadBlockFromDisk(CBlock& block, const CBlockIndex* pindex, const Consensus::Params& consensusParams, bool fCheckProof)
 {
     CDiskBlockPos blockPos;
+    bool fTrusted;
     {
         LOCK(cs_main);
         blockPos = pindex->GetBlockPos();
+        // A block that's been connected had its proof checked then; the hash check below is enough
+        // to tell it's the same block
+        fTrusted = !fParanoidBlockReads && pindex->IsValid(BLOCK_VALID_SCRIPTS);
     }
 
-    if (!ReadBlockFromDisk(block, blockPos, consensusParams))
+    if (!ReadBlockFromDisk(block, blockPos, consensusParams, fCheckProof && !fTrusted))
         return false;
     if (block.GetHash() != pindex->GetBlockHash())
         return error("ReadBlockFromDisk(CBlock&, CBlockIndex*): GetHash() doesn't match index for %s at %s",
@@ -1342,11 +1663,45 @@ void UpdateCoins(const CTransaction& tx, CCoinsViewCache& inputs, int nHeight)
 }
 
 bool CScriptCheck::operator()() {
+    if (hiveProofCheck)
+        return (*hiveProofCheck)();
     const CScript &scriptSig = ptxTo->vin[nIn].scriptSig;
     const CScriptWitness *witness = &ptxTo->vin[nIn].scriptWitness;
     return VerifyScript(scriptSig, m_tx_out.scriptPubKey, witness, nFlags, CachingTransactionSignatureChecker(ptxTo, nIn, m_tx_out.nValue, cacheStore, *txdata), &error);
 }
 
+bool CHeaderPoWCheck::operator()() {
+    *pfValid = CheckProofOfWork(pheader->GetPoWHash(), pheader->nBits, *pconsensusParams);
+    return *pfValid;
+}
+
+bool CheckHeadersPoW(const std::vector<CBlockHeader>& headers, const Consensus::Params& consensusParams, std::vector<unsigned char>& vPoWValid, CCheckQueue<CHeaderPoWCheck>* pqueue)
+{
+    assert(vPoWValid.size() == headers.size());
+    std::vector<CHeaderPoWCheck> vChecks;
+    vChecks.reserve(headers.size());
+    for (size_t i = 0; i < headers.size(); i++)
+        if (!vPoWValid[i])
+            vChecks.emplace_back(headers[i], consensusParams, &vPoWValid[i]);
+    if (vChecks.empty())
+        return true;
+
+    // Check the first header here, so a batch that's bad from the start costs a single hash
+    if (!vChecks[0]())
+        return false;
+    vChecks.erase(vChecks.begin());
+
+    if (!pqueue) {
+        for (CHeaderPoWCheck& check : vChecks)
+            if (!check())
+                return false;
+        return true;
+    }
+    CCheckQueueControl<CHeaderPoWCheck> control(pqueue);
+    control.Add(vChecks);
+    return control.Wait();
+}
+
 int GetSpendHeight(const CCoinsViewCache& inputs)
 {
     LOCK(cs_main);
@@ -1357,6 +1712,8 @@ int GetSpendHeight(const CCoinsViewCache& inputs)
 
 static CuckooCache::cache<uint256, SignatureCacheHasher> scriptExecutionCache;
 static uint256 scriptExecutionCacheNonce(GetRandHash());
+// Guards scriptExecutionCache, so mempool acceptance can check scripts without cs_main
+static boost::shared_mutex cs_scriptExecutionCache;
 
 void InitScriptExecutionCache() {
     // nMaxCacheSize is unsigned. If -maxsigcachesize is set to zero,
@@ -1408,9 +1765,11 @@ bool CheckInputs(const CTransaction& tx, CValidationState &state, const CCoinsVi
             // round - giving us 19 + 32 + 4 = 55 bytes (+ 8 + 1 = 64)
             static_assert(55 - sizeof(flags) - 32 >= 128/8, "Want at least 128 bits of nonce for script execution cache");
             CSHA256().Write(scriptExecutionCacheNonce.begin(), 55 - sizeof(flags) - 32).Write(tx.GetWitnessHash().begin(), 32).Write((unsigned char*)&flags, sizeof(flags)).Finalize(hashCacheEntry.begin());
-            AssertLockHeld(cs_main); //TODO: Remove this requirement by making CuckooCache not require external locks
-            if (scriptExecutionCache.contains(hashCacheEntry, !cacheFullScriptStore)) {
-                return true;
+            {
+                boost::shared_lock<boost::shared_mutex> lock(cs_scriptExecutionCache);
+                if (scriptExecutionCache.contains(hashCacheEntry, !cacheFullScriptStore)) {
+                    return true;
+                }
             }
 
             for (unsigned int i = 0; i < tx.vin.size(); i++) {
@@ -1456,6 +1815,7 @@ bool CheckInputs(const CTransaction& tx, CValidationState &state, const CCoinsVi
             if (cacheFullScriptStore && !pvChecks) {
                 // We executed all of the provided scripts, and were told to
                 // cache the result. Do so now.
+                boost::unique_lock<boost::shared_mutex> lock(cs_scriptExecutionCache);
                 scriptExecutionCache.insert(hashCacheEntry);
             }
         }
@@ -1643,6 +2003,10 @@ void static FlushBlockFile(bool fFinalize = false)
 
     CDiskBlockPos posOld(nLastBlockFile, 0);
 
+    // Don't leave a mapping reaching past the end of a truncated file
+    if (fFinalize)
+        blockFileReader.Invalidate(nLastBlockFile);
+
     FILE *fileOld = OpenBlockFile(posOld);
     if (fileOld) {
         if (fFinalize)
@@ -1708,6 +2072,14 @@ void ThreadScriptCheck() {
     scriptcheckqueue.Thread();
 }
 
+// PlexHive: MinotaurX+Hive1.2: Each check is a whole yespower hash, so keep batches small
+static CCheckQueue<CHeaderPoWCheck> headercheckqueue(8);
+
+void ThreadHeaderCheck() {
+    RenameThread("plexhive-headerch");
+    headercheckqueue.Thread();
+}
+
 // Protected by cs_main
 VersionBitsCache versionbitscache;
 
@@ -1817,7 +2189,8 @@ static int64_t nBlocksTotal = 0;
  *  Validity checks that depend on the UTXO set are also done; ConnectBlock()
  *  can fail if those validity checks fail (among other reasons). */
 bool CChainState::ConnectBlock(const CBlock& block, CValidationState& state, CBlockIndex* pindex,
-                  CCoinsViewCache& view, const CChainParams& chainparams, bool fJustCheck)
+                  CCoinsViewCache& view, const CChainParams& chainparams, bool fJustCheck,
+                  const std::vector<PrecomputedTransactionData>* ptxdata)
 {
     AssertLockHeld(cs_main);
     assert(pindex);
@@ -1839,7 +2212,9 @@ bool CChainState::ConnectBlock(const CBlock& block, CValidationState& state, CBl
     // is enforced in ContextualCheckBlockHeader(); we wouldn't want to
     // re-enforce that rule here (at least until we make it impossible for
     // GetAdjustedTime() to go backward).
-    if (!CheckBlock(block, state, chainparams.GetConsensus(), !fJustCheck, !fJustCheck))
+    // PlexHive: Hive: The Hive proof's bee hash and signature are checked with the scripts, below
+    std::vector<CHiveProofCheck> vHiveChecks;
+    if (!CheckBlock(block, state, chainparams.GetConsensus(), !fJustCheck, !fJustCheck, &vHiveChecks))
         return error("%s: Consensus::CheckBlock: %s", __func__, FormatStateMessage(state));
 
     // verify that the view's current state corresponds to the previous block
@@ -1940,6 +2315,23 @@ bool CChainState::ConnectBlock(const CBlock& block, CValidationState& state, CBl
 
     CCheckQueueControl<CScriptCheck> control(fScriptChecks && nScriptCheckThreads ? &scriptcheckqueue : nullptr);
 
+    // PlexHive: Hive: Start the Hive proof checks first, so they overlap with the block's script checks. Without
+    // script check threads, or with script checks skipped, run them now.
+    std::vector<std::shared_ptr<const CHiveProofCheck>> vHiveChecksQueued;
+    for (CHiveProofCheck& hiveCheck : vHiveChecks) {
+        if (fScriptChecks && nScriptCheckThreads) {
+            vHiveChecksQueued.push_back(std::make_shared<const CHiveProofCheck>(std::move(hiveCheck)));
+        } else if (!hiveCheck()) {
+            return state.DoS(100, error("%s: Consensus::CheckBlock: proof of hive failed", __func__), REJECT_INVALID, "bad-hive-proof");
+        }
+    }
+    if (!vHiveChecksQueued.empty()) {
+        std::vector<CScriptCheck> vChecks;
+        for (const auto& hiveCheck : vHiveChecksQueued)
+            vChecks.emplace_back(hiveCheck);
+        control.Add(vChecks);
+    }
+
     std::vector<int> prevheights;
     CAmount nFees = 0;
     int nInputs = 0;
@@ -1947,6 +2339,7 @@ bool CChainState::ConnectBlock(const CBlock& block, CValidationState& state, CBl
     blockundo.vtxundo.reserve(block.vtx.size() - 1);
     std::vector<PrecomputedTransactionData> txdata;
     txdata.reserve(block.vtx.size()); // Required so that pointers to individual PrecomputedTransactionData don't get invalidated
+    assert(!ptxdata || ptxdata->size() == block.vtx.size());
     for (unsigned int i = 0; i < block.vtx.size(); i++)
     {
         const CTransaction &tx = *(block.vtx[i]);
@@ -1988,7 +2381,11 @@ bool CChainState::ConnectBlock(const CBlock& block, CValidationState& state, CBl
             return state.DoS(100, error("ConnectBlock(): too many sigops"),
                              REJECT_INVALID, "bad-blk-sigops");
 
-        txdata.emplace_back(tx);
+        // Use the txdata computed ahead of time, if given
+        if (ptxdata)
+            txdata.push_back((*ptxdata)[i]);
+        else
+            txdata.emplace_back(tx);
         if (!tx.IsCoinBase())
         {
             std::vector<CScriptCheck> vChecks;
@@ -2047,8 +2444,13 @@ bool CChainState::ConnectBlock(const CBlock& block, CValidationState& state, CBl
         }
     }
 
-    if (!control.Wait())
+    if (!control.Wait()) {
+        // PlexHive: Hive: Report a bad Hive proof as such
+        for (const auto& hiveCheck : vHiveChecksQueued)
+            if (!(*hiveCheck)())
+                return state.DoS(100, error("%s: Consensus::CheckBlock: proof of hive failed", __func__), REJECT_INVALID, "bad-hive-proof");
         return state.DoS(100, error("%s: CheckQueue failed", __func__), REJECT_INVALID, "block-validation-failed");
+    }
     int64_t nTime4 = GetTimeMicros(); nTimeVerify += nTime4 - nTime2;
     LogPrint(BCLog::BENCH, "    - Verify %u txins: %.2fms (%.3fms/txin) [%.2fs (%.2fms/blk)]\n", nInputs - 1, MILLI * (nTime4 - nTime2), nInputs <= 1 ? 0 : MILLI * (nTime4 - nTime2) / (nInputs-1), nTimeVerify * MICRO, nTimeVerify * MILLI / nBlocksTotal);
 
@@ -2066,6 +2468,10 @@ bool CChainState::ConnectBlock(const CBlock& block, CValidationState& state, CBl
     if (!WriteTxIndexDataForBlock(block, state, pindex))
         return false;
 
+    // PlexHive: Hive: Index this block's BCTs so their Hive proofs can be checked without it
+    if (pbctIndex && !pbctIndex->WriteBlock(block, pindex, chainparams.GetConsensus()))
+        return AbortNode(state, "Failed to write BCT index");
+
     assert(pindex->phashBlock);
     // add this block to the view's block chain
     view.SetBestBlock(pindex->GetBlockHash());
@@ -2096,6 +2502,9 @@ bool static FlushStateToDisk(const CChainParams& chainparams, CValidationState &
     bool fDoFullFlush = false;
     int64_t nNow = 0;
     try {
+    // Surface a background flush that went wrong
+    if (pcoinsflusher && pcoinsflusher->HasFailed())
+        return AbortNode(state, "Failed to write to coin database");
     {
         LOCK(cs_LastBlockFile);
         if (fPruneMode && (fCheckForPruning || nManualPruneHeight > 0) && !fReindex) {
@@ -2125,7 +2534,8 @@ bool static FlushStateToDisk(const CChainParams& chainparams, CValidationState &
             nLastSetChain = nNow;
         }
         int64_t nMempoolSizeMax = gArgs.GetArg("-maxmempool", DEFAULT_MAX_MEMPOOL_SIZE) * 1000000;
-        int64_t cacheSize = pcoinsTip->DynamicMemoryUsage();
+        // Coins still being written in the background take memory too
+        int64_t cacheSize = pcoinsTip->DynamicMemoryUsage() + (pcoinsflusher ? pcoinsflusher->DynamicMemoryUsage() : 0);
         int64_t nTotalSpace = nCoinCacheUsage + std::max<int64_t>(nMempoolSizeMax - nMempoolUsage, 0);
         // The cache is large and we're within 10% and 10 MiB of the limit, but we have time now (not in the middle of a block processing).
         bool fCacheLarge = mode == FLUSH_STATE_PERIODIC && cacheSize > std::max((9 * nTotalSpace) / 10, nTotalSpace - MAX_BLOCK_COINSDB_USAGE * 1024 * 1024);
@@ -2177,7 +2587,11 @@ bool static FlushStateToDisk(const CChainParams& chainparams, CValidationState &
             if (!CheckDiskSpace(48 * 2 * 2 * pcoinsTip->GetCacheSize()))
                 return state.Error("out of disk space");
             // Flush the chainstate (which may refer to block index entries).
-            if (!pcoinsTip->Flush())
+            // Leave the writing to the background unless the caller needs the chainstate on disk when we
+            // return, or block files are about to be pruned.
+            bool fBackground = pcoinsflusher && mode != FLUSH_STATE_ALWAYS && !fFlushForPrune;
+            blockPrefetcher.CoinsFlushed();
+            if (!(fBackground ? pcoinsflusher->FlushInBackground(*pcoinsTip) : pcoinsTip->Flush()))
                 return AbortNode(state, "Failed to write to coin database");
             nLastFlush = nNow;
         }
@@ -2335,6 +2749,10 @@ static int64_t nTimeConnectTotal = 0;
 static int64_t nTimeFlush = 0;
 static int64_t nTimeChainState = 0;
 static int64_t nTimePostConnect = 0;
+static int64_t nTimePrefetchRead = 0;
+static int64_t nTimePrefetchPrecompute = 0;
+static int64_t nTimePrefetchCoins = 0;
+static int64_t nTimeWarmCoins = 0;
 
 struct PerBlockConnectTrace {
     CBlockIndex* pindex = nullptr;
@@ -2413,9 +2831,17 @@ bool CChainState::ConnectTip(CValidationState& state, const CChainParams& chainp
     // Read block from disk.
     int64_t nTime1 = GetTimeMicros();
     std::shared_ptr<const CBlock> pthisBlock;
-    if (!pblock) {
+    // Take the block as prepared while the one before connected, if it was. A block read here isn't proof checked
+    // on reading: ConnectBlock checks it, with a Hive proof's bee hash and signature on the script check threads,
+    // so the proof is checked once.
+    std::unique_ptr<CPrefetchedBlock> prefetched;
+    if (!pblock)
+        prefetched = blockPrefetcher.Take(pindexNew);
+    if (prefetched) {
+        pthisBlock = prefetched->pblock;
+    } else if (!pblock) {
         std::shared_ptr<CBlock> pblockNew = std::make_shared<CBlock>();
-        if (!ReadBlockFromDisk(*pblockNew, pindexNew, chainparams.GetConsensus()))
+        if (!ReadBlockFromDisk(*pblockNew, pindexNew, chainparams.GetConsensus(), false))
             return AbortNode(state, "Failed to read block");
         pthisBlock = pblockNew;
     } else {
@@ -2426,9 +2852,24 @@ bool CChainState::ConnectTip(CValidationState& state, const CChainParams& chainp
     int64_t nTime2 = GetTimeMicros(); nTimeReadFromDisk += nTime2 - nTime1;
     int64_t nTime3;
     LogPrint(BCLog::BENCH, "  - Load block from disk: %.2fms [%.2fs]\n", (nTime2 - nTime1) * MILLI, nTimeReadFromDisk * MICRO);
+    if (prefetched) {
+        // The prefetch stages ran alongside the previous block's connection; their times are what was saved
+        nTimePrefetchRead += prefetched->nReadTime;
+        nTimePrefetchPrecompute += prefetched->nPrecomputeTime;
+        nTimePrefetchCoins += prefetched->nCoinsTime;
+        LogPrint(BCLog::BENCH, "    - Prefetch read: %.2fms [%.2fs]\n", prefetched->nReadTime * MILLI, nTimePrefetchRead * MICRO);
+        LogPrint(BCLog::BENCH, "    - Prefetch txdata: %.2fms [%.2fs]\n", prefetched->nPrecomputeTime * MILLI, nTimePrefetchPrecompute * MICRO);
+        LogPrint(BCLog::BENCH, "    - Prefetch inputs: %u of %u found in %.2fms [%.2fs]\n", (unsigned int)prefetched->coins.size(), prefetched->nInputsLooked,
+            prefetched->nCoinsTime * MILLI, nTimePrefetchCoins * MICRO);
+        for (std::pair<COutPoint, Coin>& coin : prefetched->coins)
+            pcoinsTip->AddFetchedCoin(coin.first, std::move(coin.second));
+        int64_t nTimeWarmed = GetTimeMicros(); nTimeWarmCoins += nTimeWarmed - nTime2;
+        LogPrint(BCLog::BENCH, "    - Warm coins cache: %.2fms [%.2fs]\n", (nTimeWarmed - nTime2) * MILLI, nTimeWarmCoins * MICRO);
+        nTime2 = nTimeWarmed;
+    }
     {
         CCoinsViewCache view(pcoinsTip.get());
-        bool rv = ConnectBlock(blockConnecting, state, pindexNew, view, chainparams);
+        bool rv = ConnectBlock(blockConnecting, state, pindexNew, view, chainparams, false, prefetched ? &prefetched->txdata : nullptr);
         GetMainSignals().BlockChecked(blockConnecting, state);
         if (!rv) {
             if (state.IsInvalid())
@@ -2532,6 +2973,29 @@ void CChainState::PruneBlockIndexCandidates() {
     assert(!setBlockIndexCandidates.empty());
 }
 
+/** The view pcoinsTip reads through, which other threads can read too */
+static CCoinsView* CoinsTipBase()
+{
+    if (pcoinsflusher)
+        return pcoinsflusher.get();
+    return pcoinsdbview.get();
+}
+
+/**
+ * Have the blocks following pindexConnect towards pindexMostWork prepared while
+ * pindexConnect connects. If fHaveMostWork, pindexMostWork's block is already
+ * in hand.
+ */
+static void PrefetchBlocksAfter(const CBlockIndex* pindexConnect, const CBlockIndex* pindexMostWork, bool fHaveMostWork, const CChainParams& chainparams)
+{
+    AssertLockHeld(cs_main);
+    std::vector<const CBlockIndex*> vpindex(1, pindexConnect);
+    int nLastHeight = std::min(pindexConnect->nHeight + BLOCK_PREFETCH_DEPTH, pindexMostWork->nHeight - (fHaveMostWork ? 1 : 0));
+    for (int nHeight = pindexConnect->nHeight + 1; nHeight <= nLastHeight; nHeight++)
+        vpindex.push_back(pindexMostWork->GetAncestor(nHeight));
+    blockPrefetcher.Prefetch(vpindex, CoinsTipBase(), chainparams.GetConsensus());
+}
+
 /**
  * Try to make some progress towards making pindexMostWork the active block.
  * pblock is either nullptr or a pointer to a CBlock corresponding to pindexMostWork.
@@ -2574,6 +3038,8 @@ bool CChainState::ActivateBestChainStep(CValidationState& state, const CChainPar
 
         // Connect new blocks.
         for (CBlockIndex *pindexConnect : reverse_iterate(vpindexToConnect)) {
+            // Prepare the next blocks while this one connects
+            PrefetchBlocksAfter(pindexConnect, pindexMostWork, pblock != nullptr, chainparams);
             if (!ConnectTip(state, chainparams, pindexConnect, pindexConnect == pindexMostWork ? pblock : std::shared_ptr<const CBlock>(), connectTrace, disconnectpool)) {
                 if (state.IsInvalid()) {
                     // The block violates a consensus rule.
@@ -2885,6 +3351,7 @@ CBlockIndex* CChainState::AddToBlockIndex(const CBlockHeader& block)
         pindexNew->nHeight = pindexNew->pprev->nHeight + 1;
         pindexNew->BuildSkip();
     }
+    pindexNew->BuildHiveSkip(Params().GetConsensus());    // PlexHive: Hive: GetBlockProof needs these
     pindexNew->nTimeMax = (pindexNew->pprev ? std::max(pindexNew->pprev->nTimeMax, pindexNew->nTime) : pindexNew->nTime);
     pindexNew->nChainWork = (pindexNew->pprev ? pindexNew->pprev->nChainWork : 0) + GetBlockProof(*pindexNew);
     pindexNew->RaiseValidity(BLOCK_VALID_TREE);
@@ -3044,7 +3511,7 @@ static bool CheckBlockHeader(const CBlockHeader& block, CValidationState& state,
     return true;
 }
 
-bool CheckBlock(const CBlock& block, CValidationState& state, const Consensus::Params& consensusParams, bool fCheckPOW, bool fCheckMerkleRoot)
+bool CheckBlock(const CBlock& block, CValidationState& state, const Consensus::Params& consensusParams, bool fCheckPOW, bool fCheckMerkleRoot, std::vector<CHiveProofCheck>* pvHiveChecks)
 {
     // These are checks that are independent of context.
 
@@ -3058,7 +3525,7 @@ bool CheckBlock(const CBlock& block, CValidationState& state, const Consensus::P
 
     // PlexHive: Hive: Check Hive proof
     if (block.IsHiveMined(consensusParams))
-        if (!CheckHiveProof(&block, consensusParams))
+        if (!CheckHiveProof(&block, consensusParams, pvHiveChecks))
             return state.DoS(100, false, REJECT_INVALID, "bad-hive-proof", false, "proof of hive failed");
 
     // Check the merkle root.
@@ -3106,7 +3573,7 @@ bool CheckBlock(const CBlock& block, CValidationState& state, const Consensus::P
     if (nSigOps * WITNESS_SCALE_FACTOR > MAX_BLOCK_SIGOPS_COST)
         return state.DoS(100, false, REJECT_INVALID, "bad-blk-sigops", false, "out-of-bounds SigOpCount");
 
-    if (fCheckPOW && fCheckMerkleRoot)
+    if (fCheckPOW && fCheckMerkleRoot && (!pvHiveChecks || pvHiveChecks->empty()))
         block.fChecked = true;
 
     return true;
@@ -3141,25 +3608,27 @@ bool IsMinotaurXEnabled(const CBlockIndex* pindexPrev, const Consensus::Params&
 
 // PlexHive: Hive: Get the well-rooted deterministic random string (see whitepaper section 4.1)
 std::string GetDeterministicRandString(const CBlockIndex* pindexPrev) {
-    //LOCK(cs_main);  // Lock maybe not needed
+    std::vector<uint256> hashes;
+    GetDeterministicRandHashes(pindexPrev, hashes);
 
     std::string deterministicRandString = "";
-    int heights[] = { 0, 13, 173, 471, 1363, 12103 };
-    int hits = 0, steps = 0;
-    while (hits < 6) {
-        if (steps == heights[hits]) {
-            assert(pindexPrev->phashBlock);
-            deterministicRandString += pindexPrev->phashBlock->GetHex();
-            hits++;
-        }
+    for (const uint256& hash : hashes)
+        deterministicRandString += hash.GetHex();
+    return deterministicRandString;
+}
 
-        if (!pindexPrev->pprev)
+// PlexHive: Hive: The blocks 0, 13, 173, 471, 1363 and 12103 back from pindexPrev (as many as exist), found with
+// the skip list rather than by walking back 12103 blocks
+void GetDeterministicRandHashes(const CBlockIndex* pindexPrev, std::vector<uint256>& hashes) {
+    static const int heights[] = { 0, 13, 173, 471, 1363, 12103 };
+    hashes.clear();
+    for (int steps : heights) {
+        if (steps > pindexPrev->nHeight)
             break;
-
-        pindexPrev = pindexPrev->pprev;
-        steps++;
+        const CBlockIndex* pindex = pindexPrev->GetAncestor(pindexPrev->nHeight - steps);
+        assert(pindex && pindex->phashBlock);
+        hashes.push_back(*pindex->phashBlock);
     }
-    return deterministicRandString;
 }
 
 // PlexHive: Hive: Get tx by given hash, from a block at given chain height
@@ -3420,7 +3889,7 @@ static bool ContextualCheckBlock(const CBlock& block, CValidationState& state, c
     return true;
 }
 
-bool CChainState::AcceptBlockHeader(const CBlockHeader& block, CValidationState& state, const CChainParams& chainparams, CBlockIndex** ppindex)
+bool CChainState::AcceptBlockHeader(const CBlockHeader& block, CValidationState& state, const CChainParams& chainparams, CBlockIndex** ppindex, bool fCheckPOW)
 {
     AssertLockHeld(cs_main);
     // Check for duplicate
@@ -3439,7 +3908,7 @@ bool CChainState::AcceptBlockHeader(const CBlockHeader& block, CValidationState&
             return true;
         }
 
-        if (!CheckBlockHeader(block, state, chainparams.GetConsensus()))
+        if (!CheckBlockHeader(block, state, chainparams.GetConsensus(), fCheckPOW))
             return error("%s: Consensus::CheckBlockHeader: %s, %s", __func__, hash.ToString(), FormatStateMessage(state));
 
         // Get prev block index
@@ -3483,11 +3952,26 @@ bool CChainState::AcceptBlockHeader(const CBlockHeader& block, CValidationState&
 bool ProcessNewBlockHeaders(const std::vector<CBlockHeader>& headers, CValidationState& state, const CChainParams& chainparams, const CBlockIndex** ppindex, CBlockHeader *first_invalid)
 {
     if (first_invalid != nullptr) first_invalid->SetNull();
+
+    // PlexHive: MinotaurX+Hive1.2: Check the headers' proof of work up front, in parallel and without
+    // holding cs_main. Known and Hive headers aren't checked by AcceptBlockHeader, so are skipped.
+    // The check stops at the first bad header; AcceptBlockHeader checks any left unchecked.
+    std::vector<unsigned char> vPoWValid(headers.size(), 0);
+    {
+        LOCK(cs_main);
+        for (size_t i = 0; i < headers.size(); i++)
+            if (headers[i].IsHiveMined(chainparams.GetConsensus()) || mapBlockIndex.count(headers[i].GetHash()))
+                vPoWValid[i] = 1;
+    }
+    CheckHeadersPoW(headers, chainparams.GetConsensus(), vPoWValid, nScriptCheckThreads ? &headercheckqueue : nullptr);
+
     {
         LOCK(cs_main);
-        for (const CBlockHeader& header : headers) {
+        for (size_t i = 0; i < headers.size(); i++) {
+            const CBlockHeader& header = headers[i];
             CBlockIndex *pindex = nullptr; // Use a temp pindex instead of ppindex to avoid a const_cast
-            if (!g_chainstate.AcceptBlockHeader(header, state, chainparams, &pindex)) {
+            // A header that failed is checked again, so it's rejected with the usual state
+            if (!g_chainstate.AcceptBlockHeader(header, state, chainparams, &pindex, !vPoWValid[i])) {
                 if (first_invalid) *first_invalid = header;
                 return false;
             }
@@ -3566,7 +4050,10 @@ bool CChainState::AcceptBlock(const std::shared_ptr<const CBlock>& pblock, CVali
     }
     if (fNewBlock) *fNewBlock = true;
 
-    if (!CheckBlock(block, state, chainparams.GetConsensus()) ||
+    // PlexHive: Hive: A block loaded from a block file (on reindex or -loadblock) is read back from disk to
+    // connect, so its Hive proof's bee hash and signature are left to ConnectBlock to check
+    std::vector<CHiveProofCheck> vHiveChecksDeferred;
+    if (!CheckBlock(block, state, chainparams.GetConsensus(), true, true, dbp ? &vHiveChecksDeferred : nullptr) ||
         !ContextualCheckBlock(block, state, chainparams.GetConsensus(), pindex->pprev)) {
         if (state.IsInvalid() && !state.CorruptionPossible()) {
             pindex->nStatus |= BLOCK_FAILED_VALID;
@@ -3712,6 +4199,7 @@ void UnlinkPrunedFiles(const std::set<int>& setFilesToPrune)
 {
     for (std::set<int>::iterator it = setFilesToPrune.begin(); it != setFilesToPrune.end(); ++it) {
         CDiskBlockPos pos(*it, 0);
+        blockFileReader.Invalidate(*it);    // Let the file's space be freed
         fs::remove(GetBlockPosFilename(pos, "blk"));
         fs::remove(GetBlockPosFilename(pos, "rev"));
         LogPrintf("Prune: %s deleted blk/rev (%05u)\n", __func__, *it);
@@ -3895,6 +4383,7 @@ bool CChainState::LoadBlockIndex(const Consensus::Params& consensus_params, CBlo
     for (const std::pair<int, CBlockIndex*>& item : vSortedByHeight)
     {
         CBlockIndex* pindex = item.second;
+        pindex->BuildHiveSkip(consensus_params);  // PlexHive: Hive: GetBlockProof needs these
         pindex->nChainWork = (pindex->pprev ? pindex->pprev->nChainWork : 0) + GetBlockProof(*pindex);
         pindex->nTimeMax = (pindex->pprev ? std::max(pindex->pprev->nTimeMax, pindex->nTime) : pindex->nTime);
         // We can link the chain of blocks for which we've received transactions at some point.
@@ -4038,6 +4527,7 @@ bool CVerifyDB::VerifyDB(const CChainParams& chainparams, CCoinsView *coinsview,
     CCoinsViewCache coins(coinsview);
     CBlockIndex* pindexState = chainActive.Tip();
     CBlockIndex* pindexFailure = nullptr;
+    CSequentialBlockReader blockReader(chainparams.GetConsensus());   // Keep the disk reading ahead of the check
     int nGoodTransactions = 0;
     CValidationState state;
     int reportDone = 0;
@@ -4061,7 +4551,7 @@ bool CVerifyDB::VerifyDB(const CChainParams& chainparams, CCoinsView *coinsview,
         }
         CBlock block;
         // check level 0: read from disk
-        if (!ReadBlockFromDisk(block, pindex, chainparams.GetConsensus()))
+        if (!blockReader.Read(block, pindex))
             return error("VerifyDB(): *** ReadBlockFromDisk failed at %d, hash=%s", pindex->nHeight, pindex->GetBlockHash().ToString());
         // check level 1: verify block validity
         if (nCheckLevel >= 1 && !CheckBlock(block, state, chainparams.GetConsensus()))
@@ -4324,6 +4814,7 @@ void CChainState::UnloadBlockIndex() {
 void UnloadBlockIndex()
 {
     LOCK(cs_main);
+    blockPrefetcher.Clear();
     chainActive.SetTip(nullptr);
     pindexBestInvalid = nullptr;
     pindexBestHeader = nullptr;
@@ -4411,6 +4902,7 @@ bool LoadExternalBlockFile(const CChainParams& chainparams, FILE* fileIn, CDiskB
     int64_t nStart = GetTimeMillis();
 
     int nLoaded = 0;
+    AdviseSequential(fileIn);
     try {
         // This takes over fileIn and calls fclose() on it in the CBufferedFile destructor
         CBufferedFile blkdat(fileIn, 2*MAX_BLOCK_SERIALIZED_SIZE, MAX_BLOCK_SERIALIZED_SIZE+8, SER_DISK, CLIENT_VERSION);
@@ -4492,7 +4984,7 @@ bool LoadExternalBlockFile(const CChainParams& chainparams, FILE* fileIn, CDiskB
                     while (range.first != range.second) {
                         std::multimap<uint256, CDiskBlockPos>::iterator it = range.first;
                         std::shared_ptr<CBlock> pblockrecursive = std::make_shared<CBlock>();
-                        if (ReadBlockFromDisk(*pblockrecursive, it->second, chainparams.GetConsensus()))
+                        if (ReadBlockFromDisk(*pblockrecursive, it->second, chainparams.GetConsensus(), false))   // AcceptBlock checks the proof
                         {
                             LogPrint(BCLog::REINDEX, "%s: Processing out of order child %s of %s\n", __func__, pblockrecursive->GetHash().ToString(),
                                     head.ToString());
@@ -4736,10 +5228,11 @@ int VersionBitsTipStateSinceHeight(const Consensus::Params& params, Consensus::D
 }
 
 static const uint64_t MEMPOOL_DUMP_VERSION = 1;
+/** Transactions loaded from mempool.dat accepted at once */
+static const size_t MEMPOOL_LOAD_BATCH_SIZE = 1000;
 
 bool LoadMempool(void)
 {
-    const CChainParams& chainparams = Params();
     int64_t nExpiryTimeout = gArgs.GetArg("-mempoolexpiry", DEFAULT_MEMPOOL_EXPIRY) * 60 * 60;
     FILE* filestr = fsbridge::fopen(GetDataDir() / "mempool.dat", "rb");
     CAutoFile file(filestr, SER_DISK, CLIENT_VERSION);
@@ -4762,6 +5255,7 @@ bool LoadMempool(void)
         }
         uint64_t num;
         file >> num;
+        std::vector<CTxToAccept> vTxs;
         while (num--) {
             CTransactionRef tx;
             int64_t nTime;
@@ -4774,26 +5268,30 @@ bool LoadMempool(void)
             if (amountdelta) {
                 mempool.PrioritiseTransaction(tx->GetHash(), amountdelta);
             }
-            CValidationState state;
             if (nTime + nExpiryTimeout > nNow) {
-                LOCK(cs_main);
-                AcceptToMemoryPoolWithTime(chainparams, mempool, state, tx, nullptr /* pfMissingInputs */, nTime,
-                                           nullptr /* plTxnReplaced */, false /* bypass_limits */, 0 /* nAbsurdFee */);
-                if (state.IsValid()) {
-                    ++count;
-                } else {
-                    // mempool may contain the transaction already, e.g. from
-                    // wallet(s) having loaded it while we were processing
-                    // mempool transactions; consider these as valid, instead of
-                    // failed, but mark them as 'already there'
-                    if (mempool.exists(tx->GetHash())) {
-                        ++already_there;
+                vTxs.emplace_back(tx, nTime);
+            } else {
+                ++expired;
+            }
+            // Accept in batches, checking the scripts concurrently
+            if (vTxs.size() >= MEMPOOL_LOAD_BATCH_SIZE || (!num && !vTxs.empty())) {
+                AcceptToMemoryPoolMany(mempool, vTxs, false /* bypass_limits */, 0 /* nAbsurdFee */);
+                for (const CTxToAccept& txToAccept : vTxs) {
+                    if (txToAccept.state.IsValid()) {
+                        ++count;
                     } else {
-                        ++failed;
+                        // mempool may contain the transaction already, e.g. from
+                        // wallet(s) having loaded it while we were processing
+                        // mempool transactions; consider these as valid, instead of
+                        // failed, but mark them as 'already there'
+                        if (mempool.exists(txToAccept.tx->GetHash())) {
+                            ++already_there;
+                        } else {
+                            ++failed;
+                        }
                     }
                 }
-            } else {
-                ++expired;
+                vTxs.clear();
             }
             if (ShutdownRequested())
                 return false;
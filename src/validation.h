@@ -12,6 +12,7 @@
 
 #include <amount.h>
 #include <coins.h>
+#include <consensus/validation.h>
 #include <fs.h>
 #include <protocol.h> // For CMessageHeader::MessageStartChars
 #include <policy/feerate.h>
@@ -29,14 +30,19 @@
 #include <vector>
 
 #include <atomic>
+#include <memory>
 
 class CBlockIndex;
 class CBlockTreeDB;
 class CChainParams;
+class CCoinsViewBackgroundFlush;
 class CCoinsViewDB;
 class CInv;
 class CConnman;
 class CScriptCheck;
+class CHeaderPoWCheck;
+class CHiveProofCheck;
+template <typename T> class CCheckQueue;
 class CBlockPolicyEstimator;
 class CTxMemPool;
 class CValidationState;
@@ -129,6 +135,8 @@ static const int64_t MAX_FEE_ESTIMATION_TIP_AGE = 3 * 60 * 60;
 /** Default for -permitbaremultisig */
 static const bool DEFAULT_PERMIT_BAREMULTISIG = true;
 static const bool DEFAULT_CHECKPOINTS_ENABLED = true;
+/** Default for -paranoidblockreads */
+static const bool DEFAULT_PARANOID_BLOCK_READS = false;
 static const bool DEFAULT_TXINDEX = false;
 static const unsigned int DEFAULT_BANSCORE_THRESHOLD = 100;
 /** Default for -persistmempool */
@@ -173,6 +181,7 @@ extern bool fIsBareMultisigStd;
 extern bool fRequireStandard;
 extern bool fCheckBlockIndex;
 extern bool fCheckpointsEnabled;
+extern bool fParanoidBlockReads;
 extern size_t nCoinCacheUsage;
 /** A fee rate smaller than this is considered zero fee (for relaying, mining and transaction creation) */
 extern CFeeRate minRelayTxFee;
@@ -272,6 +281,10 @@ bool LoadChainTip(const CChainParams& chainparams);
 void UnloadBlockIndex();
 /** Run an instance of the script checking thread */
 void ThreadScriptCheck();
+/** PlexHive: MinotaurX+Hive1.2: Run an instance of the header proof of work checking thread */
+void ThreadHeaderCheck();
+/** Run an instance of the mempool acceptance checking thread */
+void ThreadTxAcceptCheck();
 /** Check whether we are doing an initial block download (synchronizing from disk or network) */
 bool IsInitialBlockDownload();
 /** Retrieve a transaction (from memory pool, or from disk, if possible) */
@@ -309,6 +322,34 @@ bool AcceptToMemoryPool(CTxMemPool& pool, CValidationState &state, const CTransa
                         bool* pfMissingInputs, std::list<CTransactionRef>* plTxnReplaced,
                         bool bypass_limits, const CAmount nAbsurdFee);
 
+/** A transaction for AcceptToMemoryPoolMany, and what became of it */
+struct CTxToAccept
+{
+    CTransactionRef tx;
+    int64_t nAcceptTime;
+    CValidationState state;
+    bool fMissingInputs;
+    bool fAccepted;
+
+    CTxToAccept(const CTransactionRef& txIn, int64_t nAcceptTimeIn) : tx(txIn), nAcceptTime(nAcceptTimeIn), fMissingInputs(false), fAccepted(false) {}
+};
+
+/**
+ * (try to) add a batch of transactions to the memory pool, with the same
+ * outcome as calling AcceptToMemoryPool on each in turn. The context-free
+ * checks and script checks run on the mempool acceptance threads, against the
+ * coins each transaction spends as they were when the batch was looked up, with
+ * no locks held; only the lookup and each insert are made under cs_main and
+ * pool.cs. A transaction whose inputs or in-mempool parents have changed by the
+ * time it's inserted, or that replaces others or spends another in the batch,
+ * is accepted as AcceptToMemoryPool would. If cs_main is already held, as when
+ * resolving orphans, the checks still run concurrently but other threads wait
+ * for them. plTxnReplaced will be appended to with all transactions replaced
+ * from mempool.
+ */
+void AcceptToMemoryPoolMany(CTxMemPool& pool, std::vector<CTxToAccept>& vTxs, bool bypass_limits, const CAmount nAbsurdFee,
+                            std::list<CTransactionRef>* plTxnReplaced = nullptr);
+
 /** Convert CValidationState to a human-readable message for logging */
 std::string FormatStateMessage(const CValidationState &state);
 
@@ -368,11 +409,15 @@ private:
     bool cacheStore;
     ScriptError error;
     PrecomputedTransactionData *txdata;
+    std::shared_ptr<const CHiveProofCheck> hiveProofCheck;   // PlexHive: Hive: If set, run this instead of a script
 
 public:
     CScriptCheck(): ptxTo(nullptr), nIn(0), nFlags(0), cacheStore(false), error(SCRIPT_ERR_UNKNOWN_ERROR) {}
     CScriptCheck(const CTxOut& outIn, const CTransaction& txToIn, unsigned int nInIn, unsigned int nFlagsIn, bool cacheIn, PrecomputedTransactionData* txdataIn) :
         m_tx_out(outIn), ptxTo(&txToIn), nIn(nInIn), nFlags(nFlagsIn), cacheStore(cacheIn), error(SCRIPT_ERR_UNKNOWN_ERROR), txdata(txdataIn) { }
+    // PlexHive: Hive: Check a Hive proof's bee hash and signature on the script check threads
+    explicit CScriptCheck(std::shared_ptr<const CHiveProofCheck> hiveProofCheckIn) :
+        ptxTo(nullptr), nIn(0), nFlags(0), cacheStore(false), error(SCRIPT_ERR_UNKNOWN_ERROR), txdata(nullptr), hiveProofCheck(hiveProofCheckIn) { }
 
     bool operator()();
 
@@ -384,23 +429,65 @@ public:
         std::swap(cacheStore, check.cacheStore);
         std::swap(error, check.error);
         std::swap(txdata, check.txdata);
+        std::swap(hiveProofCheck, check.hiveProofCheck);
     }
 
     ScriptError GetScriptError() const { return error; }
 };
 
+/**
+ * PlexHive: MinotaurX+Hive1.2: Closure representing one header proof of work check.
+ * The result is returned, so the queue stops at the first bad header, and also
+ * written to *pfValid so the caller knows which headers passed.
+ */
+class CHeaderPoWCheck
+{
+private:
+    const CBlockHeader *pheader;
+    const Consensus::Params *pconsensusParams;
+    unsigned char *pfValid;
+
+public:
+    CHeaderPoWCheck(): pheader(nullptr), pconsensusParams(nullptr), pfValid(nullptr) {}
+    CHeaderPoWCheck(const CBlockHeader& headerIn, const Consensus::Params& consensusParamsIn, unsigned char* pfValidIn) :
+        pheader(&headerIn), pconsensusParams(&consensusParamsIn), pfValid(pfValidIn) { }
+
+    bool operator()();
+
+    void swap(CHeaderPoWCheck &check) {
+        std::swap(pheader, check.pheader);
+        std::swap(pconsensusParams, check.pconsensusParams);
+        std::swap(pfValid, check.pfValid);
+    }
+};
+
+/**
+ * PlexHive: MinotaurX+Hive1.2: Check the proof of work of each header whose vPoWValid entry
+ * is 0, setting the entry to 1 if it passes. The first such header is checked in the calling
+ * thread, and the rest on pqueue's threads if one is given. Returns false once a header fails;
+ * entries left at 0 then may not have been checked.
+ */
+bool CheckHeadersPoW(const std::vector<CBlockHeader>& headers, const Consensus::Params& consensusParams, std::vector<unsigned char>& vPoWValid, CCheckQueue<CHeaderPoWCheck>* pqueue);
+
 /** Initializes the script-execution cache */
 void InitScriptExecutionCache();
 
 
-/** Functions for disk access for blocks */
-bool ReadBlockFromDisk(CBlock& block, const CDiskBlockPos& pos, const Consensus::Params& consensusParams);
-bool ReadBlockFromDisk(CBlock& block, const CBlockIndex* pindex, const Consensus::Params& consensusParams);
+/**
+ * Functions for disk access for blocks.
+ * Reading by position checks the block's PoW or Hive proof unless fCheckProof is false. Reading by
+ * index skips the proof for blocks already validated up to BLOCK_VALID_SCRIPTS (unless
+ * -paranoidblockreads is set), relying on the header hash matching the index, and for any block when
+ * fCheckProof is false, for callers that check it themselves.
+ */
+bool ReadBlockFromDisk(CBlock& block, const CDiskBlockPos& pos, const Consensus::Params& consensusParams, bool fCheckProof = true);
+bool ReadBlockFromDisk(CBlock& block, const CBlockIndex* pindex, const Consensus::Params& consensusParams, bool fCheckProof = true);
 
 /** Functions for validating blocks and updating the block tree */
 
 /** Context-independent validity checks */
-bool CheckBlock(const CBlock& block, CValidationState& state, const Consensus::Params& consensusParams, bool fCheckPOW = true, bool fCheckMerkleRoot = true);
+/** PlexHive: Hive: If pvHiveChecks is given, a Hive proof's bee hash and signature checks are left in it for the caller */
+bool CheckBlock(const CBlock& block, CValidationState& state, const Consensus::Params& consensusParams, bool fCheckPOW = true, bool fCheckMerkleRoot = true, std::vector<CHiveProofCheck>* pvHiveChecks = nullptr);
 
 /** Check a block is completely valid from start to finish (only works on top of our current best block, with cs_main held) */
 bool TestBlockValidity(CValidationState& state, const CChainParams& chainparams, const CBlock& block, CBlockIndex* pindexPrev, bool fCheckPOW = true, bool fCheckMerkleRoot = true);
@@ -420,6 +507,9 @@ bool IsMinotaurXEnabled(const CBlockIndex* pindexPrev, const Consensus::Params&
 // PlexHive: Hive: Get the well-rooted deterministic random string (see whitepaper section 4.1)
 std::string GetDeterministicRandString(const CBlockIndex* pindexPrev);
 
+// PlexHive: Hive: Get the block hashes making up the deterministic random string
+void GetDeterministicRandHashes(const CBlockIndex* pindexPrev, std::vector<uint256>& hashes);
+
 // PlexHive: Hive: Get tx by given hash, from a block at given chain height
 bool GetTxByHashAndHeight(const uint256 txHash, const int nHeight, CTransactionRef& txNew, CBlockIndex& foundAtOut, CBlockIndex* pindex, const Consensus::Params& consensusParams);
 
@@ -461,6 +551,10 @@ extern CChain& chainActive;
 /** Global variable that points to the coins database (protected by cs_main) */
 extern std::unique_ptr<CCoinsViewDB> pcoinsdbview;
 
+/** Global variable that points to the layer writing pcoinsTip's flushes in the background, between pcoinsTip
+ *  and the coins database, if -backgroundflush is on (protected by cs_main) */
+extern std::unique_ptr<CCoinsViewBackgroundFlush> pcoinsflusher;
+
 /** Global variable that points to the active CCoinsView (protected by cs_main) */
 extern std::unique_ptr<CCoinsViewCache> pcoinsTip;
 
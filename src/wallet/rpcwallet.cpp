@@ -689,7 +689,8 @@ UniValue getnetworkhiveinfo(const JSONRPCRequest& request)
 
     int globalImmatureBees, globalImmatureBCTs, globalMatureBees, globalMatureBCTs;
     CAmount potentialRewards;
-    if (!GetNetworkHiveInfo(globalImmatureBees, globalImmatureBCTs, globalMatureBees, globalMatureBCTs, potentialRewards, consensusParams, includeGraph))
+    std::vector<BeePopGraphPoint> beePopGraph;
+    if (!GetNetworkHiveInfo(globalImmatureBees, globalImmatureBCTs, globalMatureBees, globalMatureBCTs, potentialRewards, consensusParams, includeGraph ? &beePopGraph : nullptr))
         throw std::runtime_error("Error: A block required to calculate network bee population was not available (pruned data / not found on disk)");
 
     UniValue jsonResults(UniValue::VOBJ);
@@ -11,9 +11,6 @@ class CRPCTable;
 class CWallet;
 class JSONRPCRequest;
 
-struct BeePopGraphPoint;                            // PlexHive: Hive
-extern BeePopGraphPoint beePopGraph[1024*40];       // PlexHive: Hive
-
 void RegisterWalletRPCCommands(CRPCTable &t);
 
 /**
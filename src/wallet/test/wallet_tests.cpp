@@ -9,6 +9,7 @@
 #include <utility>
 #include <vector>
 
+#include <chainparams.h>
 #include <consensus/validation.h>
 #include <rpc/server.h>
 #include <test/test_bitcoin.h>
@@ -699,4 +700,197 @@ BOOST_FIXTURE_TEST_CASE(ListCoins, ListCoinsTestingSetup)
     BOOST_CHECK_EQUAL(list.begin()->second.size(), 2);
 }
 
+// PlexHive: Hive: Mining optimisations: The BCT index relies on status being a function of height alone
+BOOST_AUTO_TEST_CASE(bee_status_boundaries)
+{
+    Consensus::Params params;
+    params.beeGestationBlocks = 40;
+    params.beeLifespanBlocks = 100;
+
+    const int bctHeight = 1000;
+    BOOST_CHECK(GetBeeStatus(bctHeight, bctHeight, params) == BeeStatus::IMMATURE);
+    BOOST_CHECK(GetBeeStatus(bctHeight, bctHeight + 39, params) == BeeStatus::IMMATURE);
+    BOOST_CHECK(GetBeeStatus(bctHeight, bctHeight + 40, params) == BeeStatus::MATURE);
+    BOOST_CHECK(GetBeeStatus(bctHeight, bctHeight + 139, params) == BeeStatus::MATURE);
+    BOOST_CHECK(GetBeeStatus(bctHeight, bctHeight + 140, params) == BeeStatus::EXPIRED);
+
+    BOOST_CHECK_EQUAL(BeeStatusString(BeeStatus::IMMATURE), "immature");
+    BOOST_CHECK_EQUAL(BeeStatusString(BeeStatus::MATURE), "mature");
+    BOOST_CHECK_EQUAL(BeeStatusString(BeeStatus::EXPIRED), "expired");
+}
+
+// PlexHive: Hive: Mining optimisations: A wallet holding one of our BCTs, with block indexes outside chainActive to confirm it in
+class BCTIndexTestingSetup : public WalletTestingSetup
+{
+public:
+    BCTIndexTestingSetup()
+    {
+        const Consensus::Params& consensusParams = Params().GetConsensus();
+        key.MakeNewKey(true);
+        AddKey(*pwalletMain, key);
+        scriptPubKey = GetScriptForDestination(key.GetPubKey().GetID());
+
+        // Confirm the BCT at height 10, and grow the chain until its bees have just matured
+        pindexBCT = ExtendChain(chainActive.Tip(), 10);
+        pindexMature = ExtendChain(pindexBCT, consensusParams.beeGestationBlocks);
+
+        CMutableTransaction fund;
+        fund.vin.resize(1);
+        fund.vin[0].prevout = COutPoint(GetRandHash(), 0);
+        fund.vout.emplace_back(100 * COIN, scriptPubKey);
+        fundTx = MakeTransactionRef(fund);
+        BOOST_CHECK(pwalletMain->AddToWallet(CWalletTx(pwalletMain.get(), fundTx)));
+
+        CMutableTransaction bct;
+        bct.vin.emplace_back(COutPoint(fundTx->GetHash(), 0));
+        CScript scriptPubKeyBee = consensusParams.scriptPubKeyBCF;
+        scriptPubKeyBee << OP_RETURN << OP_BEE;
+        scriptPubKeyBee += scriptPubKey;
+        bct.vout.emplace_back(3 * GetBeeCost(pindexBCT->nHeight - 1, consensusParams), scriptPubKeyBee);
+        bctTx = MakeTransactionRef(bct);
+    }
+
+    CBlockIndex* ExtendChain(CBlockIndex* pindexPrev, int count)
+    {
+        LOCK(cs_main);
+        for (int i = 0; i < count; i++) {
+            auto inserted = mapBlockIndex.emplace(GetRandHash(), new CBlockIndex);
+            CBlockIndex* pindex = inserted.first->second;
+            pindex->phashBlock = &inserted.first->first;
+            pindex->pprev = pindexPrev;
+            pindex->nHeight = pindexPrev->nHeight + 1;
+            pindex->BuildSkip();
+            pindexPrev = pindex;
+        }
+        return pindexPrev;
+    }
+
+    void ConnectBlock(const CTransactionRef& tx, const CBlockIndex* pindex)
+    {
+        auto block = std::make_shared<CBlock>();
+        block->vtx.push_back(tx);
+        pwalletMain->BlockConnected(block, pindex, {});
+    }
+
+    void DisconnectBlock(const CTransactionRef& tx)
+    {
+        auto block = std::make_shared<CBlock>();
+        block->vtx.push_back(tx);
+        pwalletMain->BlockDisconnected(block);
+    }
+
+    CTransactionRef MakeHiveCoinbase(const std::string& bctTxid, CAmount reward)
+    {
+        CMutableTransaction cbt;
+        cbt.vin.resize(1);
+        CScript scriptPubKeyProof;
+        scriptPubKeyProof << OP_RETURN << OP_BEE << std::vector<unsigned char>(4) << std::vector<unsigned char>(4) << OP_FALSE;
+        scriptPubKeyProof << std::vector<unsigned char>(bctTxid.begin(), bctTxid.end());
+        cbt.vout.emplace_back(0, scriptPubKeyProof);
+        cbt.vout.emplace_back(reward, scriptPubKey);
+        return MakeTransactionRef(cbt);
+    }
+
+    int MatureBees(const CBlockIndex* pindexTip)
+    {
+        int totalBees;
+        pwalletMain->GetMatureBeeRanges(pindexTip, Params().GetConsensus(), totalBees);
+        return totalBees;
+    }
+
+    CKey key;
+    CScript scriptPubKey;
+    CBlockIndex* pindexBCT;
+    CBlockIndex* pindexMature;
+    CTransactionRef fundTx;
+    CTransactionRef bctTx;
+};
+
+// PlexHive: Hive: Mining optimisations: Every path that confirms, unconfirms or removes a BCT keeps the BCT index in step
+BOOST_FIXTURE_TEST_CASE(bct_index_paths, BCTIndexTestingSetup)
+{
+    // Connected
+    ConnectBlock(bctTx, pindexBCT);
+    BOOST_CHECK_EQUAL(MatureBees(pindexMature), 3);
+    BOOST_CHECK_EQUAL(MatureBees(pindexMature->pprev), 0);
+
+    // Disconnected
+    DisconnectBlock(bctTx);
+    BOOST_CHECK_EQUAL(MatureBees(pindexMature), 0);
+
+    // Abandoned (the BCT's block isn't in chainActive, so it has no confirmations), then connected again
+    ConnectBlock(bctTx, pindexBCT);
+    BOOST_CHECK_EQUAL(MatureBees(pindexMature), 3);
+    BOOST_CHECK(pwalletMain->AbandonTransaction(bctTx->GetHash()));
+    BOOST_CHECK_EQUAL(MatureBees(pindexMature), 0);
+    ConnectBlock(bctTx, pindexBCT);
+    BOOST_CHECK_EQUAL(MatureBees(pindexMature), 3);
+
+    // Added directly with a merkle branch, as importprunedfunds does
+    DisconnectBlock(bctTx);
+    BOOST_CHECK_EQUAL(MatureBees(pindexMature), 0);
+    CWalletTx wtx(pwalletMain.get(), bctTx);
+    wtx.SetMerkleBranch(pindexBCT, 0);
+    BOOST_CHECK(pwalletMain->AddToWallet(wtx));
+    BOOST_CHECK_EQUAL(MatureBees(pindexMature), 3);
+
+    // Zapped
+    {
+        LOCK(pwalletMain->cs_wallet);
+        std::vector<uint256> vHashIn{bctTx->GetHash()};
+        std::vector<uint256> vHashOut;
+        BOOST_CHECK_EQUAL(pwalletMain->ZapSelectTx(vHashIn, vHashOut), DB_LOAD_OK);
+        BOOST_CHECK_EQUAL(vHashOut.size(), 1U);
+    }
+    BOOST_CHECK_EQUAL(MatureBees(pindexMature), 0);
+}
+
+// PlexHive: Hive: Mining optimisations: A hive coinbase is credited to the BCT named in its script, while it's confirmed and in the wallet
+BOOST_FIXTURE_TEST_CASE(bct_hive_rewards, BCTIndexTestingSetup)
+{
+    LOCK2(cs_main, pwalletMain->cs_wallet);
+    const Consensus::Params& consensusParams = Params().GetConsensus();
+    CBlockIndex* pindexGenesis = chainActive.Genesis();
+    CBlockIndex* pindexCBT = ExtendChain(pindexMature, 1);
+    chainActive.SetTip(pindexCBT);
+    ConnectBlock(bctTx, pindexBCT);
+
+    // Only the coinbase naming our BCT is credited to it
+    CTransactionRef cbtOurs = MakeHiveCoinbase(bctTx->GetHash().GetHex(), 5 * COIN);
+    CTransactionRef cbtOther = MakeHiveCoinbase(GetRandHash().GetHex(), 7 * COIN);
+    ConnectBlock(cbtOther, pindexMature);
+    ConnectBlock(cbtOurs, pindexCBT);
+    std::vector<CBeeCreationTransactionInfo> bcts = pwalletMain->GetBCTs(false, true, consensusParams);
+    BOOST_REQUIRE_EQUAL(bcts.size(), 1U);
+    BOOST_CHECK_EQUAL(bcts[0].txid, bctTx->GetHash().GetHex());
+    BOOST_CHECK_EQUAL(bcts[0].beeCount, 3);
+    BOOST_CHECK_EQUAL(bcts[0].blocksFound, 1);
+    BOOST_CHECK_EQUAL(bcts[0].rewardsPaid, 5 * COIN);
+
+    // Its block disconnected
+    chainActive.SetTip(pindexMature);
+    DisconnectBlock(cbtOurs);
+    bcts = pwalletMain->GetBCTs(false, true, consensusParams);
+    BOOST_REQUIRE_EQUAL(bcts.size(), 1U);
+    BOOST_CHECK_EQUAL(bcts[0].blocksFound, 0);
+    BOOST_CHECK_EQUAL(bcts[0].rewardsPaid, 0);
+
+    // Connected again, then zapped
+    chainActive.SetTip(pindexCBT);
+    ConnectBlock(cbtOurs, pindexCBT);
+    bcts = pwalletMain->GetBCTs(false, true, consensusParams);
+    BOOST_REQUIRE_EQUAL(bcts.size(), 1U);
+    BOOST_CHECK_EQUAL(bcts[0].blocksFound, 1);
+    std::vector<uint256> vHashIn{cbtOurs->GetHash()};
+    std::vector<uint256> vHashOut;
+    BOOST_CHECK_EQUAL(pwalletMain->ZapSelectTx(vHashIn, vHashOut), DB_LOAD_OK);
+    BOOST_CHECK_EQUAL(vHashOut.size(), 1U);
+    bcts = pwalletMain->GetBCTs(false, true, consensusParams);
+    BOOST_REQUIRE_EQUAL(bcts.size(), 1U);
+    BOOST_CHECK_EQUAL(bcts[0].blocksFound, 0);
+    BOOST_CHECK_EQUAL(bcts[0].rewardsPaid, 0);
+
+    chainActive.SetTip(pindexGenesis);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
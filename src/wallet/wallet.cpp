@@ -6,6 +6,7 @@
 #include <wallet/wallet.h>
 
 #include <base58.h>
+#include <blockfilereader.h>
 #include <checkpoints.h>
 #include <chain.h>
 #include <wallet/coincontrol.h>
@@ -920,6 +921,7 @@ bool CWallet::AddToWallet(const CWalletTx& wtxIn, bool fFlushOnClose)
         wtxOrdered.insert(std::make_pair(wtx.nOrderPos, TxPair(&wtx, nullptr)));
         wtx.nTimeSmart = ComputeTimeSmart(wtx);
         AddToSpends(hash);
+        AddToHiveRewards(wtx);  // PlexHive: Hive
     }
 
     bool fUpdated = false;
@@ -966,6 +968,10 @@ bool CWallet::AddToWallet(const CWalletTx& wtxIn, bool fFlushOnClose)
         if (!walletdb.WriteTx(wtx))
             return false;
 
+    // PlexHive: Hive: Mining optimisations: Keep the BCT index in step. Index on wtxIn rather than the merged
+    // wtx, so a notification without a block (disconnect, conflict) drops the BCT even though hashBlock is kept
+    UpdateBCTIndex(wtxIn);
+
     // Break debit/credit balance caches:
     wtx.MarkDirty();
 
@@ -991,6 +997,9 @@ bool CWallet::LoadToWallet(const CWalletTx& wtxIn)
     wtx.BindWallet(this);
     wtxOrdered.insert(std::make_pair(wtx.nOrderPos, TxPair(&wtx, nullptr)));
     AddToSpends(hash);
+    AddToHiveRewards(wtx);  // PlexHive: Hive
+    // PlexHive: Hive: Mining optimisations: BCTs aren't indexed here, as their inputs may not be loaded yet
+    // (IsAllFromMe would fail); BuildBCTIndex indexes them once the whole wallet is loaded
     for (const CTxIn& txin : wtx.tx->vin) {
         auto it = mapWallet.find(txin.prevout.hash);
         if (it != mapWallet.end()) {
@@ -1120,6 +1129,7 @@ bool CWallet::AbandonTransaction(const uint256& hashTx)
             wtx.setAbandoned();
             wtx.MarkDirty();
             walletdb.WriteTx(wtx);
+            EraseFromBCTIndex(wtx.GetHash());   // PlexHive: Hive: Mining optimisations
             NotifyTransactionChanged(this, wtx.GetHash(), CT_UPDATED);
             // Iterate over all its outputs, and mark transactions in the wallet that spend them abandoned too
             TxSpends::const_iterator iter = mapTxSpends.lower_bound(COutPoint(hashTx, 0));
@@ -1185,6 +1195,7 @@ void CWallet::MarkConflicted(const uint256& hashBlock, const uint256& hashTx)
             wtx.hashBlock = hashBlock;
             wtx.MarkDirty();
             walletdb.WriteTx(wtx);
+            EraseFromBCTIndex(wtx.GetHash());   // PlexHive: Hive: Mining optimisations
             // Iterate over all its outputs, and mark transactions in the wallet that spend them conflicted too
             TxSpends::const_iterator iter = mapTxSpends.lower_bound(COutPoint(now, 0));
             while (iter != mapTxSpends.end() && iter->first.hash == now) {
@@ -1662,6 +1673,7 @@ CBlockIndex* CWallet::ScanForWalletTransactions(CBlockIndex* pindexStart, CBlock
         fAbortRescan = false;
         ShowProgress(_("Rescanning..."), 0); // show rescan progress in GUI as dialog or on splashscreen, if -rescan on startup
         CBlockIndex* tip = nullptr;
+        CSequentialBlockReader blockReader(Params().GetConsensus());    // PlexHive: Hive: Mining optimisations: Keep the disk reading ahead of the scan
         double dProgressStart;
         double dProgressTip;
         {
@@ -1687,7 +1699,7 @@ CBlockIndex* CWallet::ScanForWalletTransactions(CBlockIndex* pindexStart, CBlock
             }
 
             CBlock block;
-            if (ReadBlockFromDisk(block, pindex, Params().GetConsensus())) {
+            if (blockReader.Read(block, pindex)) {
                 LOCK2(cs_main, cs_wallet);
                 if (pindex && !chainActive.Contains(pindex)) {
                     // Abort scan if current block is no longer active, to prevent
@@ -2701,6 +2713,27 @@ OutputType CWallet::TransactionChangeType(OutputType change_type, const std::vec
 
 bool fWalletUnlockHiveMiningOnly = false;  // PlexHive: Hive: Unlock for hive mining purposes only.
 
+// PlexHive: Hive: Mining optimisations: Bees gestate for beeGestationBlocks after the BCT's block, then live for beeLifespanBlocks
+BeeStatus GetBeeStatus(int nBCTHeight, int nTipHeight, const Consensus::Params& consensusParams)
+{
+    int depth = nTipHeight - nBCTHeight + 1;
+    if (depth > consensusParams.beeGestationBlocks + consensusParams.beeLifespanBlocks)
+        return BeeStatus::EXPIRED;
+    if (depth > consensusParams.beeGestationBlocks)
+        return BeeStatus::MATURE;
+    return BeeStatus::IMMATURE;
+}
+
+std::string BeeStatusString(BeeStatus status)
+{
+    switch (status) {
+    case BeeStatus::IMMATURE: return "immature";
+    case BeeStatus::MATURE: return "mature";
+    case BeeStatus::EXPIRED: return "expired";
+    }
+    assert(false);
+}
+
 // PlexHive: Hive: Return info for a single BCT known by this wallet, optionally scanning for blocks minted by bees from this BCT
 CBeeCreationTransactionInfo CWallet::GetBCT(const CWalletTx& wtx, bool includeDead, bool scanRewards, const Consensus::Params& consensusParams, int minHoneyConfirmations) {
     CBeeCreationTransactionInfo bct;
@@ -2710,8 +2743,8 @@ CBeeCreationTransactionInfo CWallet::GetBCT(const CWalletTx& wtx, bool includeDe
 
     int maxDepth = consensusParams.beeGestationBlocks + consensusParams.beeLifespanBlocks;
 
-    CScript scriptPubKeyBCF = GetScriptForDestination(DecodeDestination(consensusParams.beeCreationAddress));
-    CScript scriptPubKeyCF = GetScriptForDestination(DecodeDestination(consensusParams.hiveCommunityAddress));
+    const CScript& scriptPubKeyBCF = consensusParams.scriptPubKeyBCF;
+    const CScript& scriptPubKeyCF = consensusParams.scriptPubKeyCF;
 
     // Make sure it's really a BCT
     CAmount beeFeePaid;
@@ -2731,20 +2764,13 @@ CBeeCreationTransactionInfo CWallet::GetBCT(const CWalletTx& wtx, bool includeDe
     int depth = wtx.GetDepthInMainChain();
     int blocksLeft = maxDepth - depth;
     blocksLeft++;   // Bee life starts at zero immediately AFTER the BCT appears in a block.
-    bool isMature = false;
-    std::string status = "immature";
-    if (blocksLeft < 1) {
+    BeeStatus status = GetBeeStatus(chainActive.Height() - depth + 1, chainActive.Height(), consensusParams);
+    if (status == BeeStatus::EXPIRED) {
         if (!includeDead)   // Skip dead bees unless explicitly including them
             return bct;
         blocksLeft = 0;
-        status = "expired";
-        isMature = true;    // We still want to calc rewards
-    } else {
-        if (depth > consensusParams.beeGestationBlocks) {
-            status = "mature";
-            isMature = true;
-        }
     }
+    bool isMature = status != BeeStatus::IMMATURE;    // We still want to calc rewards for expired bees
 
     // Find bee count & community donation status
     int height = chainActive.Height() - depth;
@@ -2761,27 +2787,17 @@ CBeeCreationTransactionInfo CWallet::GetBCT(const CWalletTx& wtx, bool includeDe
     int blocksFound = 0;
     CAmount rewardsPaid = 0;
     if (isMature && scanRewards) {
-        for (const std::pair<uint256, CWalletTx>& pairWtx2 : mapWallet) {
-            const CWalletTx& wtx2 = pairWtx2.second;
-
-            // Skip non-CBTs
-            if (!wtx2.IsHiveCoinBase())
-                continue;
-
-            // Skip unconfirmed transactions and orphans
-            if (wtx2.GetDepthInMainChain() < minHoneyConfirmations)
-                continue;
-
-            // Grab the txid (bytes 14-78)
-            std::vector<unsigned char> blockTxid(&wtx2.tx->vout[0].scriptPubKey[14], &wtx2.tx->vout[0].scriptPubKey[14 + 64]);
-            std::string blockTxidStr = std::string(blockTxid.begin(), blockTxid.end());
-
-            // Check it
-            if (bctTxid!=blockTxidStr)
-                continue;
+        // PlexHive: Hive: Mining optimisations: Only visit the CBTs attributed to this BCT
+        std::map<std::string, std::map<uint256, CAmount>>::const_iterator mi = mapHiveRewards.find(bctTxid);
+        if (mi != mapHiveRewards.end()) {
+            for (const auto& reward : mi->second) {
+                // Skip unconfirmed transactions and orphans
+                if (mapWallet.at(reward.first).GetDepthInMainChain() < minHoneyConfirmations)
+                    continue;
 
-            blocksFound++;
-            rewardsPaid += wtx2.tx->vout[1].nValue;
+                blocksFound++;
+                rewardsPaid += reward.second;
+            }
         }
     }
 
@@ -2794,7 +2810,7 @@ CBeeCreationTransactionInfo CWallet::GetBCT(const CWalletTx& wtx, bool includeDe
     bct.beeCount = beeCount;
     bct.beeFeePaid = beeFeePaid;
     bct.communityContrib = communityContrib;
-    bct.beeStatus = status;
+    bct.beeStatus = BeeStatusString(status);
     bct.honeyAddress = honeyAddress;
     bct.rewardsPaid = rewardsPaid;
     bct.blocksFound = blocksFound;
@@ -2811,22 +2827,15 @@ std::vector<CBeeCreationTransactionInfo> CWallet::GetBCTs(bool includeDead, bool
     if (chainActive.Height() == 0)  // Don't continue if chainActive is invalid; we may be reindexing
         return bcts;
 
-    CScript scriptPubKeyBCF = GetScriptForDestination(DecodeDestination(consensusParams.beeCreationAddress));
-    CScript scriptPubKeyCF = GetScriptForDestination(DecodeDestination(consensusParams.hiveCommunityAddress));
-
-    for (const std::pair<uint256, CWalletTx>& pairWtx : mapWallet) {
-        const CWalletTx& wtx = pairWtx.second;
-
-        // Skip unconfirmed transactions and orphans
-        if (wtx.GetDepthInMainChain() < 1)
-            continue;
-
-        // Skip CBTs
-        if (wtx.IsCoinBase())
+    // PlexHive: Hive: Mining optimisations: Only visit transactions in the BCT index, which holds our own confirmed BCTs
+    for (const auto& pairBCT : mapBCTs) {
+        std::map<uint256, CWalletTx>::const_iterator mi = mapWallet.find(pairBCT.first);
+        if (mi == mapWallet.end())
             continue;
+        const CWalletTx& wtx = mi->second;
 
-        // Check it's actually our BCT (otherwise comm fund keyholder for example would see all BCTs as wallet txs)
-        if (!IsAllFromMe(*wtx.tx, ISMINE_SPENDABLE))
+        // Skip unconfirmed transactions and orphans; the index can trail chainActive briefly after a reorg
+        if (wtx.GetDepthInMainChain() < 1)
             continue;
 
         // Get its info if it's a BCT
@@ -2838,6 +2847,140 @@ std::vector<CBeeCreationTransactionInfo> CWallet::GetBCTs(bool includeDead, bool
     return bcts;
 }
 
+// PlexHive: Hive: Mining optimisations: Return a bee range for each mature BCT on the chain ending at pindexTip, and their total bee count
+std::vector<CBeeRange> CWallet::GetMatureBeeRanges(const CBlockIndex* pindexTip, const Consensus::Params& consensusParams, int& totalBees) {
+    LOCK(cs_wallet);
+
+    std::vector<CBeeRange> ranges;
+    totalBees = 0;
+
+    // Mature BCTs were confirmed between beeGestationBlocks + 1 and beeGestationBlocks + beeLifespanBlocks blocks deep
+    int lowestHeight = pindexTip->nHeight - consensusParams.beeGestationBlocks - consensusParams.beeLifespanBlocks + 1;
+    int highestHeight = pindexTip->nHeight - consensusParams.beeGestationBlocks;
+    for (auto it = mapBCTsByHeight.lower_bound(lowestHeight); it != mapBCTsByHeight.end() && it->first <= highestHeight; it++) {
+        const CWalletBCT& bct = mapBCTs.at(it->second);
+
+        // The index follows validation notifications, which can trail the tip; skip BCTs that aren't on pindexTip's chain
+        const CBlockIndex* pindexBCT = pindexTip->GetAncestor(bct.nHeight);
+        if (!pindexBCT || pindexBCT->GetBlockHash() != bct.hashBlock)
+            continue;
+
+        ranges.push_back({bct.txid, bct.honeyAddress, bct.communityContrib, 0, bct.beeCount});
+        totalBees += bct.beeCount;
+    }
+
+    return ranges;
+}
+
+// PlexHive: Hive: Mining optimisations: Index wtx as confirmed in pindex if it's one of our BCTs, or drop it from the index if pindex is null
+void CWallet::UpdateBCTIndex(const CWalletTx& wtx, const CBlockIndex* pindex) {
+    AssertLockHeld(cs_wallet);
+
+    EraseFromBCTIndex(wtx.GetHash());
+    if (!pindex || wtx.IsCoinBase() || wtx.tx->vout.empty())
+        return;
+
+    const Consensus::Params& consensusParams = Params().GetConsensus();
+    const CScript& scriptPubKeyBCF = consensusParams.scriptPubKeyBCF;
+    const CScript& scriptPubKeyCF = consensusParams.scriptPubKeyCF;
+
+    CAmount beeFeePaid;
+    CScript scriptPubKeyHoney;
+    if (!wtx.tx->IsBCT(consensusParams, scriptPubKeyBCF, &beeFeePaid, &scriptPubKeyHoney))
+        return;
+
+    // Check it's actually our BCT (otherwise comm fund keyholder for example would see all BCTs as wallet txs)
+    if (!IsAllFromMe(*wtx.tx, ISMINE_SPENDABLE))
+        return;
+
+    CTxDestination honeyDestination;
+    if (!ExtractDestination(scriptPubKeyHoney, honeyDestination))
+        return;
+
+    CWalletBCT bct;
+    bct.hashBlock = pindex->GetBlockHash();
+    bct.nHeight = pindex->nHeight;
+    bct.txid = wtx.GetHash().GetHex();
+    bct.honeyAddress = EncodeDestination(honeyDestination);
+    bct.communityContrib = false;
+    if (wtx.tx->vout.size() > 1 && wtx.tx->vout[1].scriptPubKey == scriptPubKeyCF) {
+        beeFeePaid += wtx.tx->vout[1].nValue;
+        bct.communityContrib = true;
+    }
+    bct.beeCount = beeFeePaid / GetBeeCost(pindex->nHeight - 1, consensusParams);   // Costed as GetBCT does
+
+    mapBCTs[wtx.GetHash()] = bct;
+    mapBCTsByHeight.emplace(bct.nHeight, wtx.GetHash());
+}
+
+void CWallet::UpdateBCTIndex(const CWalletTx& wtx) {
+    const CBlockIndex* pindex = nullptr;
+    if (wtx.nIndex >= 0 && !wtx.hashUnset()) {
+        BlockMap::const_iterator mi = mapBlockIndex.find(wtx.hashBlock);
+        if (mi != mapBlockIndex.end())
+            pindex = mi->second;
+    }
+    UpdateBCTIndex(wtx, pindex);
+}
+
+void CWallet::EraseFromBCTIndex(const uint256& hash) {
+    AssertLockHeld(cs_wallet);
+
+    std::map<uint256, CWalletBCT>::iterator mi = mapBCTs.find(hash);
+    if (mi == mapBCTs.end())
+        return;
+
+    auto range = mapBCTsByHeight.equal_range(mi->second.nHeight);
+    for (auto it = range.first; it != range.second; it++) {
+        if (it->second == hash) {
+            mapBCTsByHeight.erase(it);
+            break;
+        }
+    }
+    mapBCTs.erase(mi);
+}
+
+// PlexHive: Hive: Mining optimisations: Record a CBT against the BCT named in its coinbase script
+void CWallet::AddToHiveRewards(const CWalletTx& wtx) {
+    if (!wtx.IsHiveCoinBase() || wtx.tx->vout.size() < 2 || wtx.tx->vout[0].scriptPubKey.size() < 14 + 64)
+        return;
+
+    // Grab the txid (bytes 14-78)
+    const CScript& script = wtx.tx->vout[0].scriptPubKey;
+    std::string bctTxid(script.begin() + 14, script.begin() + 14 + 64);
+    mapHiveRewards[bctTxid][wtx.GetHash()] = wtx.tx->vout[1].nValue;
+}
+
+void CWallet::EraseFromHiveRewards(const uint256& hash) {
+    std::map<uint256, CWalletTx>::const_iterator mi = mapWallet.find(hash);
+    if (mi == mapWallet.end() || !mi->second.IsHiveCoinBase() || mi->second.tx->vout[0].scriptPubKey.size() < 14 + 64)
+        return;
+
+    const CScript& script = mi->second.tx->vout[0].scriptPubKey;
+    std::string bctTxid(script.begin() + 14, script.begin() + 14 + 64);
+    auto it = mapHiveRewards.find(bctTxid);
+    if (it == mapHiveRewards.end())
+        return;
+    it->second.erase(hash);
+    if (it->second.empty())
+        mapHiveRewards.erase(it);
+}
+
+// PlexHive: Hive: Mining optimisations: Rebuild the BCT index from scratch
+void CWallet::BuildBCTIndex() {
+    LOCK2(cs_main, cs_wallet);
+
+    mapBCTs.clear();
+    mapBCTsByHeight.clear();
+    for (const auto& pairWtx : mapWallet) {
+        const CWalletTx& wtx = pairWtx.second;
+        if (wtx.GetDepthInMainChain() < 1)
+            continue;
+        UpdateBCTIndex(wtx, mapBlockIndex.at(wtx.hashBlock));
+    }
+    LogPrint(BCLog::HIVE, "%s: Indexed %u BCTs\n", __func__, mapBCTs.size());
+}
+
 // PlexHive: Hive: Create a BCT to gestate given number of bees
 bool CWallet::CreateBeeTransaction(int beeCount, CWalletTx& wtxNew, CReserveKey& reservekeyChange, CReserveKey& reservekeyHoney, std::string honeyAddress, std::string changeAddress, bool communityContrib, std::string& strFailReason, const Consensus::Params& consensusParams) {
     CBlockIndex* pindexPrev = chainActive.Tip();
@@ -3455,8 +3598,11 @@ DBErrors CWallet::ZapSelectTx(std::vector<uint256>& vHashIn, std::vector<uint256
 {
     AssertLockHeld(cs_wallet); // mapWallet
     DBErrors nZapSelectTxRet = CWalletDB(*dbw,"cr+").ZapSelectTx(vHashIn, vHashOut);
-    for (uint256 hash : vHashOut)
+    for (uint256 hash : vHashOut) {
+        EraseFromHiveRewards(hash); // PlexHive: Hive
         mapWallet.erase(hash);
+        EraseFromBCTIndex(hash);    // PlexHive: Hive
+    }
 
     if (nZapSelectTxRet == DB_NEED_REWRITE)
     {
@@ -4385,6 +4531,10 @@ CWallet* CWallet::CreateWalletFromFile(const std::string walletFile)
             }
         }
     }
+
+    // PlexHive: Hive: Mining optimisations: Index confirmed BCTs now the wallet has caught up with the chain
+    walletInstance->BuildBCTIndex();
+
     walletInstance->SetBroadcastTransactions(gArgs.GetBoolArg("-walletbroadcast", DEFAULT_WALLETBROADCAST));
 
     {
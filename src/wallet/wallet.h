@@ -692,6 +692,29 @@ struct CBeeRange
     int count;
 };
 
+// PlexHive: Hive: Mining optimisations: Lifecycle stage of a BCT's bees
+enum class BeeStatus {
+    IMMATURE,
+    MATURE,
+    EXPIRED,
+};
+
+/** Status of bees from a BCT confirmed at nBCTHeight, as seen from a tip at nTipHeight */
+BeeStatus GetBeeStatus(int nBCTHeight, int nTipHeight, const Consensus::Params& consensusParams);
+/** "immature", "mature" or "expired", as reported by listbees */
+std::string BeeStatusString(BeeStatus status);
+
+// PlexHive: Hive: Mining optimisations: A confirmed BCT in the wallet's BCT index
+struct CWalletBCT
+{
+    uint256 hashBlock;          // Block the BCT was confirmed in
+    int nHeight;                // Height of that block
+    std::string txid;
+    std::string honeyAddress;
+    bool communityContrib;
+    int beeCount;
+};
+
 class WalletRescanReserver; //forward declarations for ScanForWalletTransactions/RescanFromTime
 /**
  * A CWallet is an extension of a keystore, which also maintains a set of transactions and balances,
@@ -741,6 +764,34 @@ private:
 
     void SyncMetaData(std::pair<TxSpends::iterator, TxSpends::iterator>);
 
+    /**
+     * PlexHive: Hive: Mining optimisations: Index of this wallet's confirmed BCTs.
+     *
+     * Entries are added and removed as the wallet learns of BCTs being
+     * connected or disconnected, so BusyBees never has to walk mapWallet.
+     * A BCT's status depends only on its height relative to the tip, so
+     * mapBCTsByHeight holds the immature, mature and expired sets as three
+     * contiguous height ranges; the mature set is a single range query.
+     */
+    std::map<uint256, CWalletBCT> mapBCTs;
+    std::multimap<int, uint256> mapBCTsByHeight;
+
+    /* Index wtx as confirmed in pindex if it's one of our BCTs, or drop it from the index if pindex is null */
+    void UpdateBCTIndex(const CWalletTx& wtx, const CBlockIndex* pindex);
+    /* Index wtx as confirmed in the block its merkle branch points to, if it has one */
+    void UpdateBCTIndex(const CWalletTx& wtx);
+    void EraseFromBCTIndex(const uint256& hash);
+
+    /**
+     * PlexHive: Hive: Mining optimisations: Hive coinbases in the wallet, keyed by the txid
+     * (as it appears in the coinbase script) of the BCT whose bee minted them, with their reward.
+     * Which BCT a coinbase belongs to never changes, so entries track mapWallet insertions
+     * only; confirmations are checked when rewards are tallied.
+     */
+    std::map<std::string, std::map<uint256, CAmount>> mapHiveRewards;
+    void AddToHiveRewards(const CWalletTx& wtx);
+    void EraseFromHiveRewards(const uint256& hash);
+
     /* Used by TransactionAddedToMemorypool/BlockConnected/Disconnected.
      * Should be called with pindexBlock and posInBlock if this is for a transaction that is included in a block. */
     void SyncTransaction(const CTransactionRef& tx, const CBlockIndex *pindex = nullptr, int posInBlock = 0);
@@ -1009,6 +1060,12 @@ public:
     // PlexHive: Hive: Return all BCTs known by this wallet, optionally including dead bees and optionally scanning for blocks minted by bees from each BCT
     std::vector<CBeeCreationTransactionInfo> GetBCTs(bool includeDead, bool scanRewards, const Consensus::Params& consensusParams, int minHoneyConfirmations = 1);
 
+    // PlexHive: Hive: Mining optimisations: Return a bee range for each mature BCT on the chain ending at pindexTip, and their total bee count
+    std::vector<CBeeRange> GetMatureBeeRanges(const CBlockIndex* pindexTip, const Consensus::Params& consensusParams, int& totalBees);
+
+    // PlexHive: Hive: Mining optimisations: Rebuild the BCT index from scratch
+    void BuildBCTIndex();
+
     /**
      * Insert additional inputs into the transaction by
      * calling CreateTransaction();